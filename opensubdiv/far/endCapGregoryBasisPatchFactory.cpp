@@ -28,6 +28,7 @@
 #include "../far/stencilTableFactory.h"
 #include "../far/topologyRefiner.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
@@ -44,9 +45,11 @@ EndCapGregoryBasisPatchFactory::EndCapGregoryBasisPatchFactory(
     TopologyRefiner const & refiner,
     StencilTable * vertexStencils,
     StencilTable * varyingStencils,
-    bool shareBoundaryVertices) :
+    bool shareBoundaryVertices,
+    bool useThreads) :
     _vertexStencils(vertexStencils), _varyingStencils(varyingStencils),
     _refiner(&refiner), _shareBoundaryVertices(shareBoundaryVertices),
+    _useThreads(useThreads),
     _numGregoryBasisVertices(0), _numGregoryBasisPatches(0) {
 
     // Sanity check: the mesh must be adaptively refined
@@ -69,50 +72,108 @@ EndCapGregoryBasisPatchFactory::EndCapGregoryBasisPatchFactory(
     }
 }
 
-bool
-EndCapGregoryBasisPatchFactory::addPatchBasis(Vtr::internal::Level const & level, Index faceIndex,
-                                              Vtr::internal::Level::VSpan const cornerSpans[],
-                                              bool verticesMask[4][5],
-                                              int levelVertOffset,
-                                              int fvarChannel) {
+//
+//  Stencils of the new vertices of a patch, in the order they are appended
+//  to the stencil tables:
+//
+struct EndCapGregoryBasisPatchFactory::PatchStencils {
+
+    void Clear() {
+        sizes.clear();
+        indices.clear();
+        weights.clear();
+        varyingIndices.clear();
+    }
+
+    void Append(GregoryBasis::Point const & p, Index varyingIndex) {
+        int size = p.GetSize();
+        sizes.push_back(size);
+        for (int i = 0; i < size; ++i) {
+            indices.push_back(p.GetStencilIndex(i));
+            weights.push_back(p.GetStencilWeight(i));
+        }
+        varyingIndices.push_back(varyingIndex);
+    }
+
+    std::vector<int>   sizes;
+    std::vector<Index> indices;
+    std::vector<float> weights;
+    std::vector<Index> varyingIndices;
+};
+
+void
+EndCapGregoryBasisPatchFactory::computePatchBasis(PatchBasis const & patchBasis,
+                                                  PatchStencils & patchStencils) {
 
     // Gather the CVs that influence the Gregory patch and their relative
     // weights in a basis
-    GregoryBasis::ProtoBasis basis(level, faceIndex, cornerSpans, levelVertOffset, fvarChannel);
+    GregoryBasis::ProtoBasis basis(*patchBasis.level, patchBasis.faceIndex,
+                                   patchBasis.cornerSpans, patchBasis.levelVertOffset,
+                                   patchBasis.fvarChannel, &_basisCache);
 
+    bool const (&verticesMask)[4][5] = patchBasis.newVerticesMask;
+
+    patchStencils.Clear();
     for (int i = 0; i < 4; ++i) {
         if (verticesMask[i][0]) {
-            GregoryBasis::AppendToStencilTable(basis.P[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
-            }
+            patchStencils.Append(basis.P[i], basis.varyingIndex[i]);
         }
         if (verticesMask[i][1]) {
-            GregoryBasis::AppendToStencilTable(basis.Ep[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
-            }
+            patchStencils.Append(basis.Ep[i], basis.varyingIndex[i]);
         }
         if (verticesMask[i][2]) {
-            GregoryBasis::AppendToStencilTable(basis.Em[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
-            }
+            patchStencils.Append(basis.Em[i], basis.varyingIndex[i]);
         }
         if (verticesMask[i][3]) {
-            GregoryBasis::AppendToStencilTable(basis.Fp[i], _vertexStencils);
-            if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
-            }
+            patchStencils.Append(basis.Fp[i], basis.varyingIndex[i]);
         }
         if (verticesMask[i][4]) {
-            GregoryBasis::AppendToStencilTable(basis.Fm[i], _vertexStencils);
+            patchStencils.Append(basis.Fm[i], basis.varyingIndex[i]);
+        }
+    }
+}
+
+//
+//  Computes the bases of the patches gathered -- concurrently for blocks of
+//  patches when threaded -- and appends their stencils in order
+//
+void
+EndCapGregoryBasisPatchFactory::Finalize() {
+
+    int numPatches = (int)_patchBases.size();
+    int blockSize = std::min(numPatches, 1024);
+
+    std::vector<PatchStencils> blockStencils(blockSize);
+
+    for (int blockBegin = 0; blockBegin < numPatches; blockBegin += blockSize) {
+        int blockEnd = std::min(blockBegin + blockSize, numPatches);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
+        for (int i = blockBegin; i < blockEnd; ++i) {
+            computePatchBasis(_patchBases[i], blockStencils[i - blockBegin]);
+        }
+
+        for (int i = blockBegin; i < blockEnd; ++i) {
+            PatchStencils const & patchStencils = blockStencils[i - blockBegin];
+
+            _vertexStencils->_sizes.insert(_vertexStencils->_sizes.end(),
+                patchStencils.sizes.begin(), patchStencils.sizes.end());
+            _vertexStencils->_indices.insert(_vertexStencils->_indices.end(),
+                patchStencils.indices.begin(), patchStencils.indices.end());
+            _vertexStencils->_weights.insert(_vertexStencils->_weights.end(),
+                patchStencils.weights.begin(), patchStencils.weights.end());
+
             if (_varyingStencils) {
-                GregoryBasis::AppendToStencilTable(basis.varyingIndex[i], _varyingStencils);
+                for (int j = 0; j < (int)patchStencils.varyingIndices.size(); ++j) {
+                    GregoryBasis::AppendToStencilTable(
+                        patchStencils.varyingIndices[j], _varyingStencils);
+                }
             }
         }
     }
-    return true;
+    _patchBases.clear();
 }
 
 //
@@ -220,7 +281,16 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
         _levelAndFaceIndices.push_back(LevelAndFaceIndex::create(levelIndex, faceIndex));
     }
 
-    bool newVerticesMask[4][5];
+    PatchBasis patchBasis;
+    patchBasis.level = level;
+    patchBasis.faceIndex = faceIndex;
+    for (int i = 0; i < 4; ++i) {
+        patchBasis.cornerSpans[i] = cornerSpans[i];
+    }
+    patchBasis.levelVertOffset = levelVertOffset;
+    patchBasis.fvarChannel = fvarChannel;
+
+    bool (&newVerticesMask)[4][5] = patchBasis.newVerticesMask;
     for (int i = 0; i < 4; ++i) {
         for (int j = 0; j < 5; ++j) {
             if (dest[i*5+j]==Vtr::INDEX_INVALID) {
@@ -236,8 +306,8 @@ EndCapGregoryBasisPatchFactory::GetPatchPoints(
         }
     }
 
-    // add basis
-    addPatchBasis(*level, faceIndex, cornerSpans, newVerticesMask, levelVertOffset, fvarChannel);
+    // add basis (computed when finalized)
+    _patchBases.push_back(patchBasis);
 
     ++_numGregoryBasisPatches;
 
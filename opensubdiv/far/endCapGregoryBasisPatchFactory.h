@@ -64,10 +64,15 @@ public:
     ///                               patches. It reduces the number of stencils
     ///                               to be used.
     ///
+    /// @param useThreads             Compute the bases of the patches concurrently
+    ///                               when finalized (requires OpenMP, the result is
+    ///                               unchanged)
+    ///
     EndCapGregoryBasisPatchFactory(TopologyRefiner const & refiner,
                                    StencilTable *vertexStencils,
                                    StencilTable *varyingStencils,
-                                   bool shareBoundaryVertices=true);
+                                   bool shareBoundaryVertices=true,
+                                   bool useThreads=false);
 
     /// \brief Returns end patch point indices for \a faceIndex of \a level.
     ///        Note that end patch points are not included in the vertices in
@@ -88,24 +93,45 @@ public:
         Vtr::internal::Level::VSpan const cornerSpans[],
         int levelVertOffset, int fvarChannel = -1);
 
+    /// \brief Computes the stencils of the patch points returned, which are
+    ///        appended to the stencil tables. Must be called once all patches
+    ///        have been gathered.
+    ///
+    void Finalize();
+
 private:
 
+    //  The basis of each patch is computed when finalized, from the
+    //  information retained here when its points are gathered:
+    struct PatchBasis {
+        Vtr::internal::Level const * level;
+        Index faceIndex;
+        Vtr::internal::Level::VSpan cornerSpans[4];
+        int levelVertOffset;
+        int fvarChannel;
+        bool newVerticesMask[4][5];
+    };
+
+    struct PatchStencils;
+
     /// Creates a basis for the vertices specified in mask on the face and
-    /// accumulates it
-    bool addPatchBasis(Vtr::internal::Level const & level, Index faceIndex,
-                       Vtr::internal::Level::VSpan const cornerSpans[],
-                       bool newVerticesMask[4][5],
-                       int levelVertOffset, int fvarChannel);
+    /// gathers its stencils
+    void computePatchBasis(PatchBasis const & patchBasis,
+                           PatchStencils & patchStencils);
 
     StencilTable *_vertexStencils;
     StencilTable *_varyingStencils;
 
     TopologyRefiner const *_refiner;
     bool _shareBoundaryVertices;
+    bool _useThreads;
     int _numGregoryBasisVertices;
     int _numGregoryBasisPatches;
     std::vector<Index> _patchPoints;
 
+    std::vector<PatchBasis> _patchBases;
+    GregoryBasis::ProtoBasisCache _basisCache;
+
     //  Only used when sharing vertices:
     std::vector<unsigned int> _levelAndFaceIndices;
 };
@@ -0,0 +1,275 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/faceRegion.h"
+#include "../far/ptexIndices.h"
+#include "../far/topologyRefiner.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    void
+    sortUnique(std::vector<Index> & v) {
+        std::sort(v.begin(), v.end());
+        v.erase(std::unique(v.begin(), v.end()), v.end());
+    }
+
+    void
+    select(Index stencil, std::vector<bool> & selected,
+           std::vector<Index> & stencils) {
+        if (stencil >= 0 && !selected[stencil]) {
+            selected[stencil] = true;
+            stencils.push_back(stencil);
+        }
+    }
+} // end namespace
+
+FaceRegion::FaceRegion(TopologyRefiner const & refiner,
+                       PatchTable const * patchTable,
+                       int numFaces, Index const * faces) :
+    _numLocalPoints(0) {
+
+    int nlevels = refiner.GetNumLevels();
+
+    _levels.resize(nlevels);
+    _numLevelVertices.resize(nlevels);
+
+    std::vector<Index> levelVertOffsets(nlevels + 1, 0);
+
+    // descend the faces of the region through the levels
+    _levels[0].faces.assign(faces, faces + numFaces);
+    sortUnique(_levels[0].faces);
+
+    for (int level = 0; level < nlevels; ++level) {
+
+        TopologyLevel const & tlevel = refiner.GetLevel(level);
+
+        _numLevelVertices[level] = tlevel.GetNumVertices();
+        levelVertOffsets[level + 1] =
+            levelVertOffsets[level] + _numLevelVertices[level];
+
+        std::vector<Index> const & levelFaces = _levels[level].faces;
+        std::vector<Index> & vertices = _levels[level].vertices;
+
+        for (int i = 0; i < (int)levelFaces.size(); ++i) {
+            ConstIndexArray fverts = tlevel.GetFaceVertices(levelFaces[i]);
+            vertices.insert(vertices.end(), fverts.begin(), fverts.end());
+        }
+
+        if (level + 1 < nlevels) {
+            // adaptive refinement only refines the faces of interest
+            std::vector<Index> & childFaces = _levels[level + 1].faces;
+            for (int i = 0; i < (int)levelFaces.size(); ++i) {
+                ConstIndexArray children =
+                    tlevel.GetFaceChildFaces(levelFaces[i]);
+                for (int j = 0; j < children.size(); ++j) {
+                    if (IndexIsValid(children[j])) {
+                        childFaces.push_back(children[j]);
+                    }
+                }
+            }
+            sortUnique(childFaces);
+        }
+    }
+
+    if (patchTable) {
+
+        int numVerticesTotal = levelVertOffsets[nlevels];
+
+        _numLocalPoints = patchTable->GetNumLocalPoints();
+
+        // patches are selected by the ptex faces of the base faces
+        PtexIndices ptexIndices(refiner);
+
+        int numBaseFaces = refiner.GetLevel(0).GetNumFaces();
+
+        std::vector<bool> ptexFaces(ptexIndices.GetNumFaces(), false);
+        for (int i = 0; i < (int)_levels[0].faces.size(); ++i) {
+            Index face = _levels[0].faces[i];
+            int first = ptexIndices.GetFaceId(face),
+                last = (face + 1 < numBaseFaces) ?
+                    ptexIndices.GetFaceId(face + 1) : ptexIndices.GetNumFaces();
+            std::fill(ptexFaces.begin() + first, ptexFaces.begin() + last, true);
+        }
+
+        std::vector<bool> localPoints(_numLocalPoints, false);
+
+        for (int parray = 0, current = 0;
+            parray < patchTable->GetNumPatchArrays(); ++parray) {
+
+            ConstPatchParamArray params = patchTable->GetPatchParams(parray);
+
+            int ncvs = patchTable->GetPatchArrayDescriptor(
+                parray).GetNumControlVertices();
+
+            for (int j = 0; j < patchTable->GetNumPatches(parray);
+                ++j, ++current) {
+
+                if (! ptexFaces[params[j].GetFaceId()]) {
+                    continue;
+                }
+
+                PatchTable::PatchHandle handle;
+                handle.arrayIndex = parray;
+                handle.patchIndex = current;
+                handle.vertIndex  = j * ncvs;
+                _patches.push_back(handle);
+
+                ConstIndexArray cvs = patchTable->GetPatchVertices(parray, j);
+                for (int k = 0; k < cvs.size(); ++k) {
+                    if (cvs[k] < numVerticesTotal) {
+                        int level = (int)(std::upper_bound(
+                            levelVertOffsets.begin(), levelVertOffsets.end(),
+                                cvs[k]) - levelVertOffsets.begin()) - 1;
+                        _levels[level].vertices.push_back(
+                            cvs[k] - levelVertOffsets[level]);
+                    } else {
+                        localPoints[cvs[k] - numVerticesTotal] = true;
+                    }
+                }
+            }
+        }
+
+        // add the vertices supporting the local points
+        StencilTable const * localPointStencils =
+            patchTable->GetLocalPointStencilTable();
+
+        for (int i = 0; i < _numLocalPoints; ++i) {
+            if (! localPoints[i]) {
+                continue;
+            }
+            _localPoints.push_back(i);
+
+            if (localPointStencils) {
+                Stencil stencil = localPointStencils->GetStencil(i);
+                for (int k = 0; k < stencil.GetSize(); ++k) {
+                    Index v = stencil.GetVertexIndices()[k];
+                    assert(v < numVerticesTotal);
+                    int level = (int)(std::upper_bound(
+                        levelVertOffsets.begin(), levelVertOffsets.end(), v) -
+                            levelVertOffsets.begin()) - 1;
+                    _levels[level].vertices.push_back(v - levelVertOffsets[level]);
+                }
+            }
+        }
+    }
+
+    for (int level = 0; level < nlevels; ++level) {
+        sortUnique(_levels[level].vertices);
+    }
+}
+
+bool
+FaceRegion::getStencils(std::vector<int> const & sizes,
+                        std::vector<Index> const & offsets,
+                        std::vector<Index> const & indices,
+                        std::vector<Index> const & levelOffsets,
+                        std::vector<Index> const & levelSourceOffsets,
+                        std::vector<Index> & stencils) const {
+
+    stencils.clear();
+
+    int nlevels = (int)_levels.size();
+
+    std::vector<Index> levelVertOffsets(nlevels + 1, 0);
+    for (int level = 0; level < nlevels; ++level) {
+        levelVertOffsets[level + 1] =
+            levelVertOffsets[level] + _numLevelVertices[level];
+    }
+
+    int numVerticesTotal = levelVertOffsets[nlevels],
+        numStencils = (int)sizes.size();
+
+    // deduce the layout of the table : the first vertex with a stencil is
+    // either the first control vertex, the first refined vertex or the
+    // first vertex of the last level, optionally followed by local points
+    Index const candidates[3] = { 0, _numLevelVertices[0],
+                                  levelVertOffsets[nlevels - 1] };
+
+    Index firstVertex = -1;
+    bool hasLocalPoints = false;
+    for (int i = 0; i < 3; ++i) {
+        int numVertexStencils = numVerticesTotal - candidates[i];
+        if (numStencils == numVertexStencils) {
+            firstVertex = candidates[i];
+            break;
+        }
+        if (_numLocalPoints > 0 &&
+            numStencils == numVertexStencils + _numLocalPoints) {
+            firstVertex = candidates[i];
+            hasLocalPoints = true;
+            break;
+        }
+    }
+    if (firstVertex < 0) {
+        return false;
+    }
+
+    std::vector<bool> selected(numStencils, false);
+
+    for (int level = 0; level < nlevels; ++level) {
+        std::vector<Index> const & vertices = _levels[level].vertices;
+        for (int i = 0; i < (int)vertices.size(); ++i) {
+            select(levelVertOffsets[level] + vertices[i] - firstVertex,
+                selected, stencils);
+        }
+    }
+
+    if (hasLocalPoints) {
+        for (int i = 0; i < (int)_localPoints.size(); ++i) {
+            select(numVerticesTotal - firstVertex + _localPoints[i],
+                selected, stencils);
+        }
+    }
+
+    if (! levelOffsets.empty()) {
+        // level-to-level stencils also depend on the stencils of the
+        // vertices they refer to, down to the control vertices
+        assert(levelSourceOffsets.size() + 1 == levelOffsets.size());
+        for (int i = 0; i < (int)stencils.size(); ++i) {
+            Index stencil = stencils[i];
+            int pass = (int)(std::upper_bound(levelOffsets.begin(),
+                levelOffsets.end(), stencil) - levelOffsets.begin()) - 1;
+            Index const * src = &indices[offsets[stencil]];
+            for (int j = 0; j < sizes[stencil]; ++j) {
+                select(levelSourceOffsets[pass] + src[j], selected, stencils);
+            }
+        }
+    }
+
+    std::sort(stencils.begin(), stencils.end());
+    return true;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
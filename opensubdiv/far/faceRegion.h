@@ -0,0 +1,165 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_FACEREGION_H
+#define OPENSUBDIV3_FAR_FACEREGION_H
+
+#include "../version.h"
+
+#include "../far/patchTable.h"
+#include "../far/stencilTable.h"
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+class TopologyRefiner;
+
+///
+/// \brief Region of interest of a refined mesh defined by a set of base faces
+///
+/// Gathers everything the evaluation of a subset of the base faces depends
+/// on : the faces descending from them at each level of refinement, the
+/// refined vertices supporting these faces and their patches, the local
+/// points of the patches and the patches themselves. The stencils of the
+/// region (see GetStencils()) can then be evaluated with the sparse stencil
+/// evaluation of the Osd CPU evaluators and the patches with EvalPatches(),
+/// at a cost proportional to the size of the region rather than to the size
+/// of the mesh (ex. the faces being posed or the faces of a render bucket).
+///
+class FaceRegion {
+
+public:
+
+    /// \brief Constructor
+    ///
+    /// @param refiner     TopologyRefiner refined uniformly or adaptively
+    ///
+    /// @param patchTable  PatchTable created from the refiner (optional)
+    ///
+    /// @param numFaces    Number of base faces of the region
+    ///
+    /// @param faces       Indices of the base faces of the region
+    ///
+    FaceRegion(TopologyRefiner const & refiner, PatchTable const * patchTable,
+               int numFaces, Index const * faces);
+
+    /// \brief Returns the number of levels of the refiner
+    int GetNumLevels() const {
+        return (int)_levels.size();
+    }
+
+    /// \brief Returns the faces of the region at a given level (sorted)
+    ConstIndexArray GetFaces(int level) const {
+        return getArray(_levels[level].faces);
+    }
+
+    /// \brief Returns the vertices supporting the region at a given level
+    ///        (sorted) : the vertices of its faces, the control vertices of
+    ///        its patches and the vertices supporting their local points
+    ConstIndexArray GetVertices(int level) const {
+        return getArray(_levels[level].vertices);
+    }
+
+    /// \brief Returns the local points of the region (sorted, relative to the
+    ///        first local point of the patch table)
+    ConstIndexArray GetLocalPoints() const {
+        return getArray(_localPoints);
+    }
+
+    /// \brief Returns the patches of the region
+    std::vector<PatchTable::PatchHandle> const & GetPatches() const {
+        return _patches;
+    }
+
+    /// \brief Gathers the stencils of a table evaluating the vertices and the
+    ///        local points of the region
+    ///
+    /// The layout of the table is deduced from its number of stencils :
+    /// with or without stencils for the control vertices, for the vertices
+    /// of every level or of the last level only (uniform refinement), with
+    /// or without the stencils of the local points appended. The stencils
+    /// that the vertices of the region depend on are included for
+    /// level-to-level tables : the stencils of each pass (see
+    /// StencilTableReal::GetLevelOffsets()) are then evaluated one pass after
+    /// the other, as with the whole table.
+    ///
+    /// @param table     StencilTable of the refiner of the region
+    ///
+    /// @param stencils  Returns the indices of the stencils, sorted and unique
+    ///                  (ex. for CpuEvaluator::EvalStencils())
+    ///
+    /// @return          False if the layout of the table was not recognized
+    ///
+    template <typename REAL>
+    bool GetStencils(StencilTableReal<REAL> const & table,
+                     std::vector<Index> & stencils) const {
+        return getStencils(table.GetSizes(), table.GetOffsets(),
+                           table.GetControlIndices(), table.GetLevelOffsets(),
+                           table.GetLevelSourceOffsets(), stencils);
+    }
+
+private:
+
+    static ConstIndexArray getArray(std::vector<Index> const & v) {
+        return ConstIndexArray(v.empty() ? 0 : &v[0], (int)v.size());
+    }
+
+    bool getStencils(std::vector<int> const & sizes,
+                     std::vector<Index> const & offsets,
+                     std::vector<Index> const & indices,
+                     std::vector<Index> const & levelOffsets,
+                     std::vector<Index> const & levelSourceOffsets,
+                     std::vector<Index> & stencils) const;
+
+private:
+
+    struct Level {
+        std::vector<Index> faces,
+                           vertices;
+    };
+
+    std::vector<Level> _levels;
+
+    std::vector<int> _numLevelVertices;  // vertices of each level of the refiner
+
+    int _numLocalPoints;
+
+    std::vector<Index> _localPoints;
+
+    std::vector<PatchTable::PatchHandle> _patches;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_FACEREGION_H */
@@ -28,6 +28,7 @@
 #include "../far/topologyRefiner.h"
 #include "../vtr/stackBuffer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstring>
@@ -58,6 +59,31 @@ inline float computeCoefficient(int valence) {
                               sqrtf((cosf(t) + 9) * (cosf(t) + 1)))/16.0f);
 }
 
+//
+//  Basis retained by the ProtoBasisCache -- its points refer to the positions of
+//  the points of the neighborhood rather than to their indices:
+//
+struct GregoryBasis::ProtoBasisCache::Basis {
+
+    Basis(ProtoBasis const & basis) {
+        for (int corner = 0; corner < 4; ++corner) {
+            P[corner]  = basis.P[corner];
+            Ep[corner] = basis.Ep[corner];
+            Em[corner] = basis.Em[corner];
+            Fp[corner] = basis.Fp[corner];
+            Fm[corner] = basis.Fm[corner];
+        }
+    }
+
+    Point P[4], Ep[4], Em[4], Fp[4], Fm[4];
+};
+
+GregoryBasis::ProtoBasisCache::~ProtoBasisCache() {
+    for (BasisMap::iterator it = _bases.begin(); it != _bases.end(); ++it) {
+        delete it->second;
+    }
+}
+
 //
 //  There is a long and unclear history to the details of the patch conversion here...
 //
@@ -78,7 +104,7 @@ inline float computeCoefficient(int valence) {
 GregoryBasis::ProtoBasis::ProtoBasis(
     Vtr::internal::Level const & level, Index faceIndex,
     Vtr::internal::Level::VSpan const cornerSpans[],
-    int levelVertOffset, int fvarChannel) {
+    int levelVertOffset, int fvarChannel, ProtoBasisCache * cache) {
 
     //
     //  The first stage -- gather topology information for the entire patch:
@@ -98,12 +124,152 @@ GregoryBasis::ProtoBasis::ProtoBasis(
     //  A discontinuous edge in the fvar topology can increase the valence by one.
     int maxvalence = level.getMaxValence() + int(fvarChannel>=0);
 
-    Vtr::internal::StackBuffer<Index, 40> manifoldRings[4];
+    Ring manifoldRings[4];
     manifoldRings[0].SetSize(maxvalence*2);
     manifoldRings[1].SetSize(maxvalence*2);
     manifoldRings[2].SetSize(maxvalence*2);
     manifoldRings[3].SetSize(maxvalence*2);
 
+    int  ringSizes[4];
+    bool sharpCorners[4];
+
+    for (int corner = 0; corner < 4; ++corner) {
+
+        // save for varying stencils
+        varyingIndex[corner] = faceVerts[corner] + levelVertOffset;
+
+        //  Gather the (partial) one-ring around the corner vertex:
+        if (!cornerSpans[corner].isAssigned()) {
+            ringSizes[corner] = level.gatherQuadRegularRingAroundVertex( faceVerts[corner],
+                    manifoldRings[corner], fvarChannel);
+        } else {
+            ringSizes[corner] = level.gatherQuadRegularPartialRingAroundVertex( faceVerts[corner],
+                    cornerSpans[corner],
+                    manifoldRings[corner], fvarChannel);
+        }
+        sharpCorners[corner] = cornerSpans[corner]._sharp;
+    }
+
+    //
+    //  The remaining stages compute the points from the rings gathered -- directly or
+    //  via the cache, which identifies the neighborhood by its local topology: the sizes
+    //  of the rings, the sharp corners and, for each point of the face and rings, the
+    //  position of its first occurrence.  As the points are computed only by comparing
+    //  indices, computing them from these positions and remapping them to the indices
+    //  gives results identical to computing them directly:
+    //
+    if (cache == 0) {
+        computePoints(&facePoints[0], manifoldRings, ringSizes, sharpCorners, maxvalence);
+    } else {
+        int numPoints = 4 + ringSizes[0] + ringSizes[1] + ringSizes[2] + ringSizes[3];
+
+        Vtr::internal::StackBuffer<Index, 200> points(numPoints);
+        Vtr::internal::StackBuffer<std::pair<Index,int>, 200> sortedPoints(numPoints);
+
+        for (int i = 0; i < 4; ++i) {
+            points[i] = facePoints[i];
+        }
+        for (int corner = 0, pointIndex = 4; corner < 4; ++corner) {
+            for (int i = 0; i < ringSizes[corner]; ++i, ++pointIndex) {
+                points[pointIndex] = manifoldRings[corner][i];
+            }
+        }
+        for (int i = 0; i < numPoints; ++i) {
+            sortedPoints[i] = std::make_pair(points[i], i);
+        }
+        std::sort(&sortedPoints[0], &sortedPoints[0] + numPoints);
+
+        std::vector<int> key(5 + numPoints);
+        key[0] = ringSizes[0];
+        key[1] = ringSizes[1];
+        key[2] = ringSizes[2];
+        key[3] = ringSizes[3];
+        key[4] = sharpCorners[0] | (sharpCorners[1] << 1) |
+                (sharpCorners[2] << 2) | (sharpCorners[3] << 3);
+        for (int i = 0, first = 0; i < numPoints; ++i) {
+            if ((i == 0) || (sortedPoints[i].first != sortedPoints[i-1].first)) {
+                first = sortedPoints[i].second;
+            }
+            key[5 + sortedPoints[i].second] = first;
+        }
+
+        ProtoBasisCache::Basis const * basis = 0;
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp critical (GregoryBasisProtoBasisCache)
+#endif
+        {
+            ProtoBasisCache::BasisMap::const_iterator it = cache->_bases.find(key);
+            if (it != cache->_bases.end()) {
+                basis = it->second;
+            }
+        }
+
+        if (basis) {
+            for (int corner = 0; corner < 4; ++corner) {
+                P[corner]  = basis->P[corner];
+                Ep[corner] = basis->Ep[corner];
+                Em[corner] = basis->Em[corner];
+                Fp[corner] = basis->Fp[corner];
+                Fm[corner] = basis->Fm[corner];
+            }
+        } else {
+            Index localFacePoints[4] = { key[5], key[6], key[7], key[8] };
+
+            Ring localRings[4];
+            for (int corner = 0, ringStart = 4; corner < 4; ++corner) {
+                localRings[corner].SetSize(maxvalence*2);
+                for (int i = 0; i < ringSizes[corner]; ++i) {
+                    localRings[corner][i] = key[5 + ringStart + i];
+                }
+                ringStart += ringSizes[corner];
+            }
+            computePoints(localFacePoints, localRings, ringSizes, sharpCorners, maxvalence);
+
+            ProtoBasisCache::Basis * newBasis = new ProtoBasisCache::Basis(*this);
+#ifdef OPENSUBDIV_HAS_OPENMP
+            #pragma omp critical (GregoryBasisProtoBasisCache)
+#endif
+            {
+                if (! cache->_bases.insert(std::make_pair(key, newBasis)).second) {
+                    delete newBasis;
+                }
+            }
+        }
+
+        for (int corner = 0; corner < 4; ++corner) {
+            P[corner].RemapIndices(&points[0]);
+            Ep[corner].RemapIndices(&points[0]);
+            Em[corner].RemapIndices(&points[0]);
+            Fp[corner].RemapIndices(&points[0]);
+            Fm[corner].RemapIndices(&points[0]);
+        }
+    }
+
+    //
+    //  Offset stencil indices...
+    //
+    //  These stencils are currently created relative to the level and have levelVertOffset
+    //  to make them absolute indices.  But we will be localizing these to the patch itself
+    //  and so any association/mapping with vertices or face-varying values in a Level will
+    //  be handled externally.
+    //
+    for (int corner = 0; corner < 4; ++corner) {
+        P[corner].OffsetIndices(levelVertOffset);
+        Ep[corner].OffsetIndices(levelVertOffset);
+        Em[corner].OffsetIndices(levelVertOffset);
+        Fp[corner].OffsetIndices(levelVertOffset);
+        Fm[corner].OffsetIndices(levelVertOffset);
+    }
+}
+
+//
+//  Compute the points of the basis from the rings gathered around each corner:
+//
+void
+GregoryBasis::ProtoBasis::computePoints(
+    Index const facePoints[4], Ring manifoldRings[4],
+    int const ringSizes[4], bool const sharpCorners[4], int maxvalence) {
+
     bool  cornerBoundary[4];
     int   cornerValences[4];
     int   cornerNumFaces[4];
@@ -118,19 +284,7 @@ GregoryBasis::ProtoBasis::ProtoBasis(
 
     for (int corner = 0; corner < 4; ++corner) {
 
-        // save for varying stencils
-        varyingIndex[corner] = faceVerts[corner] + levelVertOffset;
-
-        //  Gather the (partial) one-ring around the corner vertex:
-        int ringSize = 0;
-        if (!cornerSpans[corner].isAssigned()) {
-            ringSize = level.gatherQuadRegularRingAroundVertex( faceVerts[corner],
-                    manifoldRings[corner], fvarChannel);
-        } else {
-            ringSize = level.gatherQuadRegularPartialRingAroundVertex( faceVerts[corner],
-                    cornerSpans[corner],
-                    manifoldRings[corner], fvarChannel);
-        }
+        int ringSize = ringSizes[corner];
         stencilCapacity += ringSize - 3;
 
         //  Cache topology information about the corner for ease of use later:
@@ -237,7 +391,7 @@ GregoryBasis::ProtoBasis::ProtoBasis(
         //  results as the Ep and Em can be computed more directly from the limit
         //  masks for the tangent vectors.
         //
-        if (cornerSpans[corner]._sharp) {
+        if (sharpCorners[corner]) {
             P[corner].Clear(stencilCapacity);
             P[corner].AddWithWeight(vCorner, 1.0f);
 
@@ -343,7 +497,7 @@ GregoryBasis::ProtoBasis::ProtoBasis(
         float faceAngleNext = faceAngle * float(iEdgeNext);
         float faceAnglePrev = faceAngle * float(iEdgePrev);
 
-        if (cornerSpans[corner]._sharp) {
+        if (sharpCorners[corner]) {
             Ep[corner] = e0[corner];
             Em[corner] = e1[corner];
         } else if (! cornerBoundary[corner]) {
@@ -454,22 +608,6 @@ GregoryBasis::ProtoBasis::ProtoBasis(
             Fm[corner] = Fp[corner];
         }
     }
-
-    //
-    //  Offset stencil indices...
-    //
-    //  These stencils are currently created relative to the level and have levelVertOffset
-    //  to make them absolute indices.  But we will be localizing these to the patch itself
-    //  and so any association/mapping with vertices or face-varying values in a Level will
-    //  be handled externally.
-    //
-    for (int corner = 0; corner < 4; ++corner) {
-        P[corner].OffsetIndices(levelVertOffset);
-        Ep[corner].OffsetIndices(levelVertOffset);
-        Em[corner].OffsetIndices(levelVertOffset);
-        Fp[corner].OffsetIndices(levelVertOffset);
-        Fm[corner].OffsetIndices(levelVertOffset);
-    }
 }
 
 } // end namespace Far
@@ -30,6 +30,8 @@
 #include "../far/types.h"
 #include "../far/stencilTable.h"
 #include <cstring>
+#include <map>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -125,6 +127,12 @@ public:
             }
         }
 
+        void RemapIndices(Vtr::Index const indexMap[]) {
+            for (int i=0; i<_size; ++i) {
+                _stencils[i].index = indexMap[_stencils[i].index];
+            }
+        }
+
         void Copy(int ** size, Vtr::Index ** indices, float ** weights) const {
             for (int i = 0; i < _size; ++i) {
                 **indices = _stencils[i].index;
@@ -154,19 +162,25 @@ public:
         Vtr::internal::StackBuffer<Stencil, RESERVED_STENCIL_SIZE> _stencils;
     };
 
+    class ProtoBasisCache;
+
     //
     // ProtoBasis
     //
     // Given a Vtr::Level and a face index, gathers all the influences of the
     // 1-ring that supports the 20 CVs of a Gregory patch basis.
     //
+    // When a cache is provided, the basis is copied from that of a previous
+    // face with an identical neighborhood when available.
+    //
     struct ProtoBasis {
 
         ProtoBasis(Vtr::internal::Level const & level,
                    Vtr::Index faceIndex,
                    Vtr::internal::Level::VSpan const cornerSpans[],
                    int levelVertOffset,
-                   int fvarChannel);
+                   int fvarChannel,
+                   ProtoBasisCache * cache = 0);
 
         // Control Vertices based on :
         // "Approximating Subdivision Surfaces with Gregory Patches for Hardware
@@ -197,6 +211,46 @@ public:
 
         // for varying interpolation
         Vtr::Index varyingIndex[4];
+
+    private:
+        typedef Vtr::internal::StackBuffer<Vtr::Index, 40> Ring;
+
+        void computePoints(Vtr::Index const facePoints[4], Ring manifoldRings[4],
+                           int const ringSizes[4], bool const sharpCorners[4],
+                           int maxvalence);
+    };
+
+    //
+    // ProtoBasisCache
+    //
+    // Retains the bases computed for faces in terms of the local topology of
+    // their neighborhood -- the valence, boundary and sharpness of each corner,
+    // and which points of the face and rings coincide.  Faces with identical
+    // neighborhoods share the same weights, so their bases only differ by the
+    // indices of the points, which are remapped.  The resulting bases are
+    // identical to those computed directly.  The cache may be shared between
+    // threads.
+    //
+    class ProtoBasisCache {
+    public:
+        ProtoBasisCache() { }
+        ~ProtoBasisCache();
+
+        /// \brief Returns the number of distinct bases retained
+        int GetNumBases() const { return (int)_bases.size(); }
+
+    private:
+        friend struct ProtoBasis;
+
+        struct Basis;
+        typedef std::map<std::vector<int>, Basis *> BasisMap;
+
+        BasisMap _bases;
+
+    private:
+        // Non-copyable
+        ProtoBasisCache(ProtoBasisCache const &) { }
+        ProtoBasisCache & operator=(ProtoBasisCache const &) { return *this; }
     };
 
     // for basis point stencil
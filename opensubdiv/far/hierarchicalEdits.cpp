@@ -0,0 +1,138 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/hierarchicalEdits.h"
+#include "../far/error.h"
+
+#include <algorithm>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+void
+HierarchicalEdits::Clear() {
+
+    _vertexEdits.clear();
+    _topologyEdits.clear();
+    _subfaces.clear();
+    _values.clear();
+}
+
+int
+HierarchicalEdits::GetMaxLevel() const {
+
+    int maxLevel = 0;
+    for (int i = 0; i < (int)_vertexEdits.size(); ++i) {
+        maxLevel = std::max(maxLevel, (int)_vertexEdits[i].level);
+    }
+    for (int i = 0; i < (int)_topologyEdits.size(); ++i) {
+        maxLevel = std::max(maxLevel, (int)_topologyEdits[i].level);
+    }
+    return maxLevel;
+}
+
+void
+HierarchicalEdits::addEdit(Type type, Index baseFace, int numSubfaces,
+    int const * subfaces, int component, Operation op,
+    float const * values, int width) {
+
+    Edit edit;
+    edit.type        = type;
+    edit.op          = op;
+    edit.level       = numSubfaces;
+    edit.baseFace    = baseFace;
+    edit.pathOffset  = (int)_subfaces.size();
+    edit.component   = component;
+    edit.valueOffset = (int)_values.size();
+    edit.width       = width;
+
+    _subfaces.insert(_subfaces.end(), subfaces, subfaces + numSubfaces);
+    _values.insert(_values.end(), values, values + width);
+
+    if (type == VERTEX_VALUE) {
+        _vertexEdits.push_back(edit);
+    } else {
+        _topologyEdits.push_back(edit);
+    }
+}
+
+int
+HierarchicalEdits::AddVertexEdit(Index baseFace, int numSubfaces,
+    int const * subfaces, LocalIndex vertex, Operation op,
+    float const * values, int width) {
+
+    if (baseFace < 0 || numSubfaces < 0 || width <= 0) {
+        Error(FAR_CODING_ERROR, "Failure in HierarchicalEdits::AddVertexEdit() "
+            "-- invalid path or width.");
+        return INDEX_INVALID;
+    }
+    addEdit(VERTEX_VALUE, baseFace, numSubfaces, subfaces, vertex, op,
+        values, width);
+    return GetNumVertexEdits() - 1;
+}
+
+void
+HierarchicalEdits::AddVertexSharpnessEdit(Index baseFace, int numSubfaces,
+    int const * subfaces, LocalIndex vertex, Operation op, float sharpness) {
+
+    if (baseFace < 0 || numSubfaces < 0) {
+        Error(FAR_CODING_ERROR, "Failure in HierarchicalEdits::"
+            "AddVertexSharpnessEdit() -- invalid path.");
+        return;
+    }
+    addEdit(VERTEX_SHARPNESS, baseFace, numSubfaces, subfaces, vertex, op,
+        &sharpness, 1);
+}
+
+void
+HierarchicalEdits::AddEdgeSharpnessEdit(Index baseFace, int numSubfaces,
+    int const * subfaces, LocalIndex edge, Operation op, float sharpness) {
+
+    if (baseFace < 0 || numSubfaces < 0) {
+        Error(FAR_CODING_ERROR, "Failure in HierarchicalEdits::"
+            "AddEdgeSharpnessEdit() -- invalid path.");
+        return;
+    }
+    addEdit(EDGE_SHARPNESS, baseFace, numSubfaces, subfaces, edge, op,
+        &sharpness, 1);
+}
+
+void
+HierarchicalEdits::AddHoleEdit(Index baseFace, int numSubfaces,
+    int const * subfaces) {
+
+    if (baseFace < 0 || numSubfaces < 0) {
+        Error(FAR_CODING_ERROR, "Failure in HierarchicalEdits::AddHoleEdit() "
+            "-- invalid path.");
+        return;
+    }
+    addEdit(FACE_HOLE, baseFace, numSubfaces, subfaces, 0, SET, 0, 0);
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,197 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_HIERARCHICAL_EDITS_H
+#define OPENSUBDIV3_FAR_HIERARCHICAL_EDITS_H
+
+#include "../version.h"
+
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief A set of hierarchical edits applied to a TopologyRefiner
+///
+/// Hierarchical edits modify the value of vertices, the sharpness of vertices
+/// and edges, or tag faces as holes, at a given level of refinement.  The
+/// component edited is identified by a path: a base face, followed by the
+/// index of a child face at each level of refinement (child faces are indexed
+/// by the corner of their parent), and for vertices and edges, by its local
+/// index in the last face of the path.  The number of child faces in the path
+/// is the level of the edit.
+///
+/// Sharpness and hole edits change the topology and are applied by the
+/// TopologyRefiner as it refines each level.  Vertex edits are applied when
+/// interpolating primvar data: the edit values are treated as additional
+/// control vertices (the i-th vertex edit is the control vertex following the
+/// base vertices and the i-1 previous edits), so that the stencils of the
+/// edited vertices (and of all the vertices subsequently refined from them)
+/// simply reference the edit values with a weight of 1 (or -1 when
+/// subtracted).
+///
+/// \note Vertex edits only apply to vertex interpolation (not to varying or
+///       face-varying data).
+///
+class HierarchicalEdits {
+
+public:
+
+    enum Operation {
+        SET = 0,   ///< replace the current value
+        ADD,       ///< add to the current value
+        SUBTRACT   ///< subtract from the current value
+    };
+
+    HierarchicalEdits() { }
+
+    /// \brief Returns true if no edits have been added
+    bool IsEmpty() const {
+        return _vertexEdits.empty() && _topologyEdits.empty();
+    }
+
+    /// \brief Removes all the edits
+    void Clear();
+
+    /// \brief Returns the deepest level of refinement of the edits
+    int GetMaxLevel() const;
+
+    //@{
+    ///  @name Adding edits
+    ///
+    ///  @param baseFace     The base face of the path to the edited component
+    ///
+    ///  @param numSubfaces  The number of child faces in the path (i.e. the
+    ///                      level of refinement of the edit)
+    ///
+    ///  @param subfaces     The index of the child face at each level
+    ///
+
+    /// \brief Adds an edit of the value of a vertex and returns its index
+    ///
+    /// @param vertex  The vertex of the last face of the path
+    ///
+    /// @param op      The edit operation
+    ///
+    /// @param values  The 'width' values of the edit (ex. a position)
+    ///
+    /// @param width   The number of values of the edit
+    ///
+    int AddVertexEdit(Index baseFace, int numSubfaces, int const * subfaces,
+        LocalIndex vertex, Operation op, float const * values, int width);
+
+    /// \brief Adds an edit of the sharpness of a vertex
+    void AddVertexSharpnessEdit(Index baseFace, int numSubfaces,
+        int const * subfaces, LocalIndex vertex, Operation op, float sharpness);
+
+    /// \brief Adds an edit of the sharpness of an edge (the edge of the last
+    ///        face of the path starting at its 'edge' vertex)
+    void AddEdgeSharpnessEdit(Index baseFace, int numSubfaces,
+        int const * subfaces, LocalIndex edge, Operation op, float sharpness);
+
+    /// \brief Tags the last face of the path (and its child faces) as a hole
+    void AddHoleEdit(Index baseFace, int numSubfaces, int const * subfaces);
+    //@}
+
+    //@{
+    ///  @name Vertex edits
+    ///
+
+    /// \brief Returns the number of vertex edits
+    int GetNumVertexEdits() const { return (int)_vertexEdits.size(); }
+
+    /// \brief Returns the level of refinement of the vertex edit
+    int GetVertexEditLevel(int edit) const {
+        return _vertexEdits[edit].level;
+    }
+
+    /// \brief Returns the operation of the vertex edit
+    Operation GetVertexEditOperation(int edit) const {
+        return (Operation)_vertexEdits[edit].op;
+    }
+
+    /// \brief Returns the number of values of the vertex edit
+    int GetVertexEditWidth(int edit) const {
+        return _vertexEdits[edit].width;
+    }
+
+    /// \brief Returns the values of the vertex edit
+    float const * GetVertexEditValues(int edit) const {
+        return &_values[_vertexEdits[edit].valueOffset];
+    }
+    //@}
+
+protected:
+    friend class TopologyRefiner;
+
+    enum Type {
+        VERTEX_VALUE = 0,
+        VERTEX_SHARPNESS,
+        EDGE_SHARPNESS,
+        FACE_HOLE
+    };
+
+    struct Edit {
+        unsigned int type  : 2,
+                     op    : 2,
+                     level : 28;
+        Index baseFace;
+        int   pathOffset;   // offset of the subfaces in _subfaces
+        int   component;    // local index of the vertex or edge
+        int   valueOffset;  // offset of the values (or sharpness) in _values
+        int   width;
+    };
+
+    void addEdit(Type type, Index baseFace, int numSubfaces,
+        int const * subfaces, int component, Operation op,
+        float const * values, int width);
+
+    int const * getSubfaces(Edit const & edit) const {
+        return edit.level ? &_subfaces[edit.pathOffset] : 0;
+    }
+
+    float getSharpness(Edit const & edit) const {
+        return _values[edit.valueOffset];
+    }
+
+private:
+
+    std::vector<Edit>  _vertexEdits,    // vertex values, in order of addition
+                       _topologyEdits;  // sharpness and holes
+    std::vector<int>   _subfaces;
+    std::vector<float> _values;
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_HIERARCHICAL_EDITS_H */
@@ -0,0 +1,204 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/limitEvaluator.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    // Largest number of control points of the supported patches (Gregory
+    // basis)
+    int const MAX_PATCH_SIZE = 20;
+
+    inline bool isSupportedPatchType(PatchDescriptor::Type type) {
+        return type == PatchDescriptor::REGULAR ||
+               type == PatchDescriptor::GREGORY_BASIS ||
+               type == PatchDescriptor::QUADS;
+    }
+
+    inline void
+    combine(float const * controlPoints, int length, int stride,
+            ConstIndexArray const & cvs, float const * weights, float * dst) {
+
+        memset(dst, 0, length * sizeof(float));
+        for (int i = 0; i < cvs.size(); ++i) {
+            float const * src = controlPoints + cvs[i] * stride;
+            float w = weights[i];
+            for (int k = 0; k < length; ++k) {
+                dst[k] += w * src[k];
+            }
+        }
+    }
+}
+
+int
+LimitEvaluator::Evaluate(PatchTable const & patchTable,
+                         PatchMap const & patchMap,
+                         int numLocations,
+                         int const * ptexFaces,
+                         float const * s,
+                         float const * t,
+                         float const * controlPoints,
+                         int length,
+                         int stride,
+                         float * P,
+                         float * dPdu,
+                         float * dPdv,
+                         float * dPduu,
+                         float * dPduv,
+                         float * dPdvv,
+                         Options options) {
+
+    if (numLocations <= 0) {
+        return 0;
+    }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    bool useThreads = options.useThreads;
+#endif
+
+    //
+    //  Locate the patches (locations that do not map to a supported patch
+    //  are tagged with a NULL handle)
+    //
+    std::vector<PatchMap::Handle const *> handles(numLocations);
+
+    int const blockSize = 1024;
+    int numBlocks = (numLocations + blockSize - 1) / blockSize;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(static) if (useThreads)
+#endif
+    for (int b = 0; b < numBlocks; ++b) {
+        int start = b * blockSize,
+            end = std::min(start + blockSize, numLocations);
+
+        patchMap.FindPatches(end - start, ptexFaces + start, s + start,
+                             t + start, &handles[start]);
+
+        for (int i = start; i < end; ++i) {
+            PatchMap::Handle const * handle = handles[i];
+            if (handle && ! isSupportedPatchType(
+                    patchTable.GetPatchArrayDescriptor(handle->arrayIndex).GetType())) {
+                handles[i] = 0;
+            }
+        }
+    }
+
+    //
+    //  Order the locations (by patch if requested : counting sort), the
+    //  locations that are not evaluated are set to 0 and dropped
+    //
+    std::vector<int> order;
+    int numFound = 0;
+
+    if (options.sortLocations) {
+        int numPatches = patchTable.GetNumPatchesTotal();
+
+        std::vector<int> offsets(numPatches + 1, 0);
+        for (int i = 0; i < numLocations; ++i) {
+            if (handles[i]) {
+                ++offsets[handles[i]->patchIndex + 1];
+            }
+        }
+        for (int p = 0; p < numPatches; ++p) {
+            offsets[p + 1] += offsets[p];
+        }
+        numFound = offsets[numPatches];
+
+        order.resize(numFound);
+        for (int i = 0; i < numLocations; ++i) {
+            if (handles[i]) {
+                order[offsets[handles[i]->patchIndex]++] = i;
+            }
+        }
+    } else {
+        order.reserve(numLocations);
+        for (int i = 0; i < numLocations; ++i) {
+            if (handles[i]) {
+                order.push_back(i);
+            }
+        }
+        numFound = (int)order.size();
+    }
+
+    if (numFound < numLocations) {
+        float * dsts[6] = { P, dPdu, dPdv, dPduu, dPduv, dPdvv };
+        for (int i = 0; i < numLocations; ++i) {
+            if (handles[i]) continue;
+            for (int d = 0; d < 6; ++d) {
+                if (dsts[d]) {
+                    memset(dsts[d] + i * length, 0, length * sizeof(float));
+                }
+            }
+        }
+    }
+
+    //
+    //  Evaluate : the 2nd derivatives require the weights of the 1st ones
+    //
+    bool evalDeriv2 = dPduu || dPduv || dPdvv,
+         evalDeriv1 = dPdu || dPdv || evalDeriv2;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for schedule(static, 64) if (useThreads)
+#endif
+    for (int k = 0; k < numFound; ++k) {
+
+        int i = order[k];
+        PatchMap::Handle const & handle = *handles[i];
+
+        float wP[MAX_PATCH_SIZE], wDu[MAX_PATCH_SIZE], wDv[MAX_PATCH_SIZE],
+              wDuu[MAX_PATCH_SIZE], wDuv[MAX_PATCH_SIZE], wDvv[MAX_PATCH_SIZE];
+
+        patchTable.EvaluateBasis(handle, s[i], t[i], wP,
+            evalDeriv1 ? wDu : 0, evalDeriv1 ? wDv : 0,
+            evalDeriv2 ? wDuu : 0, evalDeriv2 ? wDuv : 0,
+            evalDeriv2 ? wDvv : 0);
+
+        ConstIndexArray cvs = patchTable.GetPatchVertices(handle);
+
+        int offset = i * length;
+        combine(controlPoints, length, stride, cvs, wP, P + offset);
+        if (dPdu) combine(controlPoints, length, stride, cvs, wDu, dPdu + offset);
+        if (dPdv) combine(controlPoints, length, stride, cvs, wDv, dPdv + offset);
+        if (dPduu) combine(controlPoints, length, stride, cvs, wDuu, dPduu + offset);
+        if (dPduv) combine(controlPoints, length, stride, cvs, wDuv, dPduv + offset);
+        if (dPdvv) combine(controlPoints, length, stride, cvs, wDvv, dPdvv + offset);
+    }
+    return numFound;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,135 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_LIMIT_EVALUATOR_H
+#define OPENSUBDIV3_FAR_LIMIT_EVALUATOR_H
+
+#include "../version.h"
+
+#include "../far/patchMap.h"
+#include "../far/patchTable.h"
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Batched evaluation of limit surface locations
+///
+/// Evaluates arrays of (ptex face, s, t) locations on the patches of a
+/// PatchTable, along with their 1st and 2nd derivatives, optionally spread
+/// over threads.
+///
+/// The locations can also be evaluated in the order of the patches they fall
+/// in, so that the control points of each patch are fetched together. This
+/// only pays off when the locations are incoherent and the control points do
+/// not fit in the caches, since the results are then written out of order.
+///
+/// Primvar data are arrays of floats : the control point buffer holds the
+/// primvar of each vertex referenced by the patches (refined vertices and
+/// local points), and results are written densely (\p length floats per
+/// location).
+///
+class LimitEvaluator {
+
+public:
+
+    struct Options {
+
+        Options() : useThreads(false),
+                    sortLocations(false) { }
+
+        unsigned int useThreads    : 1, ///< evaluate the locations concurrently
+                     sortLocations : 1; ///< evaluate the locations in the order
+                                        ///  of the patches
+    };
+
+    /// \brief Evaluates limit surface locations
+    ///
+    /// @param patchTable    The PatchTable of the surface
+    ///
+    /// @param patchMap      A PatchMap of the same PatchTable
+    ///
+    /// @param numLocations  Number of locations to evaluate
+    ///
+    /// @param ptexFaces     Ptex face index of each location
+    ///
+    /// @param s             Ptex face u coordinate of each location
+    ///
+    /// @param t             Ptex face v coordinate of each location
+    ///
+    /// @param controlPoints Primvar data of the control points (the first
+    ///                      element of control point i is at
+    ///                      controlPoints[i*stride])
+    ///
+    /// @param length        Number of elements of the primvar
+    ///
+    /// @param stride        Stride of the control point buffer
+    ///
+    /// @param P             Destination of the limit values
+    ///                      (numLocations*length floats)
+    ///
+    /// @param dPdu          Destination of the 'u' derivatives (optional)
+    ///
+    /// @param dPdv          Destination of the 'v' derivatives (optional)
+    ///
+    /// @param dPduu         Destination of the 'uu' derivatives (optional)
+    ///
+    /// @param dPduv         Destination of the 'uv' derivatives (optional)
+    ///
+    /// @param dPdvv         Destination of the 'vv' derivatives (optional)
+    ///
+    /// @param options       Options controlling the evaluation
+    ///
+    /// @return              The number of locations evaluated : locations
+    ///                      that do not map to a patch (ex. holes) or that
+    ///                      map to unsupported patch types are set to 0.
+    ///
+    static int Evaluate(PatchTable const & patchTable,
+                        PatchMap const & patchMap,
+                        int numLocations,
+                        int const * ptexFaces,
+                        float const * s,
+                        float const * t,
+                        float const * controlPoints,
+                        int length,
+                        int stride,
+                        float * P,
+                        float * dPdu = 0,
+                        float * dPdv = 0,
+                        float * dPduu = 0,
+                        float * dPduv = 0,
+                        float * dPdvv = 0,
+                        Options options = Options());
+};
+
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_LIMIT_EVALUATOR_H */
@@ -0,0 +1,943 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/patchBVH.h"
+#include "../far/patchBasis.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+namespace {
+
+    // nodes holding more than LEAF_SIZE patches are split
+    const int LEAF_SIZE = 4;
+
+    // patches are sampled (tessellated for rays) on a grid of SAMPLE_RATE
+    // segments per side to seed the Newton iterations
+    const int SAMPLE_RATE = 2,
+              MAX_ITERATIONS = 8,
+              MAX_HALVINGS = 8;
+
+    const int MAX_PATCH_VERTICES = 20;
+
+    // initial capacity of the traversal queues
+    const int QUEUE_CAPACITY = 128;
+
+    bool
+    isSupported(PatchDescriptor::Type type) {
+        return type == PatchDescriptor::REGULAR ||
+               type == PatchDescriptor::GREGORY_BASIS ||
+               type == PatchDescriptor::LOOP ||
+               type == PatchDescriptor::QUADS ||
+               type == PatchDescriptor::TRIANGLES;
+    }
+
+    bool
+    isTriangular(PatchDescriptor::Type type) {
+        return type == PatchDescriptor::LOOP ||
+               type == PatchDescriptor::TRIANGLES;
+    }
+
+    inline float
+    dot(float const a[3], float const b[3]) {
+        return a[0]*b[0] + a[1]*b[1] + a[2]*b[2];
+    }
+
+    //
+    //  Position and derivatives of a patch at (s,t) : the derivatives are
+    //  only computed when requested
+    //
+    struct PatchPoint {
+        float P[3],
+              Ps[3], Pt[3],
+              Pss[3], Pst[3], Ptt[3];
+    };
+
+    void
+    evaluate(PatchTable const & patchTable, PatchTable::PatchHandle const & handle,
+             float s, float t, float const * controlPoints, int stride,
+             int derivatives, PatchPoint & p) {
+
+        float w[6][MAX_PATCH_VERTICES];
+
+        patchTable.EvaluateBasis(handle, s, t, w[0],
+            derivatives > 0 ? w[1] : 0, derivatives > 0 ? w[2] : 0,
+            derivatives > 1 ? w[3] : 0, derivatives > 1 ? w[4] : 0,
+            derivatives > 1 ? w[5] : 0);
+
+        float * dst[6] = { p.P, p.Ps, p.Pt, p.Pss, p.Pst, p.Ptt };
+
+        int nweights = derivatives > 1 ? 6 : (derivatives > 0 ? 3 : 1);
+
+        ConstIndexArray cvs = patchTable.GetPatchVertices(handle);
+
+        for (int i = 0; i < nweights; ++i) {
+            dst[i][0] = dst[i][1] = dst[i][2] = 0.0f;
+            for (int j = 0; j < cvs.size(); ++j) {
+                if (w[i][j] != 0.0f) {
+                    float const * cv = controlPoints + cvs[j] * stride;
+                    dst[i][0] += w[i][j] * cv[0];
+                    dst[i][1] += w[i][j] * cv[1];
+                    dst[i][2] += w[i][j] * cv[2];
+                }
+            }
+        }
+    }
+
+    //
+    //  Maps (u,v) from the normalized parametric domain of a patch to its
+    //  ptex face and back, clamping them to the domain
+    //
+    void
+    toPtex(PatchParam const & param, bool triangular, float u, float v,
+           float & s, float & t) {
+        s = u;
+        t = v;
+        if (triangular) {
+            param.UnnormalizeTriangle(s, t);
+        } else {
+            param.Unnormalize(s, t);
+        }
+    }
+
+    void
+    clampToPatch(PatchParam const & param, bool triangular, float & s, float & t) {
+
+        float u = s, v = t;
+        if (triangular) {
+            param.NormalizeTriangle(u, v);
+            u = std::max(u, 0.0f);
+            v = std::max(v, 0.0f);
+            if (u + v > 1.0f) {
+                float excess = 0.5f * (u + v - 1.0f);
+                u = std::max(u - excess, 0.0f);
+                v = std::max(v - excess, 0.0f);
+            }
+        } else {
+            param.Normalize(u, v);
+            u = std::min(std::max(u, 0.0f), 1.0f);
+            v = std::min(std::max(v, 0.0f), 1.0f);
+        }
+        toPtex(param, triangular, u, v, s, t);
+    }
+
+    //
+    //  Solves the 2x2 system [a b ; c d] x = -(r0, r1)
+    //
+    bool
+    solve(float a, float b, float c, float d, float r0, float r1,
+          float & x0, float & x1) {
+        float det = a*d - b*c;
+        if (std::fabs(det) <= FLT_MIN) {
+            return false;
+        }
+        x0 = -( d*r0 - b*r1) / det;
+        x1 = -(-c*r0 + a*r1) / det;
+        return true;
+    }
+
+    //
+    //  Squared distance from a point to a box, and interval of a ray within
+    //  a box
+    //
+    template <class BOX> float
+    distanceSquared(BOX const & box, float const point[3]) {
+        float d2 = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            float d = std::max(std::max(box.min[k] - point[k],
+                                        point[k] - box.max[k]), 0.0f);
+            d2 += d * d;
+        }
+        return d2;
+    }
+
+    template <class BOX> bool
+    intersectBox(BOX const & box, float const origin[3], float const invDir[3],
+                 float maxDistance, float & tnear) {
+        float tmin = 0.0f, tmax = maxDistance;
+        for (int k = 0; k < 3; ++k) {
+            float t0 = (box.min[k] - origin[k]) * invDir[k],
+                  t1 = (box.max[k] - origin[k]) * invDir[k];
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            // NaNs (origin on a slab of a flat box) leave the interval as is
+            if (t0 > tmin) tmin = t0;
+            if (t1 < tmax) tmax = t1;
+        }
+        tnear = tmin;
+        return tmin <= tmax;
+    }
+
+    //
+    //  Same for the oriented extents of the bounds of a patch
+    //
+    template <class BOUNDS> float
+    orientedDistanceSquared(BOUNDS const & bounds, float const point[3]) {
+        float d2 = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            float x = dot(bounds.axes[k], point),
+                  d = std::max(std::max(bounds.lower[k] - x,
+                                        x - bounds.upper[k]), 0.0f);
+            d2 += d * d;
+        }
+        return d2;
+    }
+
+    template <class BOUNDS> bool
+    intersectOriented(BOUNDS const & bounds, float const origin[3],
+                      float const direction[3], float maxDistance,
+                      float & tnear) {
+        float tmin = 0.0f, tmax = maxDistance;
+        for (int k = 0; k < 3; ++k) {
+            float o = dot(bounds.axes[k], origin),
+                  d = dot(bounds.axes[k], direction);
+            if (d == 0.0f) {
+                if (o < bounds.lower[k] || o > bounds.upper[k]) {
+                    return false;
+                }
+                continue;
+            }
+            float t0 = (bounds.lower[k] - o) / d,
+                  t1 = (bounds.upper[k] - o) / d;
+            if (t0 > t1) {
+                std::swap(t0, t1);
+            }
+            if (t0 > tmin) tmin = t0;
+            if (t1 < tmax) tmax = t1;
+        }
+        tnear = tmin;
+        return tmin <= tmax;
+    }
+
+    // node (or ~patch) to visit, ordered closest first in a heap
+    struct Candidate {
+        Candidate(float d, int i) : distance(d), index(i) { }
+
+        bool operator < (Candidate const & other) const {
+            return distance > other.distance;
+        }
+
+        float distance;
+        int   index;
+    };
+
+    template <class BOX> void
+    initBox(BOX & box) {
+        for (int k = 0; k < 3; ++k) {
+            box.min[k] =  FLT_MAX;
+            box.max[k] = -FLT_MAX;
+        }
+    }
+
+    template <class BOX> void
+    addPoint(BOX & box, float const point[3]) {
+        for (int k = 0; k < 3; ++k) {
+            box.min[k] = std::min(box.min[k], point[k]);
+            box.max[k] = std::max(box.max[k], point[k]);
+        }
+    }
+
+    template <class BOX0, class BOX1> void
+    addBox(BOX0 & box, BOX1 const & other) {
+        addPoint(box, other.min);
+        addPoint(box, other.max);
+    }
+
+    template <class BOX> float
+    boxExtent(BOX const & box) {
+        return std::max(std::max(box.max[0] - box.min[0],
+                                 box.max[1] - box.min[1]),
+                                 box.max[2] - box.min[2]);
+    }
+
+    // orders patches by the center of their bounds along an axis
+    template <class BOX> struct CenterLess {
+
+        CenterLess(std::vector<BOX> const & boxes, int axis) :
+            _boxes(boxes), _axis(axis) { }
+
+        bool operator () (int a, int b) const {
+            return (_boxes[a].min[_axis] + _boxes[a].max[_axis]) <
+                   (_boxes[b].min[_axis] + _boxes[b].max[_axis]);
+        }
+
+        std::vector<BOX> const & _boxes;
+        int _axis;
+    };
+} // end namespace
+
+PatchBVH::PatchBVH(PatchTable const & patchTable,
+                   float const * controlPoints, int stride) :
+    _patchTable(patchTable) {
+
+    // gather the patches that can be evaluated
+    std::vector<Handle> handles;
+    for (int parray = 0, current = 0;
+        parray < patchTable.GetNumPatchArrays(); ++parray) {
+
+        int npatches = patchTable.GetNumPatches(parray),
+            ncvs = patchTable.GetPatchArrayDescriptor(
+                parray).GetNumControlVertices();
+
+        if (isSupported(patchTable.GetPatchArrayDescriptor(parray).GetType())) {
+            for (int j = 0; j < npatches; ++j) {
+                Handle handle;
+                handle.arrayIndex = parray;
+                handle.patchIndex = current + j;
+                handle.vertIndex  = j * ncvs;
+                handles.push_back(handle);
+            }
+        }
+        current += npatches;
+    }
+
+    if (handles.empty()) {
+        return;
+    }
+
+    _handles = handles;
+
+    std::vector<Bounds> bounds(handles.size());
+    for (int i = 0; i < (int)handles.size(); ++i) {
+        computePatchBounds(i, controlPoints, stride, bounds[i]);
+    }
+
+    // split the patches recursively at the median of their centers
+    std::vector<int> order(handles.size());
+    for (int i = 0; i < (int)order.size(); ++i) {
+        order[i] = i;
+    }
+
+    _nodes.reserve(2 * handles.size() / LEAF_SIZE + 1);
+
+    build(order, bounds, 0, (int)order.size());
+
+    for (int i = 0; i < (int)order.size(); ++i) {
+        _handles[i] = handles[order[i]];
+    }
+
+    Refit(controlPoints, stride);
+}
+
+int
+PatchBVH::build(std::vector<int> & order, std::vector<Bounds> const & bounds,
+                int first, int last) {
+
+    int nodeIndex = (int)_nodes.size();
+    _nodes.push_back(Node());
+
+    if (last - first <= LEAF_SIZE) {
+        _nodes[nodeIndex].index = first;
+        _nodes[nodeIndex].count = last - first;
+        return nodeIndex;
+    }
+
+    // split along the largest extent of the centers
+    Box centers;
+    initBox(centers);
+    for (int i = first; i < last; ++i) {
+        Bounds const & box = bounds[order[i]];
+        float center[3] = { 0.5f * (box.min[0] + box.max[0]),
+                            0.5f * (box.min[1] + box.max[1]),
+                            0.5f * (box.min[2] + box.max[2]) };
+        addPoint(centers, center);
+    }
+    int axis = 0;
+    for (int k = 1; k < 3; ++k) {
+        if (centers.max[k] - centers.min[k] >
+            centers.max[axis] - centers.min[axis]) {
+            axis = k;
+        }
+    }
+
+    int middle = (first + last) / 2;
+    std::nth_element(order.begin() + first, order.begin() + middle,
+        order.begin() + last, CenterLess<Bounds>(bounds, axis));
+
+    build(order, bounds, first, middle);
+
+    int second = build(order, bounds, middle, last);
+
+    _nodes[nodeIndex].index = second;
+    _nodes[nodeIndex].count = 0;
+    return nodeIndex;
+}
+
+void
+PatchBVH::computePatchBounds(int patch, float const * controlPoints,
+                             int stride, Bounds & bounds) const {
+
+    Handle const & handle = _handles[patch];
+
+    PatchDescriptor::Type type =
+        _patchTable.GetPatchArrayDescriptor(handle.arrayIndex).GetType();
+    PatchParam param = _patchTable.GetPatchParam(handle);
+    ConstIndexArray cvs = _patchTable.GetPatchVertices(handle);
+
+    float hull[MAX_PATCH_VERTICES][3];
+
+    if (param.GetBoundary() &&
+        (type == PatchDescriptor::REGULAR || type == PatchDescriptor::LOOP)) {
+
+        // the weights of the phantom points of boundary patches are folded
+        // into the control vertices : bound the reconstructed hull instead
+        float w[MAX_PATCH_VERTICES];
+        for (int i = 0; i < cvs.size(); ++i) {
+            if (type == PatchDescriptor::REGULAR) {
+                internal::GetBSplineHullWeights(param, i, w);
+            } else {
+                internal::GetLoopHullWeights(param, i, w);
+            }
+            float * point = hull[i];
+            point[0] = point[1] = point[2] = 0.0f;
+            for (int j = 0; j < cvs.size(); ++j) {
+                if (w[j] != 0.0f) {
+                    float const * cv = controlPoints + cvs[j] * stride;
+                    point[0] += w[j] * cv[0];
+                    point[1] += w[j] * cv[1];
+                    point[2] += w[j] * cv[2];
+                }
+            }
+        }
+    } else {
+        for (int i = 0; i < cvs.size(); ++i) {
+            std::copy(controlPoints + cvs[i] * stride,
+                      controlPoints + cvs[i] * stride + 3, hull[i]);
+        }
+    }
+
+    initBox(bounds);
+    for (int i = 0; i < cvs.size(); ++i) {
+        addPoint(bounds, hull[i]);
+    }
+
+    // frame of the patch from the hull points at (or closest to) its
+    // corners (0,0), (1,0) and (0,1)
+    int corners[3] = { 0, 1, 2 };
+    switch (type) {
+        case PatchDescriptor::REGULAR       : corners[0] = 5; corners[1] = 6;
+                                              corners[2] = 9; break;
+        case PatchDescriptor::GREGORY_BASIS : corners[0] = 0; corners[1] = 5;
+                                              corners[2] = 15; break;
+        case PatchDescriptor::LOOP          : corners[0] = 4; corners[1] = 5;
+                                              corners[2] = 8; break;
+        case PatchDescriptor::QUADS         : corners[2] = 3; break;
+        default : break;
+    }
+
+    float const * P = hull[corners[0]];
+    float u[3] = { hull[corners[1]][0] - P[0],
+                   hull[corners[1]][1] - P[1],
+                   hull[corners[1]][2] - P[2] },
+          v[3] = { hull[corners[2]][0] - P[0],
+                   hull[corners[2]][1] - P[1],
+                   hull[corners[2]][2] - P[2] },
+          n[3] = { u[1]*v[2] - u[2]*v[1],
+                   u[2]*v[0] - u[0]*v[2],
+                   u[0]*v[1] - u[1]*v[0] };
+
+    float ul = std::sqrt(dot(u, u)),
+          nl = std::sqrt(dot(n, n));
+
+    float (*axes)[3] = bounds.axes;
+    if (nl > 0.0f && nl >= 1e-6f * ul * std::sqrt(dot(v, v))) {
+        for (int k = 0; k < 3; ++k) {
+            axes[0][k] = u[k] / ul;
+            axes[2][k] = n[k] / nl;
+        }
+        axes[1][0] = axes[2][1] * axes[0][2] - axes[2][2] * axes[0][1];
+        axes[1][1] = axes[2][2] * axes[0][0] - axes[2][0] * axes[0][2];
+        axes[1][2] = axes[2][0] * axes[0][1] - axes[2][1] * axes[0][0];
+    } else {
+        // degenerate patch : fall back to the axes of the box
+        for (int k = 0; k < 3; ++k) {
+            axes[k][0] = axes[k][1] = axes[k][2] = 0.0f;
+            axes[k][k] = 1.0f;
+        }
+    }
+
+    for (int k = 0; k < 3; ++k) {
+        bounds.lower[k] =  FLT_MAX;
+        bounds.upper[k] = -FLT_MAX;
+        for (int i = 0; i < cvs.size(); ++i) {
+            float x = dot(axes[k], hull[i]);
+            bounds.lower[k] = std::min(bounds.lower[k], x);
+            bounds.upper[k] = std::max(bounds.upper[k], x);
+        }
+    }
+}
+
+void
+PatchBVH::Refit(float const * controlPoints, int stride) {
+
+    if (_nodes.empty()) {
+        return;
+    }
+
+    _bounds.resize(_handles.size());
+    for (int i = 0; i < (int)_handles.size(); ++i) {
+        computePatchBounds(i, controlPoints, stride, _bounds[i]);
+    }
+
+    // children follow their parent : update the nodes bottom-up
+    for (int i = (int)_nodes.size() - 1; i >= 0; --i) {
+        Node & node = _nodes[i];
+        initBox(node);
+        if (node.count) {
+            for (int j = 0; j < node.count; ++j) {
+                addBox(node, _bounds[node.index + j]);
+            }
+        } else {
+            addBox(node, _nodes[i + 1]);
+            addBox(node, _nodes[node.index]);
+        }
+    }
+}
+
+bool
+PatchBVH::closestOnPatch(int patch, float const point[3],
+                         float const * controlPoints, int stride,
+                         Hit & hit) const {
+
+    Handle const & handle = _handles[patch];
+
+    bool triangular = isTriangular(
+        _patchTable.GetPatchArrayDescriptor(handle.arrayIndex).GetType());
+    PatchParam param = _patchTable.GetPatchParam(handle);
+
+    PatchPoint p;
+
+    // seed with the closest sample of the patch
+    float s = 0.0f, t = 0.0f, d2 = FLT_MAX, P[3] = { 0.0f, 0.0f, 0.0f };
+    for (int i = 0; i <= SAMPLE_RATE; ++i) {
+        for (int j = 0; j <= (triangular ? SAMPLE_RATE - i : SAMPLE_RATE); ++j) {
+            float si, ti;
+            toPtex(param, triangular, (float)j / SAMPLE_RATE,
+                (float)i / SAMPLE_RATE, si, ti);
+            evaluate(_patchTable, handle, si, ti, controlPoints, stride, 0, p);
+            float d[3] = { p.P[0] - point[0], p.P[1] - point[1], p.P[2] - point[2] };
+            if (dot(d, d) < d2) {
+                d2 = dot(d, d);
+                s = si;
+                t = ti;
+                std::copy(p.P, p.P + 3, P);
+            }
+        }
+    }
+
+    // minimize the squared distance with Newton iterations, falling back to
+    // Gauss-Newton steps where the Hessian is not positive definite. Steps
+    // are halved until they bring the patch closer (the bounds of the domain
+    // and distorted patches can defeat full steps).
+    float tolerance = 1e-6f / (float)(1 << param.GetDepth());
+
+    for (int iteration = 0; iteration < MAX_ITERATIONS; ++iteration) {
+
+        evaluate(_patchTable, handle, s, t, controlPoints, stride, 2, p);
+
+        float d[3] = { p.P[0] - point[0], p.P[1] - point[1], p.P[2] - point[2] };
+
+        float gs = dot(p.Ps, d),
+              gt = dot(p.Pt, d),
+              hss = dot(p.Ps, p.Ps),
+              hst = dot(p.Ps, p.Pt),
+              htt = dot(p.Pt, p.Pt),
+              Hss = hss + dot(p.Pss, d),
+              Hst = hst + dot(p.Pst, d),
+              Htt = htt + dot(p.Ptt, d),
+              ds = 0.0f, dt = 0.0f;
+
+        if (! (Hss > 0.0f && Hss * Htt - Hst * Hst > 0.0f &&
+                solve(Hss, Hst, Hst, Htt, gs, gt, ds, dt))) {
+            if (! solve(hss, hst, hst, htt, gs, gt, ds, dt)) {
+                break;
+            }
+        }
+
+        // steps are bounded by half the size of the patch
+        float maxStep = 0.5f * param.GetParamFraction(),
+              step = std::max(std::fabs(ds), std::fabs(dt));
+        if (step > maxStep) {
+            ds *= maxStep / step;
+            dt *= maxStep / step;
+        }
+
+        bool closer = false;
+        for (int halving = 0; halving < MAX_HALVINGS && ! closer; ++halving) {
+            float si = s + ds,
+                  ti = t + dt;
+            clampToPatch(param, triangular, si, ti);
+            if (std::fabs(si - s) + std::fabs(ti - t) < tolerance) {
+                break;
+            }
+
+            PatchPoint q;
+            evaluate(_patchTable, handle, si, ti, controlPoints, stride, 0, q);
+            float e[3] = { q.P[0] - point[0], q.P[1] - point[1], q.P[2] - point[2] };
+            if (dot(e, e) < d2) {
+                d2 = dot(e, e);
+                s = si;
+                t = ti;
+                std::copy(q.P, q.P + 3, P);
+                closer = true;
+            }
+            ds *= 0.5f;
+            dt *= 0.5f;
+        }
+        if (! closer) {
+            break;
+        }
+    }
+
+    hit.handle = handle;
+    hit.faceId = param.GetFaceId();
+    hit.s = s;
+    hit.t = t;
+    std::copy(P, P + 3, hit.P);
+    hit.distance = std::sqrt(d2);
+    return true;
+}
+
+bool
+PatchBVH::intersectPatch(int patch, float const origin[3],
+                         float const direction[3], float const planes[2][4],
+                         float const * controlPoints, int stride,
+                         float maxDistance, Hit & hit) const {
+
+    Handle const & handle = _handles[patch];
+
+    bool triangular = isTriangular(
+        _patchTable.GetPatchArrayDescriptor(handle.arrayIndex).GetType());
+    PatchParam param = _patchTable.GetPatchParam(handle);
+
+    PatchPoint p;
+
+    // tessellate the patch coarsely and seed with the first intersection of
+    // the ray with the tessellation (or with the closest sample to the ray)
+    int const R = SAMPLE_RATE;
+
+    float samples[R+1][R+1][5];  // position, s, t
+
+    float s = 0.0f, t = 0.0f, distance = FLT_MAX, f2 = FLT_MAX, cell2 = 0.0f;
+    for (int i = 0; i <= R; ++i) {
+        for (int j = 0; j <= (triangular ? R - i : R); ++j) {
+            float * sample = samples[i][j];
+            toPtex(param, triangular, (float)j / R, (float)i / R,
+                sample[3], sample[4]);
+            evaluate(_patchTable, handle, sample[3], sample[4],
+                controlPoints, stride, 0, p);
+            std::copy(p.P, p.P + 3, sample);
+
+            float f0 = dot(planes[0], sample) + planes[0][3],
+                  f1 = dot(planes[1], sample) + planes[1][3];
+            if (f0 * f0 + f1 * f1 < f2) {
+                f2 = f0 * f0 + f1 * f1;
+                s = sample[3];
+                t = sample[4];
+            }
+        }
+    }
+
+    for (int i = 0; i < R; ++i) {
+        for (int j = 0; j < (triangular ? R - i : R); ++j) {
+
+            // cells are split along their (i,j+1)-(i+1,j) diagonal, the
+            // last cell of a row of a triangular grid being a triangle
+            float const * triangles[2][3] = {
+                { samples[i][j],   samples[i][j+1],   samples[i+1][j] },
+                { samples[i][j+1], samples[i+1][j+1], samples[i+1][j] } };
+
+            int ntriangles = (triangular && j == R - i - 1) ? 1 : 2;
+
+            for (int k = 0; k < ntriangles; ++k) {
+                float const * v0 = triangles[k][0],
+                            * v1 = triangles[k][1],
+                            * v2 = triangles[k][2];
+                float e1[3] = { v1[0]-v0[0], v1[1]-v0[1], v1[2]-v0[2] },
+                      e2[3] = { v2[0]-v0[0], v2[1]-v0[1], v2[2]-v0[2] },
+                      e3[3] = { v2[0]-v1[0], v2[1]-v1[1], v2[2]-v1[2] },
+                      q[3] = { direction[1]*e2[2] - direction[2]*e2[1],
+                               direction[2]*e2[0] - direction[0]*e2[2],
+                               direction[0]*e2[1] - direction[1]*e2[0] };
+                cell2 = std::max(cell2, std::max(std::max(dot(e1, e1),
+                    dot(e2, e2)), dot(e3, e3)));
+                float det = dot(e1, q);
+                if (std::fabs(det) <= FLT_MIN) {
+                    continue;
+                }
+                float o[3] = { origin[0]-v0[0], origin[1]-v0[1], origin[2]-v0[2] },
+                      r[3] = { o[1]*e1[2] - o[2]*e1[1],
+                               o[2]*e1[0] - o[0]*e1[2],
+                               o[0]*e1[1] - o[1]*e1[0] };
+                float b1 = dot(o, q) / det,
+                      b2 = dot(direction, r) / det,
+                      tau = dot(e2, r) / det;
+                if (b1 >= 0.0f && b2 >= 0.0f && b1 + b2 <= 1.0f &&
+                    tau >= 0.0f && tau < distance) {
+                    distance = tau;
+                    s = v0[3] + b1 * (v1[3] - v0[3]) + b2 * (v2[3] - v0[3]);
+                    t = v0[4] + b1 * (v1[4] - v0[4]) + b2 * (v2[4] - v0[4]);
+                }
+            }
+        }
+    }
+
+    // a ray crossing the patch passes within the size of a cell from one of
+    // its samples, even when it misses the tessellation
+    if (distance == FLT_MAX && f2 > cell2) {
+        return false;
+    }
+
+    // solve for the intersection of the patch with the 2 planes crossing
+    // along the ray with Newton iterations
+    float tolerance = 1e-4f * boxExtent(_bounds[patch]);
+
+    bool converged = false;
+    for (int iteration = 0; iteration <= MAX_ITERATIONS; ++iteration) {
+
+        evaluate(_patchTable, handle, s, t, controlPoints, stride, 1, p);
+
+        float f0 = dot(planes[0], p.P) + planes[0][3],
+              f1 = dot(planes[1], p.P) + planes[1][3];
+
+        float scale = std::max(std::max(std::fabs(p.P[0]), std::fabs(p.P[1])),
+                               std::fabs(p.P[2]));
+        if (std::fabs(f0) + std::fabs(f1) <= tolerance + 1e-6f * scale) {
+            converged = true;
+            break;
+        }
+
+        float ds, dt;
+        if (iteration == MAX_ITERATIONS ||
+            ! solve(dot(planes[0], p.Ps), dot(planes[0], p.Pt),
+                    dot(planes[1], p.Ps), dot(planes[1], p.Pt), f0, f1, ds, dt)) {
+            break;
+        }
+        s += ds;
+        t += dt;
+        clampToPatch(param, triangular, s, t);
+    }
+
+    if (! converged) {
+        return false;
+    }
+
+    float d[3] = { p.P[0] - origin[0], p.P[1] - origin[1], p.P[2] - origin[2] };
+    float tau = dot(direction, d) / dot(direction, direction);
+    if (tau < 0.0f || tau >= maxDistance) {
+        return false;
+    }
+
+    hit.handle = handle;
+    hit.faceId = param.GetFaceId();
+    hit.s = s;
+    hit.t = t;
+    std::copy(p.P, p.P + 3, hit.P);
+    hit.distance = tau;
+    return true;
+}
+
+bool
+PatchBVH::FindClosestPoint(float const point[3],
+                           float const * controlPoints, int stride,
+                           Hit & hit, float maxDistance) const {
+
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    float best = maxDistance * maxDistance;
+    bool found = false;
+
+    // visit the nodes and patches in the order of the distance to their
+    // bounds : the closest patches tighten the best distance early and the
+    // others are culled by it
+    std::vector<Candidate> queue;
+    queue.reserve(QUEUE_CAPACITY);
+    queue.push_back(Candidate(distanceSquared(_nodes[0], point), 0));
+
+    while (! queue.empty() && queue.front().distance < best) {
+
+        std::pop_heap(queue.begin(), queue.end());
+        int index = queue.back().index;
+        queue.pop_back();
+
+        if (index < 0) {
+            Hit candidate;
+            if (closestOnPatch(~index, point, controlPoints, stride, candidate) &&
+                candidate.distance * candidate.distance < best) {
+                best = candidate.distance * candidate.distance;
+                hit = candidate;
+                found = true;
+            }
+            continue;
+        }
+
+        Node const & node = _nodes[index];
+        if (node.count) {
+            for (int i = node.index; i < node.index + node.count; ++i) {
+                float d2 = std::max(distanceSquared(_bounds[i], point),
+                    orientedDistanceSquared(_bounds[i], point));
+                if (d2 < best) {
+                    queue.push_back(Candidate(d2, ~i));
+                    std::push_heap(queue.begin(), queue.end());
+                }
+            }
+        } else {
+            int children[2] = { index + 1, node.index };
+            for (int i = 0; i < 2; ++i) {
+                float d2 = distanceSquared(_nodes[children[i]], point);
+                if (d2 < best) {
+                    queue.push_back(Candidate(d2, children[i]));
+                    std::push_heap(queue.begin(), queue.end());
+                }
+            }
+        }
+    }
+    return found;
+}
+
+bool
+PatchBVH::Intersect(float const origin[3], float const direction[3],
+                    float const * controlPoints, int stride,
+                    Hit & hit, float maxDistance) const {
+
+    if (_nodes.empty()) {
+        return false;
+    }
+
+    float length = std::sqrt(dot(direction, direction));
+    if (length == 0.0f) {
+        return false;
+    }
+
+    float invDir[3] = { 1.0f / direction[0],
+                        1.0f / direction[1],
+                        1.0f / direction[2] };
+
+    // the ray is the intersection of 2 orthogonal planes
+    float n[3] = { direction[0] / length,
+                   direction[1] / length,
+                   direction[2] / length };
+
+    float planes[2][4];
+    if (std::fabs(n[0]) > std::fabs(n[2])) {
+        float l = std::sqrt(n[0] * n[0] + n[1] * n[1]);
+        planes[0][0] = -n[1] / l;
+        planes[0][1] =  n[0] / l;
+        planes[0][2] =  0.0f;
+    } else {
+        float l = std::sqrt(n[1] * n[1] + n[2] * n[2]);
+        planes[0][0] =  0.0f;
+        planes[0][1] = -n[2] / l;
+        planes[0][2] =  n[1] / l;
+    }
+    planes[1][0] = n[1] * planes[0][2] - n[2] * planes[0][1];
+    planes[1][1] = n[2] * planes[0][0] - n[0] * planes[0][2];
+    planes[1][2] = n[0] * planes[0][1] - n[1] * planes[0][0];
+    planes[0][3] = -dot(planes[0], origin);
+    planes[1][3] = -dot(planes[1], origin);
+
+    float best = maxDistance;
+    bool found = false;
+
+    // visit the nodes and patches in the order of the entry of the ray in
+    // their bounds
+    std::vector<Candidate> queue;
+    queue.reserve(QUEUE_CAPACITY);
+
+    float tnear;
+    if (intersectBox(_nodes[0], origin, invDir, best, tnear)) {
+        queue.push_back(Candidate(tnear, 0));
+    }
+
+    while (! queue.empty() && queue.front().distance < best) {
+
+        std::pop_heap(queue.begin(), queue.end());
+        int index = queue.back().index;
+        queue.pop_back();
+
+        if (index < 0) {
+            Hit candidate;
+            if (intersectPatch(~index, origin, direction, planes,
+                    controlPoints, stride, best, candidate)) {
+                best = candidate.distance;
+                hit = candidate;
+                found = true;
+            }
+            continue;
+        }
+
+        Node const & node = _nodes[index];
+        if (node.count) {
+            for (int i = node.index; i < node.index + node.count; ++i) {
+                float tbox, toriented;
+                if (intersectBox(_bounds[i], origin, invDir, best, tbox) &&
+                    intersectOriented(_bounds[i], origin, direction, best,
+                        toriented)) {
+                    queue.push_back(Candidate(std::max(tbox, toriented), ~i));
+                    std::push_heap(queue.begin(), queue.end());
+                }
+            }
+        } else {
+            int children[2] = { index + 1, node.index };
+            for (int i = 0; i < 2; ++i) {
+                if (intersectBox(_nodes[children[i]], origin, invDir, best,
+                        tnear)) {
+                    queue.push_back(Candidate(tnear, children[i]));
+                    std::push_heap(queue.begin(), queue.end());
+                }
+            }
+        }
+    }
+    return found;
+}
+
+size_t
+PatchBVH::GetMemoryUsage(MemoryUsage * usage,
+                         std::string const & prefix) const {
+
+    MemoryUsage localUsage;
+    if (! usage) {
+        usage = &localUsage;
+    }
+    size_t total = usage->GetTotal();
+
+    usage->Add(prefix + "nodes",   _nodes);
+    usage->Add(prefix + "handles", _handles);
+    usage->Add(prefix + "bounds",  _bounds);
+
+    return usage->GetTotal() - total;
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
@@ -0,0 +1,212 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_PATCH_BVH_H
+#define OPENSUBDIV3_FAR_PATCH_BVH_H
+
+#include "../version.h"
+
+#include "../far/patchTable.h"
+
+#include <cfloat>
+#include <string>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+/// \brief A bounding volume hierarchy over the patches of a PatchTable
+///
+/// Answers closest point and ray queries against the limit surface of a
+/// mesh. The patches are bounded by the boxes of their control hulls (the
+/// control vertices and local points they refer to, with the phantom points
+/// of boundary patches), which contain the patches of the bases with positive
+/// weights supported by PatchTable::EvaluateBasis().
+///
+/// Queries visit the nodes and patches closest first (in the order of the
+/// distance to their bounds, or of the entry of the ray in them) until no
+/// bounds may hold a closer hit. Patches are sampled coarsely and the best
+/// sample is refined with Newton iterations on the basis functions of the
+/// patch, returning the ptex face location of the hit (to be evaluated with
+/// a PatchMap or a LimitEvaluator).
+///
+/// The hierarchy is built once from the control points : when they move
+/// (ex. animated meshes), Refit() updates the bounds of its nodes in linear
+/// time while keeping its topology. The quality of the hierarchy degrades as
+/// the surface drifts away from its initial shape, at which point building a
+/// new one is faster.
+///
+/// Positions are arrays of 3 floats : the control point buffer holds the
+/// position of each vertex referenced by the patches (refined vertices and
+/// local points), as with LimitEvaluator.
+///
+class PatchBVH {
+
+public:
+
+    typedef PatchTable::PatchHandle Handle;
+
+    /// \brief A location on the limit surface
+    struct Hit {
+        Handle handle;       ///< patch of the location
+        int    faceId;       ///< ptex face of the location
+        float  s, t;         ///< ptex face coordinates of the location
+        float  P[3];         ///< position of the location
+        float  distance;     ///< distance to the query point, or ray parameter
+    };
+
+    /// \brief Constructor
+    ///
+    /// @param patchTable     The PatchTable of the surface (must outlive the
+    ///                       hierarchy)
+    ///
+    /// @param controlPoints  Positions of the control points (the position of
+    ///                       control point i is at controlPoints[i*stride])
+    ///
+    /// @param stride         Stride of the control point buffer
+    ///
+    PatchBVH(PatchTable const & patchTable,
+             float const * controlPoints, int stride = 3);
+
+    /// \brief Updates the bounds of the hierarchy to moved control points
+    ///
+    /// @param controlPoints  Positions of the control points
+    ///
+    /// @param stride         Stride of the control point buffer
+    ///
+    void Refit(float const * controlPoints, int stride = 3);
+
+    /// \brief Finds the closest location of the limit surface to a point
+    ///
+    /// @param point          The query point
+    ///
+    /// @param controlPoints  Positions of the control points (as last given
+    ///                       to the constructor or to Refit())
+    ///
+    /// @param stride         Stride of the control point buffer
+    ///
+    /// @param hit            Returns the closest location
+    ///
+    /// @param maxDistance    Locations further than maxDistance are ignored
+    ///
+    /// @return               False if no location was found
+    ///
+    bool FindClosestPoint(float const point[3],
+                          float const * controlPoints, int stride,
+                          Hit & hit, float maxDistance = FLT_MAX) const;
+
+    /// \brief Finds the first intersection of a ray with the limit surface
+    ///
+    /// @param origin         Origin of the ray
+    ///
+    /// @param direction      Direction of the ray (hit distances are in units
+    ///                       of its length)
+    ///
+    /// @param controlPoints  Positions of the control points (as last given
+    ///                       to the constructor or to Refit())
+    ///
+    /// @param stride         Stride of the control point buffer
+    ///
+    /// @param hit            Returns the first intersection
+    ///
+    /// @param maxDistance    Intersections further than maxDistance along
+    ///                       the ray are ignored
+    ///
+    /// @return               False if the ray misses the surface
+    ///
+    bool Intersect(float const origin[3], float const direction[3],
+                   float const * controlPoints, int stride,
+                   Hit & hit, float maxDistance = FLT_MAX) const;
+
+    /// \brief Returns the number of nodes of the hierarchy
+    int GetNumNodes() const { return (int)_nodes.size(); }
+
+    /// \brief Returns the memory used by the hierarchy (in bytes)
+    ///
+    /// @param usage   Optional breakdown to which the vectors of the
+    ///                hierarchy are added
+    ///
+    /// @param prefix  Prefix of the names of the components in the breakdown
+    ///
+    size_t GetMemoryUsage(MemoryUsage * usage = 0,
+                          std::string const & prefix = std::string()) const;
+
+private:
+
+    // Nodes are stored depth first : the first child of an inner node
+    // follows it, 'index' is its second child. Leaves hold 'count' patches
+    // from 'index' in _handles.
+    struct Node {
+        float min[3],
+              max[3];
+        int   index,
+              count;    // 0 for inner nodes
+    };
+
+    struct Box {
+        float min[3],
+              max[3];
+    };
+
+    // Bounds of a patch : its box, and the extents of its hull along the axes
+    // of a frame of the patch (tangent and normal), which hug the slanted
+    // patches much more tightly than boxes
+    struct Bounds : public Box {
+        float axes[3][3],
+              lower[3],
+              upper[3];
+    };
+
+    int build(std::vector<int> & order, std::vector<Bounds> const & bounds,
+        int first, int last);
+
+    void computePatchBounds(int patch, float const * controlPoints,
+        int stride, Bounds & bounds) const;
+
+    bool closestOnPatch(int patch, float const point[3],
+        float const * controlPoints, int stride, Hit & hit) const;
+
+    bool intersectPatch(int patch, float const origin[3],
+        float const direction[3], float const planes[2][4],
+        float const * controlPoints, int stride, float maxDistance,
+        Hit & hit) const;
+
+private:
+
+    PatchTable const & _patchTable;
+
+    std::vector<Node>   _nodes;
+    std::vector<Handle> _handles;   // patches in the order of the leaves
+    std::vector<Bounds> _bounds;    // bounds of the patches
+};
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_PATCH_BVH_H */
@@ -49,7 +49,8 @@ public:
     static void GetWeights(float t, float point[], float deriv[], float deriv2[]);
 
     // box-spline weights
-    static void GetWeights(float v, float w, float point[]);
+    static void GetWeights(float s, float t, float point[], float derivS[], float derivT[],
+        float derivSS[], float derivST[], float derivTT[]);
 
     // patch weights
     static void GetPatchWeights(PatchParam const & param,
@@ -128,54 +129,79 @@ inline void Spline<BASIS_BSPLINE>::GetWeights(
 
 template <>
 inline void Spline<BASIS_BOX_SPLINE>::GetWeights(
-    float v, float w, float point[12]) {
-
-    float u = 1.0f - v - w;
+    float s, float t, float point[12], float derivS[12], float derivT[12],
+    float derivSS[12], float derivST[12], float derivTT[12]) {
 
     //
-    //  The 12 basis functions of the quartic box spline (unscaled by their common
-    //  factor of 1/12 until later, and formatted to make it easy to spot any
-    //  typing errors):
+    //  The 12 basis functions of the quartic box spline are polynomials in
+    //  (s,t) and are tabulated below by their coefficients for the 15 terms
+    //  of degree up to 4 (unscaled by their common factor of 1/12 until
+    //  later).  The control points are ordered as follows, with s increasing
+    //  from point 4 to point 5 and t from point 4 to point 8:
     //
-    //      15 terms for the 3 points above the triangle corners
-    //       9 terms for the 3 points on faces opposite the triangle edges
-    //       2 terms for the 6 points on faces opposite the triangle corners
+    //               10 ----- 11
+    //              /  \     /  \
+    //             /    \   /    \
+    //            7 ----- 8 ----- 9
+    //           / \     / \     / \
+    //          /   \   /   \   /   \
+    //         3 ---- 4 ----- 5 ---- 6
+    //          \   /   \   /   \   /
+    //           \ /     \ /     \ /
+    //            0 ----- 1 ----- 2
     //
-    //  Powers of each variable for notational convenience:
-    float u2 = u*u;
-    float u3 = u*u2;
-    float u4 = u*u3;
-    float v2 = v*v;
-    float v3 = v*v2;
-    float v4 = v*v3;
-    float w2 = w*w;
-    float w3 = w*w2;
-    float w4 = w*w3;
-
-    //  And now the basis functions:
-    point[ 0] = u4 + 2.0f*u3*v;
-    point[ 1] = u4 + 2.0f*u3*w;
-    point[ 8] = w4 + 2.0f*w3*u;
-    point[11] = w4 + 2.0f*w3*v;
-    point[ 9] = v4 + 2.0f*v3*w;
-    point[ 5] = v4 + 2.0f*v3*u;
-
-    point[ 2] = u4 + 2.0f*u3*w + 6.0f*u3*v + 6.0f*u2*v*w + 12.0f*u2*v2 +
-                v4 + 2.0f*v3*w + 6.0f*v3*u + 6.0f*v2*u*w;
-    point[ 4] = w4 + 2.0f*w3*v + 6.0f*w3*u + 6.0f*w2*u*v + 12.0f*w2*u2 +
-                u4 + 2.0f*u3*v + 6.0f*u3*w + 6.0f*u2*v*w;
-    point[10] = v4 + 2.0f*v3*u + 6.0f*v3*w + 6.0f*v2*w*u + 12.0f*v2*w2 +
-                w4 + 2.0f*w3*u + 6.0f*w3*v + 6.0f*w3*u*v;
-
-    point[ 3] = v4 + 6*v3*w + 8*v3*u + 36*v2*w*u + 24*v2*u2 + 24*v*u3 +
-                w4 + 6*w3*v + 8*w3*u + 36*w2*v*u + 24*w2*u2 + 24*w*u3 + 6*u4 + 60*u2*v*w + 12*v2*w2;
-    point[ 6] = w4 + 6*w3*u + 8*w3*v + 36*w2*u*v + 24*w2*v2 + 24*w*v3 +
-                u4 + 6*u3*w + 8*u3*v + 36*u2*v*w + 24*u2*v2 + 24*u*v3 + 6*v4 + 60*v2*w*u + 12*w2*u2;
-    point[ 7] = u4 + 6*u3*v + 8*u3*w + 36*u2*v*w + 24*u2*w2 + 24*u*w3 +
-                v4 + 6*v3*u + 8*v3*w + 36*v2*u*w + 24*v2*w2 + 24*v*w3 + 6*w4 + 60*w2*u*v + 12*u2*v2;
+    //  Powers of s and t for each of the 15 terms:
+    static int const sPower[15] = { 0, 1, 0, 2, 1, 0, 3, 2, 1, 0, 4, 3, 2, 1, 0 };
+    static int const tPower[15] = { 0, 0, 1, 0, 1, 2, 0, 1, 2, 3, 0, 1, 2, 3, 4 };
+
+    static float const coeffs[12][15] = {
+        { 1, -2, -4,   0,   6,   6, 2,   0,  -6, -4, -1, -2, 0, 2,  1 },
+        { 1,  2, -2,   0,  -6,   0,-4,   0,   6,  2,  2,  4, 0,-2, -1 },
+        { 0,  0,  0,   0,   0,   0, 2,   0,   0,  0, -1, -2, 0, 0,  0 },
+        { 1, -4, -2,   6,   6,   0,-4,  -6,   0,  2,  1,  2, 0,-2, -1 },
+        { 6,  0,  0, -12, -12, -12, 8,  12,  12,  8, -1, -2, 0,-2, -1 },
+        { 1,  4,  2,   6,   6,   0,-4,  -6, -12, -4, -1, -2, 0, 4,  2 },
+        { 0,  0,  0,   0,   0,   0, 0,   0,   0,  0,  1,  2, 0, 0,  0 },
+        { 1, -2,  2,   0,  -6,   0, 2,   6,   0, -4, -1, -2, 0, 4,  2 },
+        { 1,  2,  4,   0,   6,   6,-4, -12,  -6, -4,  2,  4, 0,-2, -1 },
+        { 0,  0,  0,   0,   0,   0, 2,   6,   6,  2, -1, -2, 0,-2, -1 },
+        { 0,  0,  0,   0,   0,   0, 0,   0,   0,  2,  0,  0, 0,-2, -1 },
+        { 0,  0,  0,   0,   0,   0, 0,   0,   0,  0,  0,  0, 0, 2,  1 }
+    };
+
+    //  Powers of each variable (padded with zeros for the derivatives):
+    float sPow[7] = { 0.0f, 0.0f, 1.0f, s, s*s, s*s*s, s*s*s*s };
+    float tPow[7] = { 0.0f, 0.0f, 1.0f, t, t*t, t*t*t, t*t*t*t };
+
+    float const * S = sPow + 2;
+    float const * T = tPow + 2;
 
     for (int i = 0; i < 12; ++i) {
-        point[i] *= 1.0f / 12.0f;
+        float const * c = coeffs[i];
+
+        float P = 0.0f, Ds = 0.0f, Dt = 0.0f, Dss = 0.0f, Dst = 0.0f, Dtt = 0.0f;
+        for (int j = 0; j < 15; ++j) {
+            if (c[j] == 0.0f) continue;
+
+            int a = sPower[j],
+                b = tPower[j];
+
+            P   += c[j] * S[a] * T[b];
+            Ds  += c[j] * (float)a * S[a-1] * T[b];
+            Dt  += c[j] * (float)b * S[a] * T[b-1];
+            Dss += c[j] * (float)(a*(a-1)) * S[a-2] * T[b];
+            Dst += c[j] * (float)(a*b) * S[a-1] * T[b-1];
+            Dtt += c[j] * (float)(b*(b-1)) * S[a] * T[b-2];
+        }
+
+        float const one12th = 1.0f / 12.0f;
+
+        if (point)   point[i]   = P   * one12th;
+        if (derivS)  derivS[i]  = Ds  * one12th;
+        if (derivT)  derivT[i]  = Dt  * one12th;
+        if (derivSS) derivSS[i] = Dss * one12th;
+        if (derivST) derivST[i] = Dst * one12th;
+        if (derivTT) derivTT[i] = Dtt * one12th;
     }
 }
 
@@ -325,6 +351,23 @@ void GetBSplineWeights(PatchParam const & param,
     Spline<BASIS_BSPLINE>::GetPatchWeights(param, s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
 }
 
+void GetBSplineHullWeights(PatchParam const & param, int point, float w[16]) {
+
+    float sWeights[4] = { 0.0f, 0.0f, 0.0f, 0.0f },
+          tWeights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+    sWeights[point % 4] = 1.0f;
+    tWeights[point / 4] = 1.0f;
+
+    Spline<BASIS_BSPLINE>::AdjustBoundaryWeights(param, sWeights, tWeights);
+
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            w[4*i+j] = sWeights[j] * tWeights[i];
+        }
+    }
+}
+
 void GetGregoryWeights(PatchParam const & param,
     float s, float t, float point[20], float deriv1[20], float deriv2[20], float deriv11[20], float deriv12[20], float deriv22[20]) {
     //
@@ -497,6 +540,171 @@ void GetGregoryWeights(PatchParam const & param,
     }
 }
 
+namespace {
+    //
+    //  Points of a Loop patch missing beyond its boundary are extrapolated
+    //  from those present -- each as a reflection through the midpoint of
+    //  a boundary edge, or as a linear extension where a boundary edge ends
+    //  at a corner.  Since these are linear combinations of other points,
+    //  the weights of the missing points are folded into those points:
+    //
+    inline void
+    foldLoopWeight(float w[12], int missing, int p0, float w0,
+                   int p1, float w1, int p2 = 0, float w2 = 0.0f) {
+        float wMissing = w[missing];
+        w[missing] = 0.0f;
+
+        w[p0] += w0 * wMissing;
+        w[p1] += w1 * wMissing;
+        w[p2] += w2 * wMissing;
+    }
+
+    void
+    adjustLoopBoundaryWeights(int boundary, float w[12]) {
+
+        if (boundary & 8) {
+            //  Boundary vertices of an interior triangle:
+            if (boundary & 1) {
+                foldLoopWeight(w, 0, 4, 1.0f, 1, 1.0f, 5, -1.0f);
+                foldLoopWeight(w, 3, 4, 1.0f, 7, 1.0f, 8, -1.0f);
+            }
+            if (boundary & 2) {
+                foldLoopWeight(w, 2, 5, 1.0f, 1, 1.0f, 4, -1.0f);
+                foldLoopWeight(w, 6, 5, 1.0f, 9, 1.0f, 8, -1.0f);
+            }
+            if (boundary & 4) {
+                foldLoopWeight(w, 10, 8, 1.0f, 7, 1.0f, 4, -1.0f);
+                foldLoopWeight(w, 11, 8, 1.0f, 9, 1.0f, 5, -1.0f);
+            }
+            return;
+        }
+
+        //  Boundary edges -- the points beyond each edge are folded into the
+        //  triangle or into points beyond the adjacent edges if not boundaries:
+        bool e0 = (boundary & 1) != 0,
+             e1 = (boundary & 2) != 0,
+             e2 = (boundary & 4) != 0;
+
+        if (e0) {
+            foldLoopWeight(w, 1, 4, 1.0f, 5, 1.0f, 8, -1.0f);
+            if (e2) foldLoopWeight(w, 0, 4, 2.0f, 8, -1.0f);
+            else    foldLoopWeight(w, 0, 3, 1.0f, 4, 1.0f, 7, -1.0f);
+            if (e1) foldLoopWeight(w, 2, 5, 2.0f, 8, -1.0f);
+            else    foldLoopWeight(w, 2, 5, 1.0f, 6, 1.0f, 9, -1.0f);
+        }
+        if (e1) {
+            foldLoopWeight(w, 9, 5, 1.0f, 8, 1.0f, 4, -1.0f);
+            if (e0) foldLoopWeight(w, 6, 5, 2.0f, 4, -1.0f);
+            else    foldLoopWeight(w, 6, 2, 1.0f, 5, 1.0f, 1, -1.0f);
+            if (e2) foldLoopWeight(w, 11, 8, 2.0f, 4, -1.0f);
+            else    foldLoopWeight(w, 11, 8, 1.0f, 10, 1.0f, 7, -1.0f);
+        }
+        if (e2) {
+            foldLoopWeight(w, 7, 8, 1.0f, 4, 1.0f, 5, -1.0f);
+            if (e1) foldLoopWeight(w, 10, 8, 2.0f, 5, -1.0f);
+            else    foldLoopWeight(w, 10, 11, 1.0f, 8, 1.0f, 9, -1.0f);
+            if (e0) foldLoopWeight(w, 3, 4, 2.0f, 5, -1.0f);
+            else    foldLoopWeight(w, 3, 4, 1.0f, 0, 1.0f, 1, -1.0f);
+        }
+    }
+} // end namespace
+
+void GetLoopWeights(PatchParam const & param,
+    float s, float t, float point[12], float deriv1[12], float deriv2[12], float deriv11[12], float deriv12[12], float deriv22[12]) {
+
+    //  Rotated triangles are parameterized from their opposite corner, which
+    //  also reverses the direction of their first derivatives:
+    bool rotated = param.IsTriangleRotated();
+
+    param.NormalizeTriangle(s,t);
+
+    if (! (deriv1 && deriv2)) {
+        deriv1 = deriv2 = 0;
+    }
+    if (! (deriv1 && deriv11 && deriv12 && deriv22)) {
+        deriv11 = deriv12 = deriv22 = 0;
+    }
+
+    Spline<BASIS_BOX_SPLINE>::GetWeights(s, t, point, deriv1, deriv2, deriv11, deriv12, deriv22);
+
+    int boundary = param.GetBoundary();
+    if (boundary) {
+        float * weights[6] = { point, deriv1, deriv2, deriv11, deriv12, deriv22 };
+        for (int i = 0; i < 6; ++i) {
+            if (weights[i]) {
+                adjustLoopBoundaryWeights(boundary, weights[i]);
+            }
+        }
+    }
+
+    if (deriv1) {
+        float dScale = (float)(1 << param.GetDepth());
+        float d1Scale = rotated ? -dScale : dScale;
+
+        for (int i = 0; i < 12; ++i) {
+            deriv1[i] *= d1Scale;
+            deriv2[i] *= d1Scale;
+        }
+
+        if (deriv11) {
+            float d2Scale = dScale * dScale;
+
+            for (int i = 0; i < 12; ++i) {
+                deriv11[i] *= d2Scale;
+                deriv12[i] *= d2Scale;
+                deriv22[i] *= d2Scale;
+            }
+        }
+    }
+}
+
+void GetLoopHullWeights(PatchParam const & param, int point, float w[12]) {
+
+    for (int i = 0; i < 12; ++i) {
+        w[i] = (i == point) ? 1.0f : 0.0f;
+    }
+    if (param.GetBoundary()) {
+        adjustLoopBoundaryWeights(param.GetBoundary(), w);
+    }
+}
+
+void GetLinearTriWeights(PatchParam const & param,
+    float s, float t, float point[3], float deriv1[3], float deriv2[3], float deriv11[3], float deriv12[3], float deriv22[3]) {
+
+    bool rotated = param.IsTriangleRotated();
+
+    param.NormalizeTriangle(s,t);
+
+    if (point) {
+        point[0] = 1.0f - s - t;
+        point[1] = s;
+        point[2] = t;
+    }
+
+    if (deriv1 && deriv2) {
+        float dScale = (float)(1 << param.GetDepth());
+        if (rotated) {
+            dScale = -dScale;
+        }
+
+        deriv1[0] = -dScale;
+        deriv1[1] =  dScale;
+        deriv1[2] =  0.0f;
+
+        deriv2[0] = -dScale;
+        deriv2[1] =  0.0f;
+        deriv2[2] =  dScale;
+
+        if (deriv11 && deriv12 && deriv22) {
+            for (int i = 0; i < 3; ++i) {
+                deriv11[i] = 0.0f;
+                deriv12[i] = 0.0f;
+                deriv22[i] = 0.0f;
+            }
+        }
+    }
+}
+
 } // end namespace internal
 } // end namespace Far
 
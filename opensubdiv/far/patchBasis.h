@@ -38,9 +38,8 @@ namespace internal {
 //
 // XXXX barfowl:  These functions are being kept in place while more complete
 // underlying support for all patch types is being worked out.  That support
-// will include a larger set of patch types (eventually including triangular
-// patches for Loop) and arbitrary differentiation of all (to support second
-// derivatives and other needs).
+// will include a larger set of patch types and arbitrary differentiation of
+// all (to support second derivatives and other needs).
 //
 // So this interface will be changing in future.
 //
@@ -57,6 +56,22 @@ void GetBSplineWeights(PatchParam const & patchParam,
 void GetGregoryWeights(PatchParam const & patchParam,
     float s, float t, float wP[20], float wDs[20], float wDt[20], float wDss[20] = 0, float wDst[20] = 0, float wDtt[20] = 0);
 
+void GetLinearTriWeights(PatchParam const & patchParam,
+    float s, float t, float wP[3], float wDs[3], float wDt[3], float wDss[3] = 0, float wDst[3] = 0, float wDtt[3] = 0);
+
+void GetLoopWeights(PatchParam const & patchParam,
+    float s, float t, float wP[12], float wDs[12], float wDt[12], float wDss[12] = 0, float wDst[12] = 0, float wDtt[12] = 0);
+
+//
+// Weights of the points of the control hull of a B-spline or Loop patch in
+// terms of its control vertices : the points beyond the boundaries of
+// boundary patches are extrapolated from the control vertices (ex. to bound
+// the patches by their hull).
+//
+void GetBSplineHullWeights(PatchParam const & patchParam, int point, float w[16]);
+
+void GetLoopHullWeights(PatchParam const & patchParam, int point, float w[12]);
+
 
 } // end namespace internal
 } // end namespace Far
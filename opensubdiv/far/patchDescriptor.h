@@ -124,6 +124,9 @@ public:
     /// \brief Number of control vertices of Gregory patch basis (20)
     static short GetGregoryBasisPatchSize() { return 20; }
 
+    /// \brief Number of control vertices of Loop Patches in table.
+    static short GetLoopPatchSize() { return 12; }
+
 
     /// \brief Returns a vector of all the legal patch descriptors for the
     ///        given adaptive subdivision scheme
@@ -153,6 +156,7 @@ PatchDescriptor::GetNumControlVertices( Type type ) {
         case GREGORY           :
         case GREGORY_BOUNDARY  : return GetGregoryPatchSize();
         case GREGORY_BASIS     : return GetGregoryBasisPatchSize();
+        case LOOP              : return GetLoopPatchSize();
         case TRIANGLES         : return 3;
         case LINES             : return 2;
         case POINTS            : return 1;
@@ -25,43 +25,116 @@
 #include "../far/patchMap.h"
 
 #include <algorithm>
+#include <cstring>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
 
 namespace Far {
 
-// Constructor
-PatchMap::PatchMap( PatchTable const & patchTable ) {
-    initialize( patchTable );
-}
+namespace {
+
+    // Quadtree node with 4 children, used while the quadtree is under
+    // construction
+    struct QuadNode {
+        struct Child {
+            unsigned int isSet:1,    // true if the child has been set
+                         isLeaf:1,   // true if the child is a QuadNode
+                         idx:30;     // child index (either QuadNode or Handle)
+        };
+
+        QuadNode() { memset(children, 0, sizeof(children)); }
+
+        // sets all the children to point to the patch of index patchIdx
+        void SetChild(int patchIdx) {
+            for (int i=0; i<4; ++i) {
+                children[i].isSet=true;
+                children[i].isLeaf=true;
+                children[i].idx=patchIdx;
+            }
+        }
 
-// sets all the children to point to the patch of index patchIdx
-void
-PatchMap::QuadNode::SetChild(int patchIdx) {
-    for (int i=0; i<4; ++i) {
-        children[i].isSet=true;
-        children[i].isLeaf=true;
-        children[i].idx=patchIdx;
+        // sets the child in "quadrant" to point to the node or patch of the
+        // given index
+        void SetChild(unsigned char quadrant, int idx, bool isLeaf) {
+            assert(quadrant<4);
+            children[quadrant].isSet  = true;
+            children[quadrant].isLeaf = isLeaf;
+            children[quadrant].idx    = idx;
+        }
+
+        // true if the node holds a single patch
+        bool IsSinglePatch() const {
+            for (int i=0; i<4; ++i) {
+                if (! children[i].isSet || ! children[i].isLeaf ||
+                    children[i].idx != children[0].idx) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        Child children[4];
+    };
+
+    typedef std::vector<QuadNode> QuadTree;
+
+    // adds a child to a parent node and pushes it back on the tree
+    QuadNode *
+    addChild( QuadTree & quadtree, int parent, int quadrant ) {
+        quadtree.push_back(QuadNode());
+        int idx = (int)quadtree.size()-1;
+        quadtree[parent].SetChild((unsigned char)quadrant, idx, false);
+        return &(quadtree[idx]);
     }
-}
 
-// sets the child in "quadrant" to point to the node or patch of the given index
-void
-PatchMap::QuadNode::SetChild(unsigned char quadrant, int idx, bool isLeaf) {
-    assert(quadrant<4);
-    children[quadrant].isSet  = true;
-    children[quadrant].isLeaf = isLeaf;
-    children[quadrant].idx    = idx;
+    // slot of the children of each quadrant in the flat quadtree, given by
+    // their (u,v) bits
+    int const quadrantSlots[4] = { 0, 2, 3, 1 };
+
+    // slot of the children of each triangle in the flat quadtree
+    int const triangleSlots[4] = { 0, 1, 2, 3 };
+
+    // identifies the child triangles leading to a triangular patch from the
+    // root of its face -- a triangle in the cell (i,j) of its level is either
+    // upright or rotated, which also determines the parent it belongs to
+    void
+    getTriangleChildren(PatchParam const & param, int children[]) {
+
+        int depth = param.GetDepth(),
+            i = param.GetU(),
+            j = param.GetV();
+
+        bool upright = ! param.IsTriangleRotated();
+        if (! upright) {
+            i = (1 << depth) - 1 - i;
+            j = (1 << depth) - 1 - j;
+        }
+
+        for (int level=depth-1; level>=0; --level) {
+
+            int corner = ((j & 1) << 1) | (i & 1);
+
+            bool parentUpright = upright ? (corner != 3) : (corner == 0);
+
+            static int const uprightParent[2][4] = { { 3, -1, -1, -1 }, { 0, 1, 2, -1 } };
+            static int const rotatedParent[2][4] = { { -1, 2, 1, 0 }, { -1, -1, -1, 3 } };
+
+            children[level] = parentUpright ? uprightParent[upright][corner]
+                                            : rotatedParent[upright][corner];
+            assert(children[level] >= 0);
+
+            upright = parentUpright;
+            i >>= 1;
+            j >>= 1;
+        }
+    }
 }
 
-// adds a child to a parent node and pushes it back on the tree
-PatchMap::QuadNode *
-PatchMap::addChild( QuadTree & quadtree, QuadNode * parent, int quadrant ) {
-    quadtree.push_back(QuadNode());
-    int idx = (int)quadtree.size()-1;
-    parent->SetChild(quadrant, idx, false);
-    return &(quadtree[idx]);
+// Constructor
+PatchMap::PatchMap( PatchTable const & patchTable ) :
+    _patchesAreTriangular(false) {
+    initialize( patchTable );
 }
 
 void
@@ -74,6 +147,13 @@ PatchMap::initialize( PatchTable const & patchTable ) {
     if (! narrays || ! npatches)
         return;
 
+    // Loop patches are triangular, as are the patches of uniformly refined
+    // Loop meshes
+    PatchDescriptor::Type firstType = patchTable.GetPatchArrayDescriptor(0).GetType();
+
+    _patchesAreTriangular = (firstType == PatchDescriptor::LOOP) ||
+                            (firstType == PatchDescriptor::TRIANGLES);
+
     // populate subpatch handles vector
     _handles.resize(npatches);
 
@@ -98,7 +178,7 @@ PatchMap::initialize( PatchTable const & patchTable ) {
     }
     ++nfaces;
     // temporary vector to hold the quadtree while under construction
-    std::vector<QuadNode> quadtree;
+    QuadTree quadtree;
 
     // reserve memory for the octree nodes (size is a worse-case approximation)
     quadtree.reserve( nfaces + npatches );
@@ -117,11 +197,11 @@ PatchMap::initialize( PatchTable const & patchTable ) {
 
             unsigned short depth = param.GetDepth();
 
-            QuadNode * node = &quadtree[ params[i].GetFaceId() ];
+            int nodeIdx = params[i].GetFaceId();
 
             if (depth==(param.NonQuadRoot() ? 1 : 0)) {
                 // special case : regular BSpline face w/ no sub-patches
-                node->SetChild( handleIndex );
+                quadtree[nodeIdx].SetChild( handleIndex );
                 continue;
             }
 
@@ -130,38 +210,152 @@ PatchMap::initialize( PatchTable const & patchTable ) {
                 pdepth = param.NonQuadRoot() ? depth-2 : depth-1,
                 half = 1 << pdepth;
 
+            assert(pdepth < MAX_DEPTH);
+
+            int triangleChildren[MAX_DEPTH];
+            if (_patchesAreTriangular) {
+                getTriangleChildren(param, triangleChildren);
+            }
+
             for (unsigned char j=0; j<depth; ++j) {
 
-                int delta = half >> 1;
+                int quadrant = 0;
+                if (_patchesAreTriangular) {
+                    quadrant = triangleChildren[j];
+                } else {
+                    int delta = half >> 1;
+
+                    quadrant = resolveQuadrant(half, u, v);
+                    assert(quadrant>=0);
 
-                int quadrant = resolveQuadrant(half, u, v);
-                assert(quadrant>=0);
+                    half = delta;
+                }
 
-                half = delta;
+                QuadNode::Child const & child = quadtree[nodeIdx].children[quadrant];
 
                 if (j==pdepth) {
                    // we have reached the depth of the sub-patch : add a leaf
-                   assert( ! node->children[quadrant].isSet );
-                   node->SetChild(quadrant, handleIndex, true);
+                   assert( ! child.isSet );
+                   quadtree[nodeIdx].SetChild((unsigned char)quadrant, handleIndex, true);
                    break;
                 } else {
                     // travel down the child node of the corresponding quadrant
-                    if (! node->children[quadrant].isSet) {
+                    if (! child.isSet) {
                         // create a new branch in the quadrant
-                        node = addChild(quadtree, node, quadrant);
-                    } else {
-                        // travel down an existing branch
-                        node = &(quadtree[ node->children[quadrant].idx ]);
+                        addChild(quadtree, nodeIdx, quadrant);
                     }
+                    nodeIdx = quadtree[nodeIdx].children[quadrant].idx;
+                }
+            }
+        }
+    }
+
+    // flatten the quadtree : the nodes of each face are stored breadth-first
+    // after its root, faces with a single patch are resolved at the root
+    _faceRoots.resize(nfaces);
+    _quadtree.reserve(4 * (quadtree.size() - nfaces) + 4);
+
+    int const * childSlots = _patchesAreTriangular ? triangleSlots : quadrantSlots;
+
+    std::vector<std::pair<int, int> > queue;
+    for (int face=0; face<nfaces; ++face) {
+
+        QuadNode const & root = quadtree[face];
+
+        if (! (root.children[0].isSet || root.children[1].isSet ||
+               root.children[2].isSet || root.children[3].isSet)) {
+            _faceRoots[face] = (Child)HOLE;
+            continue;
+        }
+        if (root.IsSinglePatch()) {
+            _faceRoots[face] = root.children[0].idx | (Child)LEAF_BIT;
+            continue;
+        }
+
+        _faceRoots[face] = (Child)_quadtree.size();
+
+        queue.clear();
+        queue.push_back(std::make_pair(face, (int)_quadtree.size()));
+        _quadtree.resize(_quadtree.size() + 4);
+
+        for (size_t n=0; n<queue.size(); ++n) {
+
+            QuadNode const & node = quadtree[queue[n].first];
+
+            for (int quadrant=0; quadrant<4; ++quadrant) {
+
+                QuadNode::Child const & child = node.children[quadrant];
+
+                Child flatChild;
+                if (! child.isSet) {
+                    flatChild = (Child)HOLE;
+                } else if (child.isLeaf) {
+                    flatChild = child.idx | (Child)LEAF_BIT;
+                } else {
+                    flatChild = (Child)_quadtree.size();
+                    queue.push_back(std::make_pair((int)child.idx,
+                                                   (int)_quadtree.size()));
+                    _quadtree.resize(_quadtree.size() + 4);
                 }
+                _quadtree[queue[n].second + childSlots[quadrant]] = flatChild;
             }
         }
     }
+}
+
+size_t
+PatchMap::GetMemoryUsage( MemoryUsage * usage,
+                          std::string const & prefix ) const {
+
+    MemoryUsage localUsage;
+    if (! usage) {
+        usage = &localUsage;
+    }
+    size_t total = usage->GetTotal();
 
-    // copy the resulting quadtree to eliminate un-unused vector capacity
-    _quadtree = quadtree;
+    usage->Add(prefix + "handles",   _handles);
+    usage->Add(prefix + "faceRoots", _faceRoots);
+    usage->Add(prefix + "quadtree",  _quadtree);
+
+    return usage->GetTotal() - total;
 }
 
+void
+PatchMap::FindPatches( int numLocations, int const * faceids,
+                       float const * u, float const * v,
+                       Handle const ** handles ) const {
+
+    for (int i=0; i<numLocations; ) {
+
+        // locations of the same face are resolved from its root
+        int faceid = faceids[i], end = i+1;
+        while (end<numLocations && faceids[end]==faceid) {
+            ++end;
+        }
+
+        if (faceid>=(int)_faceRoots.size()) {
+            for ( ; i<end; ++i) {
+                handles[i] = 0;
+            }
+            continue;
+        }
+
+        Child root = _faceRoots[faceid];
+        if (root & LEAF_BIT) {
+            Handle const * handle =
+                (root == HOLE) ? 0 : &_handles[root & ~LEAF_BIT];
+            for ( ; i<end; ++i) {
+                handles[i] = handle;
+            }
+        } else {
+            for ( ; i<end; ++i) {
+                assert( (u[i]>=0.0f) && (u[i]<=1.0f) &&
+                        (v[i]>=0.0f) && (v[i]<=1.0f) );
+                handles[i] = findPatch(root, u[i], v[i]);
+            }
+        }
+    }
+}
 
 } // end namespace Far
 
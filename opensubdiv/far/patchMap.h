@@ -30,6 +30,8 @@
 #include "../far/patchTable.h"
 
 #include <cassert>
+#include <string>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -46,6 +48,13 @@ namespace Far {
 /// parametric location, can efficiently return a handle to the sub-patch that
 /// contains this location.
 ///
+/// The quadtree is stored as a flat array of 32 bits children, where the
+/// nodes of each face are contiguous. Faces covered by a single patch (ex.
+/// regular faces) are resolved without visiting any node.
+///
+/// The triangular patches of Loop meshes are mapped the same way, the four
+/// children of each node being the triangles resulting from its subdivision.
+///
 class PatchMap {
 public:
 
@@ -72,31 +81,54 @@ public:
     ///
     Handle const * FindPatch( int faceid, float u, float v ) const;
 
-private:
+    /// \brief Returns the handles to the sub-patches of a set of locations.
+    /// Consecutive locations on the same face share the lookup of the face,
+    /// so arrays sorted by face are resolved faster.
+    ///
+    /// @param numLocations  The number of locations
+    ///
+    /// @param faceids       The index of the face of each location
+    ///
+    /// @param u             Local u parameter of each location
+    ///
+    /// @param v             Local v parameter of each location
+    ///
+    /// @param handles       The patch handle of each location (NULL if the
+    ///                      face does not exist or the location is a hole)
+    ///
+    void FindPatches( int numLocations, int const * faceids,
+                      float const * u, float const * v,
+                      Handle const ** handles ) const;
 
-    inline void initialize( PatchTable const & patchTable );
+    /// \brief Returns the memory used by the map (in bytes)
+    ///
+    /// @param usage   Optional breakdown to which the vectors of the map
+    ///                are added
+    ///
+    /// @param prefix  Prefix of the names of the components in the breakdown
+    ///
+    size_t GetMemoryUsage(MemoryUsage * usage = 0,
+                          std::string const & prefix = std::string()) const;
+
+private:
 
-    // Quadtree node with 4 children
-    struct QuadNode {
-        struct Child {
-            unsigned int isSet:1,    // true if the child has been set
-                         isLeaf:1,   // true if the child is a QuadNode
-                         idx:30;     // child index (either QuadNode or Handle)
-        };
+    void initialize( PatchTable const & patchTable );
 
-        // sets all the children to point to the patch of index patchIdx
-        void SetChild(int patchIdx);
+    // A child of the quadtree is either the index of the first of the 4
+    // children of a node in _quadtree, or the index of a patch handle with
+    // the leaf bit set (all the bits are set for holes).
+    typedef unsigned int Child;
 
-        // sets the child in "quadrant" to point to the node or patch of the given index
-        void SetChild(unsigned char quadrant, int child, bool isLeaf=true);
+    static const Child LEAF_BIT = 0x80000000u,
+                       HOLE     = 0xFFFFFFFFu;
 
-        Child children[4];
-    };
+    // (u,v) are resolved as fixed point coordinates : the quadrant of a node
+    // at a given depth is given by the bits of u and v at that depth
+    static const int MAX_DEPTH = 16;
 
-    typedef std::vector<QuadNode> QuadTree;
+    static unsigned int toFixed( float u );
 
-    // adds a child to a parent node and pushes it back on the tree
-    static QuadNode * addChild( QuadTree & quadtree, QuadNode * parent, int quadrant );
+    Handle const * findPatch( Child child, float u, float v ) const;
 
     // given a median, transforms the (u,v) to the quadrant they point to, and
     // return the quadrant index.
@@ -113,10 +145,26 @@ private:
     //         |     |     |
     //         o-----o-----o (1,1)
     //
+    // note : the children of the nodes are stored in the order of their
+    // (u,v) bits (ie. quadrants 0, 3, 1, 2)
+    //
     template <class T> static int resolveQuadrant(T & median, T & u, T & v);
 
-    std::vector<Handle>   _handles;  // all the patches in the PatchTable
-    std::vector<QuadNode> _quadtree; // quadtree nodes
+    // transforms the (u,v) of a triangle to those of the child triangle they
+    // point to, and returns the index of the child.
+    //
+    // Children 0, 1 and 2 are the upright triangles at the corners (0,0),
+    // (1,0) and (0,1) of the parent, child 3 is the central triangle, whose
+    // parameterization is rotated (its origin is at the mid-point of the
+    // parent's hypotenuse).
+    //
+    static int resolveTriangle(float & u, float & v);
+
+    bool _patchesAreTriangular;     // triangular (Loop) patches
+
+    std::vector<Handle> _handles;   // all the patches in the PatchTable
+    std::vector<Child>  _faceRoots; // root of each face
+    std::vector<Child>  _quadtree;  // children of the nodes, 4 per node
 };
 
 // given a median, transforms the (u,v) to the quadrant they point to, and
@@ -144,42 +192,72 @@ PatchMap::resolveQuadrant(T & median, T & u, T & v) {
     return quadrant;
 }
 
-/// Returns a handle to the sub-patch of the face at the given (u,v).
-inline PatchMap::Handle const *
-PatchMap::FindPatch( int faceid, float u, float v ) const {
+inline int
+PatchMap::resolveTriangle(float & u, float & v) {
 
-    if (faceid>=(int)_quadtree.size())
-        return NULL;
+    u *= 2.0f;
+    v *= 2.0f;
 
-    assert( (u>=0.0f) && (u<=1.0f) && (v>=0.0f) && (v<=1.0f) );
+    if (u >= 1.0f) {
+        u -= 1.0f;
+        return 1;
+    }
+    if (v >= 1.0f) {
+        v -= 1.0f;
+        return 2;
+    }
+    if ((u + v) < 1.0f) {
+        return 0;
+    }
+    u = 1.0f - u;
+    v = 1.0f - v;
+    return 3;
+}
 
-    QuadNode const * node = &_quadtree[faceid];
+// converts a parametric coordinate to MAX_DEPTH bits fixed point (1.0 is
+// resolved in the last quadrants, as are values beyond)
+inline unsigned int
+PatchMap::toFixed( float u ) {
 
-    float half = 0.5f;
+    unsigned int const one = 1u << MAX_DEPTH;
 
-    // 0xFF : we should never have depths greater than k_InfinitelySharp
-    for (int depth=0; depth<0xFF; ++depth) {
+    if (u <= 0.0f) return 0;
+    unsigned int fixed = (unsigned int)(u * (float)one);
+    return (fixed < one) ? fixed : one - 1;
+}
 
-        float delta = half * 0.5f;
+// walks down the quadtree from a face root
+inline PatchMap::Handle const *
+PatchMap::findPatch( Child child, float u, float v ) const {
 
-        int quadrant = resolveQuadrant( half, u, v );
-        assert(quadrant>=0);
+    if (! (child & LEAF_BIT) && _patchesAreTriangular) {
+        for (int depth=0; ! (child & LEAF_BIT); ++depth) {
+            assert(depth<MAX_DEPTH);
+            child = _quadtree[child + resolveTriangle(u, v)];
+        }
+    } else if (! (child & LEAF_BIT)) {
+        unsigned int fu = toFixed(u),
+                     fv = toFixed(v);
+
+        for (int bit=MAX_DEPTH-1; ! (child & LEAF_BIT); --bit) {
+            assert(bit>=0);
+            child = _quadtree[child + (((fu >> bit) & 1) |
+                                      (((fv >> bit) & 1) << 1))];
+        }
+    }
+    return (child == HOLE) ? 0 : &_handles[child & ~LEAF_BIT];
+}
 
-        // is the quadrant a hole ?
-        if (! node->children[quadrant].isSet)
-            return 0;
+/// Returns a handle to the sub-patch of the face at the given (u,v).
+inline PatchMap::Handle const *
+PatchMap::FindPatch( int faceid, float u, float v ) const {
 
-        if (node->children[quadrant].isLeaf) {
-            return &_handles[node->children[quadrant].idx];
-        } else {
-            node = &_quadtree[node->children[quadrant].idx];
-        }
+    if (faceid>=(int)_faceRoots.size())
+        return NULL;
 
-        half = delta;
-    }
+    assert( (u>=0.0f) && (u<=1.0f) && (v>=0.0f) && (v<=1.0f) );
 
-    assert(0);
-    return 0;
+    return findPatch(_faceRoots[faceid], u, v);
 }
 
 } // end namespace Far
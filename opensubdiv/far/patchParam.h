@@ -78,6 +78,12 @@ namespace Far {
 /// coordinates. This encoding also takes inspiration from the Ptex
 /// texture mapping specification.
 ///
+/// The boundary bitmask of a triangular patch is interpreted differently
+/// than that of a quad: when the highest bit is clear, the lower three bits
+/// identify the boundary edges of the triangle as above, but when it is set,
+/// they identify boundary vertices of an otherwise interior triangle. Both
+/// are sequential starting from the first vertex of the refined face.
+///
 /// Bitfield layout :
 ///
 ///  Field0     | Bits | Content
@@ -215,6 +221,27 @@ struct PatchParam {
     ///
     void Unnormalize( float & u, float & v ) const;
 
+    /// \brief Returns whether the triangular patch is parameterized from the
+    /// opposite corner of the quad-tree cell it occupies (see the triangle
+    /// patch parameterization above)
+    bool IsTriangleRotated() const;
+
+    /// \brief A (u,v) pair in the fraction of parametric space covered by
+    /// this triangular face is mapped into a normalized parametric space.
+    ///
+    /// @param u  u parameter
+    /// @param v  v parameter
+    ///
+    void NormalizeTriangle( float & u, float & v ) const;
+
+    /// \brief A (u,v) pair in a normalized parametric space is mapped back
+    /// into the fraction of parametric space covered by this triangular face.
+    ///
+    /// @param u  u parameter
+    /// @param v  v parameter
+    ///
+    void UnnormalizeTriangle( float & u, float & v ) const;
+
     /// \brief Returns whether the patch is regular
     bool IsRegular() const { return (unpack(field1,1,5) != 0); }
 
@@ -285,6 +312,44 @@ PatchParam::Unnormalize( float & u, float & v ) const {
     v = v * frac + pv;
 }
 
+inline bool
+PatchParam::IsTriangleRotated() const {
+
+    return (GetU() + GetV()) >= (1 << GetDepth());
+}
+
+inline void
+PatchParam::NormalizeTriangle( float & u, float & v ) const {
+
+    if (IsTriangleRotated()) {
+        float frac = GetParamFraction();
+
+        float pu = (float)((1 << GetDepth()) - GetU())*frac;
+        float pv = (float)((1 << GetDepth()) - GetV())*frac;
+
+        u = (pu - u) / frac,
+        v = (pv - v) / frac;
+    } else {
+        Normalize(u, v);
+    }
+}
+
+inline void
+PatchParam::UnnormalizeTriangle( float & u, float & v ) const {
+
+    if (IsTriangleRotated()) {
+        float frac = GetParamFraction();
+
+        float pu = (float)((1 << GetDepth()) - GetU())*frac;
+        float pv = (float)((1 << GetDepth()) - GetV())*frac;
+
+        u = pu - u * frac,
+        v = pv - v * frac;
+    } else {
+        Unnormalize(u, v);
+    }
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
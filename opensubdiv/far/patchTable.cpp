@@ -378,14 +378,57 @@ PatchTable::IsFeatureAdaptive() const {
 
     for (int i=0; i<GetNumPatchArrays(); ++i) {
         PatchDescriptor const & desc = _patchArrays[i].desc;
-        if (desc.GetType()>=PatchDescriptor::REGULAR &&
-            desc.GetType()<=PatchDescriptor::GREGORY_BASIS) {
+        if (desc.IsAdaptive()) {
             return true;
         }
     }
     return false;
 }
 
+size_t
+PatchTable::GetMemoryUsage(MemoryUsage * usage,
+                           std::string const & prefix) const {
+
+    MemoryUsage localUsage;
+    if (! usage) {
+        usage = &localUsage;
+    }
+    size_t total = usage->GetTotal();
+
+    usage->Add(prefix + "patchArrays",        _patchArrays);
+    usage->Add(prefix + "patchVerts",         _patchVerts);
+    usage->Add(prefix + "paramTable",         _paramTable);
+    usage->Add(prefix + "quadOffsetsTable",   _quadOffsetsTable);
+    usage->Add(prefix + "vertexValenceTable", _vertexValenceTable);
+    usage->Add(prefix + "varyingVerts",       _varyingVerts);
+    usage->Add(prefix + "sharpnessIndices",   _sharpnessIndices);
+    usage->Add(prefix + "sharpnessValues",    _sharpnessValues);
+
+    for (int fvc=0; fvc<(int)_fvarChannels.size(); ++fvc) {
+        std::string channel =
+            prefix + MemoryUsage::GetIndexedName("fvar", fvc);
+        usage->Add(channel + "patchValues", _fvarChannels[fvc].patchValues);
+        usage->Add(channel + "patchParam",  _fvarChannels[fvc].patchParam);
+    }
+
+    if (_localPointStencils) {
+        _localPointStencils->GetMemoryUsage(usage,
+            prefix + "localPointStencils/");
+    }
+    if (_localPointVaryingStencils) {
+        _localPointVaryingStencils->GetMemoryUsage(usage,
+            prefix + "localPointVaryingStencils/");
+    }
+    for (int fvc=0; fvc<(int)_localPointFaceVaryingStencils.size(); ++fvc) {
+        if (_localPointFaceVaryingStencils[fvc]) {
+            _localPointFaceVaryingStencils[fvc]->GetMemoryUsage(usage,
+                prefix + MemoryUsage::GetIndexedName(
+                    "localPointFaceVaryingStencils", fvc));
+        }
+    }
+    return usage->GetTotal() - total;
+}
+
 PatchDescriptor
 PatchTable::GetVaryingPatchDescriptor() const {
     return _varyingDesc;
@@ -441,8 +484,7 @@ PatchTable::populateVaryingVertices() {
     // patch. This indexing is redundant for triangles and quads and
     // could be made redunant for other patch types if we reorganized
     // the vertex patch indices so that the zero ring indices always occured
-    // first. This will also need to be updated when we add support for
-    // triangle patches.
+    // first.
     int numVaryingCVs = _varyingDesc.GetNumControlVertices();
     for (int arrayIndex=0; arrayIndex<(int)_patchArrays.size(); ++arrayIndex) {
         PatchArray const & pa = getPatchArray(arrayIndex);
@@ -465,6 +507,10 @@ PatchTable::populateVaryingVertices() {
                 _varyingVerts[start+1] = vertexCVs[1];
                 _varyingVerts[start+2] = vertexCVs[2];
                 _varyingVerts[start+3] = vertexCVs[3];
+            } else if (patchType == PatchDescriptor::LOOP) {
+                _varyingVerts[start+0] = vertexCVs[4];
+                _varyingVerts[start+1] = vertexCVs[5];
+                _varyingVerts[start+2] = vertexCVs[8];
             } else if (patchType == PatchDescriptor::TRIANGLES) {
                 _varyingVerts[start+0] = vertexCVs[0];
                 _varyingVerts[start+1] = vertexCVs[1];
@@ -581,8 +627,12 @@ PatchTable::EvaluateBasis(
         internal::GetBSplineWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else if (patchType == PatchDescriptor::GREGORY_BASIS) {
         internal::GetGregoryWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::LOOP) {
+        internal::GetLoopWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else if (patchType == PatchDescriptor::QUADS) {
         internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::TRIANGLES) {
+        internal::GetLinearTriWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else {
         assert(0);
     }
@@ -599,7 +649,11 @@ PatchTable::EvaluateBasisVarying(
 
     PatchParam const & param = _paramTable[handle.patchIndex];
 
-    internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    if (_varyingDesc.GetType() == PatchDescriptor::TRIANGLES) {
+        internal::GetLinearTriWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else {
+        internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    }
 }
 
 //
@@ -621,8 +675,12 @@ PatchTable::EvaluateBasisFaceVarying(
         internal::GetBSplineWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else if (patchType == PatchDescriptor::GREGORY_BASIS) {
         internal::GetGregoryWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::LOOP) {
+        internal::GetLoopWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else if (patchType == PatchDescriptor::QUADS) {
         internal::GetBilinearWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
+    } else if (patchType == PatchDescriptor::TRIANGLES) {
+        internal::GetLinearTriWeights(param, s, t, wP, wDs, wDt, wDss, wDst, wDtt);
     } else {
         assert(0);
     }
@@ -94,6 +94,18 @@ public:
     /// \brief Returns the total number of ptex faces in the mesh
     int GetNumPtexFaces() const { return _numPtexFaces; }
 
+    /// \brief Returns the memory used by the table (in bytes)
+    ///
+    /// @param usage   Optional breakdown to which the vectors of the table
+    ///                are added, with the stencils of the local points
+    ///                under "localPointStencils/" (and the varying and
+    ///                face-varying local point stencils)
+    ///
+    /// @param prefix  Prefix of the names of the components in the breakdown
+    ///
+    size_t GetMemoryUsage(MemoryUsage * usage = 0,
+                          std::string const & prefix = std::string()) const;
+
 
     //@{
     ///  @name Individual patches
@@ -453,6 +465,7 @@ public:
 protected:
 
     friend class PatchTableFactory;
+    friend class Serializer;
 
     // Factory constructor
     PatchTable(int maxvalence);
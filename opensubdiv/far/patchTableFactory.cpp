@@ -201,6 +201,53 @@ offsetAndPermuteIndices(Far::Index const indices[], int count,
     }
 }
 
+//
+//  Gathers the 12 points of a regular Loop patch, ordered as expected by its
+//  box-spline basis, by walking the ring of each corner from the leading edge
+//  of the face.  As with the permutations above, points missing beyond a
+//  boundary are assigned the first vertex of the face:
+//
+inline void
+gatherTriRegularPatchPoints(Level const & level, Index faceIndex,
+                            Far::Index offset, Far::Index result[12]) {
+
+    //  Patch points for each corner and the three points of its ring beyond
+    //  the two edges of the face (in counter-clockwise order):
+    static int const cornerPoints[3]  = { 4, 5, 8 };
+    static int const ringPoints[3][3] = { { 3, 0, 1 }, { 2, 6, 9 }, { 11, 10, 7 } };
+
+    ConstIndexArray fVerts = level.getFaceVertices(faceIndex);
+    ConstIndexArray fEdges = level.getFaceEdges(faceIndex);
+
+    for (int i = 0; i < 12; ++i) {
+        result[i] = offset + fVerts[0];
+    }
+
+    for (int corner = 0; corner < 3; ++corner) {
+        Index vIndex = fVerts[corner];
+
+        result[cornerPoints[corner]] = offset + vIndex;
+
+        //  Edges of a boundary vertex are missing those following its last,
+        //  so the ring is indexed as if it were complete:
+        ConstIndexArray vEdges = level.getVertexEdges(vIndex);
+
+        int leadingEdge = vEdges.FindIndex(fEdges[corner]);
+
+        for (int i = 0; i < 3; ++i) {
+            int edgeInRing = leadingEdge + 3 + i;
+            if (edgeInRing >= vEdges.size()) {
+                edgeInRing -= 6;
+            }
+            if ((edgeInRing >= 0) && (edgeInRing < vEdges.size())) {
+                ConstIndexArray eVerts = level.getEdgeVertices(vEdges[edgeInRing]);
+
+                result[ringPoints[corner][i]] = offset + eVerts[eVerts[0] == vIndex];
+            }
+        }
+    }
+}
+
 inline int
 assignSharpnessIndex(float sharpness, std::vector<float> & sharpnessValues) {
 
@@ -322,6 +369,9 @@ public:
     // Tuple for each patch identified during topology traversal
     PatchTupleVector patches;
 
+    // Regularity of each patch, retained to avoid reclassifying it later
+    std::vector<unsigned char> patchIsRegular;
+
     std::vector<int> levelVertOffsets;
     std::vector< std::vector<int> > levelFVarValueOffsets;
 
@@ -386,6 +436,15 @@ PatchTableFactory::BuilderContext::GatherRegularPatchPoints(
 
     int fvcRefiner = GetRefinerFVarChannel(fvcFactory);
 
+    if (level.getFaceVertices(patch.faceIndex).size() == 3) {
+        //  Points of regular triangles are only gathered for vertex patches --
+        //  face-varying patches for Loop are currently linear:
+        assert(fvcRefiner < 0);
+
+        gatherTriRegularPatchPoints(level, patch.faceIndex, levelVertOffset, iptrs);
+        return 12;
+    }
+
     Index patchVerts[16];
 
     int bType  = 0;
@@ -488,11 +547,21 @@ PatchTableFactory::BuilderContext::IsPatchEligible(
     //  their full neighborhood available and so are considered "incomplete":
     //
     Vtr::ConstIndexArray fVerts = level.getFaceVertices(faceIndex);
-    assert(fVerts.size() == 4);
+    assert(fVerts.size() ==
+           Sdc::SchemeTypeTraits::GetRegularFaceSize(refiner.GetSchemeType()));
 
     if (level.getFaceCompositeVTag(fVerts)._incomplete) {
         return false;
     }
+
+    //  Triangles have no child vertex for the face itself, so the children
+    //  of a triangle that was not selected may have only complete vertices
+    //  and are instead identified by their own tag:
+    if ((fVerts.size() == 3) && (levelIndex > 0)) {
+        if (refiner.getRefinement(levelIndex-1).getChildFaceTag(faceIndex)._incomplete) {
+            return false;
+        }
+    }
     return true;
 }
 
@@ -556,9 +625,11 @@ PatchTableFactory::BuilderContext::IsPatchRegular(
     //  Ignore the face-varying channel if the topology for the face is not distinct
     int fvcRefiner = GetDistinctRefinerFVarChannel(levelIndex, faceIndex, fvcFactory);
 
-    //  Retrieve the composite VTag for the four corners:
+    //  Retrieve the composite VTag for the corners:
     Level::VTag fCompVTag = level.getFaceCompositeVTag(faceIndex, fvcRefiner);
 
+    int nCorners = level.getFaceVertices(faceIndex).size();
+
     //
     //  Patches around non-manifold features are currently regular -- will need to revise
     //  this when infinitely sharp patches are introduced later:
@@ -593,7 +664,7 @@ PatchTableFactory::BuilderContext::IsPatchRegular(
             Level::ETag eMask = getSingularEdgeMask(true);
 
             isRegular = true;
-            for (int i = 0; i < 4; ++i) {
+            for (int i = 0; i < nCorners; ++i) {
                 if (vTags[i]._infIrregular) {
                     identifyManifoldCornerSpan(level, faceIndex, i, eMask, vSpan, fvcRefiner);
 
@@ -608,7 +679,7 @@ PatchTableFactory::BuilderContext::IsPatchRegular(
         if (fCompVTag._xordinary && (levelIndex < 2)) {
             Level::VTag vTags[4];
             level.getFaceVTags(faceIndex, vTags, fvcRefiner);
-            for (int i = 0; i < 4; ++i) {
+            for (int i = 0; i < nCorners; ++i) {
                 if (vTags[i]._xordinary && (vTags[i]._rule == Sdc::Crease::RULE_SMOOTH)) {
                     isRegular = false;
                 }
@@ -622,6 +693,13 @@ PatchTableFactory::BuilderContext::IsPatchRegular(
             isRegular = IsPatchSmoothCorner(levelIndex, faceIndex, fvcRefiner);
         }
     }
+
+    //  Regular triangles must be manifold and have a boundary configuration
+    //  supported by the Loop patch:
+    if (isRegular && (nCorners == 3)) {
+        isRegular = !fCompVTag._nonManifold &&
+                    (GetRegularPatchBoundaryMask(levelIndex, faceIndex, fvcFactory) >= 0);
+    }
     return isRegular;
 }
 
@@ -634,6 +712,38 @@ PatchTableFactory::BuilderContext::GetRegularPatchBoundaryMask(
     //  Ignore the face-varying channel if the topology for the face is not distinct
     int fvcRefiner = GetDistinctRefinerFVarChannel(levelIndex, faceIndex, fvcFactory);
 
+    if (level.getFaceVertices(faceIndex).size() == 3) {
+        //
+        //  The mask for a triangle identifies either its boundary edges or,
+        //  when it has none, its boundary vertices (see PatchParam).  Those
+        //  with both are not supported by the Loop patch, in which case -1
+        //  is returned:
+        //
+        Level::VTag vTags[3];
+        Level::ETag eTags[3];
+        level.getFaceVTags(faceIndex, vTags, fvcRefiner);
+        level.getFaceETags(faceIndex, eTags, fvcRefiner);
+
+        int eMask = 0,
+            vMask = 0;
+        for (int i = 0; i < 3; ++i) {
+            if (options.useInfSharpPatch) {
+                eMask |= eTags[i]._infSharp << i;
+                vMask |= vTags[i]._infSharpEdges << i;
+            } else {
+                eMask |= eTags[i]._boundary << i;
+                vMask |= vTags[i]._boundary << i;
+            }
+        }
+
+        //  Ignore the vertices at the ends of the boundary edges:
+        vMask &= ~(eMask | (((eMask << 1) | (eMask >> 2)) & 7));
+
+        if (eMask && vMask) return -1;
+
+        return eMask ? eMask : (vMask ? (vMask | 8) : 0);
+    }
+
     //  Gather the VTags for the four corners.  Regardless of the options for
     //  treating non-manifold or inf-sharp patches, for a regular patch we can
     //  infer all that we need need from tags for the corner vertices:
@@ -781,8 +891,13 @@ PatchTableFactory::allocateVertexTables(
     table->_paramTable.resize( npatches );
 
     if (! context.refiner.IsUniform()) {
+        PatchDescriptor::Type varyingType =
+            (context.refiner.GetSchemeType() == Sdc::SCHEME_LOOP)
+                ? PatchDescriptor::TRIANGLES
+                : PatchDescriptor::QUADS;
+
         table->allocateVaryingVertices(
-            PatchDescriptor(PatchDescriptor::QUADS), npatches);
+            PatchDescriptor(varyingType), npatches);
     }
 
     if (context.options.useSingleCreasePatch) {
@@ -801,6 +916,8 @@ PatchTableFactory::allocateFVarChannels(
 
     int npatches = table->GetNumPatchesTotal();
 
+    bool isLoop = (refiner.GetSchemeType() == Sdc::SCHEME_LOOP);
+
     table->allocateFVarPatchChannels((int)context.fvarChannelIndices.size());
 
     // Initialize each channel
@@ -813,7 +930,8 @@ PatchTableFactory::allocateFVarChannels(
         table->setFVarPatchChannelLinearInterpolation(interpolation, fvc);
 
         if (refiner.IsUniform()) {
-            PatchDescriptor::Type uniformType = context.options.triangulateQuads
+            PatchDescriptor::Type uniformType =
+                (context.options.triangulateQuads || isLoop)
                 ? PatchDescriptor::TRIANGLES
                 : PatchDescriptor::QUADS;
 
@@ -824,7 +942,10 @@ PatchTableFactory::allocateFVarChannels(
             bool allLinear = context.options.generateFVarLegacyLinearPatches ||
                 (interpolation == Sdc::Options::FVAR_LINEAR_ALL);
 
-            PatchDescriptor::Type adaptiveType = allLinear
+            //  Face-varying patches for Loop are currently always linear:
+            PatchDescriptor::Type adaptiveType = isLoop
+                    ? PatchDescriptor::TRIANGLES
+                    : allLinear
                     ? PatchDescriptor::QUADS
                     : ((context.options.GetEndCapType() == Options::ENDCAP_GREGORY_BASIS)
                         ? PatchDescriptor::GREGORY_BASIS
@@ -1186,6 +1307,7 @@ PatchTableFactory::identifyAdaptivePatches(BuilderContext & context) {
     //
     int reservePatches = refiner.GetNumFacesTotal();
     context.patches.reserve(reservePatches);
+    context.patchIsRegular.reserve(reservePatches);
 
     context.levelVertOffsets.push_back(0);
     context.levelFVarValueOffsets.resize(context.fvarChannelIndices.size());
@@ -1193,6 +1315,17 @@ PatchTableFactory::identifyAdaptivePatches(BuilderContext & context) {
         context.levelFVarValueOffsets[fvc].push_back(0);
     }
 
+    //  Faces of each level are classified independently of one another (and
+    //  so possibly concurrently) before being appended in order:
+    enum { FACE_NO_PATCH = 0, FACE_REGULAR, FACE_IRREGULAR, FACE_IRREGULAR_BOUNDARY };
+
+    std::vector<unsigned char> faceTypes;
+
+    bool useThreads = context.options.useThreads;
+    bool countBoundaryPatches =
+        (context.options.GetEndCapType() == Options::ENDCAP_LEGACY_GREGORY) &&
+        (refiner.GetSchemeType() != Sdc::SCHEME_LOOP);
+
     for (int levelIndex=0; levelIndex<refiner.GetNumLevels(); ++levelIndex) {
         Level const & level = refiner.getLevel(levelIndex);
 
@@ -1206,24 +1339,44 @@ PatchTableFactory::identifyAdaptivePatches(BuilderContext & context) {
                 + level.getNumFVarValues(refinerChannel));
         }
 
+        faceTypes.resize(level.getNumFaces());
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (useThreads)
+#endif
         for (int faceIndex = 0; faceIndex < level.getNumFaces(); ++faceIndex) {
 
+            unsigned char faceType = FACE_NO_PATCH;
             if (context.IsPatchEligible(levelIndex, faceIndex)) {
+                if (context.IsPatchRegular(levelIndex, faceIndex)) {
+                    faceType = FACE_REGULAR;
+                } else if (countBoundaryPatches &&
+                           level.getFaceCompositeVTag(faceIndex)._boundary) {
+                    faceType = FACE_IRREGULAR_BOUNDARY;
+                } else {
+                    faceType = FACE_IRREGULAR;
+                }
+            }
+            faceTypes[faceIndex] = faceType;
+        }
+
+        for (int faceIndex = 0; faceIndex < level.getNumFaces(); ++faceIndex) {
+
+            if (faceTypes[faceIndex] != FACE_NO_PATCH) {
 
                 context.patches.push_back(BuilderContext::PatchTuple(faceIndex, levelIndex));
+                context.patchIsRegular.push_back(faceTypes[faceIndex] == FACE_REGULAR);
 
                 // Count the patches here to simplify subsequent allocation.
-                if (context.IsPatchRegular(levelIndex, faceIndex)) {
+                if (faceTypes[faceIndex] == FACE_REGULAR) {
                     ++context.numRegularPatches;
                 } else {
                     ++context.numIrregularPatches;
 
                     // For legacy gregory patches we need to know how many
                     // irregular patches are also boundary patches.
-                    if (context.options.GetEndCapType() == Options::ENDCAP_LEGACY_GREGORY) {
-                        bool isBoundaryPatch = level.getFaceCompositeVTag(faceIndex)._boundary;
-                        context.numIrregularBoundaryPatches += isBoundaryPatch;
-                    }
+                    context.numIrregularBoundaryPatches +=
+                        (faceTypes[faceIndex] == FACE_IRREGULAR_BOUNDARY);
                 }
             }
         }
@@ -1239,18 +1392,27 @@ PatchTableFactory::populateAdaptivePatches(
 
     TopologyRefiner const & refiner = context.refiner;
 
+    //  End-caps are not supported for Loop -- its irregular patches are
+    //  instead approximated by their linear triangles:
+    bool isLoop = (refiner.GetSchemeType() == Sdc::SCHEME_LOOP);
+
+    Options::EndCapType endCapType =
+        isLoop ? Options::ENDCAP_NONE : context.options.GetEndCapType();
+
     // State needed to populate an array in the patch table.
     // Pointers in this structure are initialized after the patch array
-    // data buffers have been allocated and are then incremented as we
-    // populate data into the patch table. Currently, we'll have at
-    // most 3 patch arrays: Regular, Irregular, and IrregularBoundary.
+    // data buffers have been allocated and are then offset by the index
+    // of each patch within its array as we populate data into the patch
+    // table. Currently, we'll have at most 3 patch arrays: Regular,
+    // Irregular, and IrregularBoundary.
     struct PatchArrayBuilder {
         PatchArrayBuilder()
-            : patchType(PatchDescriptor::REGULAR), numPatches(0)
+            : patchType(PatchDescriptor::REGULAR), numPatches(0), numPatchVerts(0)
             , iptr(NULL), pptr(NULL), sptr(NULL) { }
 
         PatchDescriptor::Type patchType;
         int numPatches;
+        int numPatchVerts;
 
         Far::Index *iptr;
         Far::PatchParam *pptr;
@@ -1267,11 +1429,19 @@ PatchTableFactory::populateAdaptivePatches(
     int R = 0, IR = 1, IRB = 2; // Regular, Irregular, IrregularBoundary
 
     // Regular patches patches will be packed into the first patch array
-    arrayBuilders[R].patchType = PatchDescriptor::REGULAR;
+    arrayBuilders[R].patchType = isLoop ? PatchDescriptor::LOOP : PatchDescriptor::REGULAR;
     arrayBuilders[R].numPatches = context.numRegularPatches;
     int numPatchArrays = (arrayBuilders[R].numPatches > 0);
 
-    switch(context.options.GetEndCapType()) {
+    if (isLoop) {
+        // Irregular triangles will be packed into an additional patch array
+        IR = IRB = numPatchArrays;
+        arrayBuilders[IR].patchType = PatchDescriptor::TRIANGLES;
+        arrayBuilders[IR].numPatches = context.numIrregularPatches;
+        numPatchArrays += (arrayBuilders[IR].numPatches > 0);
+    }
+
+    switch(endCapType) {
     case Options::ENDCAP_BSPLINE_BASIS:
         // Irregular patches are converted to bspline basis and
         // will be packed into the same patch array as regular patches
@@ -1329,6 +1499,8 @@ PatchTableFactory::populateAdaptivePatches(
     for (int arrayIndex=0; arrayIndex<numPatchArrays; ++arrayIndex) {
         PatchArrayBuilder & arrayBuilder = arrayBuilders[arrayIndex];
 
+        arrayBuilder.numPatchVerts =
+            table->GetPatchArrayDescriptor(arrayIndex).GetNumControlVertices();
         arrayBuilder.iptr = table->getPatchArrayVertices(arrayIndex).begin();
         arrayBuilder.pptr = table->getPatchParams(arrayIndex).begin();
         if (hasSharpness) {
@@ -1364,7 +1536,7 @@ PatchTableFactory::populateAdaptivePatches(
     StencilTable *localPointVaryingStencils = NULL;
     Vtr::internal::StackBuffer<StencilTable*,1> localPointFVarStencils;
 
-    switch(context.options.GetEndCapType()) {
+    switch(endCapType) {
     case Options::ENDCAP_GREGORY_BASIS:
         localPointStencils = new StencilTable(0);
         localPointVaryingStencils = new StencilTable(0);
@@ -1372,7 +1544,8 @@ PatchTableFactory::populateAdaptivePatches(
             refiner,
             localPointStencils,
             localPointVaryingStencils,
-            context.options.shareEndCapPatchPoints);
+            context.options.shareEndCapPatchPoints,
+            context.options.useThreads);
         break;
     case Options::ENDCAP_BSPLINE_BASIS:
         localPointStencils = new StencilTable(0);
@@ -1395,14 +1568,17 @@ PatchTableFactory::populateAdaptivePatches(
         localPointFVarStencils.SetSize((int)context.fvarChannelIndices.size());
 
         for (int fvc=0; fvc<(int)context.fvarChannelIndices.size(); ++fvc) {
-            switch(context.options.GetEndCapType()) {
+            localPointFVarStencils[fvc] = NULL;
+
+            switch(endCapType) {
             case Options::ENDCAP_GREGORY_BASIS:
                 localPointFVarStencils[fvc] = new StencilTable(0);
                 fvarEndCapGregoryBasis[fvc] = new EndCapGregoryBasisPatchFactory(
                     refiner,
                     localPointFVarStencils[fvc],
                     NULL,
-                    context.options.shareEndCapPatchPoints);
+                    context.options.shareEndCapPatchPoints,
+                    context.options.useThreads);
                 break;
             case Options::ENDCAP_BSPLINE_BASIS:
                 localPointFVarStencils[fvc] = new StencilTable(0);
@@ -1417,193 +1593,263 @@ PatchTableFactory::populateAdaptivePatches(
         }
     }
 
-    // Populate patch data buffers
-    for (int patchIndex=0; patchIndex<(int)context.patches.size(); ++patchIndex) {
+    //  Identify the array of each patch and its offset within it, so that
+    //  patches no longer depend on those preceding them when populated:
+    int numPatches = (int)context.patches.size();
+
+    std::vector<unsigned char> patchArrays(numPatches);
+    std::vector<int>           patchArrayOffsets(numPatches);
+
+    bool isLegacyGregory = (endCapType == Options::ENDCAP_LEGACY_GREGORY);
+
+    int arrayPatchCounts[3] = { 0, 0, 0 };
+    for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
 
         BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
 
-        Level const & level = refiner.getLevel(patch.levelIndex);
+        int arrayIndex = R;
+        if (! context.patchIsRegular[patchIndex]) {
+            // For legacy gregory patches we may need to switch to
+            // the irregular boundary patch array.
+            bool isBoundary = isLegacyGregory && refiner.getLevel(patch.levelIndex).
+                                  getFaceCompositeVTag(patch.faceIndex)._boundary;
+            arrayIndex = isBoundary ? IRB : IR;
+        }
+        patchArrays[patchIndex] = (unsigned char) arrayIndex;
+        patchArrayOffsets[patchIndex] = arrayPatchCounts[arrayIndex]++;
+    }
+
+    //  Sharpness indices depend on the order of the patches, so they are
+    //  assigned once all sharpness values have been determined:
+    std::vector<float> patchSharpness(hasSharpness ? numPatches : 0);
+
+    //  When threaded, patches requiring an end-cap factory -- for either the
+    //  vertex patch or any of its face-varying patches -- are populated after
+    //  all others and in order, as the factories accumulate state:
+    bool useThreads = context.options.useThreads;
+
+    std::vector<unsigned char> patchUsesEndCaps(useThreads ? numPatches : 0);
+    if (useThreads) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for
+#endif
+        for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+
+            BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
+
+            bool usesEndCaps = (context.patchIsRegular[patchIndex] == 0) &&
+                               (endCapType != Options::ENDCAP_NONE);
+            for (int fvc=0; !usesEndCaps && fvc<(int)context.fvarChannelIndices.size(); ++fvc) {
+                PatchDescriptor::Type fvarType = table->GetFVarPatchDescriptor(fvc).GetType();
+
+                usesEndCaps =
+                    (fvarType != PatchDescriptor::QUADS) &&
+                    (fvarType != PatchDescriptor::TRIANGLES) &&
+                    !context.DoesFaceVaryingPatchMatch(patch.levelIndex, patch.faceIndex, fvc) &&
+                    !context.IsPatchRegular(patch.levelIndex, patch.faceIndex, fvc);
+            }
+            patchUsesEndCaps[patchIndex] = usesEndCaps;
+        }
+    }
+
+    // Populate patch data buffers -- all patches in a single serial pass, or
+    // concurrently followed by those requiring end-caps when threaded
+    for (int pass=0; pass<(useThreads ? 2 : 1); ++pass) {
+
+        bool concurrentPass = useThreads && (pass == 0);
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (concurrentPass)
+#endif
+        for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+
+            if (useThreads && ((patchUsesEndCaps[patchIndex] != 0) == concurrentPass)) {
+                continue;
+            }
+
+            BuilderContext::PatchTuple const & patch = context.patches[patchIndex];
 
-        Level::VTag faceVTags = level.getFaceCompositeVTag(patch.faceIndex);
+            Level const & level = refiner.getLevel(patch.levelIndex);
 
-        PatchArrayBuilder * arrayBuilder = 0;
+            Level::VTag faceVTags = level.getFaceCompositeVTag(patch.faceIndex);
 
-        // Properties to potentially be shared across vertex and face-varying patches:
-        int          regBoundaryMask = 0;
-        bool         isRegSingleCrease = false;
-        Level::VSpan irregCornerSpans[4];
-        float        sharpness = 0.0f;
+            PatchArrayBuilder * arrayBuilder = &arrayBuilders[patchArrays[patchIndex]];
 
-        bool isRegular = context.IsPatchRegular(patch.levelIndex, patch.faceIndex);
-        if (isRegular) {
-            // Build the regular patch array
-            arrayBuilder = &arrayBuilders[R];
+            int     arrayOffset = patchArrayOffsets[patchIndex];
+            Index * iptr = arrayBuilder->iptr + arrayOffset * arrayBuilder->numPatchVerts;
 
-            regBoundaryMask = context.GetRegularPatchBoundaryMask(patch.levelIndex, patch.faceIndex);
+            // Properties to potentially be shared across vertex and face-varying patches:
+            int          regBoundaryMask = 0;
+            bool         isRegSingleCrease = false;
+            Level::VSpan irregCornerSpans[4];
+            float        sharpness = 0.0f;
 
-            // Test regular interior patches for a single-crease patch when specified:
-            if (hasSharpness && (regBoundaryMask == 0) && (faceVTags._semiSharpEdges ||
-                                                           faceVTags._infSharpEdges)) {
-                float edgeSharpness = 0.0f;
-                int   edgeInFace = 0;
-                if (level.isSingleCreasePatch(patch.faceIndex, &edgeSharpness, &edgeInFace)) {
-                    // cap sharpness to the max isolation level
-                    edgeSharpness = std::min(edgeSharpness,
-                        float(context.options.maxIsolationLevel - patch.levelIndex));
+            bool isRegular = (context.patchIsRegular[patchIndex] != 0);
+            if (isRegular) {
+                regBoundaryMask = context.GetRegularPatchBoundaryMask(patch.levelIndex, patch.faceIndex);
 
-                    if (edgeSharpness > 0.0f) {
-                        isRegSingleCrease = true;
-                        regBoundaryMask = (1 << edgeInFace);
-                        sharpness = edgeSharpness;
+                // Test regular interior patches for a single-crease patch when specified:
+                if (hasSharpness && !isLoop && (regBoundaryMask == 0) &&
+                        (faceVTags._semiSharpEdges || faceVTags._infSharpEdges)) {
+                    float edgeSharpness = 0.0f;
+                    int   edgeInFace = 0;
+                    if (level.isSingleCreasePatch(patch.faceIndex, &edgeSharpness, &edgeInFace)) {
+                        // cap sharpness to the max isolation level
+                        edgeSharpness = std::min(edgeSharpness,
+                            float(context.options.maxIsolationLevel - patch.levelIndex));
+
+                        if (edgeSharpness > 0.0f) {
+                            isRegSingleCrease = true;
+                            regBoundaryMask = (1 << edgeInFace);
+                            sharpness = edgeSharpness;
+                        }
                     }
                 }
-            }
             
-            //  The single-crease patch is an interior patch so ignore boundary mask when gathering:
-            if (isRegSingleCrease) {
-                arrayBuilder->iptr +=
-                    context.GatherRegularPatchPoints(arrayBuilder->iptr, patch, 0);
+                //  The single-crease patch is an interior patch so ignore boundary mask when gathering:
+                if (isRegSingleCrease) {
+                    context.GatherRegularPatchPoints(iptr, patch, 0);
+                } else {
+                    context.GatherRegularPatchPoints(iptr, patch, regBoundaryMask);
+                }
+            } else if (isLoop) {
+                context.GatherLinearPatchPoints(iptr, patch);
             } else {
-                arrayBuilder->iptr +=
-                    context.GatherRegularPatchPoints(arrayBuilder->iptr, patch, regBoundaryMask);
-            }
-        } else {
-            // Build the irregular patch array
-            arrayBuilder = &arrayBuilders[IR];
+                context.GetIrregularPatchCornerSpans(patch.levelIndex, patch.faceIndex, irregCornerSpans);
 
-            context.GetIrregularPatchCornerSpans(patch.levelIndex, patch.faceIndex, irregCornerSpans);
-
-            // switch endcap patch type by option
-            switch(context.options.GetEndCapType()) {
-            case Options::ENDCAP_GREGORY_BASIS:
-                arrayBuilder->iptr +=
+                // switch endcap patch type by option
+                switch(endCapType) {
+                case Options::ENDCAP_GREGORY_BASIS:
                     context.GatherIrregularPatchPoints(
-                        endCapGregoryBasis, arrayBuilder->iptr, patch, irregCornerSpans);
-                break;
-            case Options::ENDCAP_BSPLINE_BASIS:
-                arrayBuilder->iptr +=
+                        endCapGregoryBasis, iptr, patch, irregCornerSpans);
+                    break;
+                case Options::ENDCAP_BSPLINE_BASIS:
                     context.GatherIrregularPatchPoints(
-                        endCapBSpline, arrayBuilder->iptr, patch, irregCornerSpans);
-                break;
-            case Options::ENDCAP_LEGACY_GREGORY:
-                // For legacy gregory patches we may need to switch to
-                // the irregular boundary patch array.
-                if (!faceVTags._boundary) {
-                    arrayBuilder->iptr +=
-                        context.GatherIrregularPatchPoints(
-                            endCapLegacyGregory, arrayBuilder->iptr, patch, irregCornerSpans);
-                } else {
-                    arrayBuilder = &arrayBuilders[IRB];
-                    arrayBuilder->iptr +=
-                        context.GatherIrregularPatchPoints(
-                            endCapLegacyGregory, arrayBuilder->iptr, patch, irregCornerSpans);
+                        endCapBSpline, iptr, patch, irregCornerSpans);
+                    break;
+                case Options::ENDCAP_LEGACY_GREGORY:
+                    // The array of legacy gregory patches (interior or
+                    // boundary) was already identified
+                    context.GatherIrregularPatchPoints(
+                        endCapLegacyGregory, iptr, patch, irregCornerSpans);
+                    break;
+                case Options::ENDCAP_BILINEAR_BASIS:
+                    // not implemented yet
+                    assert(false);
+                    break;
+                default:
+                    // no endcap
+                    break;
                 }
-                break;
-            case Options::ENDCAP_BILINEAR_BASIS:
-                // not implemented yet
-                assert(false);
-                break;
-            default:
-                // no endcap
-                break;
             }
-        }
 
-        // Assign the patch param (why is transition mask 0 if not regular?)
-        int paramBoundaryMask = regBoundaryMask;
-        int paramTransitionMask = isRegular ?
-                context.GetTransitionMask(patch.levelIndex, patch.faceIndex) : 0;
+            // Assign the patch param (why is transition mask 0 if not regular?)
+            int paramBoundaryMask = regBoundaryMask;
+            int paramTransitionMask = isRegular ?
+                    context.GetTransitionMask(patch.levelIndex, patch.faceIndex) : 0;
 
-        PatchParam patchParam =
-            computePatchParam(context,
-                              patch.levelIndex, patch.faceIndex,
-                              paramBoundaryMask, paramTransitionMask);
-        *arrayBuilder->pptr++ = patchParam;
+            PatchParam patchParam =
+                computePatchParam(context,
+                                  patch.levelIndex, patch.faceIndex,
+                                  paramBoundaryMask, paramTransitionMask);
+            arrayBuilder->pptr[arrayOffset] = patchParam;
 
-        if (hasSharpness) {
-            *arrayBuilder->sptr++ =
-                assignSharpnessIndex(sharpness, table->_sharpnessValues);
-        }
-
-        if (context.RequiresFVarPatches()) {
-            for (int fvc=0; fvc<(int)context.fvarChannelIndices.size(); ++fvc) {
-
-                BuilderContext::PatchTuple fvarPatch(patch);
-
-                PatchDescriptor desc = table->GetFVarPatchDescriptor(fvc);
+            if (hasSharpness) {
+                patchSharpness[patchIndex] = sharpness;
+            }
 
-                PatchParam fvarPatchParam = patchParam;
+            if (context.RequiresFVarPatches()) {
+                for (int fvc=0; fvc<(int)context.fvarChannelIndices.size(); ++fvc) {
 
-                // Deal with the linear cases trivially first
-                if (desc.GetType() == PatchDescriptor::QUADS) {
-                    arrayBuilder->fptr[fvc] +=
-                        context.GatherLinearPatchPoints(
-                            arrayBuilder->fptr[fvc], fvarPatch, fvc);
-                    *arrayBuilder->fpptr[fvc]++ = fvarPatchParam;
-                    continue;
-                }
+                    BuilderContext::PatchTuple fvarPatch(patch);
 
-                // For non-linear patches, reuse patch information when the topology
-                // of the face in face-varying space matches the original patch:
-                //
-                bool fvarTopologyMatches = context.DoesFaceVaryingPatchMatch(
-                        patch.levelIndex, patch.faceIndex, fvc);
+                    PatchDescriptor desc = table->GetFVarPatchDescriptor(fvc);
 
-                bool fvarIsRegular = fvarTopologyMatches ? isRegular :
-                        context.IsPatchRegular(patch.levelIndex, patch.faceIndex, fvc);
+                    PatchParam fvarPatchParam = patchParam;
 
-                int fvarBoundaryMask = 0;
-                if (fvarIsRegular) {
-                    fvarBoundaryMask = fvarTopologyMatches ? regBoundaryMask :
-                        context.GetRegularPatchBoundaryMask(patch.levelIndex, patch.faceIndex, fvc);
+                    Index *      fptr = arrayBuilder->fptr[fvc]
+                                      + arrayOffset * desc.GetNumControlVertices();
+                    PatchParam * fpptr = arrayBuilder->fpptr[fvc] + arrayOffset;
 
-                    if (isRegSingleCrease && fvarTopologyMatches) {
-                        context.GatherRegularPatchPoints(
-                                arrayBuilder->fptr[fvc], fvarPatch, 0, fvc);
-                    } else {
-                        context.GatherRegularPatchPoints(
-                                arrayBuilder->fptr[fvc], fvarPatch, fvarBoundaryMask, fvc);
-                    }
-                } else {
-                    Level::VSpan  localCornerSpans[4];
-                    Level::VSpan* fvarCornerSpans = localCornerSpans;
-                    if (fvarTopologyMatches) {
-                        fvarCornerSpans = irregCornerSpans;
-                    } else {
-                        context.GetIrregularPatchCornerSpans(
-                                patch.levelIndex, patch.faceIndex, fvarCornerSpans, fvc);
+                    // Deal with the linear cases trivially first
+                    if ((desc.GetType() == PatchDescriptor::QUADS) ||
+                        (desc.GetType() == PatchDescriptor::TRIANGLES)) {
+                        context.GatherLinearPatchPoints(fptr, fvarPatch, fvc);
+                        *fpptr = fvarPatchParam;
+                        continue;
                     }
 
-                    if (desc.GetType() == PatchDescriptor::REGULAR) {
-                        context.GatherIrregularPatchPoints(
-                                fvarEndCapBSpline[fvc],
-                                arrayBuilder->fptr[fvc], fvarPatch, fvarCornerSpans, fvc);
-                    } else if (desc.GetType() == PatchDescriptor::GREGORY_BASIS) {
-                        context.GatherIrregularPatchPoints(
-                                fvarEndCapGregoryBasis[fvc],
-                                arrayBuilder->fptr[fvc], fvarPatch, fvarCornerSpans, fvc);
+                    // For non-linear patches, reuse patch information when the topology
+                    // of the face in face-varying space matches the original patch:
+                    //
+                    bool fvarTopologyMatches = context.DoesFaceVaryingPatchMatch(
+                            patch.levelIndex, patch.faceIndex, fvc);
+
+                    bool fvarIsRegular = fvarTopologyMatches ? isRegular :
+                            context.IsPatchRegular(patch.levelIndex, patch.faceIndex, fvc);
+
+                    int fvarBoundaryMask = 0;
+                    if (fvarIsRegular) {
+                        fvarBoundaryMask = fvarTopologyMatches ? regBoundaryMask :
+                            context.GetRegularPatchBoundaryMask(patch.levelIndex, patch.faceIndex, fvc);
+
+                        if (isRegSingleCrease && fvarTopologyMatches) {
+                            context.GatherRegularPatchPoints(
+                                    fptr, fvarPatch, 0, fvc);
+                        } else {
+                            context.GatherRegularPatchPoints(
+                                    fptr, fvarPatch, fvarBoundaryMask, fvc);
+                        }
                     } else {
-                        assert("Unknown Descriptor for FVar patch" == 0);
+                        Level::VSpan  localCornerSpans[4];
+                        Level::VSpan* fvarCornerSpans = localCornerSpans;
+                        if (fvarTopologyMatches) {
+                            fvarCornerSpans = irregCornerSpans;
+                        } else {
+                            context.GetIrregularPatchCornerSpans(
+                                    patch.levelIndex, patch.faceIndex, fvarCornerSpans, fvc);
+                        }
+
+                        if (desc.GetType() == PatchDescriptor::REGULAR) {
+                            context.GatherIrregularPatchPoints(
+                                    fvarEndCapBSpline[fvc],
+                                    fptr, fvarPatch, fvarCornerSpans, fvc);
+                        } else if (desc.GetType() == PatchDescriptor::GREGORY_BASIS) {
+                            context.GatherIrregularPatchPoints(
+                                    fvarEndCapGregoryBasis[fvc],
+                                    fptr, fvarPatch, fvarCornerSpans, fvc);
+                        } else {
+                            assert("Unknown Descriptor for FVar patch" == 0);
+                        }
                     }
+
+                    fvarPatchParam.Set(
+                        patchParam.GetFaceId(),
+                        patchParam.GetU(), patchParam.GetV(),
+                        patchParam.GetDepth(),
+                        patchParam.NonQuadRoot(),
+                        (fvarIsRegular ? fvarBoundaryMask : 0),
+                        patchParam.GetTransition(),
+                        fvarIsRegular);
+                    *fpptr = fvarPatchParam;
                 }
-                arrayBuilder->fptr[fvc] += desc.GetNumControlVertices();
-
-                fvarPatchParam.Set(
-                    patchParam.GetFaceId(),
-                    patchParam.GetU(), patchParam.GetV(),
-                    patchParam.GetDepth(),
-                    patchParam.NonQuadRoot(),
-                    (fvarIsRegular ? fvarBoundaryMask : 0),
-                    patchParam.GetTransition(),
-                    fvarIsRegular);
-                *arrayBuilder->fpptr[fvc]++ = fvarPatchParam;
             }
         }
     }
 
+    if (hasSharpness) {
+        for (int patchIndex=0; patchIndex<numPatches; ++patchIndex) {
+            arrayBuilders[patchArrays[patchIndex]].sptr[patchArrayOffsets[patchIndex]] =
+                assignSharpnessIndex(patchSharpness[patchIndex], table->_sharpnessValues);
+        }
+    }
+
     table->populateVaryingVertices();
 
     // finalize end patches
+    if (endCapGregoryBasis) {
+        endCapGregoryBasis->Finalize();
+    }
     if (localPointStencils && localPointStencils->GetNumStencils() > 0) {
         localPointStencils->finalize();
     } else {
@@ -1618,7 +1864,7 @@ PatchTableFactory::populateAdaptivePatches(
         localPointVaryingStencils = NULL;
     }
 
-    switch(context.options.GetEndCapType()) {
+    switch(endCapType) {
     case Options::ENDCAP_GREGORY_BASIS:
         table->_localPointStencils = localPointStencils;
         table->_localPointVaryingStencils = localPointVaryingStencils;
@@ -1645,14 +1891,18 @@ PatchTableFactory::populateAdaptivePatches(
                                         context.fvarChannelIndices.size());
 
         for (int fvc=0; fvc<(int)context.fvarChannelIndices.size(); ++fvc) {
-            if (localPointFVarStencils[fvc]->GetNumStencils() > 0) {
+            if (endCapType == Options::ENDCAP_GREGORY_BASIS) {
+                fvarEndCapGregoryBasis[fvc]->Finalize();
+            }
+            if (localPointFVarStencils[fvc] &&
+                localPointFVarStencils[fvc]->GetNumStencils() > 0) {
                 localPointFVarStencils[fvc]->finalize();
             } else {
                 delete localPointFVarStencils[fvc];
                 localPointFVarStencils[fvc] = NULL;
             }
 
-            switch(context.options.GetEndCapType()) {
+            switch(endCapType) {
             case Options::ENDCAP_GREGORY_BASIS:
                 delete fvarEndCapGregoryBasis[fvc];
                 break;
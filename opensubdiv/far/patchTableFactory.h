@@ -66,6 +66,7 @@ public:
              generateFVarTables(false),
              generateFVarLegacyLinearPatches(true),
              generateLegacySharpCornerPatches(true),
+             useThreads(false),
              numFVarChannels(-1),
              fvarChannelIndices(0)
         { }
@@ -92,7 +93,11 @@ public:
 
                      // legacy behaviors (default to true)
                      generateFVarLegacyLinearPatches  : 1, ///< Generate all linear face-varying patches (legacy)
-                     generateLegacySharpCornerPatches : 1; ///< Generate sharp regular patches at smooth corners (legacy)
+                     generateLegacySharpCornerPatches : 1, ///< Generate sharp regular patches at smooth corners (legacy)
+
+                     // threading
+                     useThreads : 1; ///< Identify and populate adaptive patches concurrently
+                                     ///< (requires OpenMP, the result is unchanged)
 
         int          numFVarChannels;          ///< Number of channel indices and interpolation modes passed
         int const *  fvarChannelIndices;       ///< List containing the indices of the channels selected for the factory
@@ -118,6 +123,11 @@ public:
     ///  the base level in addition to the last level while indices for face-varying
     ///  patches include only the last level.
     ///
+    ///  For adaptively refined Loop meshes, regular triangles are represented
+    ///  by quartic box-spline patches (LOOP) while irregular triangles remain
+    ///  linear (TRIANGLES) in place of end-caps, and face-varying patches are
+    ///  linear.
+    ///
     /// @param refiner              TopologyRefiner from which to generate patches
     ///
     /// @param options              Options controlling the creation of the table
@@ -0,0 +1,654 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/serializer.h"
+#include "../far/error.h"
+#include "../far/patchTable.h"
+#include "../far/stencilTable.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#if ! defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+//
+// Record layout :
+//
+//   header   : magic, byte order mark, format version, record type and size
+//              of the payload (64 bits), as 32 bit words
+//
+//   payload  : sequence of 32 bit scalars and of arrays. Arrays store their
+//              number of elements and the size of an element, followed by
+//              the elements, 8 byte aligned (relative to the record).
+//
+// All the elements are made of 32 bit words (ints, floats, PatchParams...),
+// which are swapped when the byte order mark does not match the host's.
+//
+namespace {
+
+    unsigned int const RECORD_MAGIC = 0x5444534f;  // "OSDT" in little endian
+    unsigned int const BYTE_ORDER_MARK = 0x01020304;
+
+    enum RecordType {
+        RECORD_STENCIL_TABLE = 1,
+        RECORD_LIMIT_STENCIL_TABLE,
+        RECORD_PATCH_TABLE
+    };
+
+    size_t const HEADER_SIZE = 6 * sizeof(unsigned int);
+
+    inline unsigned int swapWord(unsigned int w) {
+        return (w >> 24) | ((w >> 8) & 0xff00) |
+               ((w << 8) & 0xff0000) | (w << 24);
+    }
+
+    // Note : the weight arrays of some tables have excess elements
+    inline bool isValidWeightArray(std::vector<float> const & weights,
+                                   std::vector<Index> const & indices) {
+        return weights.size() >= indices.size();
+    }
+}
+
+//
+// Writer : appends a record to a byte vector
+//
+class Serializer::Writer {
+
+public:
+
+    Writer(std::vector<unsigned char> & data, RecordType type) :
+        _data(data), _start(data.size()) {
+
+        writeWord(RECORD_MAGIC);
+        writeWord(BYTE_ORDER_MARK);
+        writeWord(FORMAT_VERSION);
+        writeWord(type);
+        writeWord(0);
+        writeWord(0);
+    }
+
+    // Patches the size of the payload in the header
+    void Finish() {
+        unsigned long long size =
+            (unsigned long long)(_data.size() - _start - HEADER_SIZE);
+        unsigned int words[2] = { (unsigned int)(size & 0xffffffff),
+                                  (unsigned int)(size >> 32) };
+        memcpy(&_data[_start + 4*sizeof(unsigned int)], words, sizeof(words));
+    }
+
+    void WriteInt(int value) {
+        writeWord((unsigned int)value);
+    }
+
+    template <typename T>
+    void WriteArray(T const * elements, int numElements) {
+
+        // 8 byte alignment of the elements
+        while (((_data.size() - _start) & 7) != 0) {
+            _data.push_back(0);
+        }
+        writeWord((unsigned int)numElements);
+        writeWord((unsigned int)sizeof(T));
+        if (numElements > 0) {
+            size_t offset = _data.size();
+            _data.resize(offset + numElements * sizeof(T));
+            memcpy(&_data[offset], elements, numElements * sizeof(T));
+        }
+    }
+
+    template <typename T>
+    void WriteArray(std::vector<T> const & elements) {
+        WriteArray(elements.empty() ? (T const *)0 : &elements[0],
+                   (int)elements.size());
+    }
+
+private:
+
+    void writeWord(unsigned int w) {
+        unsigned char const * bytes = (unsigned char const *)&w;
+        _data.insert(_data.end(), bytes, bytes + sizeof(w));
+    }
+
+    std::vector<unsigned char> & _data;
+    size_t _start;
+};
+
+//
+// Reader : validates the header of a record and reads its payload
+//
+class Serializer::Reader {
+
+public:
+
+    Reader(void const * data, size_t size, RecordType type) :
+        _data((unsigned char const *)data), _size(size), _offset(0),
+        _swap(false), _failed(false) {
+
+        if (! data || size < HEADER_SIZE) {
+            _failed = true;
+            return;
+        }
+
+        unsigned int magic = ReadWord();
+        if (magic != RECORD_MAGIC) {
+            // record written with the opposite byte order
+            _swap = (swapWord(magic) == RECORD_MAGIC);
+            _failed = ! _swap;
+        }
+
+        unsigned int mark = ReadWord(),
+                     version = ReadWord(),
+                     recordType = ReadWord(),
+                     sizeLow = ReadWord(),
+                     sizeHigh = ReadWord();
+        unsigned long long payloadSize =
+            (unsigned long long)sizeLow | ((unsigned long long)sizeHigh << 32);
+
+        if (_failed || mark != BYTE_ORDER_MARK ||
+            version != (unsigned int)FORMAT_VERSION ||
+            recordType != (unsigned int)type ||
+            payloadSize > (unsigned long long)(size - HEADER_SIZE)) {
+            _failed = true;
+            return;
+        }
+        _size = HEADER_SIZE + (size_t)payloadSize;
+    }
+
+    bool Failed() const { return _failed; }
+
+    unsigned int ReadWord() {
+        unsigned int w = 0;
+        if (_failed || _offset + sizeof(w) > _size) {
+            _failed = true;
+        } else {
+            memcpy(&w, _data + _offset, sizeof(w));
+            _offset += sizeof(w);
+        }
+        return _swap ? swapWord(w) : w;
+    }
+
+    int ReadInt() {
+        return (int)ReadWord();
+    }
+
+    template <typename T>
+    bool ReadArray(T * elements, int numElements) {
+
+        _offset = (_offset + 7) & ~(size_t)7;
+
+        unsigned int n = ReadWord(),
+                     elementSize = ReadWord();
+        if (_failed || n != (unsigned int)numElements ||
+            elementSize != sizeof(T) || n > (_size - _offset) / sizeof(T)) {
+            _failed = true;
+            return false;
+        }
+        // single copy from the record
+        size_t numBytes = n * sizeof(T);
+        if (n > 0) {
+            memcpy(elements, _data + _offset, numBytes);
+            if (_swap) {
+                unsigned int * words = (unsigned int *)elements;
+                for (size_t i = 0; i < numBytes / sizeof(unsigned int); ++i) {
+                    words[i] = swapWord(words[i]);
+                }
+            }
+        }
+        _offset += numBytes;
+        return true;
+    }
+
+    template <typename T>
+    bool ReadArray(std::vector<T> & elements) {
+
+        // peek at the size of the array to allocate the vector
+        size_t offset = (_offset + 7) & ~(size_t)7;
+        if (_failed || offset + sizeof(unsigned int) > _size) {
+            _failed = true;
+            return false;
+        }
+        unsigned int n;
+        memcpy(&n, _data + offset, sizeof(n));
+        if (_swap) {
+            n = swapWord(n);
+        }
+        if (n > (_size - offset) / sizeof(T)) {
+            _failed = true;
+            return false;
+        }
+        elements.resize(n);
+        return ReadArray(elements.empty() ? (T *)0 : &elements[0], (int)n);
+    }
+
+private:
+
+    unsigned char const * _data;
+    size_t _size,
+           _offset;
+    bool _swap,
+         _failed;
+};
+
+//
+// Stencil tables
+//
+void
+Serializer::writeStencils(Writer & writer,
+                          StencilTableReal<float> const & table) {
+
+    writer.WriteInt(table.GetNumControlVertices());
+    writer.WriteArray(table.GetSizes());
+    writer.WriteArray(table.GetOffsets());
+    writer.WriteArray(table.GetControlIndices());
+    writer.WriteArray(table.GetWeights());
+    writer.WriteArray(table.GetLevelOffsets());
+    writer.WriteArray(table.GetLevelSourceOffsets());
+}
+
+bool
+Serializer::readStencils(Reader & reader, StencilTableReal<float> & table) {
+
+    table._numControlVertices = reader.ReadInt();
+    reader.ReadArray(table._sizes);
+    reader.ReadArray(table._offsets);
+    reader.ReadArray(table._indices);
+    reader.ReadArray(table._weights);
+    reader.ReadArray(table._levelOffsets);
+    reader.ReadArray(table._levelSourceOffsets);
+
+    return ! reader.Failed() &&
+        (table._offsets.empty() ||
+            table._offsets.size() == table._sizes.size()) &&
+        (table._levelOffsets.empty() ?
+            table._levelSourceOffsets.empty() :
+            (table._levelOffsets.back() == (Index)table._sizes.size() &&
+             table._levelSourceOffsets.size() + 1 ==
+                table._levelOffsets.size())) &&
+        isValidWeightArray(table._weights, table._indices);
+}
+
+void
+Serializer::writeOptionalStencils(Writer & writer,
+                                  StencilTable const * table) {
+    writer.WriteInt(table ? 1 : 0);
+    if (table) {
+        writeStencils(writer, *table);
+    }
+}
+
+bool
+Serializer::readOptionalStencils(Reader & reader,
+                                 StencilTable const ** table) {
+    *table = 0;
+    if (reader.ReadInt() == 0) {
+        return ! reader.Failed();
+    }
+    StencilTable * stencils = new StencilTable(0);
+    *table = stencils;
+    return readStencils(reader, *stencils);
+}
+
+void
+Serializer::WriteStencilTable(StencilTable const & table,
+                              std::vector<unsigned char> & data) {
+
+    Writer writer(data, RECORD_STENCIL_TABLE);
+    writeStencils(writer, table);
+    writer.Finish();
+}
+
+StencilTable const *
+Serializer::ReadStencilTable(void const * data, size_t size) {
+
+    Reader reader(data, size, RECORD_STENCIL_TABLE);
+
+    StencilTable * table = new StencilTable(0);
+    if (reader.Failed() || ! readStencils(reader, *table)) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in Serializer::ReadStencilTable() -- invalid record");
+        delete table;
+        return 0;
+    }
+    return table;
+}
+
+//
+// LimitStencilTable
+//
+void
+Serializer::WriteLimitStencilTable(LimitStencilTable const & table,
+                                   std::vector<unsigned char> & data) {
+
+    Writer writer(data, RECORD_LIMIT_STENCIL_TABLE);
+    writeStencils(writer, table);
+    writer.WriteArray(table.GetDuWeights());
+    writer.WriteArray(table.GetDvWeights());
+    writer.WriteArray(table.GetDuuWeights());
+    writer.WriteArray(table.GetDuvWeights());
+    writer.WriteArray(table.GetDvvWeights());
+    writer.Finish();
+}
+
+LimitStencilTable const *
+Serializer::ReadLimitStencilTable(void const * data, size_t size) {
+
+    Reader reader(data, size, RECORD_LIMIT_STENCIL_TABLE);
+
+    std::vector<int> empty;
+    std::vector<float> emptyWeights;
+    LimitStencilTable * table = new LimitStencilTable(0,
+        empty, empty, empty, emptyWeights, emptyWeights, emptyWeights,
+        emptyWeights, emptyWeights, emptyWeights, true, 0);
+
+    bool valid = ! reader.Failed() && readStencils(reader, *table);
+    if (valid) {
+        std::vector<float> * derivatives[5] = {
+            &table->_duWeights, &table->_dvWeights,
+            &table->_duuWeights, &table->_duvWeights, &table->_dvvWeights };
+
+        for (int i = 0; valid && i < 5; ++i) {
+            valid = reader.ReadArray(*derivatives[i]) &&
+                (derivatives[i]->empty() ||
+                    isValidWeightArray(*derivatives[i], table->_indices));
+        }
+    }
+    if (! valid) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in Serializer::ReadLimitStencilTable() -- invalid record");
+        delete table;
+        return 0;
+    }
+    return table;
+}
+
+//
+// PatchTable
+//
+void
+Serializer::WritePatchTable(PatchTable const & table,
+                            std::vector<unsigned char> & data) {
+
+    Writer writer(data, RECORD_PATCH_TABLE);
+
+    writer.WriteInt(table.GetMaxValence());
+    writer.WriteInt(table.GetNumPtexFaces());
+
+    // patch arrays : the offsets of the arrays are recomputed when reading
+    int numPatchArrays = table.GetNumPatchArrays();
+    std::vector<int> patchArrays(2 * numPatchArrays);
+    for (int i = 0; i < numPatchArrays; ++i) {
+        patchArrays[2*i] = table.GetPatchArrayDescriptor(i).GetType();
+        patchArrays[2*i+1] = table.GetNumPatches(i);
+    }
+    writer.WriteArray(patchArrays);
+
+    writer.WriteArray(table.GetPatchControlVerticesTable());
+    writer.WriteArray(table.GetPatchParamTable());
+    writer.WriteArray(table.GetQuadOffsetsTable());
+    writer.WriteArray(table.GetVertexValenceTable());
+
+    writeOptionalStencils(writer, table.GetLocalPointStencilTable());
+    writeOptionalStencils(writer, table.GetLocalPointVaryingStencilTable());
+
+    // varying
+    ConstIndexArray varyingVerts = table.GetVaryingVertices();
+    writer.WriteInt(table.GetVaryingPatchDescriptor().GetType());
+    writer.WriteArray(varyingVerts.begin(), varyingVerts.size());
+
+    // face-varying
+    int numFVarChannels = table.GetNumFVarChannels();
+    writer.WriteInt(numFVarChannels);
+    for (int channel = 0; channel < numFVarChannels; ++channel) {
+        ConstIndexArray values = table.GetFVarValues(channel);
+        ConstPatchParamArray params = table.GetFVarPatchParams(channel);
+
+        writer.WriteInt(table.GetFVarChannelLinearInterpolation(channel));
+        writer.WriteInt(table.GetFVarPatchDescriptor(channel).GetType());
+        writer.WriteArray(values.begin(), values.size());
+        writer.WriteArray(params.begin(), params.size());
+    }
+
+    int numFVarStencils = (int)table._localPointFaceVaryingStencils.size();
+    writer.WriteInt(numFVarStencils);
+    for (int channel = 0; channel < numFVarStencils; ++channel) {
+        writeOptionalStencils(writer,
+            table._localPointFaceVaryingStencils[channel]);
+    }
+
+    // single-crease sharpness
+    writer.WriteArray(table.GetSharpnessIndexTable());
+    writer.WriteArray(table.GetSharpnessValues());
+
+    writer.Finish();
+}
+
+namespace {
+
+    inline bool isValidPatchType(int type) {
+        return type > PatchDescriptor::NON_PATCH &&
+               type <= PatchDescriptor::GREGORY_BASIS;
+    }
+}
+
+PatchTable const *
+Serializer::ReadPatchTable(void const * data, size_t size) {
+
+    Reader reader(data, size, RECORD_PATCH_TABLE);
+
+    int maxValence = reader.ReadInt();
+
+    PatchTable * table = new PatchTable(maxValence);
+    table->_numPtexFaces = reader.ReadInt();
+
+    // patch arrays
+    std::vector<int> patchArrays;
+    bool valid = reader.ReadArray(patchArrays) &&
+        (patchArrays.size() % 2) == 0;
+
+    int numPatchArrays = (int)patchArrays.size() / 2;
+    table->reservePatchArrays(numPatchArrays);
+
+    Index voffset = 0, poffset = 0, qoffset = 0;
+    for (int i = 0; valid && i < numPatchArrays; ++i) {
+        valid = isValidPatchType(patchArrays[2*i]) && patchArrays[2*i+1] > 0;
+        if (valid) {
+            table->pushPatchArray(PatchDescriptor(patchArrays[2*i]),
+                patchArrays[2*i+1], &voffset, &poffset, &qoffset);
+        }
+    }
+
+    valid = valid &&
+        reader.ReadArray(table->_patchVerts) &&
+        reader.ReadArray(table->_paramTable) &&
+        reader.ReadArray(table->_quadOffsetsTable) &&
+        reader.ReadArray(table->_vertexValenceTable) &&
+        (int)table->_patchVerts.size() == voffset &&
+        (int)table->_paramTable.size() == poffset;
+
+    valid = valid &&
+        readOptionalStencils(reader, &table->_localPointStencils) &&
+        readOptionalStencils(reader, &table->_localPointVaryingStencils);
+
+    // varying
+    if (valid) {
+        int varyingType = reader.ReadInt();
+        valid = isValidPatchType(varyingType);
+        if (valid) {
+            table->allocateVaryingVertices(PatchDescriptor(varyingType), 0);
+            valid = reader.ReadArray(table->_varyingVerts);
+        }
+    }
+
+    // face-varying
+    int numFVarChannels = valid ? reader.ReadInt() : 0;
+    if (numFVarChannels < 0 || reader.Failed()) {
+        valid = false;
+        numFVarChannels = 0;
+    }
+    table->allocateFVarPatchChannels(numFVarChannels);
+    for (int channel = 0; valid && channel < numFVarChannels; ++channel) {
+
+        int interpolation = reader.ReadInt(),
+            type = reader.ReadInt();
+        if (interpolation < Sdc::Options::FVAR_LINEAR_NONE ||
+            interpolation > Sdc::Options::FVAR_LINEAR_ALL ||
+            ! isValidPatchType(type)) {
+            valid = false;
+            break;
+        }
+        table->allocateFVarPatchChannelValues(
+            PatchDescriptor(type), poffset, channel);
+        table->setFVarPatchChannelLinearInterpolation(
+            (Sdc::Options::FVarLinearInterpolation)interpolation, channel);
+
+        IndexArray values = table->getFVarValues(channel);
+        PatchParamArray params = table->getFVarPatchParams(channel);
+        valid = reader.ReadArray(values.begin(), values.size()) &&
+                reader.ReadArray(params.begin(), params.size());
+    }
+
+    int numFVarStencils = valid ? reader.ReadInt() : 0;
+    if (numFVarStencils < 0 || reader.Failed()) {
+        valid = false;
+        numFVarStencils = 0;
+    }
+    table->_localPointFaceVaryingStencils.resize(numFVarStencils, 0);
+    for (int channel = 0; valid && channel < numFVarStencils; ++channel) {
+        valid = readOptionalStencils(reader,
+            &table->_localPointFaceVaryingStencils[channel]);
+    }
+
+    // single-crease sharpness
+    valid = valid &&
+        reader.ReadArray(table->_sharpnessIndices) &&
+        reader.ReadArray(table->_sharpnessValues);
+
+    if (! valid || reader.Failed()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in Serializer::ReadPatchTable() -- invalid record");
+        delete table;
+        return 0;
+    }
+    return table;
+}
+
+//
+// Files
+//
+bool
+Serializer::WriteFile(char const * filename,
+                      std::vector<unsigned char> const & data) {
+
+    FILE * file = fopen(filename, "wb");
+    if (! file) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in Serializer::WriteFile() -- cannot open %s", filename);
+        return false;
+    }
+    bool success = data.empty() ||
+        fwrite(&data[0], 1, data.size(), file) == data.size();
+    success = (fclose(file) == 0) && success;
+    if (! success) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in Serializer::WriteFile() -- cannot write %s", filename);
+    }
+    return success;
+}
+
+Serializer::MappedFile *
+Serializer::MappedFile::Open(char const * filename) {
+
+    MappedFile * file = new MappedFile;
+
+#if ! defined(_WIN32)
+    int fd = open(filename, O_RDONLY);
+    struct stat status;
+    if (fd >= 0 && fstat(fd, &status) == 0 && status.st_size > 0) {
+        void * data = mmap(0, (size_t)status.st_size, PROT_READ, MAP_PRIVATE,
+                           fd, 0);
+        if (data != MAP_FAILED) {
+            file->_data = data;
+            file->_size = (size_t)status.st_size;
+            file->_mapped = true;
+        }
+    }
+    if (fd >= 0) {
+        close(fd);
+    }
+    if (file->_mapped) {
+        return file;
+    }
+#endif
+
+    // read the whole file
+    FILE * f = fopen(filename, "rb");
+    if (f && fseek(f, 0, SEEK_END) == 0) {
+        long size = ftell(f);
+        if (size > 0 && fseek(f, 0, SEEK_SET) == 0) {
+            file->_data = malloc((size_t)size);
+            if (file->_data &&
+                fread(file->_data, 1, (size_t)size, f) == (size_t)size) {
+                file->_size = (size_t)size;
+            }
+        }
+    }
+    if (f) {
+        fclose(f);
+    }
+    if (file->_size == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in Serializer::MappedFile::Open() -- cannot read %s",
+            filename);
+        delete file;
+        return 0;
+    }
+    return file;
+}
+
+Serializer::MappedFile::~MappedFile() {
+
+#if ! defined(_WIN32)
+    if (_mapped) {
+        munmap(_data, _size);
+        return;
+    }
+#endif
+    free(_data);
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
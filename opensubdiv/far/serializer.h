@@ -0,0 +1,160 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_SERIALIZER_H
+#define OPENSUBDIV3_FAR_SERIALIZER_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+template <typename REAL> class StencilTableReal;
+class StencilTable;
+class LimitStencilTable;
+class PatchTable;
+
+///
+/// \brief Binary serialization of stencil and patch tables
+///
+/// Tables are written in a versioned binary format, so that applications can
+/// cache them on disk instead of refining and factorizing the same assets on
+/// every run. PatchTable records include the local point stencils (vertex,
+/// varying and face-varying), the face-varying channels and the sharpness
+/// tables.
+///
+/// The data are written with the byte order of the host : records written
+/// on a host with a different byte order are swapped when they are read.
+/// Arrays are 8 byte aligned within a record, and are read with a single
+/// copy each, which makes reading mostly bound by the bandwidth of the
+/// (mapped) file.
+///
+/// \note Records are self-contained : each buffer holds a single table.
+///
+class Serializer {
+
+public:
+
+    /// \brief Version of the binary format (records of other versions are
+    ///        rejected)
+    enum { FORMAT_VERSION = 2 };
+
+    /// \brief Appends the serialization of a StencilTable to \p data
+    static void WriteStencilTable(StencilTable const & table,
+                                  std::vector<unsigned char> & data);
+
+    /// \brief Appends the serialization of a LimitStencilTable to \p data
+    static void WriteLimitStencilTable(LimitStencilTable const & table,
+                                       std::vector<unsigned char> & data);
+
+    /// \brief Appends the serialization of a PatchTable to \p data
+    static void WritePatchTable(PatchTable const & table,
+                                std::vector<unsigned char> & data);
+
+    /// \brief Returns a new StencilTable read from a record (or NULL if the
+    ///        record is not a valid StencilTable record)
+    static StencilTable const * ReadStencilTable(
+        void const * data, size_t size);
+
+    /// \brief Returns a new LimitStencilTable read from a record (or NULL if
+    ///        the record is not a valid LimitStencilTable record)
+    static LimitStencilTable const * ReadLimitStencilTable(
+        void const * data, size_t size);
+
+    /// \brief Returns a new PatchTable read from a record (or NULL if the
+    ///        record is not a valid PatchTable record)
+    static PatchTable const * ReadPatchTable(
+        void const * data, size_t size);
+
+    /// \brief Writes a serialized record to a file
+    static bool WriteFile(char const * filename,
+                          std::vector<unsigned char> const & data);
+
+    ///
+    /// \brief Read-only mapping of a file
+    ///
+    /// Files are memory mapped where supported (and read into memory
+    /// otherwise), so that records can be read directly from the pages of
+    /// the file.
+    ///
+    class MappedFile {
+
+    public:
+
+        /// \brief Returns a new mapping of the file (or NULL on failure)
+        static MappedFile * Open(char const * filename);
+
+        /// \brief Destructor (unmaps the file)
+        ~MappedFile();
+
+        /// \brief Returns the address of the contents of the file
+        void const * GetData() const { return _data; }
+
+        /// \brief Returns the size of the file (in bytes)
+        size_t GetSize() const { return _size; }
+
+    private:
+
+        MappedFile() : _data(0), _size(0), _mapped(false) { }
+
+        // non-copyable
+        MappedFile(MappedFile const &);
+        MappedFile & operator = (MappedFile const &);
+
+        void * _data;
+        size_t _size;
+        bool   _mapped;  // memory mapped (or allocated)
+    };
+
+private:
+
+    class Writer;
+    class Reader;
+
+    static void writeStencils(Writer & writer,
+                              StencilTableReal<float> const & table);
+
+    static bool readStencils(Reader & reader,
+                             StencilTableReal<float> & table);
+
+    static void writeOptionalStencils(Writer & writer,
+                                      StencilTable const * table);
+
+    static bool readOptionalStencils(Reader & reader,
+                                     StencilTable const ** table);
+};
+
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_SERIALIZER_H */
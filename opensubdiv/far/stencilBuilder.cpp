@@ -24,6 +24,12 @@
 
 #include "../far/stencilBuilder.h"
 #include "../far/topologyRefiner.h"
+
+#include <algorithm>
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
  
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -37,25 +43,27 @@ namespace {
 #pragma warning disable 1572
 #endif
 
-    inline bool isWeightZero(float w) { return (w == 0.0f); }
+    template <typename REAL>
+    inline bool isWeightZero(REAL w) { return (w == (REAL)0.0); }
 
 #ifdef __INTEL_COMPILER
 #pragma warning (pop)
 #endif
 }
 
+template <typename REAL>
 struct Point1stDerivWeight {
-    float p;
-    float du;
-    float dv;
+    REAL p;
+    REAL du;
+    REAL dv;
 
     Point1stDerivWeight()
-        : p(0.0f), du(0.0f), dv(0.0f)
+        : p(0.0), du(0.0), dv(0.0)
     { }
-    Point1stDerivWeight(float w)
+    Point1stDerivWeight(REAL w)
         : p(w), du(w), dv(w)
     { }
-    Point1stDerivWeight(float w, float wDu, float wDv)
+    Point1stDerivWeight(REAL w, REAL wDu, REAL wDv)
         : p(w), du(wDu), dv(wDv)
     { }
 
@@ -74,22 +82,23 @@ struct Point1stDerivWeight {
     }
 };
 
+template <typename REAL>
 struct Point2ndDerivWeight {
-    float p;
-    float du;
-    float dv;
-    float duu;
-    float duv;
-    float dvv;
+    REAL p;
+    REAL du;
+    REAL dv;
+    REAL duu;
+    REAL duv;
+    REAL dvv;
 
     Point2ndDerivWeight()
-        : p(0.0f), du(0.0f), dv(0.0f), duu(0.0f), duv(0.0f), dvv(0.0f)
+        : p(0.0), du(0.0), dv(0.0), duu(0.0), duv(0.0), dvv(0.0)
     { }
-    Point2ndDerivWeight(float w)
+    Point2ndDerivWeight(REAL w)
         : p(w), du(w), dv(w), duu(w), duv(w), dvv(w)
     { }
-    Point2ndDerivWeight(float w, float wDu, float wDv,
-                        float wDuu, float wDuv, float wDvv)
+    Point2ndDerivWeight(REAL w, REAL wDu, REAL wDv,
+                        REAL wDuu, REAL wDuv, REAL wDvv)
         : p(w), du(wDu), dv(wDv), duu(wDuu), duv(wDuv), dvv(wDvv)
     { }
 
@@ -116,6 +125,7 @@ struct Point2ndDerivWeight {
 
 /// Stencil table constructor set.
 ///
+template <typename REAL>
 class WeightTable {
 public:
     WeightTable(int coarseVerts,
@@ -157,6 +167,18 @@ public:
         _lastOffset = _size - 1;
     }
 
+    // Constructs an empty table to hold a subset of the stencils of a level
+    // (see StencilBuilder::AddLevelMasks()).
+    WeightTable(int coarseVerts, bool compactWeights, int numStencils)
+        : _size(0)
+        , _lastOffset(0)
+        , _coarseVertCount(coarseVerts)
+        , _compactWeights(compactWeights)
+    {
+        _indices.reserve(numStencils);
+        _sizes.reserve(numStencils);
+    }
+
     template <class W, class WACCUM>
     void AddWithWeight(int src, int dest, W weight, WACCUM weights)
     {
@@ -193,23 +215,109 @@ public:
         }
     }
 
+    // Scalar variant of AddWithWeight() that resolves the stencils of
+    // non-coarse sources from another table: this allows the vertices of a
+    // level to be factorized into separate tables concurrently.
+    void AddWithWeight(WeightTable const & srcTable, int src, int dest,
+                       REAL weight)
+    {
+        ScalarAccumulator weights(this);
+
+        if (src < _coarseVertCount) {
+            merge(src, dest, weight, (REAL)1.0, _lastOffset, _size, weights);
+            return;
+        }
+
+        int len = srcTable._sizes[src];
+        int start = srcTable._indices[src];
+
+        for (int i = start; i < start+len; i++) {
+            assert(srcTable._sources[i] < _coarseVertCount);
+
+            merge(srcTable._sources[i], dest, srcTable._weights[i], weight,
+                                _lastOffset, _size, weights);
+        }
+    }
+
+    // Append the (scalar) stencils of another table, remapping the stencil
+    // at index i of 'other' to the destination vertex dests[i].
+    void Append(WeightTable const & other, int const * dests)
+    {
+        int base = _size;
+        for (int i = 0; i < (int)other._sizes.size(); ++i) {
+            // Only stencils that were actually started are transferred, as
+            // vertices without contributions would not exist serially either.
+            if (other._sizes[i] == 0)
+                continue;
+
+            int dst = dests[i];
+            if (dst+1 > (int)_indices.size()) {
+                _indices.resize(dst+1);
+                _sizes.resize(dst+1);
+            }
+            _indices[dst] = base + other._indices[i];
+            _sizes[dst] = other._sizes[i];
+            _lastOffset = _indices[dst];
+        }
+        for (int i = 0; i < other._size; ++i) {
+            _dests.push_back(dests[other._dests[i]]);
+        }
+        _sources.insert(_sources.end(),
+                        other._sources.begin(), other._sources.end());
+        _weights.insert(_weights.end(),
+                        other._weights.begin(), other._weights.end());
+        _size += other._size;
+    }
+
+    // Re-emit the completed stencil of 'dst' at the end of the table with
+    // the additional (coarse) source 'src', or with 'src' as its only source
+    // when 'replace' is set. The stencils of the following levels resolve
+    // 'dst' through _indices and _sizes and so inherit the edit.
+    void ApplyVertexEdit(int dst, int src, REAL weight, bool replace)
+    {
+        assert(src < _coarseVertCount);
+
+        int start = _indices[dst],
+            len = replace ? 0 : _sizes[dst];
+
+        _indices[dst] = _size;
+        _sizes[dst] = 0;
+        _lastOffset = _size;
+
+        for (int i = start; i < start+len; ++i) {
+            int srcVert = _sources[i];
+            REAL w = _weights[i];
+
+            _dests.push_back(dst);
+            _sources.push_back(srcVert);
+            _weights.push_back(w);
+            _sizes[dst]++;
+            _size++;
+        }
+        add(src, dst, weight, GetScalarAccumulator());
+    }
+
+    int GetCoarseVertCount() const { return _coarseVertCount; }
+
+    bool IsCompact() const { return _compactWeights; }
+
     class Point1stDerivAccumulator {
         WeightTable* _tbl;
     public:
         Point1stDerivAccumulator(WeightTable* tbl) : _tbl(tbl)
         { }
-        void PushBack(Point1stDerivWeight weight) {
+        void PushBack(Point1stDerivWeight<REAL> weight) {
             _tbl->_weights.push_back(weight.p);
             _tbl->_duWeights.push_back(weight.du);
             _tbl->_dvWeights.push_back(weight.dv);
         }
-        void Add(size_t i, Point1stDerivWeight weight) {
+        void Add(size_t i, Point1stDerivWeight<REAL> weight) {
             _tbl->_weights[i] += weight.p;
             _tbl->_duWeights[i] += weight.du;
             _tbl->_dvWeights[i] += weight.dv;
         }
-        Point1stDerivWeight Get(size_t index) {
-            return Point1stDerivWeight(_tbl->_weights[index],
+        Point1stDerivWeight<REAL> Get(size_t index) {
+            return Point1stDerivWeight<REAL>(_tbl->_weights[index],
                                        _tbl->_duWeights[index],
                                        _tbl->_dvWeights[index]);
         }
@@ -223,7 +331,7 @@ public:
     public:
         Point2ndDerivAccumulator(WeightTable* tbl) : _tbl(tbl)
         { }
-        void PushBack(Point2ndDerivWeight weight) {
+        void PushBack(Point2ndDerivWeight<REAL> weight) {
             _tbl->_weights.push_back(weight.p);
             _tbl->_duWeights.push_back(weight.du);
             _tbl->_dvWeights.push_back(weight.dv);
@@ -231,7 +339,7 @@ public:
             _tbl->_duvWeights.push_back(weight.duv);
             _tbl->_dvvWeights.push_back(weight.dvv);
         }
-        void Add(size_t i, Point2ndDerivWeight weight) {
+        void Add(size_t i, Point2ndDerivWeight<REAL> weight) {
             _tbl->_weights[i] += weight.p;
             _tbl->_duWeights[i] += weight.du;
             _tbl->_dvWeights[i] += weight.dv;
@@ -239,8 +347,8 @@ public:
             _tbl->_duvWeights[i] += weight.duv;
             _tbl->_dvvWeights[i] += weight.dvv;
         }
-        Point2ndDerivWeight Get(size_t index) {
-            return Point2ndDerivWeight(_tbl->_weights[index],
+        Point2ndDerivWeight<REAL> Get(size_t index) {
+            return Point2ndDerivWeight<REAL>(_tbl->_weights[index],
                                        _tbl->_duWeights[index],
                                        _tbl->_dvWeights[index],
                                        _tbl->_duuWeights[index],
@@ -257,13 +365,13 @@ public:
     public:
         ScalarAccumulator(WeightTable* tbl) : _tbl(tbl)
         { }
-        void PushBack(float weight) {
+        void PushBack(REAL weight) {
             _tbl->_weights.push_back(weight);
         }
-        void Add(size_t i, float w) {
+        void Add(size_t i, REAL w) {
             _tbl->_weights[i] += w;
         }
-        float Get(size_t index) {
+        REAL Get(size_t index) {
             return _tbl->_weights[index];
         }
     };
@@ -280,22 +388,22 @@ public:
     std::vector<int> const&
     GetSources() const { return _sources; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetWeights() const { return _weights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDuWeights() const { return _duWeights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDvWeights() const { return _dvWeights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDuuWeights() const { return _duuWeights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDuvWeights() const { return _duvWeights; }
 
-    std::vector<float> const&
+    std::vector<REAL> const&
     GetDvvWeights() const { return _dvvWeights; }
 
     void SetCoarseVertCount(int numVerts) {
@@ -387,12 +495,12 @@ private:
 
     // The actual stencil data.
     std::vector<int> _sources;
-    std::vector<float> _weights;
-    std::vector<float> _duWeights;
-    std::vector<float> _dvWeights;
-    std::vector<float> _duuWeights;
-    std::vector<float> _duvWeights;
-    std::vector<float> _dvvWeights;
+    std::vector<REAL> _weights;
+    std::vector<REAL> _duWeights;
+    std::vector<REAL> _dvWeights;
+    std::vector<REAL> _duuWeights;
+    std::vector<REAL> _duvWeights;
+    std::vector<REAL> _dvvWeights;
 
     // Index data used to recover stencil-to-vertex mapping.
     std::vector<int> _indices;
@@ -405,29 +513,33 @@ private:
     bool _compactWeights;
 };
 
-StencilBuilder::StencilBuilder(int coarseVertCount,
+template <typename REAL>
+StencilBuilder<REAL>::StencilBuilder(int coarseVertCount,
                                bool genCtrlVertStencils,
                                bool compactWeights)
-        : _weightTable(new WeightTable(coarseVertCount,
+        : _weightTable(new WeightTable<REAL>(coarseVertCount,
                                    genCtrlVertStencils,
                                    compactWeights))
 {
 }
 
-StencilBuilder::~StencilBuilder()
+template <typename REAL>
+StencilBuilder<REAL>::~StencilBuilder()
 {
     delete _weightTable;
 }
 
+template <typename REAL>
 size_t
-StencilBuilder::GetNumVerticesTotal() const
+StencilBuilder<REAL>::GetNumVerticesTotal() const
 {
     return _weightTable->GetWeights().size();
 }
 
 
+template <typename REAL>
 int 
-StencilBuilder::GetNumVertsInStencil(size_t stencilIndex) const
+StencilBuilder<REAL>::GetNumVertsInStencil(size_t stencilIndex) const
 {
     if (stencilIndex > _weightTable->GetSizes().size() - 1)
         return 0;
@@ -435,59 +547,218 @@ StencilBuilder::GetNumVertsInStencil(size_t stencilIndex) const
     return (int)_weightTable->GetSizes()[stencilIndex];
 }
 
+template <typename REAL>
 void
-StencilBuilder::SetCoarseVertCount(int numVerts)
+StencilBuilder<REAL>::SetCoarseVertCount(int numVerts)
 {
     _weightTable->SetCoarseVertCount(numVerts);
 }
 
+template <typename REAL>
+void
+StencilBuilder<REAL>::ApplyVertexEdit(int vertex, int source, REAL weight,
+                                      bool replace)
+{
+    _weightTable->ApplyVertexEdit(vertex, source, weight, replace);
+}
+
+template <typename REAL>
 std::vector<int> const&
-StencilBuilder::GetStencilOffsets() const {
+StencilBuilder<REAL>::GetStencilOffsets() const {
     return _weightTable->GetOffsets();
 }
 
+template <typename REAL>
 std::vector<int> const& 
-StencilBuilder::GetStencilSizes() const {
+StencilBuilder<REAL>::GetStencilSizes() const {
     return _weightTable->GetSizes();
 }
 
+template <typename REAL>
 std::vector<int> const&
-StencilBuilder::GetStencilSources() const {
+StencilBuilder<REAL>::GetStencilSources() const {
     return _weightTable->GetSources();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilWeights() const {
     return _weightTable->GetWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDuWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDuWeights() const {
     return _weightTable->GetDuWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDvWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDvWeights() const {
     return _weightTable->GetDvWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDuuWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDuuWeights() const {
     return _weightTable->GetDuuWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDuvWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDuvWeights() const {
     return _weightTable->GetDuvWeights();
 }
 
-std::vector<float> const&
-StencilBuilder::GetStencilDvvWeights() const {
+template <typename REAL>
+std::vector<REAL> const&
+StencilBuilder<REAL>::GetStencilDvvWeights() const {
     return _weightTable->GetDvvWeights();
 }
 
+template <typename REAL>
+void
+StencilBuilder<REAL>::AddLevelMasks(LevelMasks<REAL> const & masks, int firstLevelVert)
+{
+    int numEntries = masks.GetNumEntries();
+    if (numEntries == 0) {
+        return;
+    }
+
+    int const * dests = &masks._dests[0];
+    int const * sources = &masks._sources[0];
+    REAL const * weights = &masks._weights[0];
+
+    // PrimvarRefiner issues all the contributions to a given vertex
+    // consecutively: split the entries in runs, one per destination vertex.
+    std::vector<int> runs;
+    runs.reserve(numEntries/4 + 1);
+    for (int i = 0; i < numEntries; ++i) {
+        if (i == 0 || dests[i] != dests[i-1]) {
+            runs.push_back(i);
+        }
+    }
+    int numRuns = (int)runs.size();
+    runs.push_back(numEntries);
+
+    // Some vertices (ex. Catmark edge and vertex-vertices) depend on vertices
+    // of the same level, which have to be factorized first. Split the runs in
+    // two successive passes: independent and dependent.
+    int numLevelVerts = *std::max_element(dests, dests+numEntries) + 1 -
+                        firstLevelVert;
+
+    std::vector<char> isDependent(numLevelVerts, false);
+    bool serialize = false;
+    for (int r = 0; r < numRuns; ++r) {
+        for (int i = runs[r]; i < runs[r+1]; ++i) {
+            if (sources[i] >= firstLevelVert) {
+                isDependent[dests[i] - firstLevelVert] = true;
+                break;
+            }
+        }
+    }
+    for (int r = 0; r < numRuns && !serialize; ++r) {
+        if (! isDependent[dests[runs[r]] - firstLevelVert])
+            continue;
+        for (int i = runs[r]; i < runs[r+1]; ++i) {
+            int src = sources[i] - firstLevelVert;
+            if (src >= 0 && src < numLevelVerts && isDependent[src]) {
+                serialize = true;
+                break;
+            }
+        }
+    }
+
+    int numThreads = 1;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    numThreads = omp_get_max_threads();
+#endif
+
+    if (numThreads == 1 || serialize) {
+        // Deeper dependency chains are not expected from PrimvarRefiner, but
+        // fall back to factorizing the level serially if present.
+        for (int i = 0; i < numEntries; ++i) {
+            _weightTable->AddWithWeight(sources[i], dests[i], weights[i],
+                                _weightTable->GetScalarAccumulator());
+        }
+        return;
+    }
+
+    std::vector<int> passRuns;
+    std::vector<int> passDests;
+    for (int pass = 0; pass < 2; ++pass) {
+
+        passRuns.clear();
+        passDests.clear();
+        for (int r = 0; r < numRuns; ++r) {
+            int dst = dests[runs[r]];
+            if (isDependent[dst - firstLevelVert] == (pass == 1)) {
+                passRuns.push_back(r);
+                passDests.push_back(dst);
+            }
+        }
+        int numPassRuns = (int)passRuns.size();
+        if (numPassRuns == 0) {
+            continue;
+        }
+
+        // Over-partition the runs to balance the uneven cost of stencils
+        // around extraordinary features.
+        int numChunks = std::min(numPassRuns, 4*numThreads);
+        int chunkSize = (numPassRuns + numChunks - 1) / numChunks;
+        numChunks = (numPassRuns + chunkSize - 1) / chunkSize;
+
+        std::vector<WeightTable<REAL> *> chunks(numChunks, (WeightTable<REAL> *)0);
+
+        WeightTable<REAL> const & levelTable = *_weightTable;
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for schedule(dynamic)
+#endif
+        for (int c = 0; c < numChunks; ++c) {
+            int begin = c * chunkSize,
+                end = std::min(begin + chunkSize, numPassRuns);
+
+            WeightTable<REAL> * chunk = new WeightTable<REAL>(
+                levelTable.GetCoarseVertCount(), levelTable.IsCompact(),
+                    end - begin);
+
+            // Stencils are indexed locally in the chunk and remapped to their
+            // destination vertex when appended.
+            for (int k = begin; k < end; ++k) {
+                int r = passRuns[k];
+                for (int i = runs[r]; i < runs[r+1]; ++i) {
+                    chunk->AddWithWeight(levelTable, sources[i], k - begin,
+                                         weights[i]);
+                }
+            }
+            chunks[c] = chunk;
+        }
+
+        // Splice the chunks in order so the result is deterministic.
+        for (int c = 0; c < numChunks; ++c) {
+            _weightTable->Append(*chunks[c], &passDests[c * chunkSize]);
+            delete chunks[c];
+        }
+    }
+}
+
+template <typename REAL>
 void
-StencilBuilder::Index::AddWithWeight(Index const & src, float weight)
+LevelMasks<REAL>::Index::AddWithWeight(Index const & src, REAL weight)
+{
+    // Ignore no-op weights.
+    if (isWeightZero(weight)) {
+        return;
+    }
+    _owner->_dests.push_back(_index);
+    _owner->_sources.push_back(src._index);
+    _owner->_weights.push_back(weight);
+}
+
+template <typename REAL>
+void
+StencilBuilder<REAL>::Index::AddWithWeight(Index const & src, REAL weight)
 {
     // Ignore no-op weights.
     if (isWeightZero(weight)) {
@@ -497,8 +768,9 @@ StencilBuilder::Index::AddWithWeight(Index const & src, float weight)
                                 _owner->_weightTable->GetScalarAccumulator());
 }
 
+template <typename REAL>
 void
-StencilBuilder::Index::AddWithWeight(Stencil const& src, float weight)
+StencilBuilder<REAL>::Index::AddWithWeight(StencilReal<REAL> const& src, REAL weight)
 {
     if (isWeightZero(weight)) {
         return;
@@ -506,25 +778,26 @@ StencilBuilder::Index::AddWithWeight(Stencil const& src, float weight)
 
     int srcSize = *src.GetSizePtr();
     Vtr::Index const * srcIndices = src.GetVertexIndices();
-    float const * srcWeights = src.GetWeights();
+    REAL const * srcWeights = src.GetWeights();
 
     for (int i = 0; i < srcSize; ++i) {
-        float w = srcWeights[i];
+        REAL w = srcWeights[i];
         if (isWeightZero(w)) {
             continue;
         }
 
         Vtr::Index srcIndex = srcIndices[i];
 
-        float wgt = weight * w;
+        REAL wgt = weight * w;
         _owner->_weightTable->AddWithWeight(srcIndex, _index, wgt,
                             _owner->_weightTable->GetScalarAccumulator());
     }  
 }
 
+template <typename REAL>
 void
-StencilBuilder::Index::AddWithWeight(Stencil const& src,
-    float weight, float du, float dv)
+StencilBuilder<REAL>::Index::AddWithWeight(StencilReal<REAL> const& src,
+    REAL weight, REAL du, REAL dv)
 {
     if (isWeightZero(weight) && isWeightZero(du) && isWeightZero(dv)) {
         return;
@@ -532,25 +805,27 @@ StencilBuilder::Index::AddWithWeight(Stencil const& src,
 
     int srcSize = *src.GetSizePtr();
     Vtr::Index const * srcIndices = src.GetVertexIndices();
-    float const * srcWeights = src.GetWeights();
+    REAL const * srcWeights = src.GetWeights();
 
     for (int i = 0; i < srcSize; ++i) {
-        float w = srcWeights[i];
+        REAL w = srcWeights[i];
         if (isWeightZero(w)) {
             continue;
         }
 
         Vtr::Index srcIndex = srcIndices[i];
 
-        Point1stDerivWeight wgt = Point1stDerivWeight(weight, du, dv) * w;
+        Point1stDerivWeight<REAL> wgt =
+            Point1stDerivWeight<REAL>(weight, du, dv) * w;
         _owner->_weightTable->AddWithWeight(srcIndex, _index, wgt,
                            _owner->_weightTable->GetPoint1stDerivAccumulator());
     }
 }
 
+template <typename REAL>
 void
-StencilBuilder::Index::AddWithWeight(Stencil const& src,
-    float weight, float du, float dv, float duu, float duv, float dvv)
+StencilBuilder<REAL>::Index::AddWithWeight(StencilReal<REAL> const& src,
+    REAL weight, REAL du, REAL dv, REAL duu, REAL duv, REAL dvv)
 {
     if (isWeightZero(weight) && isWeightZero(du) && isWeightZero(dv) &&
         isWeightZero(duu) && isWeightZero(duv) && isWeightZero(dvv)) {
@@ -559,22 +834,32 @@ StencilBuilder::Index::AddWithWeight(Stencil const& src,
 
     int srcSize = *src.GetSizePtr();
     Vtr::Index const * srcIndices = src.GetVertexIndices();
-    float const * srcWeights = src.GetWeights();
+    REAL const * srcWeights = src.GetWeights();
 
     for (int i = 0; i < srcSize; ++i) {
-        float w = srcWeights[i];
+        REAL w = srcWeights[i];
         if (isWeightZero(w)) {
             continue;
         }
 
         Vtr::Index srcIndex = srcIndices[i];
 
-        Point2ndDerivWeight wgt = Point2ndDerivWeight(weight, du, dv, duu, duv, dvv) * w;
+        Point2ndDerivWeight<REAL> wgt =
+            Point2ndDerivWeight<REAL>(weight, du, dv, duu, duv, dvv) * w;
         _owner->_weightTable->AddWithWeight(srcIndex, _index, wgt,
                            _owner->_weightTable->GetPoint2ndDerivAccumulator());
     }
 }
 
+//
+//  Explicit instantiation for float and double:
+//
+template class LevelMasks<float>;
+template class LevelMasks<double>;
+
+template class StencilBuilder<float>;
+template class StencilBuilder<double>;
+
 } // end namespace internal
 } // end namespace Far
 } // end namespace OPENSUBDIV_VERSION
@@ -36,8 +36,56 @@ namespace OPENSUBDIV_VERSION {
 namespace Far {
 namespace internal {
 
-class WeightTable;
+template <typename REAL> class WeightTable;
+
+/// Records the un-factorized interpolation masks of a refinement level, in the
+/// order they are issued by PrimvarRefiner, so that StencilBuilder can later
+/// factorize them concurrently (see StencilBuilder::AddLevelMasks()).
+///
+template <typename REAL>
+class LevelMasks {
+public:
+    void Clear() {
+        _dests.clear();
+        _sources.clear();
+        _weights.clear();
+    }
+
+    int GetNumEntries() const { return (int)_dests.size(); }
+
+    // Vertex Facade.
+    class Index {
+    public:
+        Index(LevelMasks* owner, int index)
+            : _owner(owner)
+            , _index(index)
+        {}
+
+        // Record the contribution of src, no-op weights are dropped
+        // exactly as StencilBuilder::Index would.
+        void AddWithWeight(Index const & src, REAL weight);
+
+        Index operator[](int index) const {
+            return Index(_owner, index+_index);
+        }
 
+        int GetOffset() const { return _index; }
+
+        void Clear() {/*nothing to do here*/}
+    private:
+        LevelMasks* _owner;
+        int _index;
+    };
+
+private:
+    template <typename OTHER_REAL> friend class StencilBuilder;
+
+    std::vector<int>   _dests;
+    std::vector<int>   _sources;
+    std::vector<REAL>  _weights;
+};
+
+template <typename REAL>
 class StencilBuilder {
 public:
     StencilBuilder(int coarseVertCount, 
@@ -53,6 +101,17 @@ public:
 
     void SetCoarseVertCount(int numVerts);
 
+    // Factorize the masks recorded for the vertices of a refinement level
+    // (starting at 'firstLevelVert'). The work is split between threads when
+    // OpenMP is available, and the resulting stencils are identical to the
+    // ones built by issuing the same masks serially through Index.
+    void AddLevelMasks(LevelMasks<REAL> const & masks, int firstLevelVert);
+
+    // Apply a hierarchical vertex edit to the completed stencil of 'vertex':
+    // the coarse 'source' holding the edit value is added with 'weight', or
+    // replaces the stencil entirely when 'replace' is set.
+    void ApplyVertexEdit(int vertex, int source, REAL weight, bool replace);
+
     // Mapping from stencil[i] to its starting offset in the sources[] and weights[] arrays;
     std::vector<int> const& GetStencilOffsets() const;
 
@@ -63,12 +122,12 @@ public:
     std::vector<int> const& GetStencilSources() const;
 
     // The individual vertex weights, each weight is paired with one source.
-    std::vector<float> const& GetStencilWeights() const;
-    std::vector<float> const& GetStencilDuWeights() const;
-    std::vector<float> const& GetStencilDvWeights() const;
-    std::vector<float> const& GetStencilDuuWeights() const;
-    std::vector<float> const& GetStencilDuvWeights() const;
-    std::vector<float> const& GetStencilDvvWeights() const;
+    std::vector<REAL> const& GetStencilWeights() const;
+    std::vector<REAL> const& GetStencilDuWeights() const;
+    std::vector<REAL> const& GetStencilDvWeights() const;
+    std::vector<REAL> const& GetStencilDuuWeights() const;
+    std::vector<REAL> const& GetStencilDuvWeights() const;
+    std::vector<REAL> const& GetStencilDvvWeights() const;
 
     // Vertex Facade.
     class Index {
@@ -79,16 +138,16 @@ public:
         {}
 
         // Add with point/vertex weight only.
-        void AddWithWeight(Index const & src, float weight);
-        void AddWithWeight(Stencil const& src, float weight);
+        void AddWithWeight(Index const & src, REAL weight);
+        void AddWithWeight(StencilReal<REAL> const& src, REAL weight);
 
         // Add with first derivative.
-        void AddWithWeight(Stencil const& src,
-            float weight, float du, float dv);
+        void AddWithWeight(StencilReal<REAL> const& src,
+            REAL weight, REAL du, REAL dv);
 
         // Add with first and second derivatives.
-        void AddWithWeight(Stencil const& src,
-            float weight, float du, float dv, float duu, float duv, float dvv);
+        void AddWithWeight(StencilReal<REAL> const& src,
+            REAL weight, REAL du, REAL dv, REAL duu, REAL duv, REAL dvv);
 
         Index operator[](int index) const {
             return Index(_owner, index+_index);
@@ -103,7 +162,7 @@ public:
     };
 
 private:
-    WeightTable* _weightTable;
+    WeightTable<REAL>* _weightTable;
 };
 
 } // end namespace internal
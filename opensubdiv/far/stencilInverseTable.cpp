@@ -0,0 +1,132 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../far/stencilInverseTable.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+void
+StencilInverseTable::initialize(int numControlVertices,
+                                std::vector<int> const & sizes,
+                                std::vector<Index> const & indices) {
+
+    _numStencils = (int)sizes.size();
+
+    // count the stencils supported by each control vertex
+    _offsets.assign(numControlVertices + 1, 0);
+    for (int i = 0; i < (int)indices.size(); ++i) {
+        if (indices[i] >= 0 && indices[i] < numControlVertices) {
+            ++_offsets[indices[i] + 1];
+        }
+    }
+    for (int i = 0; i < numControlVertices; ++i) {
+        _offsets[i+1] += _offsets[i];
+    }
+
+    // stencils are visited in order : each list is sorted
+    _stencils.resize(_offsets[numControlVertices]);
+
+    std::vector<Index> cursor(_offsets.begin(), _offsets.end() - 1);
+    for (int i = 0, offset = 0; i < _numStencils; ++i) {
+        for (int j = 0; j < sizes[i]; ++j, ++offset) {
+            Index v = indices[offset];
+            if (v >= 0 && v < numControlVertices) {
+                _stencils[cursor[v]++] = i;
+            }
+        }
+    }
+
+    // a vertex appears once per stencil in factorized tables, but remove
+    // any duplicate to keep the lists unique
+    Index dst = 0;
+    for (int v = 0; v < numControlVertices; ++v) {
+        Index begin = _offsets[v],
+              end = cursor[v];
+        _offsets[v] = dst;
+        for (Index s = begin; s < end; ++s) {
+            if (s == begin || _stencils[s] != _stencils[s-1]) {
+                _stencils[dst++] = _stencils[s];
+            }
+        }
+    }
+    _offsets[numControlVertices] = dst;
+    _stencils.resize(dst);
+}
+
+void
+StencilInverseTable::GetAffectedStencils(int numVertices,
+    Index const * vertices, std::vector<Index> & stencils) const {
+
+    stencils.clear();
+    if (numVertices == 1) {
+        Index v = vertices[0];
+        assert(v >= 0 && v < GetNumControlVertices());
+        stencils.assign(_stencils.begin() + _offsets[v],
+                        _stencils.begin() + _offsets[v+1]);
+        return;
+    }
+
+    int numGathered = 0;
+    for (int i = 0; i < numVertices; ++i) {
+        Index v = vertices[i];
+        assert(v >= 0 && v < GetNumControlVertices());
+        numGathered += _offsets[v+1] - _offsets[v];
+    }
+
+    if (numGathered > _numStencils / 8) {
+        // large edits : flag the affected stencils and gather them in order
+        std::vector<char> affected(_numStencils, 0);
+        for (int i = 0; i < numVertices; ++i) {
+            Index v = vertices[i];
+            for (Index j = _offsets[v]; j < _offsets[v+1]; ++j) {
+                affected[_stencils[j]] = 1;
+            }
+        }
+        for (int i = 0; i < _numStencils; ++i) {
+            if (affected[i]) stencils.push_back(i);
+        }
+    } else {
+        // small edits : merge the sorted lists of the vertices
+        stencils.reserve(numGathered);
+        for (int i = 0; i < numVertices; ++i) {
+            Index v = vertices[i];
+            stencils.insert(stencils.end(), _stencils.begin() + _offsets[v],
+                                            _stencils.begin() + _offsets[v+1]);
+        }
+        std::sort(stencils.begin(), stencils.end());
+        stencils.erase(std::unique(stencils.begin(), stencils.end()),
+                       stencils.end());
+    }
+}
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+} // end namespace OpenSubdiv
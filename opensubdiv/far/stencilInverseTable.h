@@ -0,0 +1,114 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_FAR_STENCILINVERSETABLE_H
+#define OPENSUBDIV3_FAR_STENCILINVERSETABLE_H
+
+#include "../version.h"
+
+#include "../far/stencilTable.h"
+#include "../far/types.h"
+
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+
+///
+/// \brief Inverse index of a StencilTable
+///
+/// Maps each control vertex to the stencils it contributes to, so that the
+/// stencils affected by the edit of a few control vertices can be found (and
+/// re-evaluated) at a cost proportional to the size of the edit rather than
+/// to the size of the table.
+///
+/// \note Indices that do not reference control vertices (ex. stencils of
+///       non-factorized tables) are ignored.
+///
+class StencilInverseTable {
+
+public:
+
+    /// \brief Constructor
+    template <typename REAL>
+    StencilInverseTable(StencilTableReal<REAL> const &stencilTable) {
+        initialize(stencilTable.GetNumControlVertices(),
+                   stencilTable.GetSizes(),
+                   stencilTable.GetControlIndices());
+    }
+
+    /// \brief Returns the number of control vertices of the stencil table
+    int GetNumControlVertices() const {
+        return (int)_offsets.size() - 1;
+    }
+
+    /// \brief Returns the number of stencils of the stencil table
+    int GetNumStencils() const {
+        return _numStencils;
+    }
+
+    /// \brief Returns the stencils supported by the control vertex 'v', in
+    ///        increasing order
+    ConstIndexArray GetStencils(Index v) const {
+        int size = _offsets[v+1] - _offsets[v];
+        return ConstIndexArray(size ? &_stencils[_offsets[v]] : 0, size);
+    }
+
+    /// \brief Gathers the stencils supported by a set of control vertices
+    ///
+    /// @param numVertices  Number of control vertices
+    ///
+    /// @param vertices     Indices of the control vertices (ex. the ones
+    ///                     edited since the last evaluation)
+    ///
+    /// @param stencils     Returns the indices of the affected stencils,
+    ///                     sorted and unique
+    ///
+    void GetAffectedStencils(int numVertices, Index const * vertices,
+                             std::vector<Index> & stencils) const;
+
+private:
+
+    void initialize(int numControlVertices,
+                    std::vector<int> const & sizes,
+                    std::vector<Index> const & indices);
+
+private:
+
+    int _numStencils;
+
+    std::vector<Index> _offsets,   // offsets of the stencils of each vertex
+                       _stencils;  // stencils supported by each vertex
+};
+
+
+} // end namespace Far
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_FAR_STENCILINVERSETABLE_H */
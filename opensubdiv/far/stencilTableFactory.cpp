@@ -24,6 +24,7 @@
 
 #include "../far/stencilTableFactory.h"
 #include "../far/stencilBuilder.h"
+#include "../far/error.h"
 #include "../far/endCapGregoryBasisPatchFactory.h"
 #include "../far/patchTable.h"
 #include "../far/patchTableFactory.h"
@@ -46,51 +47,400 @@ namespace {
 #pragma warning disable 1572
 #endif
 
-    inline bool isWeightZero(float w) { return (w == 0.0f); }
+    template <typename REAL>
+    inline bool isWeightZero(REAL w) { return (w == (REAL)0.0); }
 
 #ifdef __INTEL_COMPILER
 #pragma warning (pop)
 #endif
+
+    //
+    //  The tables of single precision are created as instances of the classes
+    //  StencilTable and LimitStencilTable, so that the pointers returned by
+    //  the factories can be safely cast to them.
+    //
+    template <typename REAL>
+    struct StencilTableTypes {
+        typedef StencilTableReal<REAL>      Table;
+        typedef LimitStencilTableReal<REAL> LimitTable;
+    };
+
+    template <>
+    struct StencilTableTypes<float> {
+        typedef StencilTable      Table;
+        typedef LimitStencilTable LimitTable;
+    };
+
+    //
+    //  The local point stencils of the PatchTable are single precision: they
+    //  are converted before being appended to tables of other precisions.
+    //
+    template <typename REAL>
+    StencilTableReal<REAL> const *
+    appendLocalPointStencils(TopologyRefiner const & refiner,
+                             StencilTableReal<REAL> const * baseStencilTable,
+                             StencilTable const * localPointStencilTable) {
+
+        StencilTableReal<REAL> const * localPointStencils =
+            StencilTableFactoryReal<REAL>::Create(*localPointStencilTable);
+
+        StencilTableReal<REAL> const * result =
+            StencilTableFactoryReal<REAL>::AppendLocalPointStencilTable(
+                refiner, baseStencilTable, localPointStencils);
+
+        delete localPointStencils;
+        return result;
+    }
+
+    template <>
+    StencilTableReal<float> const *
+    appendLocalPointStencils<float>(TopologyRefiner const & refiner,
+                             StencilTableReal<float> const * baseStencilTable,
+                             StencilTable const * localPointStencilTable) {
+
+        return StencilTableFactoryReal<float>::AppendLocalPointStencilTable(
+                refiner, baseStencilTable, localPointStencilTable);
+    }
+
+    template <typename REAL, class T, class U>
+    void interpolateLevel(PrimvarRefinerReal<REAL> const & primvarRefiner,
+                          typename StencilTableFactoryReal<REAL>::Options const & options,
+                          int level, T const & src, U & dst) {
+
+        switch (options.interpolationMode) {
+        case StencilTableFactoryReal<REAL>::INTERPOLATE_VERTEX:
+            primvarRefiner.Interpolate(level, src, dst);
+            break;
+        case StencilTableFactoryReal<REAL>::INTERPOLATE_VARYING:
+            primvarRefiner.InterpolateVarying(level, src, dst);
+            break;
+        default:
+            primvarRefiner.InterpolateFaceVarying(level, src, dst,
+                                                  options.fvarChannel);
+            break;
+        }
+    }
+
+    //
+    //  Applies a vertex edit of a refined level to the stencil of the edited
+    //  vertex, the edit value being the control vertex 'numControlVerts+edit'.
+    //
+    template <typename REAL>
+    void applyVertexEdit(TopologyRefiner const & refiner,
+                         HierarchicalEdits const & edits, int edit,
+                         int numControlVerts, int levelOffset,
+                         internal::StencilBuilder<REAL> & builder) {
+
+        Index vert = refiner.GetVertexEditVertex(edit);
+        if (vert == INDEX_INVALID) {
+            return;
+        }
+        HierarchicalEdits::Operation op = edits.GetVertexEditOperation(edit);
+        builder.ApplyVertexEdit(levelOffset + vert, numControlVerts + edit,
+            (op==HierarchicalEdits::SUBTRACT) ? (REAL)-1.0 : (REAL)1.0,
+            op==HierarchicalEdits::SET);
+    }
+
+    //
+    //  Orders the control vertices by increasing valence in the graph
+    //  connecting them to the stencils they support.
+    //
+    struct CompareVertexDegree {
+        CompareVertexDegree(Index const * vertOffsets) :
+            _vertOffsets(vertOffsets) { }
+
+        bool operator() (Index a, Index b) const {
+            return (_vertOffsets[a+1] - _vertOffsets[a]) <
+                   (_vertOffsets[b+1] - _vertOffsets[b]);
+        }
+
+        Index const * _vertOffsets;
+    };
+
+    //
+    //  Computes the Cuthill-McKee ordering of the bipartite graph connecting
+    //  each stencil to its supporting control vertices: a breadth-first
+    //  traversal from the vertices of lowest valence, emitting the stencils
+    //  as their first supporting vertex is dequeued. If only one of the two
+    //  sets is reordered, the other keeps its order and drives the traversal.
+    //  The orders map the new indices to the original ones.
+    //
+    void
+    computeStencilOrdering(int numControlVerts,
+                           std::vector<int> const & sizes,
+                           std::vector<Index> const & indices,
+                           bool reorderStencils, bool reorderControlVerts,
+                           std::vector<Index> & stencilOrder,
+                           std::vector<Index> & controlVertOrder) {
+
+        int numStencils = (int)sizes.size();
+
+        std::vector<Index> stencilOffsets(numStencils + 1, 0);
+        for (int i = 0; i < numStencils; ++i) {
+            stencilOffsets[i+1] = stencilOffsets[i] + sizes[i];
+        }
+
+        //  Gather the stencils supported by each control vertex
+        std::vector<Index> vertOffsets(numControlVerts + 1, 0);
+        for (int i = 0; i < (int)indices.size(); ++i) {
+            if (indices[i] < numControlVerts) {
+                ++vertOffsets[indices[i] + 1];
+            }
+        }
+        for (int i = 0; i < numControlVerts; ++i) {
+            vertOffsets[i+1] += vertOffsets[i];
+        }
+        std::vector<Index> vertStencils(vertOffsets[numControlVerts]);
+        {
+            std::vector<Index> vertCursor(vertOffsets.begin(),
+                                          vertOffsets.end() - 1);
+            for (int i = 0; i < numStencils; ++i) {
+                for (Index j = stencilOffsets[i]; j < stencilOffsets[i+1]; ++j) {
+                    if (indices[j] < numControlVerts) {
+                        vertStencils[vertCursor[indices[j]]++] = i;
+                    }
+                }
+            }
+        }
+
+        std::vector<char> stencilVisited(numStencils, 0),
+                          vertVisited(numControlVerts, 0);
+
+        stencilOrder.clear();
+        stencilOrder.reserve(numStencils);
+        controlVertOrder.clear();
+        controlVertOrder.reserve(numControlVerts);
+
+        if (!reorderControlVerts) {
+            //  Stencils sorted by their first supporting control vertex
+            for (Index v = 0; v < numControlVerts; ++v) {
+                vertVisited[v] = 1;
+                controlVertOrder.push_back(v);
+                if (!reorderStencils) continue;
+
+                for (Index j = vertOffsets[v]; j < vertOffsets[v+1]; ++j) {
+                    Index stencil = vertStencils[j];
+                    if (!stencilVisited[stencil]) {
+                        stencilVisited[stencil] = 1;
+                        stencilOrder.push_back(stencil);
+                    }
+                }
+            }
+        } else if (!reorderStencils) {
+            //  Control vertices numbered as first referenced by the stencils
+            for (Index i = 0; i < numStencils; ++i) {
+                stencilVisited[i] = 1;
+                stencilOrder.push_back(i);
+
+                for (Index j = stencilOffsets[i]; j < stencilOffsets[i+1]; ++j) {
+                    Index v = indices[j];
+                    if (v < numControlVerts && !vertVisited[v]) {
+                        vertVisited[v] = 1;
+                        controlVertOrder.push_back(v);
+                    }
+                }
+            }
+        } else {
+            CompareVertexDegree compareDegree(&vertOffsets[0]);
+
+            //  Seed each connected component with its vertex of lowest valence
+            std::vector<Index> seeds(numControlVerts);
+            for (Index v = 0; v < numControlVerts; ++v) {
+                seeds[v] = v;
+            }
+            std::stable_sort(seeds.begin(), seeds.end(), compareDegree);
+
+            //  The vertex order doubles as the queue of the traversal
+            int head = 0;
+            for (int seed = 0; seed < numControlVerts; ++seed) {
+                Index v = seeds[seed];
+                if (vertVisited[v] || (vertOffsets[v+1] == vertOffsets[v])) {
+                    continue;
+                }
+                vertVisited[v] = 1;
+                controlVertOrder.push_back(v);
+
+                for ( ; head < (int)controlVertOrder.size(); ++head) {
+                    Index vert = controlVertOrder[head];
+                    for (Index j = vertOffsets[vert]; j < vertOffsets[vert+1]; ++j) {
+                        Index stencil = vertStencils[j];
+                        if (stencilVisited[stencil]) continue;
+
+                        stencilVisited[stencil] = 1;
+                        stencilOrder.push_back(stencil);
+
+                        int first = (int)controlVertOrder.size();
+                        for (Index k = stencilOffsets[stencil];
+                             k < stencilOffsets[stencil+1]; ++k) {
+                            Index support = indices[k];
+                            if (support < numControlVerts && !vertVisited[support]) {
+                                vertVisited[support] = 1;
+                                controlVertOrder.push_back(support);
+                            }
+                        }
+                        //  Few vertices are queued per stencil: insertion sort
+                        for (int k = first + 1; k < (int)controlVertOrder.size(); ++k) {
+                            Index support = controlVertOrder[k];
+                            int l = k;
+                            for ( ; l > first &&
+                                  compareDegree(support, controlVertOrder[l-1]); --l) {
+                                controlVertOrder[l] = controlVertOrder[l-1];
+                            }
+                            controlVertOrder[l] = support;
+                        }
+                    }
+                }
+            }
+        }
+
+        //  Stencils without support and unreferenced control vertices last
+        for (Index i = 0; i < numStencils; ++i) {
+            if (!stencilVisited[i]) stencilOrder.push_back(i);
+        }
+        for (Index v = 0; v < numControlVerts; ++v) {
+            if (!vertVisited[v]) controlVertOrder.push_back(v);
+        }
+    }
 }
 
 //------------------------------------------------------------------------------
 
+template <typename REAL>
 void
-StencilTableFactory::generateControlVertStencils(
-    int numControlVerts, Stencil & dst) {
+StencilTableFactoryReal<REAL>::generateControlVertStencils(
+    int numControlVerts, StencilReal<REAL> & dst) {
 
     // Control vertices contribute a single index with a weight of 1.0
     for (int i=0; i<numControlVerts; ++i) {
         *dst._size = 1;
         *dst._indices = i;
-        *dst._weights = 1.0f;
+        *dst._weights = (REAL)1.0;
         dst.Next();
     }
 }
 
+template <typename REAL>
+void
+StencilTableFactoryReal<REAL>::applyBaseVertexEdits(
+    TopologyRefiner const & refiner, int numControlVerts,
+    StencilTableReal<REAL> & table) {
+
+    HierarchicalEdits const & edits = *refiner.GetHierarchicalEdits();
+
+    // Resolve the edits of each base vertex, in order, into a list of
+    // weighted sources starting with the vertex itself
+    typedef std::pair<Index, REAL> Source;
+
+    std::vector<std::vector<Source> > vertSources(numControlVerts);
+    bool hasBaseEdits = false;
+    for (int edit=0; edit<edits.GetNumVertexEdits(); ++edit) {
+        if (edits.GetVertexEditLevel(edit)!=0) continue;
+
+        Index vert = refiner.GetVertexEditVertex(edit);
+        if (vert==INDEX_INVALID) continue;
+
+        std::vector<Source> & vs = vertSources[vert];
+        if (vs.empty()) {
+            vs.push_back(Source(vert, (REAL)1.0));
+        }
+        Source editSource(numControlVerts + edit, (REAL)1.0);
+        switch (edits.GetVertexEditOperation(edit)) {
+        case HierarchicalEdits::SET:
+            vs.clear();
+            break;
+        case HierarchicalEdits::SUBTRACT:
+            editSource.second = (REAL)-1.0;
+            break;
+        default:
+            break;
+        }
+        vs.push_back(editSource);
+        hasBaseEdits = true;
+    }
+    if (! hasBaseEdits) {
+        return;
+    }
+
+    int numStencils = table.GetNumStencils();
+
+    std::vector<int> sizes(numStencils);
+    std::vector<Index> indices;
+    std::vector<REAL> weights;
+    indices.reserve(table._indices.size());
+    weights.reserve(table._weights.size());
+
+    for (int i=0, offset=0; i<numStencils; ++i) {
+        int size = table._sizes[i];
+        for (int j=offset; j<offset+size; ++j) {
+            Index src = table._indices[j];
+            REAL w = table._weights[j];
+            if (src>=numControlVerts || vertSources[src].empty()) {
+                indices.push_back(src);
+                weights.push_back(w);
+                ++sizes[i];
+                continue;
+            }
+            std::vector<Source> const & vs = vertSources[src];
+            for (int k=0; k<(int)vs.size(); ++k) {
+                indices.push_back(vs[k].first);
+                weights.push_back(w * vs[k].second);
+                ++sizes[i];
+            }
+        }
+        offset += size;
+    }
+
+    table._sizes.swap(sizes);
+    table._indices.swap(indices);
+    table._weights.swap(weights);
+    table.generateOffsets();
+}
+
 //
 // StencilTable factory
 //
-StencilTable const *
-StencilTableFactory::Create(TopologyRefiner const & refiner,
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::Create(TopologyRefiner const & refiner,
     Options options) {
 
-    bool interpolateVertex = options.interpolationMode==INTERPOLATE_VERTEX;
-    bool interpolateVarying = options.interpolationMode==INTERPOLATE_VARYING;
+    typedef typename StencilTableTypes<REAL>::Table Table;
+
     bool interpolateFaceVarying = options.interpolationMode==INTERPOLATE_FACE_VARYING;
 
     int numControlVertices = !interpolateFaceVarying
         ? refiner.GetLevel(0).GetNumVertices()
         : refiner.GetLevel(0).GetNumFVarValues(options.fvarChannel);
 
+    // The values of the vertex edits are read as additional control
+    // vertices following the base vertices of the refiner.
+    HierarchicalEdits const * edits =
+        (options.interpolationMode==INTERPOLATE_VERTEX)
+            ? refiner.GetHierarchicalEdits() : 0;
+    int numVertexEdits = edits ? edits->GetNumVertexEdits() : 0;
+    int numSourceVertices = numControlVertices + numVertexEdits;
+
+    // Level-to-level stencils refer to the vertices of the previous level,
+    // which have to be evaluated as well. The values of the vertex edits
+    // would be mistaken for vertices of the previous level.
+    bool levelToLevel = ! options.factorizeIntermediateLevels;
+    if (levelToLevel) {
+        options.generateIntermediateLevels = true;
+        if (numVertexEdits) {
+            Warning("Vertex edits are ignored by level-to-level stencils");
+            numVertexEdits = 0;
+            numSourceVertices = numControlVertices;
+        }
+    }
+
     int maxlevel = std::min(int(options.maxLevel), refiner.GetMaxLevel());
     if (maxlevel==0 && (! options.generateControlVerts)) {
-        StencilTable * result = new StencilTable;
-        result->_numControlVertices = numControlVertices;
+        Table * result = new Table;
+        result->_numControlVertices = numSourceVertices;
         return result;
     }
 
-    internal::StencilBuilder builder(numControlVertices,
+    internal::StencilBuilder<REAL> builder(numSourceVertices,
                                 /*genControlVerts*/ true,
                                 /*compactWeights*/  true);
 
@@ -98,18 +448,40 @@ StencilTableFactory::Create(TopologyRefiner const & refiner,
     // Interpolate stencils for each refinement level using
     // PrimvarRefiner::InterpolateLevel<>() for vertex or varying
     //
-    PrimvarRefiner primvarRefiner(refiner);
+    PrimvarRefinerReal<REAL> primvarRefiner(refiner);
+
+    typename internal::StencilBuilder<REAL>::Index srcIndex(&builder, 0);
+    typename internal::StencilBuilder<REAL>::Index dstIndex(&builder,
+                                                    numSourceVertices);
 
-    internal::StencilBuilder::Index srcIndex(&builder, 0);
-    internal::StencilBuilder::Index dstIndex(&builder, numControlVertices);
+    // When threaded, the masks of each level are first recorded and then
+    // factorized concurrently by the builder.
+    internal::LevelMasks<REAL> levelMasks;
+
+    // First vertex of each refined level (the stencils of level-to-level
+    // tables are evaluated in one pass per level)
+    std::vector<Index> levelVerts(1, numSourceVertices);
 
     for (int level=1; level<=maxlevel; ++level) {
-        if (interpolateVertex) {
-            primvarRefiner.Interpolate(level, srcIndex, dstIndex);
-        } else if (interpolateVarying) {
-            primvarRefiner.InterpolateVarying(level, srcIndex, dstIndex);
+        if (options.useThreads) {
+            levelMasks.Clear();
+
+            typename internal::LevelMasks<REAL>::Index
+                maskSrc(&levelMasks, srcIndex.GetOffset()),
+                maskDst(&levelMasks, dstIndex.GetOffset());
+
+            interpolateLevel(primvarRefiner, options, level, maskSrc, maskDst);
+
+            builder.AddLevelMasks(levelMasks, dstIndex.GetOffset());
         } else {
-            primvarRefiner.InterpolateFaceVarying(level, srcIndex, dstIndex, options.fvarChannel);
+            interpolateLevel(primvarRefiner, options, level, srcIndex, dstIndex);
+        }
+
+        for (int edit=0; edit<numVertexEdits; ++edit) {
+            if (edits->GetVertexEditLevel(edit) == level) {
+                applyVertexEdit(refiner, *edits, edit, numControlVertices,
+                    dstIndex.GetOffset(), builder);
+            }
         }
 
         if (options.factorizeIntermediateLevels) {
@@ -120,6 +492,7 @@ StencilTableFactory::Create(TopologyRefiner const & refiner,
             ? refiner.GetLevel(level).GetNumVertices()
             : refiner.GetLevel(level).GetNumFVarValues(options.fvarChannel);
         dstIndex = dstIndex[dstVertex];
+        levelVerts.push_back(dstIndex.GetOffset());
 
         if (! options.factorizeIntermediateLevels) {
             // All previous verts are considered as coarse verts, as a
@@ -129,27 +502,55 @@ StencilTableFactory::Create(TopologyRefiner const & refiner,
         }
     }
 
-    size_t firstOffset = numControlVertices;
+    size_t firstOffset = numSourceVertices;
     if (! options.generateIntermediateLevels)
         firstOffset = srcIndex.GetOffset();
  
     // Copy stencils from the StencilBuilder into the StencilTable.
     // Always initialize numControlVertices (useful for torus case)
-    StencilTable * result = 
-                        new StencilTable(numControlVertices,
-                                          builder.GetStencilOffsets(),
-                                          builder.GetStencilSizes(),
-                                          builder.GetStencilSources(),
-                                          builder.GetStencilWeights(),
-                                          options.generateControlVerts,
-                                          firstOffset);
+    // The trivial stencils of the edit values are skipped so that the
+    // stencils keep the numbering of the vertices of the refiner.
+    Table * result = new Table(numControlVertices,
+                               builder.GetStencilOffsets(),
+                               builder.GetStencilSizes(),
+                               builder.GetStencilSources(),
+                               builder.GetStencilWeights(),
+                               options.generateControlVerts,
+                               firstOffset);
+
+    if (levelToLevel) {
+        // The masks of each level refer to the vertices of the previous level
+        // by their index in the level : the passes read from the first vertex
+        // of the previous level. The stencils of the control vertices, if
+        // any, form the first pass.
+        int firstStencil = options.generateControlVerts ? 0 : numControlVertices;
+        if (options.generateControlVerts) {
+            result->_levelOffsets.push_back(0);
+            result->_levelSourceOffsets.push_back(0);
+        }
+        for (int level=1; level<=maxlevel; ++level) {
+            Index source = (level > 1) ? levelVerts[level-2] : 0;
+            result->_levelOffsets.push_back(levelVerts[level-1] - firstStencil);
+            result->_levelSourceOffsets.push_back(source - firstStencil);
+        }
+        result->_levelOffsets.push_back(levelVerts[maxlevel] - firstStencil);
+    }
+
+    if (numVertexEdits) {
+        result->_numControlVertices = numSourceVertices;
+        applyBaseVertexEdits(refiner, numControlVertices, *result);
+    }
     return result;
 }
 
 //------------------------------------------------------------------------------
 
-StencilTable const *
-StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::Create(int numTables,
+    StencilTableReal<REAL> const ** tables) {
+
+    typedef typename StencilTableTypes<REAL>::Table Table;
 
     // XXXtakahito:
     // This function returns NULL for empty inputs or erroneous condition.
@@ -167,13 +568,17 @@ StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
 
     for (int i=0; i<numTables; ++i) {
 
-        StencilTable const * st = tables[i];
+        StencilTableReal<REAL> const * st = tables[i];
         // allow the tables could have a null entry.
         if (!st) continue;
 
         if (ncvs >= 0 && st->GetNumControlVertices() != ncvs) {
             return NULL;
         }
+        // level-to-level stencils refer to the refined vertices of their table
+        if (! st->_levelOffsets.empty()) {
+            return NULL;
+        }
         ncvs = st->GetNumControlVertices();
         nstencils += st->GetNumStencils();
         nelems += (int)st->GetControlIndices().size();
@@ -183,21 +588,21 @@ StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
         return NULL;
     }
 
-    StencilTable * result = new StencilTable;
+    Table * result = new Table;
     result->resize(nstencils, nelems);
 
     int * sizes = &result->_sizes[0];
     Index * indices = &result->_indices[0];
-    float * weights = &result->_weights[0];
+    REAL * weights = &result->_weights[0];
     for (int i=0; i<numTables; ++i) {
-        StencilTable const * st = tables[i];
+        StencilTableReal<REAL> const * st = tables[i];
         if (!st) continue;
 
         int st_nstencils = st->GetNumStencils(),
             st_nelems = (int)st->_indices.size();
         memcpy(sizes, &st->_sizes[0], st_nstencils*sizeof(int));
         memcpy(indices, &st->_indices[0], st_nelems*sizeof(Index));
-        memcpy(weights, &st->_weights[0], st_nelems*sizeof(float));
+        memcpy(weights, &st->_weights[0], st_nelems*sizeof(REAL));
 
         sizes += st_nstencils;
         indices += st_nelems;
@@ -214,11 +619,113 @@ StencilTableFactory::Create(int numTables, StencilTable const ** tables) {
 
 //------------------------------------------------------------------------------
 
-StencilTable const *
-StencilTableFactory::AppendLocalPointStencilTable(
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::Create(StencilTableReal<float> const & table) {
+
+    return convert(table);
+}
+
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::Create(StencilTableReal<double> const & table) {
+
+    return convert(table);
+}
+
+template <typename REAL>
+template <typename OTHER_REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::convert(
+    StencilTableReal<OTHER_REAL> const & table) {
+
+    typedef typename StencilTableTypes<REAL>::Table Table;
+
+    Table * result = new Table(table.GetNumControlVertices());
+
+    result->_sizes = table._sizes;
+    result->_offsets = table._offsets;
+    result->_indices = table._indices;
+    result->_weights.assign(table._weights.begin(), table._weights.end());
+    result->_levelOffsets = table._levelOffsets;
+    result->_levelSourceOffsets = table._levelSourceOffsets;
+
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::Reorder(StencilTableReal<REAL> const & table,
+    std::vector<Index> * stencilPermutation,
+    std::vector<Index> * controlVertPermutation,
+    ReorderOptions options) {
+
+    typedef typename StencilTableTypes<REAL>::Table Table;
+
+    if (! table._levelOffsets.empty()) {
+        return NULL;
+    }
+
+    int numControlVerts = table.GetNumControlVertices(),
+        numStencils = table.GetNumStencils();
+
+    std::vector<Index> stencilOrder, controlVertOrder;
+    computeStencilOrdering(numControlVerts, table._sizes, table._indices,
+        options.reorderStencils, options.reorderControlVerts,
+        stencilOrder, controlVertOrder);
+
+    std::vector<Index> newVertIndex(numControlVerts);
+    for (int i = 0; i < numControlVerts; ++i) {
+        newVertIndex[controlVertOrder[i]] = i;
+    }
+
+    std::vector<Index> stencilOffsets(numStencils);
+    for (int i = 0, offset = 0; i < numStencils; ++i) {
+        stencilOffsets[i] = offset;
+        offset += table._sizes[i];
+    }
+
+    Table * result = new Table(numControlVerts);
+
+    result->resize(numStencils, (int)table._indices.size());
+
+    for (int i = 0, dst = 0; i < numStencils; ++i) {
+        Index stencil = stencilOrder[i];
+        int size = table._sizes[stencil],
+            src = stencilOffsets[stencil];
+
+        result->_sizes[i] = size;
+        for (int j = 0; j < size; ++j, ++src, ++dst) {
+            Index index = table._indices[src];
+            assert(index < numControlVerts);
+            result->_indices[dst] =
+                (index < numControlVerts) ? newVertIndex[index] : index;
+            result->_weights[dst] = table._weights[src];
+        }
+    }
+    if (!table._offsets.empty()) {
+        result->generateOffsets();
+    }
+
+    if (stencilPermutation) {
+        stencilPermutation->swap(stencilOrder);
+    }
+    if (controlVertPermutation) {
+        controlVertPermutation->swap(controlVertOrder);
+    }
+    return result;
+}
+
+//------------------------------------------------------------------------------
+
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::AppendLocalPointStencilTable(
     TopologyRefiner const &refiner,
-    StencilTable const * baseStencilTable,
-    StencilTable const * localPointStencilTable,
+    StencilTableReal<REAL> const * baseStencilTable,
+    StencilTableReal<REAL> const * localPointStencilTable,
     bool factorize) {
 
     return appendLocalPointStencilTable(
@@ -229,11 +736,12 @@ StencilTableFactory::AppendLocalPointStencilTable(
         factorize);
 }
 
-StencilTable const *
-StencilTableFactory::AppendLocalPointStencilTableFaceVarying(
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::AppendLocalPointStencilTableFaceVarying(
     TopologyRefiner const &refiner,
-    StencilTable const * baseStencilTable,
-    StencilTable const * localPointStencilTable,
+    StencilTableReal<REAL> const * baseStencilTable,
+    StencilTableReal<REAL> const * localPointStencilTable,
     int channel,
     bool factorize) {
 
@@ -245,11 +753,12 @@ StencilTableFactory::AppendLocalPointStencilTableFaceVarying(
         factorize);
 }
 
-StencilTable const *
-StencilTableFactory::appendLocalPointStencilTable(
+template <typename REAL>
+StencilTableReal<REAL> const *
+StencilTableFactoryReal<REAL>::appendLocalPointStencilTable(
     TopologyRefiner const &refiner,
-    StencilTable const * baseStencilTable,
-    StencilTable const * localPointStencilTable,
+    StencilTableReal<REAL> const * baseStencilTable,
+    StencilTableReal<REAL> const * localPointStencilTable,
     int channel,
     bool factorize) {
 
@@ -265,6 +774,41 @@ StencilTableFactory::appendLocalPointStencilTable(
         ? refiner.GetLevel(0).GetNumVertices()
         : refiner.GetLevel(0).GetNumFVarValues(channel);
 
+    // The local points of level-to-level stencils are not factorized: they
+    // are computed from the refined vertices in an additional pass, which
+    // reads from the first control vertex (the source of the first pass).
+    if (! baseStencilTable->_levelOffsets.empty()) {
+        typedef typename StencilTableTypes<REAL>::Table Table;
+
+        Table * result = new Table(baseStencilTable->GetNumControlVertices());
+        result->_sizes = baseStencilTable->_sizes;
+        result->_indices = baseStencilTable->_indices;
+        result->_weights.assign(baseStencilTable->_weights.begin(),
+            baseStencilTable->_weights.begin() + result->_indices.size());
+        result->_levelOffsets = baseStencilTable->_levelOffsets;
+        result->_levelSourceOffsets = baseStencilTable->_levelSourceOffsets;
+        result->_levelSourceOffsets.push_back(
+            baseStencilTable->_levelSourceOffsets[0]);
+
+        for (int i = 0; i < localPointStencilTable->GetNumStencils(); ++i) {
+            StencilReal<REAL> src = localPointStencilTable->GetStencil(i);
+            int size = 0;
+            for (int j = 0; j < src.GetSize(); ++j) {
+                Index index = src.GetVertexIndices()[j];
+                REAL weight = src.GetWeights()[j];
+                if (isWeightZero(weight)) continue;
+
+                result->_indices.push_back(index);
+                result->_weights.push_back(weight);
+                ++size;
+            }
+            result->_sizes.push_back(size);
+        }
+        result->_levelOffsets.push_back(result->GetNumStencils());
+        result->generateOffsets();
+        return result;
+    }
+
     int controlVertsIndexOffset = 0;
     int nBaseStencils = baseStencilTable->GetNumStencils();
     int nBaseStencilsElements = (int)baseStencilTable->_indices.size();
@@ -318,19 +862,23 @@ StencilTableFactory::appendLocalPointStencilTable(
     int nLocalPointStencils = localPointStencilTable->GetNumStencils();
     int nLocalPointStencilsElements = 0;
 
-    internal::StencilBuilder builder(nControlVerts,
+    // The base stencils may also reference the values of vertex edits,
+    // which follow the control vertices.
+    int nSourceVerts = baseStencilTable->GetNumControlVertices();
+
+    internal::StencilBuilder<REAL> builder(nSourceVerts,
                                 /*genControlVerts*/ false,
                                 /*compactWeights*/  factorize);
-    internal::StencilBuilder::Index origin(&builder, 0);
-    internal::StencilBuilder::Index dst = origin;
-    internal::StencilBuilder::Index srcIdx = origin;
+    typename internal::StencilBuilder<REAL>::Index origin(&builder, 0);
+    typename internal::StencilBuilder<REAL>::Index dst = origin;
+    typename internal::StencilBuilder<REAL>::Index srcIdx = origin;
 
     for (int i = 0 ; i < nLocalPointStencils; ++i) {
-        Stencil src = localPointStencilTable->GetStencil(i);
+        StencilReal<REAL> src = localPointStencilTable->GetStencil(i);
         dst = origin[i];
         for (int j = 0; j < src.GetSize(); ++j) {
             Index index = src.GetVertexIndices()[j];
-            float weight = src.GetWeights()[j];
+            REAL weight = src.GetWeights()[j];
             if (isWeightZero(weight)) continue;
 
             if (factorize) {
@@ -350,14 +898,16 @@ StencilTableFactory::appendLocalPointStencilTable(
     }
 
     // create new stencil table
-    StencilTable * result = new StencilTable;
-    result->_numControlVertices = nControlVerts;
+    typedef typename StencilTableTypes<REAL>::Table Table;
+
+    Table * result = new Table;
+    result->_numControlVertices = nSourceVerts;
     result->resize(nBaseStencils + nLocalPointStencils,
                    nBaseStencilsElements + nLocalPointStencilsElements);
 
     int* sizes = &result->_sizes[0];
     Index * indices = &result->_indices[0];
-    float * weights = &result->_weights[0];
+    REAL * weights = &result->_weights[0];
 
     // put base stencils first
     memcpy(sizes, &baseStencilTable->_sizes[0],
@@ -365,7 +915,7 @@ StencilTableFactory::appendLocalPointStencilTable(
     memcpy(indices, &baseStencilTable->_indices[0],
            nBaseStencilsElements*sizeof(Index));
     memcpy(weights, &baseStencilTable->_weights[0],
-           nBaseStencilsElements*sizeof(float));
+           nBaseStencilsElements*sizeof(REAL));
 
     sizes += nBaseStencils;
     indices += nBaseStencilsElements;
@@ -389,13 +939,16 @@ StencilTableFactory::appendLocalPointStencilTable(
 }
 
 //------------------------------------------------------------------------------
-LimitStencilTable const *
-LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
+template <typename REAL>
+LimitStencilTableReal<REAL> const *
+LimitStencilTableFactoryReal<REAL>::Create(TopologyRefiner const & refiner,
     LocationArrayVec const & locationArrays,
-        StencilTable const * cvStencilsIn,
+        StencilTableReal<REAL> const * cvStencilsIn,
           PatchTable const * patchTableIn,
                      Options options) {
 
+    typedef typename StencilTableTypes<REAL>::LimitTable LimitTable;
+
     // Compute the total number of stencils to generate
     int numStencils=0, numLimitStencils=0;
     for (int i=0; i<(int)locationArrays.size(); ++i) {
@@ -410,14 +963,14 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
 
     int maxlevel = refiner.GetMaxLevel();
 
-    StencilTable const * cvstencils = cvStencilsIn;
+    StencilTableReal<REAL> const * cvstencils = cvStencilsIn;
     if (! cvstencils) {
         // Generate stencils for the control vertices - this is necessary to
         // properly factorize patches with control vertices at level 0 (natural
         // regular patches, such as in a torus)
         // note: the control vertices of the mesh are added as single-index
         //       stencils of weight 1.0f
-        StencilTableFactory::Options stencilTableOptions;
+        typename StencilTableFactoryReal<REAL>::Options stencilTableOptions;
         stencilTableOptions.generateIntermediateLevels = uniform ? false :true;
         stencilTableOptions.generateControlVerts = true;
         stencilTableOptions.generateOffsets = true;
@@ -425,7 +978,8 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
         // PERFORMANCE: We could potentially save some mem-copies by not
         // instantiating the stencil tables and work directly off the source
         // data.
-        cvstencils = StencilTableFactory::Create(refiner, stencilTableOptions);
+        cvstencils = StencilTableFactoryReal<REAL>::Create(refiner,
+                                                           stencilTableOptions);
     } else {
         // Sanity checks
         //
@@ -459,8 +1013,8 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
             // if cvstencils is just created above, append endcap stencils
             if (StencilTable const *localPointStencilTable =
                 patchtable->GetLocalPointStencilTable()) {
-                StencilTable const *table =
-                    StencilTableFactory::AppendLocalPointStencilTable(
+                StencilTableReal<REAL> const *table =
+                    appendLocalPointStencils(
                         refiner, cvstencils, localPointStencilTable);
                 delete cvstencils;
                 cvstencils = table;
@@ -486,12 +1040,16 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
     // Generate limit stencils for locations
     //
 
-    internal::StencilBuilder builder(refiner.GetLevel(0).GetNumVertices(),
+    // The control vertices include the values of the vertex edits, if any
+    int numControlVertices = cvstencils->GetNumControlVertices();
+
+    internal::StencilBuilder<REAL> builder(numControlVertices,
                                 /*genControlVerts*/ false,
                                 /*compactWeights*/  true);
-    internal::StencilBuilder::Index origin(&builder, 0);
-    internal::StencilBuilder::Index dst = origin;
+    typename internal::StencilBuilder<REAL>::Index origin(&builder, 0);
+    typename internal::StencilBuilder<REAL>::Index dst = origin;
 
+    // Note: the patch basis is evaluated in single precision
     float wP[20], wDs[20], wDt[20], wDss[20], wDst[20], wDtt[20];
 
     for (size_t i=0; i<locationArrays.size(); ++i) {
@@ -499,15 +1057,15 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
         assert(array.ptexIdx>=0);
 
         for (int j=0; j<array.numLocations; ++j) { // for each face we're working on
-            float s = array.s[j],
-                  t = array.t[j]; // for each target (s,t) point on that face
+            float s = (float)array.s[j],
+                  t = (float)array.t[j]; // for each target (s,t) point on that face
 
             PatchMap::Handle const * handle = 
                                         patchmap.FindPatch(array.ptexIdx, s, t);
             if (handle) {
                 ConstIndexArray cvs = patchtable->GetPatchVertices(*handle);
 
-                StencilTable const & src = *cvstencils;
+                StencilTableReal<REAL> const & src = *cvstencils;
                 dst = origin[numLimitStencils];
 
                 if (options.generate2ndDerivatives) {
@@ -549,8 +1107,8 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
     //
     // Copy the proto-stencils into the limit stencil table
     //
-    LimitStencilTable * result = new LimitStencilTable(
-                                          refiner.GetLevel(0).GetNumVertices(),
+    LimitTable * result = new LimitTable(
+                                          numControlVertices,
                                           builder.GetStencilOffsets(),
                                           builder.GetStencilSizes(),
                                           builder.GetStencilSources(),
@@ -565,6 +1123,15 @@ LimitStencilTableFactory::Create(TopologyRefiner const & refiner,
     return result;
 }
 
+//
+//  Explicit instantiation for float and double:
+//
+template class StencilTableFactoryReal<float>;
+template class StencilTableFactoryReal<double>;
+
+template class LimitStencilTableFactoryReal<float>;
+template class LimitStencilTableFactoryReal<double>;
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
@@ -38,14 +38,24 @@ namespace Far {
 
 class TopologyRefiner;
 
-class Stencil;
+template <typename REAL> class StencilReal;
+template <typename REAL> class StencilTableReal;
+
+template <typename REAL> class LimitStencilReal;
+template <typename REAL> class LimitStencilTableReal;
+
 class StencilTable;
-class LimitStencil;
 class LimitStencilTable;
 
 /// \brief A specialized factory for StencilTable
 ///
-class StencilTableFactory {
+/// The factory is templated on the precision of the stencil weights: tables
+/// factorized with double precision weights accumulate significantly less
+/// round-off at high levels of refinement (see StencilTableFactory for the
+/// single precision factory).
+///
+template <typename REAL>
+class StencilTableFactoryReal {
 
 public:
 
@@ -63,6 +73,7 @@ public:
                     generateIntermediateLevels(true),
                     factorizeIntermediateLevels(true),
                     maxLevel(10),
+                    useThreads(false),
                     fvarChannel(0) { }
 
         unsigned int interpolationMode           : 2, ///< interpolation mode
@@ -71,8 +82,13 @@ public:
                      generateIntermediateLevels  : 1, ///< vertices at all levels or highest only
                      factorizeIntermediateLevels : 1, ///< accumulate stencil weights from control
                                                       ///  vertices or from the stencils of the
-                                                      ///  previous level
-                     maxLevel                    : 4; ///< generate stencils up to 'maxLevel'
+                                                      ///  previous level (level-to-level stencils,
+                                                      ///  evaluated in passes, see
+                                                      ///  StencilTableReal::GetLevelOffsets())
+                     maxLevel                    : 4, ///< generate stencils up to 'maxLevel'
+                     useThreads                  : 1; ///< factorize the stencils of each level
+                                                      ///  concurrently (requires OpenMP, the
+                                                      ///  result is identical to the serial one)
         unsigned int fvarChannel;                     ///< face-varying channel to use
                                                       ///  when generating face-varying stencils
     };
@@ -84,12 +100,21 @@ public:
     ///       been refined in the TopologyRefiner. Use RefineUniform() or
     ///       RefineAdaptive() before constructing the stencils.
     ///
+    /// Unless factorizeIntermediateLevels is set, the stencils of each level
+    /// only hold the subdivision masks of its vertices, which refer to the
+    /// vertices of the previous level. These tables are much smaller at high
+    /// levels of refinement, always include the intermediate levels and are
+    /// evaluated one level at a time in a buffer holding the control vertices
+    /// followed by the refined vertices (see
+    /// StencilTableReal::GetLevelSourceOffsets()). Vertex edits are not
+    /// supported by level-to-level stencils and are ignored.
+    ///
     /// @param refiner  The TopologyRefiner containing the topology
     ///
     /// @param options  Options controlling the creation of the table
     ///
-    static StencilTable const * Create(TopologyRefiner const & refiner,
-        Options options = Options());
+    static StencilTableReal<REAL> const * Create(
+        TopologyRefiner const & refiner, Options options = Options());
 
 
     /// \brief Instantiates StencilTable by concatenating an array of existing
@@ -98,13 +123,81 @@ public:
     /// \note This factory checks that the stencil tables point to the same set
     ///       of supporting control vertices - no re-indexing is done.
     ///       GetNumControlVertices() *must* return the same value for all input
-    ///       tables.
+    ///       tables. Tables of level-to-level stencils, which refer to their
+    ///       own refined vertices, cannot be concatenated (NULL is returned).
     ///
     /// @param numTables Number of input StencilTables
     ///
     /// @param tables    Array of input StencilTables
     ///
-    static StencilTable const * Create(int numTables, StencilTable const ** tables);
+    static StencilTableReal<REAL> const * Create(
+        int numTables, StencilTableReal<REAL> const ** tables);
+
+
+    /// \brief Instantiates StencilTable by converting the weights of an
+    ///        existing table of single precision.
+    ///
+    /// @param table     Input StencilTable
+    ///
+    static StencilTableReal<REAL> const * Create(
+        StencilTableReal<float> const & table);
+
+    /// \brief Instantiates StencilTable by converting the weights of an
+    ///        existing table of double precision.
+    ///
+    /// Tables factorized in double precision can be converted to single
+    /// precision for evaluation once complete.
+    ///
+    /// @param table     Input StencilTable
+    ///
+    static StencilTableReal<REAL> const * Create(
+        StencilTableReal<double> const & table);
+
+
+    struct ReorderOptions {
+
+        ReorderOptions() : reorderStencils(true),
+                           reorderControlVerts(true) { }
+
+        unsigned int reorderStencils     : 1, ///< sort the stencils of the table
+                     reorderControlVerts : 1; ///< renumber the supporting control
+                                              ///  vertices
+    };
+
+    /// \brief Instantiates StencilTable by reordering an existing table for
+    ///        cache locality.
+    ///
+    /// Control vertices and stencils are sorted in the Cuthill-McKee order of
+    /// the graph connecting each stencil to its supporting control vertices,
+    /// so that the evaluation of consecutive stencils streams through the
+    /// control vertex buffer. The coefficients of each stencil keep their
+    /// order, so evaluated values are identical to those of the input table.
+    ///
+    /// Both permutations map the new indices to the original ones: the
+    /// control values of the new table are gathered as
+    /// newValues[i] = values[controlVertPermutation[i]], and stencil i of the
+    /// new table evaluates stencil stencilPermutation[i] of the input table.
+    ///
+    /// \note The stencils of the input table must be factorized down to the
+    ///       control vertices (all indices less than GetNumControlVertices()) :
+    ///       tables of level-to-level stencils cannot be reordered (NULL is
+    ///       returned).
+    ///
+    /// @param table                  Input StencilTable
+    ///
+    /// @param stencilPermutation     Returns the original index of each
+    ///                               stencil (optional)
+    ///
+    /// @param controlVertPermutation Returns the original index of each
+    ///                               control vertex (optional)
+    ///
+    /// @param options                Options controlling the reordering
+    ///
+    static StencilTableReal<REAL> const * Reorder(
+        StencilTableReal<REAL> const & table,
+        std::vector<Index> * stencilPermutation,
+        std::vector<Index> * controlVertPermutation,
+        ReorderOptions options = ReorderOptions());
 
 
     /// \brief Utility function for stencil splicing for local point stencils.
@@ -119,12 +212,14 @@ public:
     /// @param factorize            If factorize set to true, endcap stencils will be
     ///                             factorized with supporting vertices from baseStencil
     ///                             table so that the endcap points can be computed
-    ///                             directly from control vertices.
+    ///                             directly from control vertices. The endcap stencils
+    ///                             of level-to-level tables are never factorized and
+    ///                             are evaluated in a last pass.
     ///
-    static StencilTable const * AppendLocalPointStencilTable(
+    static StencilTableReal<REAL> const * AppendLocalPointStencilTable(
         TopologyRefiner const &refiner,
-        StencilTable const *baseStencilTable,
-        StencilTable const *localPointStencilTable,
+        StencilTableReal<REAL> const *baseStencilTable,
+        StencilTableReal<REAL> const *localPointStencilTable,
         bool factorize = true);
 
     /// \brief Utility function for stencil splicing for local point
@@ -144,25 +239,36 @@ public:
     ///                             table so that the endcap points can be computed
     ///                             directly from control vertices.
     ///
-    static StencilTable const * AppendLocalPointStencilTableFaceVarying(
+    static StencilTableReal<REAL> const * AppendLocalPointStencilTableFaceVarying(
         TopologyRefiner const &refiner,
-        StencilTable const *baseStencilTable,
-        StencilTable const *localPointStencilTable,
+        StencilTableReal<REAL> const *baseStencilTable,
+        StencilTableReal<REAL> const *localPointStencilTable,
         int channel = 0,
         bool factorize = true);
 
-private:
+protected:
 
     // Generate stencils for the coarse control-vertices (single weight = 1.0f)
-    static void generateControlVertStencils(int numControlVerts, Stencil & dst);
+    static void generateControlVertStencils(int numControlVerts,
+        StencilReal<REAL> & dst);
 
     // Internal method to splice local point stencils
-    static StencilTable const * appendLocalPointStencilTable(
+    static StencilTableReal<REAL> const * appendLocalPointStencilTable(
         TopologyRefiner const &refiner,
-        StencilTable const * baseStencilTable,
-        StencilTable const * localPointStencilTable,
+        StencilTableReal<REAL> const * baseStencilTable,
+        StencilTableReal<REAL> const * localPointStencilTable,
         int channel,
         bool factorize);
+
+    // Internal method to substitute the edited base vertices referenced by
+    // the stencils of a table with the values of their vertex edits
+    static void applyBaseVertexEdits(TopologyRefiner const & refiner,
+        int numControlVerts, StencilTableReal<REAL> & table);
+
+    // Internal method to convert the weights of a table
+    template <typename OTHER_REAL>
+    static StencilTableReal<REAL> const * convert(
+        StencilTableReal<OTHER_REAL> const & table);
 };
 
 /// \brief A specialized factory for LimitStencilTable
@@ -176,7 +282,12 @@ private:
 /// normalized (s,t) patch coordinates. The factory exposes the LocationArray
 /// struct as a container for these location descriptors.
 ///
-class LimitStencilTableFactory {
+/// \note With double precision, the stencils of the refined vertices are
+///       factorized in double precision but the patch basis weights (and the
+///       local point stencils of the PatchTable) are single precision.
+///
+template <typename REAL>
+class LimitStencilTableFactoryReal {
 
 public:
 
@@ -188,8 +299,8 @@ public:
         int ptexIdx,        ///< ptex face index
             numLocations;   ///< number of (u,v) coordinates in the array
 
-        float const * s,    ///< array of u coordinates
-                    * t;    ///< array of v coordinates
+        REAL const * s,     ///< array of u coordinates
+                   * t;     ///< array of v coordinates
     };
 
     typedef std::vector<LocationArray> LocationArrayVec;
@@ -221,14 +332,100 @@ public:
     ///
     /// @param options          Options controlling the creation of the table
     ///
-    static LimitStencilTable const * Create(TopologyRefiner const & refiner,
+    static LimitStencilTableReal<REAL> const * Create(
+        TopologyRefiner const & refiner,
         LocationArrayVec const & locationArrays,
-            StencilTable const * cvStencils=0,
+            StencilTableReal<REAL> const * cvStencils=0,
               PatchTable const * patchTable=0,
                          Options options=Options());
 
 };
 
+/// \brief Stencil table factory class wrapping the template for compatibility.
+///
+class StencilTableFactory : public StencilTableFactoryReal<float> {
+protected:
+    typedef StencilTableFactoryReal<float> BaseFactory;
+    typedef StencilTableReal<float>        BaseTable;
+
+public:
+    static StencilTable const * Create(
+        TopologyRefiner const & refiner, Options options = Options()) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::Create(refiner, options));
+    }
+
+    static StencilTable const * Create(
+        int numTables, StencilTable const ** tables) {
+
+        std::vector<BaseTable const *> baseTables(tables, tables+numTables);
+        return static_cast<StencilTable const *>(BaseFactory::Create(
+                numTables, baseTables.empty() ? 0 : &baseTables[0]));
+    }
+
+    static StencilTable const * Create(
+        StencilTableReal<double> const & table) {
+
+        return static_cast<StencilTable const *>(BaseFactory::Create(table));
+    }
+
+    static StencilTable const * Reorder(
+        StencilTable const & table,
+        std::vector<Index> * stencilPermutation,
+        std::vector<Index> * controlVertPermutation,
+        ReorderOptions options = ReorderOptions()) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::Reorder(table, stencilPermutation,
+                    controlVertPermutation, options));
+    }
+
+    static StencilTable const * AppendLocalPointStencilTable(
+        TopologyRefiner const &refiner,
+        StencilTable const *baseStencilTable,
+        StencilTable const *localPointStencilTable,
+        bool factorize = true) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::AppendLocalPointStencilTable(refiner,
+                    baseStencilTable, localPointStencilTable, factorize));
+    }
+
+    static StencilTable const * AppendLocalPointStencilTableFaceVarying(
+        TopologyRefiner const &refiner,
+        StencilTable const *baseStencilTable,
+        StencilTable const *localPointStencilTable,
+        int channel = 0,
+        bool factorize = true) {
+
+        return static_cast<StencilTable const *>(
+                BaseFactory::AppendLocalPointStencilTableFaceVarying(refiner,
+                    baseStencilTable, localPointStencilTable,
+                    channel, factorize));
+    }
+};
+
+/// \brief Limit stencil table factory class wrapping the template for
+///        compatibility.
+///
+class LimitStencilTableFactory : public LimitStencilTableFactoryReal<float> {
+protected:
+    typedef LimitStencilTableFactoryReal<float> BaseFactory;
+
+public:
+    static LimitStencilTable const * Create(TopologyRefiner const & refiner,
+        LocationArrayVec const & locationArrays,
+            StencilTable const * cvStencils = 0,
+              PatchTable const * patchTable = 0,
+                         Options options = Options()) {
+
+        return static_cast<LimitStencilTable const *>(
+                BaseFactory::Create(refiner, locationArrays,
+                    cvStencils, patchTable, options));
+    }
+};
+
 
 } // end namespace Far
 
@@ -53,7 +53,8 @@ TopologyRefiner::TopologyRefiner(Sdc::SchemeType schemeType, Sdc::Options scheme
     _totalEdges(0),
     _totalFaces(0),
     _totalFaceVertices(0),
-    _maxValence(0) {
+    _maxValence(0),
+    _edits(0) {
 
     //  Need to revisit allocation scheme here -- want to use smart-ptrs for these
     //  but will probably have to settle for explicit new/delete...
@@ -72,6 +73,29 @@ TopologyRefiner::~TopologyRefiner() {
     for (int i=0; i<(int)_refinements.size(); ++i) {
         delete _refinements[i];
     }
+
+    delete _edits;
+}
+
+size_t
+TopologyRefiner::GetMemoryUsage(MemoryUsage * usage,
+                                std::string const & prefix) const {
+
+    MemoryUsage localUsage;
+    if (! usage) {
+        usage = &localUsage;
+    }
+    size_t total = usage->GetTotal();
+
+    for (int i=0; i<(int)_levels.size(); ++i) {
+        _levels[i]->getMemoryUsage(*usage,
+            prefix + MemoryUsage::GetIndexedName("level", i));
+    }
+    for (int i=0; i<(int)_refinements.size(); ++i) {
+        _refinements[i]->getMemoryUsage(*usage,
+            prefix + MemoryUsage::GetIndexedName("refinement", i));
+    }
+    return usage->GetTotal() - total;
 }
 
 void
@@ -93,6 +117,236 @@ TopologyRefiner::Unrefine() {
 }
 
 
+//
+//  Hierarchical edits -- assigned prior to refinement and applied to each level
+//  as it is refined.  Sharpness and hole edits of the base level are applied to
+//  it immediately as they persist when unrefined:
+//
+void
+TopologyRefiner::SetHierarchicalEdits(HierarchicalEdits const & edits) {
+
+    if (_levels[0]->getNumVertices() == 0) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::SetHierarchicalEdits() -- base level is uninitialized.");
+        return;
+    }
+    if (_refinements.size()) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::SetHierarchicalEdits() -- previous refinements already applied.");
+        return;
+    }
+    if (_edits) {
+        Error(FAR_RUNTIME_ERROR,
+            "Failure in TopologyRefiner::SetHierarchicalEdits() -- edits already assigned.");
+        return;
+    }
+    _edits = new HierarchicalEdits(edits);
+
+    applyHierarchicalEdits(0);
+}
+
+Index
+TopologyRefiner::GetVertexEditVertex(int edit) const {
+
+    HierarchicalEdits::Edit const & vertexEdit = _edits->_vertexEdits[edit];
+
+    if ((int)vertexEdit.level > (int)_refinements.size()) {
+        return INDEX_INVALID;
+    }
+    Index face = findEditFace(vertexEdit, vertexEdit.level);
+    if (!IndexIsValid(face)) {
+        return INDEX_INVALID;
+    }
+    ConstIndexArray fVerts = _levels[vertexEdit.level]->getFaceVertices(face);
+    return (vertexEdit.component < fVerts.size()) ? fVerts[vertexEdit.component] : INDEX_INVALID;
+}
+
+//
+//  Follows the path of an edit down to the given level (no deeper than the level
+//  of the edit) -- the path is invalid if a face along it was not refined:
+//
+Index
+TopologyRefiner::findEditFace(HierarchicalEdits::Edit const & edit, int level) const {
+
+    Index face = edit.baseFace;
+    if (face >= _levels[0]->getNumFaces()) {
+        return INDEX_INVALID;
+    }
+
+    int const * subfaces = _edits->getSubfaces(edit);
+    for (int i = 0; i < level; ++i) {
+        ConstIndexArray childFaces = _refinements[i]->getFaceChildFaces(face);
+        if ((subfaces[i] < 0) || (subfaces[i] >= childFaces.size())) {
+            return INDEX_INVALID;
+        }
+        face = childFaces[subfaces[i]];
+        if (!IndexIsValid(face)) {
+            return INDEX_INVALID;
+        }
+    }
+    return face;
+}
+
+namespace {
+    float
+    applySharpnessEdit(HierarchicalEdits::Operation op, float sharpness, float value) {
+
+        switch (op) {
+            case HierarchicalEdits::SET:      sharpness  = value; break;
+            case HierarchicalEdits::ADD:      sharpness += value; break;
+            case HierarchicalEdits::SUBTRACT: sharpness -= value; break;
+        }
+        return std::max(Sdc::Crease::SHARPNESS_SMOOTH,
+                        std::min(Sdc::Crease::SHARPNESS_INFINITE, sharpness));
+    }
+
+    //
+    //  Updates the tags of a vertex that depend on its sharpness and on that of
+    //  its incident edges once either has been edited -- mirroring the initial
+    //  tagging of the base level by TopologyRefinerFactory:
+    //
+    void
+    retagSharpVertex(Vtr::internal::Level & level, Index vIndex,
+                     Sdc::Crease const & creasing, int regularValence) {
+
+        Vtr::internal::Level::VTag & vTag = level.getVertexTag(vIndex);
+
+        float vSharpness = level.getVertexSharpness(vIndex);
+
+        ConstIndexArray vEdges = level.getVertexEdges(vIndex);
+        ConstIndexArray vFaces = level.getVertexFaces(vIndex);
+
+        int infSharpEdgeCount  = 0;
+        int semiSharpEdgeCount = 0;
+        for (int i = 0; i < vEdges.size(); ++i) {
+            Vtr::internal::Level::ETag const & eTag = level.getEdgeTag(vEdges[i]);
+
+            infSharpEdgeCount  += eTag._infSharp;
+            semiSharpEdgeCount += eTag._semiSharp;
+        }
+
+        vTag._infSharp       = Sdc::Crease::IsInfinite(vSharpness);
+        vTag._semiSharp      = Sdc::Crease::IsSemiSharp(vSharpness);
+        vTag._semiSharpEdges = (semiSharpEdgeCount > 0);
+        vTag._infSharpEdges  = (infSharpEdgeCount > 0);
+
+        vTag._rule = (Vtr::internal::Level::VTag::VTagSize)creasing.DetermineVertexVertexRule(
+                        vSharpness, infSharpEdgeCount + semiSharpEdgeCount);
+
+        vTag._corner = (vFaces.size() == 1) && (vEdges.size() == 2) && vTag._infSharp;
+        if (vTag._corner) {
+            vTag._xordinary = false;
+        } else if (vTag._boundary) {
+            vTag._xordinary = (vFaces.size() != regularValence / 2);
+        } else {
+            vTag._xordinary = (vFaces.size() != regularValence);
+        }
+
+        vTag._infSharpCrease = false;
+        vTag._infIrregular   = vTag._infSharp || vTag._infSharpEdges;
+
+        if (vTag._infSharpEdges) {
+            Sdc::Crease::Rule infRule = creasing.DetermineVertexVertexRule(
+                        (vTag._infSharp ? vSharpness : 0.0f), infSharpEdgeCount);
+
+            if (infRule == Sdc::Crease::RULE_CREASE) {
+                vTag._infSharpCrease = true;
+
+                if (!vTag._xordinary && !vTag._nonManifold) {
+                    if (vTag._boundary) {
+                        vTag._infIrregular = false;
+                    } else if (regularValence == 4) {
+                        vTag._infIrregular = (level.getEdgeTag(vEdges[0])._infSharp !=
+                                              level.getEdgeTag(vEdges[2])._infSharp);
+                    } else if (regularValence == 6) {
+                        vTag._infIrregular = (level.getEdgeTag(vEdges[0])._infSharp !=
+                                              level.getEdgeTag(vEdges[3])._infSharp) ||
+                                             (level.getEdgeTag(vEdges[1])._infSharp !=
+                                              level.getEdgeTag(vEdges[4])._infSharp);
+                    }
+                }
+            } else if (infRule == Sdc::Crease::RULE_CORNER) {
+                if ((infSharpEdgeCount == vEdges.size() && ((vEdges.size() > 2) || vTag._infSharp))) {
+                    vTag._infIrregular = false;
+                }
+            }
+        }
+    }
+}
+
+//
+//  Applies the sharpness and hole edits of a level -- sharpness edits are only
+//  relevant to levels that will be further refined, which requires the edges to
+//  be present (i.e. not when minimal topology was generated for the last level):
+//
+void
+TopologyRefiner::applyHierarchicalEdits(int level) {
+
+    Vtr::internal::Level & editLevel = *_levels[level];
+
+    bool edgesPresent = (editLevel.getNumFaceEdgesTotal() > 0) &&
+                        (editLevel.getNumVertexEdgesTotal() > 0);
+
+    std::vector<Index> editedVerts;
+
+    for (int i = 0; i < (int)_edits->_topologyEdits.size(); ++i) {
+        HierarchicalEdits::Edit const & edit = _edits->_topologyEdits[i];
+        if ((int)edit.level != level) continue;
+
+        Index face = findEditFace(edit, level);
+        if (!IndexIsValid(face)) continue;
+
+        if (edit.type == HierarchicalEdits::FACE_HOLE) {
+            editLevel.setFaceHole(face, true);
+            _hasHoles = true;
+            continue;
+        }
+        if (!edgesPresent) continue;
+
+        ConstIndexArray fVerts = editLevel.getFaceVertices(face);
+        if (edit.component >= fVerts.size()) continue;
+
+        HierarchicalEdits::Operation op = (HierarchicalEdits::Operation)edit.op;
+        float value = _edits->getSharpness(edit);
+
+        if (edit.type == HierarchicalEdits::VERTEX_SHARPNESS) {
+            Index vert = fVerts[edit.component];
+
+            float & vSharpness = editLevel.getVertexSharpness(vert);
+            vSharpness = applySharpnessEdit(op, vSharpness, value);
+
+            editedVerts.push_back(vert);
+        } else {
+            Index edge = editLevel.getFaceEdges(face)[edit.component];
+
+            //  Boundary and non-manifold edges remain infinitely sharp:
+            Vtr::internal::Level::ETag & eTag = editLevel.getEdgeTag(edge);
+            if (eTag._boundary || eTag._nonManifold) continue;
+
+            float & eSharpness = editLevel.getEdgeSharpness(edge);
+            eSharpness = applySharpnessEdit(op, eSharpness, value);
+
+            eTag._infSharp  = Sdc::Crease::IsInfinite(eSharpness);
+            eTag._semiSharp = Sdc::Crease::IsSharp(eSharpness) && !eTag._infSharp;
+
+            ConstIndexArray eVerts = editLevel.getEdgeVertices(edge);
+            editedVerts.push_back(eVerts[0]);
+            editedVerts.push_back(eVerts[1]);
+        }
+    }
+
+    if (editedVerts.empty()) return;
+
+    Sdc::Crease creasing(_subdivOptions);
+    int regularValence = Sdc::SchemeTypeTraits::GetRegularVertexValence(_subdivType);
+
+    for (int i = 0; i < (int)editedVerts.size(); ++i) {
+        if (!editLevel.getVertexTag(editedVerts[i])._incomplete) {
+            retagSharpVertex(editLevel, editedVerts[i], creasing, regularValence);
+        }
+    }
+}
+
 //
 //  Initializing and updating the component inventory:
 //
@@ -217,6 +471,7 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
     Vtr::internal::Refinement::Options refineOptions;
     refineOptions._sparse         = false;
     refineOptions._faceVertsFirst = options.orderVerticesFromFacesFirst;
+    refineOptions._useThreads     = options.useThreads;
 
     for (int i = 1; i <= (int)options.refinementLevel; ++i) {
         refineOptions._minimalTopology =
@@ -235,6 +490,10 @@ TopologyRefiner::RefineUniform(UniformOptions options) {
 
         appendLevel(childLevel);
         appendRefinement(*refinement);
+
+        if (_edits) {
+            applyHierarchicalEdits(i);
+        }
     }
     assembleFarLevels();
 }
@@ -357,9 +616,9 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
             "Failure in TopologyRefiner::RefineAdaptive() -- previous refinements already applied.");
         return;
     }
-    if (_subdivType != Sdc::SCHEME_CATMARK) {
+    if ((_subdivType != Sdc::SCHEME_CATMARK) && (_subdivType != Sdc::SCHEME_LOOP)) {
         Error(FAR_RUNTIME_ERROR,
-            "Failure in TopologyRefiner::RefineAdaptive() -- currently only supported for Catmark scheme.");
+            "Failure in TopologyRefiner::RefineAdaptive() -- currently only supported for Catmark and Loop schemes.");
         return;
     }
 
@@ -379,6 +638,12 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
 
     int potentialMaxLevel = deeperLevel;
 
+    //  Faces of hierarchical edits deeper than the isolation level also need to
+    //  be isolated -- though no features are selected beyond that level:
+    if (_edits) {
+        potentialMaxLevel = std::max(potentialMaxLevel, std::min(_edits->GetMaxLevel(), 15));
+    }
+
     internal::FeatureMask moreFeaturesMask(options, _subdivType);
     internal::FeatureMask lessFeaturesMask = moreFeaturesMask;
 
@@ -409,6 +674,7 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
     refineOptions._sparse          = true;
     refineOptions._minimalTopology = false;
     refineOptions._faceVertsFirst  = options.orderVerticesFromFacesFirst;
+    refineOptions._useThreads      = options.useThreads;
 
     Sdc::Split splitType = Sdc::SchemeTypeTraits::GetTopologicalSplitType(_subdivType);
 
@@ -430,7 +696,12 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
         //
         Vtr::internal::SparseSelector selector(*refinement);
 
-        selectFeatureAdaptiveComponents(selector, (i <= shallowLevel) ? moreFeaturesMask : lessFeaturesMask);
+        if (i <= deeperLevel) {
+            selectFeatureAdaptiveComponents(selector, (i <= shallowLevel) ? moreFeaturesMask : lessFeaturesMask);
+        }
+        if (_edits) {
+            selectHierarchicalEditFaces(selector);
+        }
         if (selector.isSelectionEmpty()) {
             delete refinement;
             delete &childLevel;
@@ -440,6 +711,10 @@ TopologyRefiner::RefineAdaptive(AdaptiveOptions options) {
 
             appendLevel(childLevel);
             appendRefinement(*refinement);
+
+            if (_edits) {
+                applyHierarchicalEdits(i);
+            }
         }
     }
     _maxLevel = (unsigned int) _refinements.size();
@@ -725,6 +1000,38 @@ TopologyRefiner::selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector&
     }
 }
 
+//
+//  Selects the faces along the paths of the hierarchical edits deeper than the
+//  level, along with all faces incident their vertices, so that the neighborhood
+//  of the edited components is fully refined:
+//
+void
+TopologyRefiner::selectHierarchicalEditFaces(Vtr::internal::SparseSelector& selector) {
+
+    Vtr::internal::Level const& level = selector.getRefinement().parent();
+    int levelDepth = level.getDepth();
+
+    for (int type = 0; type < 2; ++type) {
+        std::vector<HierarchicalEdits::Edit> const & edits =
+            type ? _edits->_topologyEdits : _edits->_vertexEdits;
+
+        for (int i = 0; i < (int)edits.size(); ++i) {
+            if ((int)edits[i].level <= levelDepth) continue;
+
+            Index face = findEditFace(edits[i], levelDepth);
+            if (!IndexIsValid(face)) continue;
+
+            ConstIndexArray fVerts = level.getFaceVertices(face);
+            for (int j = 0; j < fVerts.size(); ++j) {
+                ConstIndexArray vFaces = level.getVertexFaces(fVerts[j]);
+                for (int k = 0; k < vFaces.size(); ++k) {
+                    selector.selectFace(vFaces[k]);
+                }
+            }
+        }
+    }
+}
+
 } // end namespace Far
 
 } // end namespace OPENSUBDIV_VERSION
@@ -30,7 +30,9 @@
 #include "../sdc/options.h"
 #include "../far/types.h"
 #include "../far/topologyLevel.h"
+#include "../far/hierarchicalEdits.h"
 
+#include <string>
 #include <vector>
 
 
@@ -43,6 +45,7 @@ namespace Far { namespace internal { class FeatureMask; } }
 namespace Far {
 
 template <class MESH> class TopologyRefinerFactory;
+template <typename REAL> class PrimvarRefinerReal;
 
 ///
 ///  \brief Stores topology data for a specified set of refinement options.
@@ -93,6 +96,18 @@ public:
     /// \brief Returns a handle to access data specific to a particular level
     TopologyLevel const & GetLevel(int level) const { return _farLevels[level]; }
 
+    /// \brief Returns the memory used by the refiner (in bytes)
+    ///
+    /// @param usage   Optional breakdown to which the vectors of the levels
+    ///                ("level[i]/...") and refinements ("refinement[i]/...")
+    ///                are added, including their face-varying channels
+    ///                ("level[i]/fvar[c]/...")
+    ///
+    /// @param prefix  Prefix of the names of the components in the breakdown
+    ///
+    size_t GetMemoryUsage(MemoryUsage * usage = 0,
+                          std::string const & prefix = std::string()) const;
+
     //@{
     ///  @name High-level refinement and related methods
     ///
@@ -119,14 +134,17 @@ public:
         UniformOptions(int level) :
             refinementLevel(level),
             orderVerticesFromFacesFirst(false),
-            fullTopologyInLastLevel(false) { }
+            fullTopologyInLastLevel(false),
+            useThreads(false) { }
 
         unsigned int refinementLevel:4,             ///< Number of refinement iterations
                      orderVerticesFromFacesFirst:1, ///< Order child vertices from faces first
                                                     ///< instead of child vertices of vertices
-                     fullTopologyInLastLevel:1;     ///< Skip topological relationships in the last
+                     fullTopologyInLastLevel:1,     ///< Skip topological relationships in the last
                                                     ///< level of refinement that are not needed for
                                                     ///< interpolation (keep false if using limit).
+                     useThreads:1;                  ///< Refine each level concurrently (requires
+                                                    ///< OpenMP, the result is unchanged)
     };
 
     /// \brief Refine the topology uniformly
@@ -157,7 +175,8 @@ public:
             useSingleCreasePatch(false),
             useInfSharpPatch(false),
             considerFVarChannels(false),
-            orderVerticesFromFacesFirst(false) { }
+            orderVerticesFromFacesFirst(false),
+            useThreads(false) { }
 
         unsigned int isolationLevel:4;              ///< Number of iterations applied to isolate
                                                     ///< extraordinary vertices and creases
@@ -171,9 +190,11 @@ public:
                                                     ///< isolate when irregular features present
         unsigned int orderVerticesFromFacesFirst:1; ///< Order child vertices from faces first
                                                     ///< instead of child vertices of vertices
+        unsigned int useThreads:1;                  ///< Refine each level concurrently (requires
+                                                    ///< OpenMP, the result is unchanged)
     };
 
-    /// \brief Feature Adaptive topology refinement (restricted to scheme Catmark)
+    /// \brief Feature Adaptive topology refinement (restricted to schemes Catmark and Loop)
     ///
     /// @param options   Options controlling adaptive refinement
     ///
@@ -185,6 +206,30 @@ public:
     /// \brief Unrefine the topology, keeping only the base level.
     void Unrefine();
 
+    //@}
+
+    //@{
+    ///  @name Hierarchical edits
+    ///
+
+    /// \brief Assigns the hierarchical edits applied by the refinement
+    ///
+    /// The edits are copied and can only be assigned once, prior to any
+    /// refinement.  The sharpness and hole edits of the base level are
+    /// applied to it immediately, those of deeper levels as each level is
+    /// refined.  Adaptive refinement also isolates the faces of the edits,
+    /// refining beyond the isolation level if needed.
+    ///
+    void SetHierarchicalEdits(HierarchicalEdits const & edits);
+
+    /// \brief Returns the hierarchical edits assigned (if any)
+    HierarchicalEdits const * GetHierarchicalEdits() const { return _edits; }
+
+    /// \brief Returns the vertex edited by a vertex edit in the level of the
+    ///        edit, or INDEX_INVALID if that level was not refined there
+    Index GetVertexEditVertex(int edit) const;
+
+    //@}
 
     //@{
     /// @name Number and properties of face-varying channels:
@@ -213,7 +258,7 @@ protected:
     friend class EndCapGregoryBasisPatchFactory;
     friend class EndCapLegacyGregoryPatchFactory;
     friend class PtexIndices;
-    friend class PrimvarRefiner;
+    template <typename REAL> friend class PrimvarRefinerReal;
 
     Vtr::internal::Level & getLevel(int l) { return *_levels[l]; }
     Vtr::internal::Level const & getLevel(int l) const { return *_levels[l]; }
@@ -223,12 +268,16 @@ protected:
 
 private:
     //  Not default constructible or copyable:
-    TopologyRefiner() : _uniformOptions(0), _adaptiveOptions(0) { }
-    TopologyRefiner(TopologyRefiner const &) : _uniformOptions(0), _adaptiveOptions(0) { }
+    TopologyRefiner() : _uniformOptions(0), _adaptiveOptions(0), _edits(0) { }
+    TopologyRefiner(TopologyRefiner const &) : _uniformOptions(0), _adaptiveOptions(0), _edits(0) { }
     TopologyRefiner & operator=(TopologyRefiner const &) { return *this; }
 
     void selectFeatureAdaptiveComponents(Vtr::internal::SparseSelector& selector,
                                          internal::FeatureMask const & mask);
+    void selectHierarchicalEditFaces(Vtr::internal::SparseSelector& selector);
+
+    Index findEditFace(HierarchicalEdits::Edit const & edit, int level) const;
+    void  applyHierarchicalEdits(int level);
 
     void initializeInventory();
     void updateInventory(Vtr::internal::Level const & newLevel);
@@ -262,6 +311,8 @@ private:
     std::vector<Vtr::internal::Refinement *> _refinements;
 
     std::vector<TopologyLevel> _farLevels;
+
+    HierarchicalEdits * _edits;
 };
 
 
@@ -119,13 +119,14 @@ TopologyRefinerFactoryBase::prepareComponentTopologySizing(TopologyRefiner& refi
 
 bool
 TopologyRefinerFactoryBase::prepareComponentTopologyAssignment(TopologyRefiner& refiner, bool fullValidation,
-                                                               TopologyCallback callback, void const * callbackData) {
+                                                               TopologyCallback callback, void const * callbackData,
+                                                               bool useThreads) {
 
     Vtr::internal::Level& baseLevel = refiner.getLevel(0);
 
     bool completeMissingTopology = (baseLevel.getNumEdges() == 0);
     if (completeMissingTopology) {
-        if (! baseLevel.completeTopologyFromFaceVertices()) {
+        if (! baseLevel.completeTopologyFromFaceVertices(useThreads)) {
             char msg[1024];
             snprintf(msg, 1024, "Failure in TopologyRefinerFactory<>::Create() -- "
                     "vertex with valence %d > %d max.",
@@ -160,7 +161,7 @@ TopologyRefinerFactoryBase::prepareComponentTopologyAssignment(TopologyRefiner&
 }
 
 bool
-TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& refiner) {
+TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& refiner, bool useThreads) {
 
     //
     //  This method combines the initialization of internal component tags with the sharpening
@@ -182,6 +183,9 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
     //  Process the Edge tags first, as Vertex tags (notably the Rule) are dependent on
     //  properties of their incident edges.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useThreads)
+#endif
     for (Vtr::Index eIndex = 0; eIndex < baseLevel.getNumEdges(); ++eIndex) {
         Vtr::internal::Level::ETag& eTag       = baseLevel.getEdgeTag(eIndex);
         float&                      eSharpness = baseLevel.getEdgeSharpness(eIndex);
@@ -201,6 +205,9 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
     int schemeRegularInteriorValence = Sdc::SchemeTypeTraits::GetRegularVertexValence(refiner.GetSchemeType());
     int schemeRegularBoundaryValence = schemeRegularInteriorValence / 2;
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useThreads)
+#endif
     for (Vtr::Index vIndex = 0; vIndex < baseLevel.getNumVertices(); ++vIndex) {
         Vtr::internal::Level::VTag& vTag       = baseLevel.getVertexTag(vIndex);
         float&                      vSharpness = baseLevel.getVertexSharpness(vIndex);
@@ -315,16 +322,22 @@ TopologyRefinerFactoryBase::prepareComponentTagsAndSharpness(TopologyRefiner& re
             }
         }
 
-        //
-        //  Having just decided if a vertex is on a boundary, and with its incident faces
-        //  available, mark incident faces as holes.
-        //
-        if (makeBoundaryFacesHoles && vTag._boundary) {
-            for (int i = 0; i < vFaces.size(); ++i) {
-                baseLevel.getFaceTag(vFaces[i])._hole = true;
+    }
 
-                //  Don't forget this -- but it will eventually move to the Level
-                refiner._hasHoles = true;
+    //
+    //  Now that it is known which vertices are on a boundary, mark their incident faces
+    //  as holes -- done separately as faces are shared by the vertices above:
+    //
+    if (makeBoundaryFacesHoles) {
+        for (Vtr::Index vIndex = 0; vIndex < baseLevel.getNumVertices(); ++vIndex) {
+            if (baseLevel.getVertexTag(vIndex)._boundary) {
+                Vtr::ConstIndexArray vFaces = baseLevel.getVertexFaces(vIndex);
+                for (int i = 0; i < vFaces.size(); ++i) {
+                    baseLevel.getFaceTag(vFaces[i])._hole = true;
+
+                    //  Don't forget this -- but it will eventually move to the Level
+                    refiner._hasHoles = true;
+                }
             }
         }
     }
@@ -55,8 +55,9 @@ protected:
 
     static bool prepareComponentTopologySizing(TopologyRefiner& refiner);
     static bool prepareComponentTopologyAssignment(TopologyRefiner& refiner, bool fullValidation,
-                                                   TopologyCallback callback, void const * callbackData);
-    static bool prepareComponentTagsAndSharpness(TopologyRefiner& refiner);
+                                                   TopologyCallback callback, void const * callbackData,
+                                                   bool useThreads = false);
+    static bool prepareComponentTagsAndSharpness(TopologyRefiner& refiner, bool useThreads = false);
     static bool prepareFaceVaryingChannels(TopologyRefiner& refiner);
 };
 
@@ -86,7 +87,8 @@ public:
         Options(Sdc::SchemeType sdcType = Sdc::SCHEME_CATMARK, Sdc::Options sdcOptions = Sdc::Options()) :
             schemeType(sdcType),
             schemeOptions(sdcOptions),
-            validateFullTopology(false) { }
+            validateFullTopology(false),
+            useThreads(false) { }
 
         Sdc::SchemeType schemeType;             ///< The subdivision scheme type identifier
         Sdc::Options    schemeOptions;          ///< The full set of options for the scheme,
@@ -94,6 +96,9 @@ public:
         unsigned int validateFullTopology : 1;  ///< Apply more extensive validation of
                                                 ///< the constructed topology -- intended
                                                 ///< for debugging.
+        unsigned int useThreads : 1;            ///< Complete the base level topology and
+                                                ///< its tags concurrently (requires OpenMP,
+                                                ///< the result is unchanged)
     };
 
     /// \brief Instantiates a TopologyRefiner from client-provided topological
@@ -362,14 +367,15 @@ TopologyRefinerFactory<MESH>::populateBaseLevel(TopologyRefiner& refiner, MESH c
     void const *     userData = &mesh;
         
     if (! assignComponentTopology(refiner, mesh)) return false;
-    if (! prepareComponentTopologyAssignment(refiner, validate, callback, userData)) return false;
+    if (! prepareComponentTopologyAssignment(refiner, validate, callback, userData,
+                                             options.useThreads)) return false;
 
     //
     //  User assigned and internal tagging of components -- an optional specialization for
     //  MESH.  Allows the specification of sharpness values, holes, etc.
     //
     if (! assignComponentTags(refiner, mesh)) return false;
-    if (! prepareComponentTagsAndSharpness(refiner)) return false;
+    if (! prepareComponentTagsAndSharpness(refiner, options.useThreads)) return false;
 
     //
     //  Defining channels of face-varying primvar data -- an optional specialization for MESH.
@@ -28,6 +28,7 @@
 #include "../version.h"
 
 #include "../vtr/types.h"
+#include "../vtr/memoryUsage.h"
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -49,6 +50,8 @@ typedef Vtr::ConstLocalIndexArray  ConstLocalIndexArray;
 
 inline bool IndexIsValid(Index index) { return Vtr::IndexIsValid(index); }
 
+typedef Vtr::MemoryUsage MemoryUsage;
+
 static const Index INDEX_INVALID = Vtr::INDEX_INVALID;
 static const int   VALENCE_LIMIT = Vtr::VALENCE_LIMIT;
 
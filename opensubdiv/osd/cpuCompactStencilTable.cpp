@@ -0,0 +1,367 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include "../osd/cpuCompactStencilTable.h"
+#include "../far/stencilTable.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstring>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Osd {
+
+namespace {
+
+    // Index words equal to INDEX_ESCAPE are followed by the 32 bits of an
+    // absolute index, other words are signed deltas from the previous index
+    // of the block
+    unsigned short const INDEX_ESCAPE = 0x8000;
+
+    inline void decodeIndex(unsigned short const * words, int & word,
+                            Far::Index & index) {
+        if (words[word] == INDEX_ESCAPE) {
+            index = (Far::Index)((unsigned int)words[word+1] |
+                                 ((unsigned int)words[word+2] << 16));
+            word += 3;
+        } else {
+            index += (short)words[word];
+            word += 1;
+        }
+    }
+
+    inline unsigned int floatBits(float f) {
+        unsigned int u;
+        memcpy(&u, &f, sizeof(u));
+        return u;
+    }
+
+    inline float bitsFloat(unsigned int u) {
+        float f;
+        memcpy(&f, &u, sizeof(f));
+        return f;
+    }
+
+    // Rounds to the nearest half float (values out of range become infinite
+    // and therefore exceed any error bound)
+    unsigned short floatToHalf(float value) {
+
+        unsigned int f = floatBits(value),
+                     sign = (f >> 16) & 0x8000;
+        f &= 0x7fffffff;
+
+        if (f >= 0x47800000) {
+            // overflow, infinite or NaN
+            return (unsigned short)(sign | 0x7c00);
+        }
+        if (f < 0x38800000) {
+            // denormal or zero : let the float addition round the mantissa
+            float denormMagic = bitsFloat(0x3f000000);
+            return (unsigned short)(sign |
+                (floatBits(bitsFloat(f) + denormMagic) - 0x3f000000));
+        }
+        // rebias the exponent and round to nearest even
+        unsigned int mantissaOdd = (f >> 13) & 1;
+        f += 0xc8000fff + mantissaOdd;
+        return (unsigned short)(sign | (f >> 13));
+    }
+
+    // Converts finite half floats (normal or denormal)
+    inline float halfToFloat(unsigned short h) {
+
+        unsigned int sign = (unsigned int)(h & 0x8000) << 16,
+                     bits = (unsigned int)(h & 0x7fff) << 13;
+        return bitsFloat(floatBits(bitsFloat(bits) *
+                                   bitsFloat(0x77800000)) | sign);
+    }
+
+    inline unsigned short floatToFixed(float value, float scale) {
+        float q = std::floor(value / scale + 0.5f);
+        q = std::max(-32767.0f, std::min(32767.0f, q));
+        return (unsigned short)(short)q;
+    }
+
+    inline float fixedToFloat(unsigned short q, float scale) {
+        return (float)(short)q * scale;
+    }
+}
+
+CpuCompactStencilTable::CpuCompactStencilTable() :
+    _numControlVertices(0), _numWeightSets(0),
+    _weightFormat(WEIGHTS_FLOAT), _weightError(0.0f) {
+
+    for (int w = 0; w < 6; ++w) {
+        _weightScales[w] = 1.0f;
+    }
+}
+
+CpuCompactStencilTable *
+CpuCompactStencilTable::Create(Far::StencilTable const * stencilTable,
+                               Options options) {
+
+    std::vector<float> const * weights[1] = { &stencilTable->GetWeights() };
+
+    CpuCompactStencilTable * table = new CpuCompactStencilTable;
+    if (! table->initialize(*stencilTable, 1, weights, options)) {
+        delete table;
+        return NULL;
+    }
+    return table;
+}
+
+CpuCompactStencilTable *
+CpuCompactStencilTable::Create(Far::LimitStencilTable const * stencilTable,
+                               Options options) {
+
+    std::vector<float> const * weights[6] = {
+        &stencilTable->GetWeights(),
+        &stencilTable->GetDuWeights(),
+        &stencilTable->GetDvWeights(),
+        &stencilTable->GetDuuWeights(),
+        &stencilTable->GetDuvWeights(),
+        &stencilTable->GetDvvWeights() };
+
+    int numWeightSets = 1;
+    if (! weights[1]->empty()) {
+        numWeightSets = weights[3]->empty() ? 3 : 6;
+    }
+
+    CpuCompactStencilTable * table = new CpuCompactStencilTable;
+    if (! table->initialize(*stencilTable, numWeightSets, weights, options)) {
+        delete table;
+        return NULL;
+    }
+    return table;
+}
+
+bool
+CpuCompactStencilTable::initialize(
+    Far::StencilTableReal<float> const & stencilTable,
+    int numWeightSets, std::vector<float> const ** weights,
+    Options const & options) {
+
+    // level-to-level stencils are evaluated in passes the kernels ignore
+    if (! stencilTable.GetLevelOffsets().empty()) {
+        return false;
+    }
+
+    std::vector<int> const & sizes = stencilTable.GetSizes();
+    std::vector<Far::Index> const & indices = stencilTable.GetControlIndices();
+
+    int numStencils = stencilTable.GetNumStencils(),
+        numBlocks = (numStencils + BLOCK_SIZE - 1) / BLOCK_SIZE;
+
+    _numControlVertices = stencilTable.GetNumControlVertices();
+    _numWeightSets = numWeightSets;
+
+    //
+    // sizes and delta-encoded indices
+    //
+    _sizes.resize(numStencils);
+    _blockIndices.resize(numBlocks);
+    _blockWeights.resize(numBlocks);
+    _indices.clear();
+    _indices.reserve(indices.size());
+
+    Far::Index previous = 0;
+    for (int i = 0, offset = 0; i < numStencils; ++i) {
+        if (sizes[i] > 0xffff) {
+            return false;
+        }
+        _sizes[i] = (unsigned short)sizes[i];
+
+        if ((i % BLOCK_SIZE) == 0) {
+            _blockIndices[i / BLOCK_SIZE] = (int)_indices.size();
+            _blockWeights[i / BLOCK_SIZE] = offset;
+            previous = 0;
+        }
+
+        for (int j = 0; j < sizes[i]; ++j, ++offset) {
+            Far::Index index = indices[offset];
+            long long delta = (long long)index - (long long)previous;
+            if (delta >= -32767 && delta <= 32767) {
+                _indices.push_back((unsigned short)(short)delta);
+            } else {
+                _indices.push_back(INDEX_ESCAPE);
+                _indices.push_back((unsigned short)(index & 0xffff));
+                _indices.push_back((unsigned short)((unsigned int)index >> 16));
+            }
+            previous = index;
+        }
+    }
+
+    //
+    // weights : measure the error of both 16 bit formats (relative to the
+    // magnitude of each weight set) and keep the most accurate one if it is
+    // within the bound
+    //
+    float errorHalf = 0.0f,     // relative errors
+          errorFixed = 0.0f,
+          absErrorHalf = 0.0f,  // absolute errors
+          absErrorFixed = 0.0f;
+    for (int w = 0; w < numWeightSets; ++w) {
+
+        std::vector<float> const & src = *weights[w];
+
+        float maxWeight = 0.0f;
+        for (int i = 0; i < (int)src.size(); ++i) {
+            maxWeight = std::max(maxWeight, std::abs(src[i]));
+        }
+        if (maxWeight == 0.0f) {
+            _weightScales[w] = 1.0f;
+            continue;
+        }
+        _weightScales[w] = maxWeight / 32767.0f;
+
+        float setErrorHalf = 0.0f,
+              setErrorFixed = 0.0f;
+        for (int i = 0; i < (int)src.size(); ++i) {
+            float half = halfToFloat(floatToHalf(src[i])),
+                  fixed = fixedToFloat(
+                      floatToFixed(src[i], _weightScales[w]), _weightScales[w]);
+            setErrorHalf = std::max(setErrorHalf, std::abs(half - src[i]));
+            setErrorFixed = std::max(setErrorFixed, std::abs(fixed - src[i]));
+        }
+        errorHalf = std::max(errorHalf, setErrorHalf / maxWeight);
+        errorFixed = std::max(errorFixed, setErrorFixed / maxWeight);
+        absErrorHalf = std::max(absErrorHalf, setErrorHalf);
+        absErrorFixed = std::max(absErrorFixed, setErrorFixed);
+    }
+
+    if (std::min(errorHalf, errorFixed) > options.maxWeightError) {
+        _weightFormat = WEIGHTS_FLOAT;
+        _weightError = 0.0f;
+    } else if (errorHalf <= errorFixed) {
+        _weightFormat = WEIGHTS_HALF;
+        _weightError = absErrorHalf;
+    } else {
+        _weightFormat = WEIGHTS_FIXED16;
+        _weightError = absErrorFixed;
+    }
+
+    for (int w = 0; w < numWeightSets; ++w) {
+
+        std::vector<float> const & src = *weights[w];
+
+        if (_weightFormat == WEIGHTS_FLOAT) {
+            _floatWeights[w] = src;
+            continue;
+        }
+        _weights[w].resize(src.size());
+        for (int i = 0; i < (int)src.size(); ++i) {
+            _weights[w][i] = (_weightFormat == WEIGHTS_HALF)
+                ? floatToHalf(src[i])
+                : floatToFixed(src[i], _weightScales[w]);
+        }
+    }
+    return true;
+}
+
+size_t
+CpuCompactStencilTable::GetMemoryUsage() const {
+
+    size_t size = sizeof(CpuCompactStencilTable) +
+        _sizes.size() * sizeof(unsigned short) +
+        (_blockIndices.size() + _blockWeights.size()) * sizeof(int) +
+        _indices.size() * sizeof(unsigned short);
+
+    for (int w = 0; w < _numWeightSets; ++w) {
+        size += _weights[w].size() * sizeof(unsigned short) +
+                _floatWeights[w].size() * sizeof(float);
+    }
+    return size;
+}
+
+void
+CpuCompactStencilTable::Decode(int start, int end, int numWeightSets,
+                               DecodeBuffer & buffer) const {
+
+    assert(start >= 0 && start <= end && end <= GetNumStencils());
+    assert(numWeightSets <= _numWeightSets);
+
+    int block = start / BLOCK_SIZE,
+        indexWord = _blockIndices.empty() ? 0 : _blockIndices[block],
+        weight = _blockWeights.empty() ? 0 : _blockWeights[block];
+
+    // indices : the deltas restart from 0 at the beginning of each block,
+    // so the stencils of the block which precede 'start' are decoded first
+    Far::Index previous = 0;
+    for (int i = block * BLOCK_SIZE; i < start; ++i) {
+        for (int j = 0; j < _sizes[i]; ++j) {
+            decodeIndex(&_indices[0], indexWord, previous);
+        }
+        weight += _sizes[i];
+    }
+
+    int numElements = 0;
+    buffer.sizes.resize(end - start);
+    for (int i = start; i < end; ++i) {
+        buffer.sizes[i - start] = _sizes[i];
+        numElements += _sizes[i];
+    }
+
+    buffer.indices.resize(numElements);
+
+    for (int i = start, dst = 0; i < end; ++i) {
+        if ((i % BLOCK_SIZE) == 0) {
+            previous = 0;
+        }
+        for (int j = 0; j < _sizes[i]; ++j, ++dst) {
+            decodeIndex(&_indices[0], indexWord, previous);
+            buffer.indices[dst] = previous;
+        }
+    }
+
+    // weights
+    for (int w = 0; w < numWeightSets; ++w) {
+
+        std::vector<float> & dst = buffer.weights[w];
+        dst.resize(numElements);
+        if (numElements == 0) continue;
+
+        if (_weightFormat == WEIGHTS_FLOAT) {
+            memcpy(&dst[0], &_floatWeights[w][weight],
+                   numElements * sizeof(float));
+        } else if (_weightFormat == WEIGHTS_HALF) {
+            unsigned short const * src = &_weights[w][weight];
+            for (int i = 0; i < numElements; ++i) {
+                dst[i] = halfToFloat(src[i]);
+            }
+        } else {
+            unsigned short const * src = &_weights[w][weight];
+            float scale = _weightScales[w];
+            for (int i = 0; i < numElements; ++i) {
+                dst[i] = fixedToFloat(src[i], scale);
+            }
+        }
+    }
+}
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+}  // end namespace OpenSubdiv
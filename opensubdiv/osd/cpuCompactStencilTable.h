@@ -0,0 +1,154 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_OSD_CPU_COMPACT_STENCIL_TABLE_H
+#define OPENSUBDIV3_OSD_CPU_COMPACT_STENCIL_TABLE_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Far {
+    template <typename REAL> class StencilTableReal;
+    class StencilTable;
+    class LimitStencilTable;
+}
+
+namespace Osd {
+
+/// \brief Compact stencil table for the Cpu, Omp and Tbb evaluators
+///
+/// Evaluation-only representation of a Far::StencilTable or
+/// Far::LimitStencilTable which reduces the memory footprint (and the memory
+/// bandwidth of the evaluation) 2 to 3 times:
+///   - control vertex indices are delta-encoded on 16 bits, with 32 bit
+///     escapes for distant vertices
+///   - weights are quantized to 16 bit half floats or fixed-point values,
+///     whichever is the most accurate, as long as the quantization error
+///     stays within a bound (weights are kept in single precision otherwise)
+///   - sizes are stored on 16 bits and offsets only for blocks of stencils
+///
+/// The stencils are decoded on the fly, block by block, and evaluated with
+/// the regular kernels of the Cpu evaluator.
+///
+class CpuCompactStencilTable {
+public:
+
+    enum WeightFormat {
+        WEIGHTS_FLOAT = 0,  ///< single precision weights
+        WEIGHTS_HALF,       ///< 16 bit half floats
+        WEIGHTS_FIXED16     ///< 16 bit fixed point (one scale per weight set)
+    };
+
+    struct Options {
+
+        Options() : maxWeightError(1.0e-4f) { }
+
+        float maxWeightError;   ///< bound of the quantization error of the
+                                ///  weights, relative to the largest weight
+                                ///  (in magnitude) of each weight set
+    };
+
+    /// \brief Number of stencils of the blocks decoded by the kernels
+    enum { BLOCK_SIZE = 64 };
+
+    /// \brief Creates a compact table from a table of vertex stencils.
+    ///        Returns NULL if a stencil has more than 65535 coefficients or
+    ///        if the stencils are level-to-level stencils.
+    static CpuCompactStencilTable * Create(
+        Far::StencilTable const * stencilTable, Options options = Options());
+
+    /// \brief Creates a compact table from a table of limit stencils, with
+    ///        the weights of their derivatives.
+    ///        Returns NULL if a stencil has more than 65535 coefficients.
+    static CpuCompactStencilTable * Create(
+        Far::LimitStencilTable const * stencilTable, Options options = Options());
+
+    /// \brief Returns the number of stencils in the table
+    int GetNumStencils() const { return (int)_sizes.size(); }
+
+    /// \brief Returns the number of control vertices indexed in the table
+    int GetNumControlVertices() const { return _numControlVertices; }
+
+    /// \brief Returns the number of weight sets: 1 (point), 3 (1st
+    ///        derivatives) or 6 (2nd derivatives)
+    int GetNumWeightSets() const { return _numWeightSets; }
+
+    /// \brief Returns the format of the weights
+    WeightFormat GetWeightFormat() const { return _weightFormat; }
+
+    /// \brief Returns the largest absolute quantization error of the weights
+    float GetWeightError() const { return _weightError; }
+
+    /// \brief Returns the memory used by the table (in bytes)
+    size_t GetMemoryUsage() const;
+
+    /// \brief Stencils decoded by the kernels
+    struct DecodeBuffer {
+        std::vector<int>   sizes,
+                           indices;
+        std::vector<float> weights[6];
+    };
+
+    /// \brief Decodes the stencils [start, end) and their first
+    ///        'numWeightSets' sets of weights
+    void Decode(int start, int end, int numWeightSets,
+                DecodeBuffer & buffer) const;
+
+protected:
+
+    CpuCompactStencilTable();
+
+    bool initialize(Far::StencilTableReal<float> const & stencilTable,
+                    int numWeightSets, std::vector<float> const ** weights,
+                    Options const & options);
+
+    int _numControlVertices,
+        _numWeightSets;
+
+    WeightFormat _weightFormat;
+    float _weightError;
+
+    std::vector<unsigned short> _sizes;           // size of each stencil
+    std::vector<int>            _blockIndices,    // first index word and
+                                _blockWeights;    // weight of each block
+    std::vector<unsigned short> _indices;         // delta-encoded indices
+
+    float                       _weightScales[6]; // fixed point scales
+    std::vector<unsigned short> _weights[6];      // quantized weights
+    std::vector<float>          _floatWeights[6]; // or float weights
+};
+
+}  // end namespace Osd
+
+}  // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+
+}  // end namespace OpenSubdiv
+
+#endif  // OPENSUBDIV3_OSD_CPU_COMPACT_STENCIL_TABLE_H
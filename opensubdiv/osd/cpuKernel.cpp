@@ -23,11 +23,16 @@
 //
 
 #include "../osd/cpuKernel.h"
+#include "../osd/cpuCompactStencilTable.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/types.h"
+#include "../far/patchBasis.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <cstdlib>
+#include <cstring>
 #include <vector>
 
 namespace OpenSubdiv {
@@ -35,138 +40,813 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
-template <class T> T *
-elementAtIndex(T * src, int index, BufferDescriptor const &desc) {
+//
+//  SIMD stencil kernels
+//
+//  The kernels below accumulate the contributions of the control vertices of
+//  a stencil in registers, one tile of 8 (AVX2) or 16 (AVX-512) primvar
+//  elements at a time, and for all the weight sets (point and derivatives) at
+//  once so that every control vertex is loaded only once. Partial tiles use
+//  masked loads and stores, which allows any primvar length and stride
+//  without touching the interleaved data that surrounds the primvar.
+//
+//  The instruction set is selected at runtime, so that the library does not
+//  need to be compiled for a specific CPU.
+//
+#if (defined(__GNUC__) || defined(__clang__)) && \
+    (defined(__x86_64__) || defined(__i386__))
+    #define OSD_CPU_KERNEL_SIMD
+    #define OSD_CPU_KERNEL_TARGET(isa) __attribute__((target(isa)))
+    #if defined(__clang__) || (__GNUC__ >= 5)
+        #define OSD_CPU_KERNEL_AVX512
+    #endif
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    #define OSD_CPU_KERNEL_SIMD
+    #define OSD_CPU_KERNEL_TARGET(isa)
+    #define OSD_CPU_KERNEL_AVX512
+#endif
+
+#ifdef OSD_CPU_KERNEL_SIMD
+    #include <immintrin.h>
+    #ifdef _MSC_VER
+        #include <intrin.h>
+    #endif
+#endif
+
+namespace {
+
+enum { MAX_WEIGHT_SETS = 6 };
+
+// Number of stencils applied to all the instances of a multi-instance
+// evaluation before moving to the next ones
+enum { INSTANCE_BLOCK_SIZE = 256 };
+
+// Arguments of a stencil kernel: the stencil arrays and the weights point to
+// the first stencil to evaluate, and the destinations to its results.
+struct StencilKernelArgs {
+    float const * src;
+    int srcStride;
+    int length;
+
+    int numSets;
+    float * dst[MAX_WEIGHT_SETS];
+    int dstStride[MAX_WEIGHT_SETS];
+    float const * weights[MAX_WEIGHT_SETS];
+
+    int numStencils;
+    int const * sizes;
+    int const * indices;
+};
+
+void
+computeStencilsScalar(StencilKernelArgs const & args) {
+
+    int length = args.length,
+        numSets = args.numSets;
+
+    if (numSets == 1 && length == args.srcStride &&
+        length == args.dstStride[0] && (length == 4 || length == 8)) {
+
+        // fast path for packed primvar data (4 or 8 floats)
+        if (length == 4) {
+            ComputeStencilKernel<4>(args.src, args.dst[0], args.sizes,
+                args.indices, args.weights[0], 0, args.numStencils);
+        } else {
+            ComputeStencilKernel<8>(args.src, args.dst[0], args.sizes,
+                args.indices, args.weights[0], 0, args.numStencils);
+        }
+        return;
+    }
+
+    float * result = (float*)alloca(numSets * length * sizeof(float));
+
+    float const * weights[MAX_WEIGHT_SETS];
+    for (int w = 0; w < numSets; ++w) {
+        weights[w] = args.weights[w];
+    }
+
+    int const * indices = args.indices;
+    for (int i = 0; i < args.numStencils; ++i) {
 
-    return src + index * desc.stride;
+        memset(result, 0, numSets * length * sizeof(float));
+
+        for (int j = 0; j < args.sizes[i]; ++j, ++indices) {
+            float const * src = args.src + (*indices) * args.srcStride;
+            for (int w = 0; w < numSets; ++w) {
+                float weight = *weights[w]++;
+                float * dst = result + w * length;
+                for (int k = 0; k < length; ++k) {
+                    dst[k] += src[k] * weight;
+                }
+            }
+        }
+        for (int w = 0; w < numSets; ++w) {
+            memcpy(args.dst[w] + i * args.dstStride[w],
+                   result + w * length, length * sizeof(float));
+        }
+    }
 }
 
-static inline void
-clear(float *dst, BufferDescriptor const &desc) {
+#ifdef OSD_CPU_KERNEL_SIMD
+
+// Lanes [0, n) of the AVX2 tail masks are loaded from maskTable + 8 - n
+int const maskTable[16] = { -1, -1, -1, -1, -1, -1, -1, -1,
+                             0,  0,  0,  0,  0,  0,  0,  0 };
+
+template <int NUM_SETS>
+OSD_CPU_KERNEL_TARGET("avx2,fma") void
+computeStencilsAVX2(StencilKernelArgs const & args) {
+
+    int length = args.length;
+
+    int const * indices = args.indices;
+    float const * weights[NUM_SETS];
+    for (int w = 0; w < NUM_SETS; ++w) {
+        weights[w] = args.weights[w];
+    }
+
+    for (int i = 0; i < args.numStencils; ++i) {
+        int size = args.sizes[i];
 
-    assert(dst);
-    memset(dst, 0, desc.length*sizeof(float));
+        for (int k = 0; k < length; k += 8) {
+            int n = std::min(8, length - k);
+            __m256i mask = _mm256_loadu_si256(
+                (__m256i const *)(maskTable + 8 - n));
+
+            __m256 result[NUM_SETS];
+            for (int w = 0; w < NUM_SETS; ++w) {
+                result[w] = _mm256_setzero_ps();
+            }
+
+            for (int j = 0; j < size; ++j) {
+                float const * src = args.src + indices[j] * args.srcStride + k;
+                __m256 v = (n == 8) ? _mm256_loadu_ps(src)
+                                    : _mm256_maskload_ps(src, mask);
+                for (int w = 0; w < NUM_SETS; ++w) {
+                    result[w] = _mm256_fmadd_ps(v,
+                        _mm256_broadcast_ss(weights[w] + j), result[w]);
+                }
+            }
+
+            for (int w = 0; w < NUM_SETS; ++w) {
+                float * dst = args.dst[w] + i * args.dstStride[w] + k;
+                if (n == 8) {
+                    _mm256_storeu_ps(dst, result[w]);
+                } else {
+                    _mm256_maskstore_ps(dst, mask, result[w]);
+                }
+            }
+        }
+
+        indices += size;
+        for (int w = 0; w < NUM_SETS; ++w) {
+            weights[w] += size;
+        }
+    }
 }
 
-static inline void
-addWithWeight(float *dst, const float *src, int srcIndex, float weight,
-              BufferDescriptor const &desc) {
+#ifdef OSD_CPU_KERNEL_AVX512
+template <int NUM_SETS>
+OSD_CPU_KERNEL_TARGET("avx512f") void
+computeStencilsAVX512(StencilKernelArgs const & args) {
 
-    assert(src && dst);
-    src = elementAtIndex(src, srcIndex, desc);
-    for (int k = 0; k < desc.length; ++k) {
-        dst[k] += src[k] * weight;
+    int length = args.length;
+
+    int const * indices = args.indices;
+    float const * weights[NUM_SETS];
+    for (int w = 0; w < NUM_SETS; ++w) {
+        weights[w] = args.weights[w];
     }
+
+    for (int i = 0; i < args.numStencils; ++i) {
+        int size = args.sizes[i];
+
+        for (int k = 0; k < length; k += 16) {
+            int n = std::min(16, length - k);
+            __mmask16 mask = (__mmask16)((1u << n) - 1);
+
+            __m512 result[NUM_SETS];
+            for (int w = 0; w < NUM_SETS; ++w) {
+                result[w] = _mm512_setzero_ps();
+            }
+
+            for (int j = 0; j < size; ++j) {
+                float const * src = args.src + indices[j] * args.srcStride + k;
+                __m512 v = _mm512_maskz_loadu_ps(mask, src);
+                for (int w = 0; w < NUM_SETS; ++w) {
+                    result[w] = _mm512_fmadd_ps(v,
+                        _mm512_set1_ps(weights[w][j]), result[w]);
+                }
+            }
+
+            for (int w = 0; w < NUM_SETS; ++w) {
+                _mm512_mask_storeu_ps(args.dst[w] + i * args.dstStride[w] + k,
+                                      mask, result[w]);
+            }
+        }
+
+        indices += size;
+        for (int w = 0; w < NUM_SETS; ++w) {
+            weights[w] += size;
+        }
+    }
+}
+#endif
+
+// Returns the widest instruction set supported by the CPU and the OS
+CpuKernelISA
+detectKernelISA() {
+
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return CPU_KERNEL_ISA_SCALAR;
+
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0,
+         fma     = (info[2] & (1 << 12)) != 0;
+    if (! (osxsave && fma)) return CPU_KERNEL_ISA_SCALAR;
+
+    unsigned long long xcr0 = _xgetbv(0);
+    if ((xcr0 & 0x6) != 0x6) return CPU_KERNEL_ISA_SCALAR;
+
+    __cpuidex(info, 7, 0);
+    bool avx2    = (info[1] & (1 << 5)) != 0,
+         avx512f = (info[1] & (1 << 16)) != 0;
+
+    if (avx512f && ((xcr0 & 0xe6) == 0xe6)) return CPU_KERNEL_ISA_AVX512;
+    if (avx2) return CPU_KERNEL_ISA_AVX2;
+#else
+    __builtin_cpu_init();
+#ifdef OSD_CPU_KERNEL_AVX512
+    if (__builtin_cpu_supports("avx512f")) return CPU_KERNEL_ISA_AVX512;
+#endif
+    if (__builtin_cpu_supports("avx2") &&
+        __builtin_cpu_supports("fma")) return CPU_KERNEL_ISA_AVX2;
+#endif
+    return CPU_KERNEL_ISA_SCALAR;
 }
 
-static inline void
-copy(float *dst, int dstIndex, const float *src, BufferDescriptor const &desc) {
+#endif // OSD_CPU_KERNEL_SIMD
 
-    assert(src && dst);
+CpuKernelISA
+getSupportedKernelISA() {
+#ifdef OSD_CPU_KERNEL_SIMD
+    static CpuKernelISA supportedISA = detectKernelISA();
+    return supportedISA;
+#else
+    return CPU_KERNEL_ISA_SCALAR;
+#endif
+}
 
-    dst = elementAtIndex(dst, dstIndex, desc);
-    memcpy(dst, src, desc.length*sizeof(float));
+// -1 until first use: the widest supported instruction set is then selected
+int g_kernelISA = -1;
+
+typedef void (*StencilKernel)(StencilKernelArgs const &);
+
+StencilKernel
+getStencilKernel(int numSets) {
+
+    if (g_kernelISA < 0) {
+        g_kernelISA = getSupportedKernelISA();
+    }
+
+#ifdef OSD_CPU_KERNEL_SIMD
+#ifdef OSD_CPU_KERNEL_AVX512
+    if (g_kernelISA == CPU_KERNEL_ISA_AVX512) {
+        switch (numSets) {
+            case 1: return computeStencilsAVX512<1>;
+            case 2: return computeStencilsAVX512<2>;
+            case 3: return computeStencilsAVX512<3>;
+            case 4: return computeStencilsAVX512<4>;
+            case 5: return computeStencilsAVX512<5>;
+            case 6: return computeStencilsAVX512<6>;
+        }
+    }
+#endif
+    if (g_kernelISA >= CPU_KERNEL_ISA_AVX2) {
+        switch (numSets) {
+            case 1: return computeStencilsAVX2<1>;
+            case 2: return computeStencilsAVX2<2>;
+            case 3: return computeStencilsAVX2<3>;
+            case 4: return computeStencilsAVX2<4>;
+            case 5: return computeStencilsAVX2<5>;
+            case 6: return computeStencilsAVX2<6>;
+        }
+    }
+#else
+    (void)numSets;
+#endif
+    return computeStencilsScalar;
 }
 
+//
+//  Batched patch evaluation
+//
+//  The patch coordinates are evaluated in blocks: the sizes, control vertex
+//  indices and basis weights of a block are assembled as a small stencil
+//  table, which is then applied by the stencil kernels above.
+//
+
+// Number of patch coordinates per block
+enum { PATCH_BLOCK_SIZE = 64 };
+
+// Number of B-spline patches whose basis weights are evaluated together
+enum { PATCH_LANES = 8 };
+
+enum { MAX_PATCH_CONTROL_VERTICES = 20 };
+
+struct PatchBlock {
+    int sizes[PATCH_BLOCK_SIZE];
+    int offsets[PATCH_BLOCK_SIZE];
+    int indices[PATCH_BLOCK_SIZE * MAX_PATCH_CONTROL_VERTICES];
+    float weights[MAX_WEIGHT_SETS][PATCH_BLOCK_SIZE * MAX_PATCH_CONTROL_VERTICES];
+};
+
+// Evaluates the uniform cubic B-spline basis functions (and their 1st and
+// 2nd derivatives) at t for all the lanes: w[order][function][lane]
 void
-CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
-                float * dst,       BufferDescriptor const &dstDesc,
-                int const * sizes,
-                int const * offsets,
-                int const * indices,
-                float const * weights,
-                int start, int end) {
+getBSplineLaneWeights(int numOrders, float const t[PATCH_LANES],
+                      float w[3][4][PATCH_LANES]) {
 
-    assert(start>=0 && start<end);
+    float const one6th = 1.0f / 6.0f;
 
-    if (start>0) {
-        sizes += start;
-        indices += offsets[start];
-        weights += offsets[start];
+    for (int l = 0; l < PATCH_LANES; ++l) {
+        float t2 = t[l] * t[l];
+        float t3 = t[l] * t2;
+
+        w[0][0][l] = one6th * (1.0f - 3.0f*(t[l] -      t2) -      t3);
+        w[0][1][l] = one6th * (4.0f              - 6.0f*t2  + 3.0f*t3);
+        w[0][2][l] = one6th * (1.0f + 3.0f*(t[l] +      t2  -      t3));
+        w[0][3][l] = one6th * (                                    t3);
+    }
+    if (numOrders > 1) {
+        for (int l = 0; l < PATCH_LANES; ++l) {
+            float t2 = t[l] * t[l];
+
+            w[1][0][l] = -0.5f*t2 +      t[l] - 0.5f;
+            w[1][1][l] =  1.5f*t2 - 2.0f*t[l];
+            w[1][2][l] = -1.5f*t2 +      t[l] + 0.5f;
+            w[1][3][l] =  0.5f*t2;
+        }
     }
+    if (numOrders > 2) {
+        for (int l = 0; l < PATCH_LANES; ++l) {
+            w[2][0][l] = -       t[l] + 1.0f;
+            w[2][1][l] =  3.0f * t[l] - 2.0f;
+            w[2][2][l] = -3.0f * t[l] + 1.0f;
+            w[2][3][l] =         t[l];
+        }
+    }
+}
 
-    src += srcDesc.offset;
-    dst += dstDesc.offset;
+// Adjusts the weights of the lanes for their boundary edges (the flags are
+// 0 or 1 for each edge), which gives the same results as the scalar code
+void
+adjustBoundaryLaneWeights(float const boundary[4][PATCH_LANES],
+                          float sW[4][PATCH_LANES], float tW[4][PATCH_LANES]) {
+
+    for (int l = 0; l < PATCH_LANES; ++l) {
+        float b = boundary[0][l] * tW[0][l];
+        tW[2][l] -= b;
+        tW[1][l] += 2.0f * b;
+        tW[0][l] -= b;
+
+        b = boundary[1][l] * sW[3][l];
+        sW[1][l] -= b;
+        sW[2][l] += 2.0f * b;
+        sW[3][l] -= b;
+
+        b = boundary[2][l] * tW[3][l];
+        tW[1][l] -= b;
+        tW[2][l] += 2.0f * b;
+        tW[3][l] -= b;
+
+        b = boundary[3][l] * sW[0][l];
+        sW[2][l] -= b;
+        sW[1][l] += 2.0f * b;
+        sW[0][l] -= b;
+    }
+}
 
-    if (srcDesc.length == 4 && dstDesc.length == 4 &&
-        srcDesc.stride == 4 && dstDesc.stride == 4) {
+// Evaluates the weights of up to PATCH_LANES B-spline patches of a block
+// together (the coordinates 'lanes[i]'): every loop runs across the lanes,
+// so that it is vectorized by the compiler.
+void
+getBSplinePatchLaneWeights(int numSets, PatchCoord const * coords,
+                           int const * lanes, int numLanes,
+                           PatchParam const * patchParamBuffer,
+                           PatchBlock & block) {
 
-        // SIMD fast path for aligned primvar data (4 floats)
-        ComputeStencilKernel<4>(src, dst,
-            sizes, indices, weights, start,  end);
+    float s[PATCH_LANES], t[PATCH_LANES], dScale[PATCH_LANES],
+          boundary[4][PATCH_LANES];
 
-    } else if (srcDesc.length == 8 && dstDesc.length == 8 &&
-               srcDesc.stride == 8 && dstDesc.stride == 8) {
+    for (int l = 0; l < PATCH_LANES; ++l) {
+        // the unused lanes repeat the first coordinate
+        PatchCoord const & coord = coords[lanes[l < numLanes ? l : 0]];
+        Far::PatchParam const & param =
+            patchParamBuffer[coord.handle.patchIndex];
 
-        // SIMD fast path for aligned primvar data (8 floats)
-        ComputeStencilKernel<8>(src, dst,
-            sizes, indices, weights, start,  end);
-    } else {
+        s[l] = coord.s;
+        t[l] = coord.t;
+        param.Normalize(s[l], t[l]);
 
-        // Slow path for non-aligned data
+        dScale[l] = (float)(1 << param.GetDepth());
 
-        float * result = (float*)alloca(srcDesc.length * sizeof(float));
+        int edges = param.GetBoundary();
+        for (int e = 0; e < 4; ++e) {
+            boundary[e][l] = (edges & (1 << e)) ? 1.0f : 0.0f;
+        }
+    }
+
+    int numOrders = (numSets == 1) ? 1 : ((numSets == 3) ? 2 : 3);
 
-        int nstencils = end-start;
-        for (int i=0; i<nstencils; ++i, ++sizes) {
+    float sW[3][4][PATCH_LANES], tW[3][4][PATCH_LANES];
+    getBSplineLaneWeights(numOrders, s, sW);
+    getBSplineLaneWeights(numOrders, t, tW);
+    for (int d = 0; d < numOrders; ++d) {
+        adjustBoundaryLaneWeights(boundary, sW[d], tW[d]);
+    }
 
-            clear(result, srcDesc);
+    // tensor products of the (s,t) weights: w[set][control vertex][lane]
+    float w[MAX_WEIGHT_SETS][16][PATCH_LANES];
 
-            for (int j=0; j<*sizes; ++j) {
-                addWithWeight(result, src, *indices++, *weights++, srcDesc);
+    for (int i = 0; i < 4; ++i) {
+        for (int j = 0; j < 4; ++j) {
+            for (int l = 0; l < PATCH_LANES; ++l) {
+                w[0][4*i+j][l] = sW[0][j][l] * tW[0][i][l];
             }
+            if (numOrders > 1) {
+                for (int l = 0; l < PATCH_LANES; ++l) {
+                    w[1][4*i+j][l] = sW[1][j][l] * tW[0][i][l] * dScale[l];
+                    w[2][4*i+j][l] = sW[0][j][l] * tW[1][i][l] * dScale[l];
+                }
+            }
+            if (numOrders > 2) {
+                for (int l = 0; l < PATCH_LANES; ++l) {
+                    float d2Scale = dScale[l] * dScale[l];
+                    w[3][4*i+j][l] = sW[2][j][l] * tW[0][i][l] * d2Scale;
+                    w[4][4*i+j][l] = sW[1][j][l] * tW[1][i][l] * d2Scale;
+                    w[5][4*i+j][l] = sW[0][j][l] * tW[2][i][l] * d2Scale;
+                }
+            }
+        }
+    }
 
-            copy(dst, i, result, dstDesc);
+    for (int l = 0; l < numLanes; ++l) {
+        int offset = block.offsets[lanes[l]];
+        for (int set = 0; set < numSets; ++set) {
+            float * weights = block.weights[set] + offset;
+            for (int k = 0; k < 16; ++k) {
+                weights[k] = w[set][k][l];
+            }
         }
     }
 }
 
+// Assembles the sizes, control vertex indices and weights of a block of
+// coordinates, grouping the B-spline patches by PATCH_LANES
+bool
+getPatchBlock(int numSets, PatchCoord const * coords, int numCoords,
+              PatchArray const * patchArrays,
+              int const * patchIndexBuffer,
+              PatchParam const * patchParamBuffer,
+              PatchBlock & block) {
+
+    int bsplineCoords[PATCH_BLOCK_SIZE],
+        numBSplineCoords = 0;
+
+    int offset = 0;
+    for (int i = 0; i < numCoords; ++i) {
+        PatchCoord const & coord = coords[i];
+        PatchArray const & array = patchArrays[coord.handle.arrayIndex];
+
+        Far::PatchParam const & param =
+            patchParamBuffer[coord.handle.patchIndex];
+        int patchType = param.IsRegular()
+            ? Far::PatchDescriptor::REGULAR
+            : array.GetPatchType();
+
+        float * w[MAX_WEIGHT_SETS] = { 0, 0, 0, 0, 0, 0 };
+        for (int set = 0; set < numSets; ++set) {
+            w[set] = block.weights[set] + offset;
+        }
+
+        int numControlVertices = 0;
+        if (patchType == Far::PatchDescriptor::REGULAR) {
+            bsplineCoords[numBSplineCoords++] = i;
+            numControlVertices = 16;
+        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
+            Far::internal::GetGregoryWeights(param, coord.s, coord.t,
+                                             w[0], w[1], w[2], w[3], w[4], w[5]);
+            numControlVertices = 20;
+        } else if (patchType == Far::PatchDescriptor::LOOP) {
+            Far::internal::GetLoopWeights(param, coord.s, coord.t,
+                                          w[0], w[1], w[2], w[3], w[4], w[5]);
+            numControlVertices = 12;
+        } else if (patchType == Far::PatchDescriptor::QUADS) {
+            Far::internal::GetBilinearWeights(param, coord.s, coord.t,
+                                              w[0], w[1], w[2], w[3], w[4], w[5]);
+            numControlVertices = 4;
+        } else if (patchType == Far::PatchDescriptor::TRIANGLES) {
+            Far::internal::GetLinearTriWeights(param, coord.s, coord.t,
+                                               w[0], w[1], w[2], w[3], w[4], w[5]);
+            numControlVertices = 3;
+        } else {
+            return false;
+        }
+
+        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
+        int indexBase = array.GetIndexBase() + indexStride *
+                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
+
+        memcpy(block.indices + offset, patchIndexBuffer + indexBase,
+               numControlVertices * sizeof(int));
+
+        block.sizes[i] = numControlVertices;
+        block.offsets[i] = offset;
+        offset += numControlVertices;
+    }
+
+    for (int i = 0; i < numBSplineCoords; i += PATCH_LANES) {
+        getBSplinePatchLaneWeights(numSets, coords, bsplineCoords + i,
+            std::min((int)PATCH_LANES, numBSplineCoords - i),
+            patchParamBuffer, block);
+    }
+    return true;
+}
+
+} // end namespace
+
+CpuKernelISA
+CpuGetKernelISA() {
+
+    if (g_kernelISA < 0) {
+        g_kernelISA = getSupportedKernelISA();
+    }
+    return (CpuKernelISA)g_kernelISA;
+}
+
+CpuKernelISA
+CpuSetKernelISA(CpuKernelISA isa) {
+
+    g_kernelISA = std::min(isa, getSupportedKernelISA());
+    return (CpuKernelISA)g_kernelISA;
+}
+
+void
+CpuComputeStencils(float const * src, BufferDescriptor const &srcDesc,
+                   int numWeightSets,
+                   float * const * dst, BufferDescriptor const * dstDesc,
+                   int const * sizes,
+                   int const * offsets,
+                   int const * indices,
+                   float const * const * weights,
+                   int start, int end) {
+
+    assert(numWeightSets <= MAX_WEIGHT_SETS);
+
+    if (end <= start) return;
+
+    start = (start > 0 ? start : 0);
+    int offset = (start > 0 ? offsets[start] : 0);
+
+    StencilKernelArgs args;
+    args.src = src;
+    args.srcStride = srcDesc.stride;
+    args.length = srcDesc.length;
+    args.numStencils = end - start;
+    args.sizes = sizes + start;
+    args.indices = indices + offset;
+
+    // skip the weight sets without destination
+    args.numSets = 0;
+    for (int w = 0; w < numWeightSets; ++w) {
+        if (dst[w] && weights[w]) {
+            args.dst[args.numSets] = dst[w];
+            args.dstStride[args.numSets] = dstDesc[w].stride;
+            args.weights[args.numSets] = weights[w] + offset;
+            ++args.numSets;
+        }
+    }
+    if (args.numSets == 0 || args.length <= 0) return;
+
+    getStencilKernel(args.numSets)(args);
+}
+
+void
+CpuComputeStencilList(float const * src, BufferDescriptor const &srcDesc,
+                      int numWeightSets,
+                      float * const * dst, BufferDescriptor const * dstDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * const * weights,
+                      int numStencils, int const * stencilIndices) {
+
+    assert(numWeightSets <= MAX_WEIGHT_SETS);
+
+    float * rangeDst[MAX_WEIGHT_SETS];
+
+    for (int i = 0; i < numStencils; ) {
+
+        // gather the run of consecutive stencils starting at 'i'
+        int start = stencilIndices[i], end = start + 1;
+        for (++i; i < numStencils && stencilIndices[i] == end; ++i) {
+            ++end;
+        }
+
+        for (int w = 0; w < numWeightSets; ++w) {
+            rangeDst[w] = dst[w] ? dst[w] + start * dstDesc[w].stride : 0;
+        }
+        CpuComputeStencils(src, srcDesc, numWeightSets, rangeDst, dstDesc,
+                           sizes, offsets, indices, weights, start, end);
+    }
+}
+
+void
+CpuComputeCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                          int numWeightSets,
+                          float * const * dst, BufferDescriptor const * dstDesc,
+                          CpuCompactStencilTable const & stencilTable,
+                          int start, int end) {
+
+    assert(numWeightSets <= MAX_WEIGHT_SETS &&
+           numWeightSets <= stencilTable.GetNumWeightSets());
+
+    start = (start > 0 ? start : 0);
+
+    // the decoded blocks stay in the cache while they are evaluated
+    CpuCompactStencilTable::DecodeBuffer buffer;
+
+    float * blockDst[MAX_WEIGHT_SETS];
+    float const * weights[MAX_WEIGHT_SETS];
+
+    int const blockSize = CpuCompactStencilTable::BLOCK_SIZE;
+
+    for (int blockStart = start; blockStart < end; ) {
+        int blockEnd = std::min(end, (blockStart / blockSize + 1) * blockSize);
+
+        stencilTable.Decode(blockStart, blockEnd, numWeightSets, buffer);
+
+        // blocks of empty stencils still clear their destination
+        static int const noIndex = 0;
+        static float const noWeight = 0.0f;
+
+        bool empty = buffer.indices.empty();
+        for (int w = 0; w < numWeightSets; ++w) {
+            blockDst[w] = dst[w]
+                ? dst[w] + (blockStart - start) * dstDesc[w].stride : 0;
+            weights[w] = empty ? &noWeight : &buffer.weights[w][0];
+        }
+
+        CpuComputeStencils(src, srcDesc, numWeightSets, blockDst, dstDesc,
+                           &buffer.sizes[0], 0,
+                           empty ? &noIndex : &buffer.indices[0], weights,
+                           0, blockEnd - blockStart);
+
+        blockStart = blockEnd;
+    }
+}
+
+bool
+CpuGetInterleavedInstances(int numInstances,
+                           float const * const * buffers,
+                           BufferDescriptor const &desc,
+                           BufferDescriptor * wideDesc) {
+
+    if (numInstances < 2 || desc.length * numInstances > desc.stride) {
+        return false;
+    }
+    for (int i = 1; i < numInstances; ++i) {
+        if (buffers[i] != buffers[0] + i * desc.length) return false;
+    }
+    *wideDesc = BufferDescriptor(desc.offset, desc.length * numInstances,
+                                 desc.stride);
+    return true;
+}
+
+void
+CpuComputeStencilInstances(int numInstances,
+                           float const * const * src,
+                           BufferDescriptor const &srcDesc,
+                           float * const * dst,
+                           BufferDescriptor const &dstDesc,
+                           int const * sizes,
+                           int const * offsets,
+                           int const * indices,
+                           float const * weights,
+                           int start, int end) {
+
+    start = (start > 0 ? start : 0);
+
+    BufferDescriptor wideSrcDesc, wideDstDesc;
+    if (CpuGetInterleavedInstances(numInstances, src, srcDesc, &wideSrcDesc) &&
+        CpuGetInterleavedInstances(numInstances, dst, dstDesc, &wideDstDesc)) {
+        float * wideDst = dst[0] + dstDesc.offset;
+        CpuComputeStencils(src[0] + srcDesc.offset, wideSrcDesc, 1,
+                           &wideDst, &wideDstDesc,
+                           sizes, offsets, indices, &weights, start, end);
+        return;
+    }
+
+    for (int blockStart = start; blockStart < end; ) {
+        int blockEnd = std::min(blockStart + INSTANCE_BLOCK_SIZE, end);
+
+        // the stencils of the block stay in the cache across the instances
+        for (int i = 0; i < numInstances; ++i) {
+            float * blockDst = dst[i] + dstDesc.offset +
+                               (blockStart - start) * dstDesc.stride;
+
+            CpuComputeStencils(src[i] + srcDesc.offset, srcDesc, 1,
+                               &blockDst, &dstDesc,
+                               sizes, offsets, indices, &weights,
+                               blockStart, blockEnd);
+        }
+        blockStart = blockEnd;
+    }
+}
+
+bool
+CpuEvalPatches(float const * src, BufferDescriptor const &srcDesc,
+               int numWeightSets,
+               float * const * dst, BufferDescriptor const * dstDesc,
+               int numPatchCoords,
+               PatchCoord const * patchCoords,
+               PatchArray const * patchArrays,
+               int const * patchIndexBuffer,
+               PatchParam const * patchParamBuffer) {
+
+    assert(numWeightSets == 1 || numWeightSets == 3 || numWeightSets == 6);
+
+    PatchBlock block;
+
+    float * blockDst[MAX_WEIGHT_SETS];
+    float const * blockWeights[MAX_WEIGHT_SETS];
+    for (int w = 0; w < numWeightSets; ++w) {
+        blockWeights[w] = block.weights[w];
+    }
+
+    for (int blockStart = 0; blockStart < numPatchCoords;
+         blockStart += PATCH_BLOCK_SIZE) {
+        int blockSize = std::min((int)PATCH_BLOCK_SIZE,
+                                 numPatchCoords - blockStart);
+
+        if (! getPatchBlock(numWeightSets, patchCoords + blockStart, blockSize,
+                            patchArrays, patchIndexBuffer, patchParamBuffer,
+                            block)) {
+            return false;
+        }
+
+        for (int w = 0; w < numWeightSets; ++w) {
+            blockDst[w] = dst[w] ? dst[w] + blockStart * dstDesc[w].stride : 0;
+        }
+        CpuComputeStencils(src, srcDesc, numWeightSets, blockDst, dstDesc,
+                           block.sizes, block.offsets, block.indices,
+                           blockWeights, 0, blockSize);
+    }
+    return true;
+}
+
 void
 CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
-                float * dstDu,     BufferDescriptor const &dstDuDesc,
-                float * dstDv,     BufferDescriptor const &dstDvDesc,
                 int const * sizes,
                 int const * offsets,
                 int const * indices,
                 float const * weights,
-                float const * duWeights,
-                float const * dvWeights,
                 int start, int end) {
-    if (start > 0) {
-        sizes += start;
-        indices += offsets[start];
-        weights += offsets[start];
-        duWeights += offsets[start];
-        dvWeights += offsets[start];
-    }
+
+    assert(start>=0 && start<end);
 
     src += srcDesc.offset;
     dst += dstDesc.offset;
-    dstDu += dstDuDesc.offset;
-    dstDv += dstDvDesc.offset;
 
-    int nOutLength = dstDesc.length + dstDuDesc.length + dstDvDesc.length;
-    float * result   = (float*)alloca(nOutLength * sizeof(float));
-    float * resultDu = result + dstDesc.length;
-    float * resultDv = resultDu + dstDuDesc.length;
+    CpuComputeStencils(src, srcDesc, 1, &dst, &dstDesc,
+                       sizes, offsets, indices, &weights, start, end);
+}
 
-    int nStencils = end - start;
-    for (int i = 0; i < nStencils; ++i, ++sizes) {
+void
+CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
+                float * dst,       BufferDescriptor const &dstDesc,
+                float * dstDu,     BufferDescriptor const &dstDuDesc,
+                float * dstDv,     BufferDescriptor const &dstDvDesc,
+                int const * sizes,
+                int const * offsets,
+                int const * indices,
+                float const * weights,
+                float const * duWeights,
+                float const * dvWeights,
+                int start, int end) {
 
-        // clear
-        memset(result, 0, nOutLength * sizeof(float));
+    float * dsts[3] = { dst   ? dst   + dstDesc.offset   : 0,
+                        dstDu ? dstDu + dstDuDesc.offset : 0,
+                        dstDv ? dstDv + dstDvDesc.offset : 0 };
+    BufferDescriptor dstDescs[3] = { dstDesc, dstDuDesc, dstDvDesc };
+    float const * weightSets[3] = { weights, duWeights, dvWeights };
 
-        for (int j=0; j<*sizes; ++j) {
-            addWithWeight(result,   src, *indices, *weights++,   srcDesc);
-            addWithWeight(resultDu, src, *indices, *duWeights++, srcDesc);
-            addWithWeight(resultDv, src, *indices, *dvWeights++, srcDesc);
-            ++indices;
-        }
-        copy(dst,   i, result, dstDesc);
-        copy(dstDu, i, resultDu, dstDuDesc);
-        copy(dstDv, i, resultDv, dstDvDesc);
-    }
+    CpuComputeStencils(src + srcDesc.offset, srcDesc, 3, dsts, dstDescs,
+                       sizes, offsets, indices, weightSets, start, end);
 }
 
 void
@@ -187,56 +867,20 @@ CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * duvWeights,
                 float const * dvvWeights,
                 int start, int end) {
-    if (start > 0) {
-        sizes += start;
-        indices += offsets[start];
-        weights += offsets[start];
-        duWeights += offsets[start];
-        dvWeights += offsets[start];
-        duuWeights += offsets[start];
-        duvWeights += offsets[start];
-        dvvWeights += offsets[start];
-    }
 
-    src += srcDesc.offset;
-    dst += dstDesc.offset;
-    dstDu += dstDuDesc.offset;
-    dstDv += dstDvDesc.offset;
-    dstDuu += dstDuuDesc.offset;
-    dstDuv += dstDuvDesc.offset;
-    dstDvv += dstDvvDesc.offset;
-
-    int nOutLength = dstDesc.length + dstDuDesc.length + dstDvDesc.length
-                   + dstDuuDesc.length + dstDuvDesc.length + dstDvvDesc.length;
-    float * result   = (float*)alloca(nOutLength * sizeof(float));
-    float * resultDu = result + dstDesc.length;
-    float * resultDv = resultDu + dstDuDesc.length;
-    float * resultDuu = resultDv + dstDvDesc.length;
-    float * resultDuv = resultDuu + dstDuuDesc.length;
-    float * resultDvv = resultDuv + dstDuvDesc.length;
-
-    int nStencils = end - start;
-    for (int i = 0; i < nStencils; ++i, ++sizes) {
-
-        // clear
-        memset(result, 0, nOutLength * sizeof(float));
-
-        for (int j=0; j<*sizes; ++j) {
-            addWithWeight(result,   src, *indices, *weights++,   srcDesc);
-            addWithWeight(resultDu, src, *indices, *duWeights++, srcDesc);
-            addWithWeight(resultDv, src, *indices, *dvWeights++, srcDesc);
-            addWithWeight(resultDuu, src, *indices, *duuWeights++, srcDesc);
-            addWithWeight(resultDuv, src, *indices, *duvWeights++, srcDesc);
-            addWithWeight(resultDvv, src, *indices, *dvvWeights++, srcDesc);
-            ++indices;
-        }
-        copy(dst,   i, result, dstDesc);
-        copy(dstDu, i, resultDu, dstDuDesc);
-        copy(dstDv, i, resultDv, dstDvDesc);
-        copy(dstDuu, i, resultDuu, dstDuuDesc);
-        copy(dstDuv, i, resultDuv, dstDuvDesc);
-        copy(dstDvv, i, resultDvv, dstDvvDesc);
-    }
+    float * dsts[6] = { dst    ? dst    + dstDesc.offset    : 0,
+                        dstDu  ? dstDu  + dstDuDesc.offset  : 0,
+                        dstDv  ? dstDv  + dstDvDesc.offset  : 0,
+                        dstDuu ? dstDuu + dstDuuDesc.offset : 0,
+                        dstDuv ? dstDuv + dstDuvDesc.offset : 0,
+                        dstDvv ? dstDvv + dstDvvDesc.offset : 0 };
+    BufferDescriptor dstDescs[6] = { dstDesc, dstDuDesc, dstDvDesc,
+                                     dstDuuDesc, dstDuvDesc, dstDvvDesc };
+    float const * weightSets[6] = { weights, duWeights, dvWeights,
+                                    duuWeights, duvWeights, dvvWeights };
+
+    CpuComputeStencils(src + srcDesc.offset, srcDesc, 6, dsts, dstDescs,
+                       sizes, offsets, indices, weightSets, start, end);
 }
 
 }  // end namespace Osd
@@ -34,6 +34,135 @@ namespace OPENSUBDIV_VERSION {
 namespace Osd {
 
 struct BufferDescriptor;
+struct PatchArray;
+struct PatchCoord;
+struct PatchParam;
+class CpuCompactStencilTable;
+
+/// \brief Instruction sets of the CPU stencil kernels
+enum CpuKernelISA {
+    CPU_KERNEL_ISA_SCALAR = 0,  ///< portable scalar kernels
+    CPU_KERNEL_ISA_AVX2,        ///< AVX2 and FMA kernels
+    CPU_KERNEL_ISA_AVX512       ///< AVX-512 kernels
+};
+
+/// \brief Returns the instruction set of the stencil kernels. Unless set
+///        otherwise, the widest one supported by the CPU is used.
+CpuKernelISA CpuGetKernelISA();
+
+/// \brief Restricts the instruction set of the stencil kernels (ex. for
+///        benchmarks) and returns the one effectively used, which is limited
+///        to the ones supported by the CPU. Not thread-safe.
+CpuKernelISA CpuSetKernelISA(CpuKernelISA isa);
+
+/// \brief Evaluates the stencils [start, end) for up to 6 sets of weights
+///        (point, 1st and 2nd derivatives) with the kernels of the selected
+///        instruction set. This is shared by the Cpu, Omp and Tbb evaluators.
+///
+/// The primvars can have any length and stride: the descriptor offsets are
+/// expected to be applied to the buffers already, and the results of the
+/// stencil 'start + i' are written at 'dst[w] + i * dstDesc[w].stride'.
+/// The weight sets with a null destination are skipped.
+///
+void
+CpuComputeStencils(float const * src, BufferDescriptor const &srcDesc,
+                   int numWeightSets,
+                   float * const * dst, BufferDescriptor const * dstDesc,
+                   int const * sizes,
+                   int const * offsets,
+                   int const * indices,
+                   float const * const * weights,
+                   int start, int end);
+
+/// \brief Evaluates the stencils listed in 'stencilIndices' (ex. the ones
+///        affected by the edit of a few control vertices).
+///
+/// Same as CpuComputeStencils, except that the results of the stencil
+/// 'stencilIndices[i]' are written at
+/// 'dst[w] + stencilIndices[i] * dstDesc[w].stride', leaving the other
+/// stencils untouched. Consecutive indices are evaluated as ranges, so
+/// sorted lists are processed faster.
+///
+void
+CpuComputeStencilList(float const * src, BufferDescriptor const &srcDesc,
+                      int numWeightSets,
+                      float * const * dst, BufferDescriptor const * dstDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * const * weights,
+                      int numStencils, int const * stencilIndices);
+
+/// \brief Evaluates the stencils [start, end) of a compact stencil table,
+///        which are decoded block by block (the results are written as with
+///        CpuComputeStencils).
+///
+void
+CpuComputeCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                          int numWeightSets,
+                          float * const * dst, BufferDescriptor const * dstDesc,
+                          CpuCompactStencilTable const & stencilTable,
+                          int start, int end);
+
+/// \brief Returns true when the primvars of the instances are interleaved in
+///        the elements of a single buffer (i.e. the instance 'i' starts
+///        'i * desc.length' floats after the first one), in which case they
+///        are evaluated as a single primvar described by 'wideDesc'.
+///
+bool
+CpuGetInterleavedInstances(int numInstances,
+                           float const * const * buffers,
+                           BufferDescriptor const &desc,
+                           BufferDescriptor * wideDesc);
+
+/// \brief Evaluates the stencils [start, end) for several instances of the
+///        same topology. Each block of stencils is applied to all the
+///        instances before the next one is read, so that the sizes, indices
+///        and weights of the table are streamed from memory once.
+///
+/// Unlike CpuComputeStencils, the descriptor offsets are applied here to the
+/// buffers of each instance (the results of the stencil 'start + i' are
+/// written at 'dst[instance] + dstDesc.offset + i * dstDesc.stride').
+/// Interleaved instances are evaluated at once, so that the SIMD kernels
+/// process all the instances with each weight.
+///
+void
+CpuComputeStencilInstances(int numInstances,
+                           float const * const * src,
+                           BufferDescriptor const &srcDesc,
+                           float * const * dst,
+                           BufferDescriptor const &dstDesc,
+                           int const * sizes,
+                           int const * offsets,
+                           int const * indices,
+                           float const * weights,
+                           int start, int end);
+
+/// \brief Evaluates the limit (and optionally its 1st and 2nd derivatives)
+///        at a list of patch coordinates. This is shared by the Cpu, Omp and
+///        Tbb evaluators.
+///
+/// The coordinates are processed in blocks: the basis weights of the
+/// B-spline patches of a block are evaluated several at once (the other
+/// patch types one at a time), then the control vertices of the block are
+/// gathered by the stencil kernels of the selected instruction set.
+///
+/// 'numWeightSets' is 1 (point), 3 (1st derivatives) or 6 (2nd derivatives).
+/// As with CpuComputeStencils, the descriptor offsets are expected to be
+/// applied to the buffers already, the results of the coordinate 'i' are
+/// written at 'dst[w] + i * dstDesc[w].stride' and the weight sets with a
+/// null destination are skipped. Returns false if a coordinate refers to an
+/// unsupported patch type.
+///
+bool
+CpuEvalPatches(float const * src, BufferDescriptor const &srcDesc,
+               int numWeightSets,
+               float * const * dst, BufferDescriptor const * dstDesc,
+               int numPatchCoords,
+               PatchCoord const * patchCoords,
+               PatchArray const * patchArrays,
+               int const * patchIndexBuffer,
+               PatchParam const * patchParamBuffer);
 
 void
 CpuEvalStencils(float const * src, BufferDescriptor const &srcDesc,
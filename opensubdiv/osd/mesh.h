@@ -30,6 +30,7 @@
 #include <bitset>
 #include <cassert>
 #include <cstring>
+#include <map>
 #include <vector>
 
 #include "../far/topologyRefiner.h"
@@ -57,7 +58,10 @@ enum MeshBits {
     MeshEndCapBSplineBasis   = 7,  // exclusive
     MeshEndCapGregoryBasis   = 8,  // exclusive
     MeshEndCapLegacyGregory  = 9,  // exclusive
-    NUM_MESH_BITS            = 10,
+    MeshLevelStencils        = 10, // level-to-level stencils (adaptive
+                                   // meshes with the Cpu, Omp and Tbb
+                                   // evaluators)
+    NUM_MESH_BITS            = 11,
 };
 typedef std::bitset<NUM_MESH_BITS> MeshBitset;
 
@@ -409,6 +413,391 @@ static EVALUATOR *GetEvaluator(
 
 // ---------------------------------------------------------------------------
 
+// Osd mesh topology cache: meshes whose topology, Sdc options and refinement
+//   options are identical share a single refiner and the stencil and patch
+//   tables created from it.
+//
+// Entries are reference counted: each mesh acquires the entry of its topology
+// when created and releases it when destroyed.  Device tables of an entry are
+// created with the device context of the mesh that first acquired it.
+//
+// note: this class is not thread-safe.
+//
+template <typename STENCIL_TABLE,
+          typename PATCH_TABLE,
+          typename DEVICE_CONTEXT = void>
+class MeshTopologyCacheT {
+public:
+    typedef STENCIL_TABLE StencilTable;
+    typedef PATCH_TABLE PatchTable;
+    typedef DEVICE_CONTEXT DeviceContext;
+
+    // Refinement data shared by meshes with identical topologies
+    struct Entry {
+        Far::TopologyRefiner * refiner;
+        Far::PatchTable * farPatchTable;
+        StencilTable const * vertexStencilTable;
+        StencilTable const * varyingStencilTable;
+        PatchTable * patchTable;
+        int numVertices;
+        int maxValence;
+
+        // face-varying stencil tables and number of values of each channel
+        // (only created with MeshFVarData)
+        std::vector<StencilTable const *> fvarStencilTables;
+        std::vector<int> numFVarValues;
+
+        // identification of the topology and number of meshes sharing it
+        std::vector<unsigned int> key;
+        unsigned int hash;
+        int refCount;
+    };
+
+    MeshTopologyCacheT() { }
+
+    ~MeshTopologyCacheT() {
+        for (typename EntryMap::iterator it = _entries.begin();
+             it != _entries.end(); ++it) {
+            DestroyEntry(it->second);
+        }
+    }
+
+    /// \brief Returns the entry of the topology of \a refiner, creating it
+    /// if no mesh shares it yet, and acquires a reference to it. The cache
+    /// takes ownership of the refiner, which is deleted when an entry
+    /// already exists.
+    Entry * Acquire(Far::TopologyRefiner * refiner,
+                    int numVertexElements,
+                    int numVaryingElements,
+                    int level,
+                    MeshBitset bits,
+                    DeviceContext * deviceContext = NULL) {
+        assert(refiner);
+
+        std::vector<unsigned int> key;
+        unsigned int hash = hashTopology(*refiner, numVertexElements,
+            numVaryingElements, level, bits, key);
+
+        std::pair<typename EntryMap::iterator, typename EntryMap::iterator>
+            range = _entries.equal_range(hash);
+        for (typename EntryMap::iterator it = range.first;
+             it != range.second; ++it) {
+            if (it->second->key == key) {
+                delete refiner;
+                ++it->second->refCount;
+                return it->second;
+            }
+        }
+
+        Entry * entry = CreateEntry(refiner, numVertexElements,
+            numVaryingElements, level, bits, deviceContext);
+        entry->key.swap(key);
+        entry->hash = hash;
+        _entries.insert(std::make_pair(hash, entry));
+        return entry;
+    }
+
+    /// \brief Releases a reference to an entry, which is destroyed once no
+    /// mesh references it
+    void Release(Entry * entry) {
+        assert(entry && entry->refCount > 0);
+        if (--entry->refCount > 0) return;
+
+        std::pair<typename EntryMap::iterator, typename EntryMap::iterator>
+            range = _entries.equal_range(entry->hash);
+        for (typename EntryMap::iterator it = range.first;
+             it != range.second; ++it) {
+            if (it->second == entry) {
+                _entries.erase(it);
+                break;
+            }
+        }
+        DestroyEntry(entry);
+    }
+
+    /// \brief Returns the number of distinct topologies held
+    int GetNumEntries() const {
+        return (int)_entries.size();
+    }
+
+    /// \brief Refines \a refiner and creates the tables of an entry which is
+    /// not held by a cache (the entry takes ownership of the refiner)
+    static Entry * CreateEntry(Far::TopologyRefiner * refiner,
+                               int numVertexElements,
+                               int numVaryingElements,
+                               int level,
+                               MeshBitset bits,
+                               DeviceContext * deviceContext = NULL) {
+        assert(refiner);
+
+        refineTopology(*refiner, level, bits);
+
+        Far::StencilTableFactory::Options options;
+        options.generateOffsets = true;
+        options.generateIntermediateLevels =
+            refiner->IsUniform() ? false : true;
+        // level-to-level stencils require the vertices of all the levels,
+        // which only adaptive meshes hold
+        options.factorizeIntermediateLevels =
+            refiner->IsUniform() || !bits.test(MeshLevelStencils);
+
+        Far::StencilTable const * vertexStencils = NULL;
+        Far::StencilTable const * varyingStencils = NULL;
+
+        if (numVertexElements>0) {
+
+            vertexStencils = Far::StencilTableFactory::Create(*refiner,
+                                                              options);
+        }
+
+        if (numVaryingElements>0) {
+
+            options.interpolationMode =
+                Far::StencilTableFactory::INTERPOLATE_VARYING;
+
+            varyingStencils = Far::StencilTableFactory::Create(*refiner,
+                                                               options);
+        }
+
+        Far::PatchTableFactory::Options poptions(level);
+        poptions.generateFVarTables = bits.test(MeshFVarData);
+        poptions.generateFVarLegacyLinearPatches = !bits.test(MeshFVarAdaptive);
+        poptions.generateLegacySharpCornerPatches = !bits.test(MeshUseSmoothCornerPatch);
+        poptions.useSingleCreasePatch = bits.test(MeshUseSingleCreasePatch);
+        poptions.useInfSharpPatch = bits.test(MeshUseInfSharpPatch);
+
+        if (bits.test(MeshEndCapBSplineBasis)) {
+            poptions.SetEndCapType(
+                Far::PatchTableFactory::Options::ENDCAP_BSPLINE_BASIS);
+        } else if (bits.test(MeshEndCapGregoryBasis)) {
+            poptions.SetEndCapType(
+                Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+            // points on gregory basis endcap boundary can be shared among
+            // adjacent patches to save some stencils.
+            poptions.shareEndCapPatchPoints = true;
+        } else if (bits.test(MeshEndCapLegacyGregory)) {
+            poptions.SetEndCapType(
+                Far::PatchTableFactory::Options::ENDCAP_LEGACY_GREGORY);
+        }
+
+        Entry * entry = new Entry;
+        entry->refiner = refiner;
+        entry->farPatchTable = Far::PatchTableFactory::Create(*refiner, poptions);
+        entry->hash = 0;
+        entry->refCount = 1;
+
+        // if there's endcap stencils, merge it into regular stencils.
+        if (entry->farPatchTable->GetLocalPointStencilTable()) {
+            // append stencils
+            if (Far::StencilTable const *vertexStencilsWithLocalPoints =
+                Far::StencilTableFactory::AppendLocalPointStencilTable(
+                    *refiner,
+                    vertexStencils,
+                    entry->farPatchTable->GetLocalPointStencilTable())) {
+                delete vertexStencils;
+                vertexStencils = vertexStencilsWithLocalPoints;
+            }
+            if (varyingStencils) {
+                if (Far::StencilTable const *varyingStencilsWithLocalPoints =
+                    Far::StencilTableFactory::AppendLocalPointStencilTable(
+                        *refiner,
+                        varyingStencils,
+                        entry->farPatchTable->GetLocalPointVaryingStencilTable())) {
+                    delete varyingStencils;
+                    varyingStencils = varyingStencilsWithLocalPoints;
+                }
+            }
+        }
+
+        if (bits.test(MeshFVarData)) {
+            createFaceVaryingStencilTables(entry, deviceContext);
+        }
+
+        entry->maxValence = entry->farPatchTable->GetMaxValence();
+        entry->patchTable = PatchTable::Create(entry->farPatchTable, deviceContext);
+
+        // numvertices = coarse verts + refined verts + gregory basis verts
+        entry->numVertices = vertexStencils->GetNumControlVertices()
+            + vertexStencils->GetNumStencils();
+
+        // convert to device stenciltable if necessary.
+        entry->vertexStencilTable =
+            convertToCompatibleStencilTable<StencilTable>(
+            vertexStencils, deviceContext);
+        entry->varyingStencilTable =
+            convertToCompatibleStencilTable<StencilTable>(
+            varyingStencils, deviceContext);
+
+        // FIXME: we do extra copyings for Far::Stencils.
+        delete vertexStencils;
+        delete varyingStencils;
+
+        return entry;
+    }
+
+    /// \brief Destroys an entry created by CreateEntry
+    static void DestroyEntry(Entry * entry) {
+        delete entry->refiner;
+        delete entry->farPatchTable;
+        delete entry->vertexStencilTable;
+        delete entry->varyingStencilTable;
+        delete entry->patchTable;
+        for (int i = 0; i < (int)entry->fvarStencilTables.size(); ++i) {
+            delete entry->fvarStencilTables[i];
+        }
+        delete entry;
+    }
+
+private:
+    typedef std::multimap<unsigned int, Entry *> EntryMap;
+
+    //  Creates the stencil tables of the face-varying channels of an entry,
+    //  including the local points of their end caps
+    static void createFaceVaryingStencilTables(Entry * entry,
+                                               DeviceContext * deviceContext) {
+
+        Far::TopologyRefiner const & refiner = *entry->refiner;
+
+        int numChannels = refiner.GetNumFVarChannels();
+        entry->fvarStencilTables.resize(numChannels, NULL);
+        entry->numFVarValues.resize(numChannels, 0);
+
+        Far::StencilTableFactory::Options options;
+        options.generateOffsets = true;
+        options.generateIntermediateLevels =
+            refiner.IsUniform() ? false : true;
+        options.interpolationMode =
+            Far::StencilTableFactory::INTERPOLATE_FACE_VARYING;
+
+        for (int channel = 0; channel < numChannels; ++channel) {
+
+            options.fvarChannel = channel;
+
+            Far::StencilTable const * fvarStencils =
+                Far::StencilTableFactory::Create(refiner, options);
+
+            Far::StencilTable const * localPointStencils =
+                entry->farPatchTable->GetLocalPointFaceVaryingStencilTable(
+                    channel);
+            if (localPointStencils) {
+                if (Far::StencilTable const *fvarStencilsWithLocalPoints =
+                    Far::StencilTableFactory::AppendLocalPointStencilTableFaceVarying(
+                        refiner,
+                        fvarStencils,
+                        localPointStencils,
+                        channel)) {
+                    delete fvarStencils;
+                    fvarStencils = fvarStencilsWithLocalPoints;
+                }
+            }
+
+            // numvalues = coarse values + refined values + end cap values
+            entry->numFVarValues[channel] =
+                fvarStencils->GetNumControlVertices() +
+                fvarStencils->GetNumStencils();
+
+            entry->fvarStencilTables[channel] =
+                convertToCompatibleStencilTable<StencilTable>(
+                fvarStencils, deviceContext);
+
+            delete fvarStencils;
+        }
+    }
+
+    //  Same refinement as MeshInterface::refineMesh(), which is not available
+    //  for patch tables without vertex buffer bindings
+    static void refineTopology(Far::TopologyRefiner & refiner,
+                               int level, MeshBitset bits) {
+        if (bits.test(MeshAdaptive)) {
+            Far::TopologyRefiner::AdaptiveOptions options(level);
+            options.useSingleCreasePatch = bits.test(MeshUseSingleCreasePatch);
+            options.useInfSharpPatch = bits.test(MeshUseInfSharpPatch);
+            options.considerFVarChannels = bits.test(MeshFVarAdaptive);
+            refiner.RefineAdaptive(options);
+        } else {
+            //  This dependency on FVar channels should not be necessary
+            bool fullTopologyInLastLevel = refiner.GetNumFVarChannels()>0;
+
+            Far::TopologyRefiner::UniformOptions options(level);
+            options.fullTopologyInLastLevel = fullTopologyInLastLevel;
+            refiner.RefineUniform(options);
+        }
+    }
+
+    //  Gathers everything the refinement of the base level depends on into
+    //  a key and returns its (FNV-1a) hash
+    static unsigned int hashTopology(Far::TopologyRefiner const & refiner,
+                                     int numVertexElements,
+                                     int numVaryingElements,
+                                     int level, MeshBitset bits,
+                                     std::vector<unsigned int> & key) {
+
+        Far::TopologyLevel const & baseLevel = refiner.GetLevel(0);
+        Sdc::Options sdcOptions = refiner.GetSchemeOptions();
+
+        key.push_back(refiner.GetSchemeType());
+        key.push_back(sdcOptions.GetVtxBoundaryInterpolation());
+        key.push_back(sdcOptions.GetFVarLinearInterpolation());
+        key.push_back(sdcOptions.GetCreasingMethod());
+        key.push_back(sdcOptions.GetTriangleSubdivision());
+        key.push_back(level);
+        key.push_back((unsigned int)bits.to_ulong());
+        key.push_back(numVertexElements > 0);
+        key.push_back(numVaryingElements > 0);
+
+        key.push_back(baseLevel.GetNumVertices());
+        key.push_back(baseLevel.GetNumFaces());
+        for (int face = 0; face < baseLevel.GetNumFaces(); ++face) {
+            Far::ConstIndexArray fVerts = baseLevel.GetFaceVertices(face);
+            key.push_back((unsigned int)fVerts.size() |
+                (baseLevel.IsFaceHole(face) ? 0x80000000u : 0u));
+            key.insert(key.end(), fVerts.begin(), fVerts.end());
+        }
+        key.push_back(baseLevel.GetNumEdges());
+        for (int edge = 0; edge < baseLevel.GetNumEdges(); ++edge) {
+            Far::ConstIndexArray eVerts = baseLevel.GetEdgeVertices(edge);
+            key.push_back(eVerts[0]);
+            key.push_back(eVerts[1]);
+            appendFloat(baseLevel.GetEdgeSharpness(edge), key);
+        }
+        for (int vert = 0; vert < baseLevel.GetNumVertices(); ++vert) {
+            appendFloat(baseLevel.GetVertexSharpness(vert), key);
+        }
+
+        key.push_back(baseLevel.GetNumFVarChannels());
+        for (int channel = 0; channel < baseLevel.GetNumFVarChannels(); ++channel) {
+            key.push_back(refiner.GetFVarLinearInterpolation(channel));
+            key.push_back(baseLevel.GetNumFVarValues(channel));
+            for (int face = 0; face < baseLevel.GetNumFaces(); ++face) {
+                Far::ConstIndexArray fValues =
+                    baseLevel.GetFaceFVarValues(face, channel);
+                key.insert(key.end(), fValues.begin(), fValues.end());
+            }
+        }
+
+        unsigned int hash = 2166136261u;
+        for (size_t i = 0; i < key.size(); ++i) {
+            hash = (hash ^ key[i]) * 16777619u;
+        }
+        return hash;
+    }
+
+    static void appendFloat(float value, std::vector<unsigned int> & key) {
+        unsigned int bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        key.push_back(bits);
+    }
+
+    EntryMap _entries;
+
+private:
+    // Non-copyable
+    MeshTopologyCacheT(MeshTopologyCacheT const &) { }
+    MeshTopologyCacheT & operator=(MeshTopologyCacheT const &) { return *this; }
+};
+
+// ---------------------------------------------------------------------------
+
 template <typename VERTEX_BUFFER,
           typename STENCIL_TABLE,
           typename EVALUATOR,
@@ -422,46 +811,55 @@ public:
     typedef PATCH_TABLE PatchTable;
     typedef DEVICE_CONTEXT DeviceContext;
     typedef EvaluatorCacheT<Evaluator> EvaluatorCache;
+    typedef MeshTopologyCacheT<StencilTable, PatchTable, DeviceContext>
+        TopologyCache;
     typedef typename PatchTable::VertexBufferBinding VertexBufferBinding;
 
+    /// \brief Refines \a refiner and creates the mesh tables. When a
+    /// \a topologyCache is given, meshes with identical topologies share
+    /// a single refinement (the refiner is then owned by the cache).
+    /// With MeshFVarData, a buffer of \a numFaceVaryingElements is created
+    /// for each face-varying channel.
     Mesh(Far::TopologyRefiner * refiner,
          int numVertexElements,
          int numVaryingElements,
          int level,
          MeshBitset bits = MeshBitset(),
          EvaluatorCache * evaluatorCache = NULL,
-         DeviceContext * deviceContext = NULL) :
+         DeviceContext * deviceContext = NULL,
+         TopologyCache * topologyCache = NULL,
+         int numFaceVaryingElements = 0) :
 
-            _refiner(refiner),
-            _farPatchTable(NULL),
-            _numVertices(0),
-            _maxValence(0),
+            _topology(NULL),
+            _topologyCache(topologyCache),
             _vertexBuffer(NULL),
             _varyingBuffer(NULL),
-            _vertexStencilTable(NULL),
-            _varyingStencilTable(NULL),
             _evaluatorCache(evaluatorCache),
-            _patchTable(NULL),
             _deviceContext(deviceContext) {
 
-        assert(_refiner);
+        assert(refiner);
 
-        MeshInterface<PATCH_TABLE>::refineMesh(
-            *_refiner, level, bits);
+        if (_topologyCache) {
+            _topology = _topologyCache->Acquire(refiner,
+                numVertexElements, numVaryingElements, level, bits,
+                _deviceContext);
+        } else {
+            _topology = TopologyCache::CreateEntry(refiner,
+                numVertexElements, numVaryingElements, level, bits,
+                _deviceContext);
+        }
 
         int vertexBufferStride = numVertexElements +
             (bits.test(MeshInterleaveVarying) ? numVaryingElements : 0);
         int varyingBufferStride =
             (bits.test(MeshInterleaveVarying) ? 0 : numVaryingElements);
 
-        initializeContext(numVertexElements,
-                          numVaryingElements,
-                          level, bits);
-
-        initializeVertexBuffers(_numVertices,
+        initializeVertexBuffers(_topology->numVertices,
                                 vertexBufferStride,
                                 varyingBufferStride);
 
+        initializeFaceVaryingBuffers(numFaceVaryingElements);
+
         // configure vertex buffer descriptor
         _vertexDesc =
             BufferDescriptor(0, numVertexElements, vertexBufferStride);
@@ -475,14 +873,18 @@ public:
     }
 
     virtual ~Mesh() {
-        delete _refiner;
-        delete _farPatchTable;
+        if (_topologyCache) {
+            _topologyCache->Release(_topology);
+        } else {
+            TopologyCache::DestroyEntry(_topology);
+        }
         delete _vertexBuffer;
         delete _varyingBuffer;
-        delete _vertexStencilTable;
-        delete _varyingStencilTable;
-        delete _patchTable;
-        // deviceContext and evaluatorCache are not owned by this class.
+        for (int i = 0; i < (int)_fvarBuffers.size(); ++i) {
+            delete _fvarBuffers[i];
+        }
+        // deviceContext, evaluatorCache and topologyCache are not owned by
+        // this class.
     }
 
     virtual void UpdateVertexBuffer(float const *vertexData,
@@ -499,7 +901,8 @@ public:
 
     virtual void Refine() {
 
-        int numControlVertices = _refiner->GetLevel(0).GetNumVertices();
+        int numControlVertices =
+            _topology->refiner->GetLevel(0).GetNumVertices();
 
         BufferDescriptor srcDesc = _vertexDesc;
         BufferDescriptor dstDesc(srcDesc);
@@ -514,7 +917,7 @@ public:
 
         Evaluator::EvalStencils(_vertexBuffer, srcDesc,
                                 _vertexBuffer, dstDesc,
-                                _vertexStencilTable,
+                                _topology->vertexStencilTable,
                                 instance, _deviceContext);
 
         if (_varyingDesc.length > 0) {
@@ -530,33 +933,68 @@ public:
                 // non-interleaved
                 Evaluator::EvalStencils(_varyingBuffer, vSrcDesc,
                                         _varyingBuffer, vDstDesc,
-                                        _varyingStencilTable,
+                                        _topology->varyingStencilTable,
                                         instance, _deviceContext);
             } else {
                 // interleaved
                 Evaluator::EvalStencils(_vertexBuffer, vSrcDesc,
                                         _vertexBuffer, vDstDesc,
-                                        _varyingStencilTable,
+                                        _topology->varyingStencilTable,
                                         instance, _deviceContext);
             }
         }
     }
 
+    /// \brief Updates the coarse face-varying values of a channel
+    virtual void UpdateFaceVaryingBuffer(float const *fvarData,
+                                         int startValue, int numValues,
+                                         int channel = 0) {
+        _fvarBuffers[channel]->UpdateData(fvarData, startValue, numValues,
+                                          _deviceContext);
+    }
+
+    /// \brief Refines the face-varying values of all the channels with
+    /// their stencil tables
+    virtual void RefineFaceVarying() {
+
+        for (int channel = 0; channel < (int)_fvarBuffers.size(); ++channel) {
+
+            StencilTable const * stencilTable =
+                _topology->fvarStencilTables[channel];
+
+            int numCoarseValues =
+                _topology->refiner->GetLevel(0).GetNumFVarValues(channel);
+
+            BufferDescriptor srcDesc = _fvarDesc;
+            BufferDescriptor dstDesc(srcDesc);
+            dstDesc.offset += numCoarseValues * dstDesc.stride;
+
+            Evaluator const *instance = GetEvaluator<Evaluator>(
+                _evaluatorCache, srcDesc, dstDesc,
+                _deviceContext);
+
+            Evaluator::EvalStencils(_fvarBuffers[channel], srcDesc,
+                                    _fvarBuffers[channel], dstDesc,
+                                    stencilTable,
+                                    instance, _deviceContext);
+        }
+    }
+
     virtual void Synchronize() {
         Evaluator::Synchronize(_deviceContext);
     }
 
     virtual PatchTable * GetPatchTable() const {
-        return _patchTable;
+        return _topology->patchTable;
     }
 
     virtual Far::PatchTable const *GetFarPatchTable() const {
-        return _farPatchTable;
+        return _topology->farPatchTable;
     }
 
-    virtual int GetNumVertices() const { return _numVertices; }
+    virtual int GetNumVertices() const { return _topology->numVertices; }
 
-    virtual int GetMaxValence() const { return _maxValence; }
+    virtual int GetMaxValence() const { return _topology->maxValence; }
 
     virtual VertexBufferBinding BindVertexBuffer() {
         return _vertexBuffer->BindVBO(_deviceContext);
@@ -566,6 +1004,10 @@ public:
         return _varyingBuffer->BindVBO(_deviceContext);
     }
 
+    virtual VertexBufferBinding BindFaceVaryingBuffer(int channel = 0) {
+        return _fvarBuffers[channel]->BindVBO(_deviceContext);
+    }
+
     virtual VertexBuffer * GetVertexBuffer() {
         return _vertexBuffer;
     }
@@ -574,105 +1016,21 @@ public:
         return _varyingBuffer;
     }
 
-    virtual Far::TopologyRefiner const * GetTopologyRefiner() const {
-        return _refiner;
+    virtual VertexBuffer * GetFaceVaryingBuffer(int channel = 0) {
+        return _fvarBuffers[channel];
     }
 
-private:
-    void initializeContext(int numVertexElements,
-                           int numVaryingElements,
-                           int level, MeshBitset bits) {
-        assert(_refiner);
-
-        Far::StencilTableFactory::Options options;
-        options.generateOffsets = true;
-        options.generateIntermediateLevels =
-            _refiner->IsUniform() ? false : true;
-
-        Far::StencilTable const * vertexStencils = NULL;
-        Far::StencilTable const * varyingStencils = NULL;
-
-        if (numVertexElements>0) {
-
-            vertexStencils = Far::StencilTableFactory::Create(*_refiner,
-                                                              options);
-        }
-
-        if (numVaryingElements>0) {
-
-            options.interpolationMode =
-                Far::StencilTableFactory::INTERPOLATE_VARYING;
-
-            varyingStencils = Far::StencilTableFactory::Create(*_refiner,
-                                                               options);
-        }
-
-        Far::PatchTableFactory::Options poptions(level);
-        poptions.generateFVarTables = bits.test(MeshFVarData);
-        poptions.generateFVarLegacyLinearPatches = !bits.test(MeshFVarAdaptive);
-        poptions.generateLegacySharpCornerPatches = !bits.test(MeshUseSmoothCornerPatch);
-        poptions.useSingleCreasePatch = bits.test(MeshUseSingleCreasePatch);
-        poptions.useInfSharpPatch = bits.test(MeshUseInfSharpPatch);
-
-        if (bits.test(MeshEndCapBSplineBasis)) {
-            poptions.SetEndCapType(
-                Far::PatchTableFactory::Options::ENDCAP_BSPLINE_BASIS);
-        } else if (bits.test(MeshEndCapGregoryBasis)) {
-            poptions.SetEndCapType(
-                Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
-            // points on gregory basis endcap boundary can be shared among
-            // adjacent patches to save some stencils.
-            poptions.shareEndCapPatchPoints = true;
-        } else if (bits.test(MeshEndCapLegacyGregory)) {
-            poptions.SetEndCapType(
-                Far::PatchTableFactory::Options::ENDCAP_LEGACY_GREGORY);
-        }
-
-        _farPatchTable = Far::PatchTableFactory::Create(*_refiner, poptions);
-
-        // if there's endcap stencils, merge it into regular stencils.
-        if (_farPatchTable->GetLocalPointStencilTable()) {
-            // append stencils
-            if (Far::StencilTable const *vertexStencilsWithLocalPoints =
-                Far::StencilTableFactory::AppendLocalPointStencilTable(
-                    *_refiner,
-                    vertexStencils,
-                    _farPatchTable->GetLocalPointStencilTable())) {
-                delete vertexStencils;
-                vertexStencils = vertexStencilsWithLocalPoints;
-            }
-            if (varyingStencils) {
-                if (Far::StencilTable const *varyingStencilsWithLocalPoints =
-                    Far::StencilTableFactory::AppendLocalPointStencilTable(
-                        *_refiner,
-                        varyingStencils,
-                        _farPatchTable->GetLocalPointVaryingStencilTable())) {
-                    delete varyingStencils;
-                    varyingStencils = varyingStencilsWithLocalPoints;
-                }
-            }
-        }
-
-        _maxValence = _farPatchTable->GetMaxValence();
-        _patchTable = PatchTable::Create(_farPatchTable, _deviceContext);
-
-        // numvertices = coarse verts + refined verts + gregory basis verts
-        _numVertices = vertexStencils->GetNumControlVertices()
-            + vertexStencils->GetNumStencils();
-
-        // convert to device stenciltable if necessary.
-        _vertexStencilTable =
-            convertToCompatibleStencilTable<StencilTable>(
-            vertexStencils, _deviceContext);
-        _varyingStencilTable =
-            convertToCompatibleStencilTable<StencilTable>(
-            varyingStencils, _deviceContext);
+    /// \brief Returns the number of face-varying values of a channel
+    /// (coarse, refined and end cap values)
+    virtual int GetNumFaceVaryingValues(int channel = 0) const {
+        return _topology->numFVarValues[channel];
+    }
 
-        // FIXME: we do extra copyings for Far::Stencils.
-        delete vertexStencils;
-        delete varyingStencils;
+    virtual Far::TopologyRefiner const * GetTopologyRefiner() const {
+        return _topology->refiner;
     }
 
+private:
     void initializeVertexBuffers(int numVertices,
                                  int numVertexElements,
                                  int numVaryingElements) {
@@ -688,11 +1046,21 @@ private:
         }
     }
 
-    Far::TopologyRefiner * _refiner;
-    Far::PatchTable * _farPatchTable;
+    void initializeFaceVaryingBuffers(int numElements) {
+
+        if (numElements <= 0) return;
 
-    int _numVertices;
-    int _maxValence;
+        int numChannels = (int)_topology->fvarStencilTables.size();
+        _fvarBuffers.resize(numChannels, NULL);
+        for (int channel = 0; channel < numChannels; ++channel) {
+            _fvarBuffers[channel] = VertexBuffer::Create(numElements,
+                _topology->numFVarValues[channel], _deviceContext);
+        }
+        _fvarDesc = BufferDescriptor(0, numElements, numElements);
+    }
+
+    typename TopologyCache::Entry * _topology;
+    TopologyCache * _topologyCache;
 
     VertexBuffer * _vertexBuffer;
     VertexBuffer * _varyingBuffer;
@@ -700,11 +1068,11 @@ private:
     BufferDescriptor _vertexDesc;
     BufferDescriptor _varyingDesc;
 
-    StencilTable const * _vertexStencilTable;
-    StencilTable const * _varyingStencilTable;
+    std::vector<VertexBuffer *> _fvarBuffers;
+    BufferDescriptor _fvarDesc;
+
     EvaluatorCache * _evaluatorCache;
 
-    PatchTable *_patchTable;
     DeviceContext *_deviceContext;
 };
 
@@ -24,7 +24,6 @@
 
 #include "../osd/ompEvaluator.h"
 #include "../osd/ompKernel.h"
-#include "../far/patchBasis.h"
 #include <omp.h>
 
 namespace OpenSubdiv {
@@ -128,35 +127,129 @@ OmpEvaluator::EvalStencils(
     return true;
 }
 
-template <typename T>
-struct BufferAdapter {
-    BufferAdapter(T *p, int length, int stride) :
-        _p(p), _length(length), _stride(stride) { }
-    void Clear() {
-        for (int i = 0; i < _length; ++i) _p[i] = 0;
-    }
-    void AddWithWeight(T const *src, float w) {
-        if (_p) {
-            // TODO: derivatives.
-            for (int i = 0; i < _length; ++i) {
-                _p[i] += src[i] * w;
-            }
-        }
-    }
-    const T *operator[] (int index) const {
-        return _p + _stride * index;
-    }
-    BufferAdapter<T> & operator ++() {
-        if (_p) {
-            _p += _stride;
-        }
-        return *this;
-    }
-
-    T *_p;
-    int _length;
-    int _stride;
-};
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int numStencils, const int * stencilIndices) {
+
+    if (numStencils <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    dst += dstDesc.offset;
+
+    OmpComputeStencilList(src + srcDesc.offset, srcDesc, 1, &dst, &dstDesc,
+                          sizes, offsets, indices, &weights,
+                          numStencils, stencilIndices);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    const float * duWeights,
+    const float * dvWeights,
+    int numStencils, const int * stencilIndices) {
+
+    if (numStencils <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    float * dsts[3] = { dst ? dst + dstDesc.offset : 0,
+                        du  ? du  + duDesc.offset  : 0,
+                        dv  ? dv  + dvDesc.offset  : 0 };
+    BufferDescriptor dstDescs[3] = { dstDesc, duDesc, dvDesc };
+    float const * weightSets[3] = { weights, duWeights, dvWeights };
+
+    OmpComputeStencilList(src + srcDesc.offset, srcDesc, 3, dsts, dstDescs,
+                          sizes, offsets, indices, weightSets,
+                          numStencils, stencilIndices);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(int numInstances,
+                           const float * const *src,
+                           BufferDescriptor const &srcDesc,
+                           float * const *dst,
+                           BufferDescriptor const &dstDesc,
+                           const int * sizes,
+                           const int * offsets,
+                           const int * indices,
+                           const float * weights,
+                           int start, int end) {
+
+    if (end <= start || numInstances <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    OmpComputeStencilInstances(numInstances, src, srcDesc, dst, dstDesc,
+                               sizes, offsets, indices, weights, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    dst += dstDesc.offset;
+
+    OmpComputeCompactStencils(src + srcDesc.offset, srcDesc, 1, &dst, &dstDesc,
+                              *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+OmpEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+    if (stencilTable->GetNumWeightSets() < 3) return false;
+
+    float * dsts[3] = { dst ? dst + dstDesc.offset : 0,
+                        du  ? du  + duDesc.offset  : 0,
+                        dv  ? dv  + dvDesc.offset  : 0 };
+    BufferDescriptor dstDescs[3] = { dstDesc, duDesc, dvDesc };
+
+    OmpComputeCompactStencils(src + srcDesc.offset, srcDesc, 3, dsts, dstDescs,
+                              *stencilTable, start, end);
+
+    return true;
+}
 
 /* static */
 bool
@@ -172,51 +265,10 @@ OmpEvaluator::EvalPatches(
     src += srcDesc.offset;
     if (dst) dst += dstDesc.offset;
     else return false;
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-
-#pragma omp parallel for
-    for (int i = 0; i < numPatchCoords; ++i) {
-        BufferAdapter<float> dstT(dst + dstDesc.stride*i, dstDesc.length, dstDesc.stride);
-
-        float wP[20], wDs[20], wDt[20];
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDs, wDt);
-            numControlVertices = 4;
-        } else {
-            continue;
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
-
-        dstT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-        }
-    }
-    return true;
+
+    return OmpEvalPatches(src, srcDesc, 1, &dst, &dstDesc,
+                          numPatchCoords, patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer);
 }
 
 /* static */
@@ -237,60 +289,12 @@ OmpEvaluator::EvalPatches(
     if (du)  du += duDesc.offset;
     if (dv)  dv += dvDesc.offset;
 
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-
-#pragma omp parallel for
-    for (int i = 0; i < numPatchCoords; ++i) {
-        float wP[20], wDu[20], wDv[20];
-        BufferAdapter<float> dstT(dst + dstDesc.stride*i, dstDesc.length, dstDesc.stride);
-        BufferAdapter<float> duT(du   + duDesc.stride*i, duDesc.length, duDesc.stride);
-        BufferAdapter<float> dvT(dv   + dvDesc.stride*i, dvDesc.length, dvDesc.stride);
-
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP, wDu, wDv);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP, wDu, wDv);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP, wDu, wDv);
-            numControlVertices = 4;
-        } else {
-            continue;
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
-
-        dstT.Clear();
-        duT.Clear();
-        dvT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            duT.AddWithWeight(srcT[cvs[j]], wDu[j]);
-            dvT.AddWithWeight(srcT[cvs[j]], wDv[j]);
-        }
-        ++dstT;
-        ++duT;
-        ++dvT;
-    }
-    return true;
+    float * dsts[3] = { dst, du, dv };
+    BufferDescriptor dstDescs[3] = { dstDesc, duDesc, dvDesc };
+
+    return OmpEvalPatches(src, srcDesc, 3, dsts, dstDescs,
+                          numPatchCoords, patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer);
 }
 
 /* static */
@@ -317,75 +321,13 @@ OmpEvaluator::EvalPatches(
     if (duv) duv += duvDesc.offset;
     if (dvv) dvv += dvvDesc.offset;
 
-    BufferAdapter<const float> srcT(src, srcDesc.length, srcDesc.stride);
-
-#pragma omp parallel for
-    for (int i = 0; i < numPatchCoords; ++i) {
-        float wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
-        BufferAdapter<float> dstT(dst + dstDesc.stride*i, dstDesc.length, dstDesc.stride);
-        BufferAdapter<float> duT(du   + duDesc.stride*i, duDesc.length, duDesc.stride);
-        BufferAdapter<float> dvT(dv   + dvDesc.stride*i, dvDesc.length, dvDesc.stride);
-        BufferAdapter<float> duuT(duu + duuDesc.stride*i, duuDesc.length, duuDesc.stride);
-        BufferAdapter<float> duvT(duv + duvDesc.stride*i, duvDesc.length, duvDesc.stride);
-        BufferAdapter<float> dvvT(dvv + dvvDesc.stride*i, dvvDesc.length, dvvDesc.stride);
-
-        PatchCoord const &coord = patchCoords[i];
-        PatchArray const &array = patchArrays[coord.handle.arrayIndex];
-
-        Far::PatchParam const & param =
-            patchParamBuffer[coord.handle.patchIndex];
-        int patchType = param.IsRegular()
-            ? Far::PatchDescriptor::REGULAR
-            : array.GetPatchType();
-
-        int numControlVertices = 0;
-        if (patchType == Far::PatchDescriptor::REGULAR) {
-            Far::internal::GetBSplineWeights(param,
-                                             coord.s, coord.t, wP,
-                                             wDu, wDv, wDuu, wDuv, wDvv);
-            numControlVertices = 16;
-        } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-            Far::internal::GetGregoryWeights(param,
-                                             coord.s, coord.t, wP,
-                                             wDu, wDv, wDuu, wDuv, wDvv);
-            numControlVertices = 20;
-        } else if (patchType == Far::PatchDescriptor::QUADS) {
-            Far::internal::GetBilinearWeights(param,
-                                              coord.s, coord.t, wP,
-                                              wDu, wDv, wDuu, wDuv, wDvv);
-            numControlVertices = 4;
-        } else {
-            continue;
-        }
-
-        int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-        int indexBase = array.GetIndexBase() + indexStride *
-                (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-        const int *cvs = &patchIndexBuffer[indexBase];
-
-        dstT.Clear();
-        duT.Clear();
-        dvT.Clear();
-        duuT.Clear();
-        duvT.Clear();
-        dvvT.Clear();
-        for (int j = 0; j < numControlVertices; ++j) {
-            dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            duT.AddWithWeight(srcT[cvs[j]], wDu[j]);
-            dvT.AddWithWeight(srcT[cvs[j]], wDv[j]);
-            duuT.AddWithWeight(srcT[cvs[j]], wDuu[j]);
-            duvT.AddWithWeight(srcT[cvs[j]], wDuv[j]);
-            dvvT.AddWithWeight(srcT[cvs[j]], wDvv[j]);
-        }
-        ++dstT;
-        ++duT;
-        ++dvT;
-        ++duuT;
-        ++duvT;
-        ++dvvT;
-    }
-    return true;
+    float * dsts[6] = { dst, du, dv, duu, duv, dvv };
+    BufferDescriptor dstDescs[6] = { dstDesc, duDesc, dvDesc,
+                                     duuDesc, duvDesc, dvvDesc };
+
+    return OmpEvalPatches(src, srcDesc, 6, dsts, dstDescs,
+                          numPatchCoords, patchCoords, patchArrays,
+                          patchIndexBuffer, patchParamBuffer);
 }
 
 
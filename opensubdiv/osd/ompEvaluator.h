@@ -27,9 +27,12 @@
 
 #include "../version.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/cpuCompactStencilTable.h"
 #include "../osd/types.h"
+#include "../far/stencilInverseTable.h"
 
 #include <cstddef>
+#include <vector>
 
 namespace OpenSubdiv {
 namespace OPENSUBDIV_VERSION {
@@ -60,7 +63,11 @@ public:
     ///
     /// @param dstDesc        vertex buffer descriptor for the output buffer
     ///
-    /// @param stencilTable   Far::StencilTable or equivalent
+    /// @param stencilTable   Far::StencilTable or equivalent (level-to-level
+    ///                       stencils are evaluated in one pass per level :
+    ///                       the destination buffer must then hold the
+    ///                       control vertices, right before dstDesc.offset,
+    ///                       as in the buffers of Osd::Mesh)
     ///
     /// @param instance       not used in the omp kernel
     ///                       (declared as a typed pointer to prevent
@@ -82,6 +89,33 @@ public:
         if (stencilTable->GetNumStencils() == 0)
             return false;
 
+        // Level-to-level stencils are evaluated one level after the other,
+        // each pass reading the control vertices and the vertices of the
+        // previous levels from the destination buffer.
+        std::vector<Far::Index> const & levelOffsets =
+            stencilTable->GetLevelOffsets();
+        if (! levelOffsets.empty()) {
+            std::vector<Far::Index> const & sourceOffsets =
+                stencilTable->GetLevelSourceOffsets();
+            float * dst = dstBuffer->BindCpuBuffer();
+            for (int i = 0; i+1 < (int)levelOffsets.size(); ++i) {
+                BufferDescriptor passSrcDesc = dstDesc,
+                                 passDstDesc = dstDesc;
+                passSrcDesc.offset += sourceOffsets[i] * dstDesc.stride;
+                passDstDesc.offset += levelOffsets[i] * dstDesc.stride;
+                if (! EvalStencils(dst, passSrcDesc, dst, passDstDesc,
+                                   &stencilTable->GetSizes()[0],
+                                   &stencilTable->GetOffsets()[0],
+                                   &stencilTable->GetControlIndices()[0],
+                                   &stencilTable->GetWeights()[0],
+                                   /*start = */ levelOffsets[i],
+                                   /*end   = */ levelOffsets[i+1])) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
         return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
                             dstBuffer->BindCpuBuffer(), dstDesc,
                             &stencilTable->GetSizes()[0],
@@ -415,6 +449,588 @@ public:
         const float * dvvWeights,
         int start, int end);
 
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Sparse stencil evaluations
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function which only re-evaluates
+    ///        the stencils affected by the edit of a set of control vertices.
+    ///        The other values of dstBuffer are left untouched, so that the
+    ///        cost is proportional to the edit rather than to the mesh.
+    ///
+    /// @param srcBuffer        Input primvar buffer.
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output primvar buffer, holding the results of
+    ///                         a previous evaluation of all the stencils.
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable     Far::StencilTable or equivalent
+    ///
+    /// @param inverseTable     Far::StencilInverseTable of the stencilTable
+    ///
+    /// @param numDirtyVertices number of edited control vertices
+    ///
+    /// @param dirtyVertices    indices of the edited control vertices
+    ///
+    /// @param instance         not used in the omp kernel
+    ///                         (declared as a typed pointer to prevent
+    ///                          undesirable template resolution)
+    ///
+    /// @param deviceContext    not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        Far::StencilInverseTable const *inverseTable,
+        int numDirtyVertices, Far::Index const *dirtyVertices,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        std::vector<Far::Index> stencilIndices;
+        inverseTable->GetAffectedStencils(
+            numDirtyVertices, dirtyVertices, stencilIndices);
+        if (stencilIndices.empty())
+            return true;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            (int)stencilIndices.size(), &stencilIndices[0]);
+    }
+
+    /// \brief Static eval stencils function which only evaluates a list of
+    ///        stencils, and takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally. The result of each
+    ///                       listed stencil is written at its index.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param numStencils    number of stencils to evaluate
+    ///
+    /// @param stencilIndices indices of the stencils to evaluate (sorted
+    ///                       lists are evaluated faster)
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int numStencils, const int * stencilIndices);
+
+    /// \brief Generic static eval stencils function with derivatives, which
+    ///        only re-evaluates the stencils affected by the edit of a set of
+    ///        control vertices.
+    ///
+    /// @param srcBuffer        Input primvar buffer.
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         const float pointer for read
+    ///
+    /// @param srcDesc          vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer        Output primvar buffer
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dstDesc          vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer         Output buffer derivative wrt u
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param duDesc           vertex buffer descriptor for the duBuffer
+    ///
+    /// @param dvBuffer         Output buffer derivative wrt v
+    ///                         must have BindCpuBuffer() method returning a
+    ///                         float pointer for write
+    ///
+    /// @param dvDesc           vertex buffer descriptor for the dvBuffer
+    ///
+    /// @param stencilTable     Far::LimitStencilTable or equivalent
+    ///
+    /// @param inverseTable     Far::StencilInverseTable of the stencilTable
+    ///
+    /// @param numDirtyVertices number of edited control vertices
+    ///
+    /// @param dirtyVertices    indices of the edited control vertices
+    ///
+    /// @param instance         not used in the omp kernel
+    ///                         (declared as a typed pointer to prevent
+    ///                          undesirable template resolution)
+    ///
+    /// @param deviceContext    not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        STENCIL_TABLE const *stencilTable,
+        Far::StencilInverseTable const *inverseTable,
+        int numDirtyVertices, Far::Index const *dirtyVertices,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        std::vector<Far::Index> stencilIndices;
+        inverseTable->GetAffectedStencils(
+            numDirtyVertices, dirtyVertices, stencilIndices);
+        if (stencilIndices.empty())
+            return true;
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            &stencilTable->GetDuWeights()[0],
+                            &stencilTable->GetDvWeights()[0],
+                            (int)stencilIndices.size(), &stencilIndices[0]);
+    }
+
+    /// \brief Static eval stencils function with derivatives which only
+    ///        evaluates a list of stencils, and takes raw CPU pointers for
+    ///        input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally. The result of each
+    ///                       listed stencil is written at its index.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output pointer derivative wrt u. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the duBuffer
+    ///
+    /// @param dv             Output pointer derivative wrt v. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the dvBuffer
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param duWeights      pointer to the du-weights buffer of the stencil table
+    ///
+    /// @param dvWeights      pointer to the dv-weights buffer of the stencil table
+    ///
+    /// @param numStencils    number of stencils to evaluate
+    ///
+    /// @param stencilIndices indices of the stencils to evaluate (sorted
+    ///                       lists are evaluated faster)
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        const float * duWeights,
+        const float * dvWeights,
+        int numStencils, const int * stencilIndices);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Stencil evaluations with CpuCompactStencilTable
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function for compact stencil
+    ///        tables, which are decoded on the fly.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable
+    ///
+    /// @param instance       not used in the omp kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        CpuCompactStencilTable const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function for compact stencil tables,
+    ///        which takes raw CPU pointers for input and output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        CpuCompactStencilTable const *stencilTable,
+        int start, int end);
+
+    /// \brief Generic static eval stencils function with derivatives for
+    ///        compact stencil tables, which are decoded on the fly.
+    ///
+    /// @param srcBuffer      Input primvar buffer.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dstBuffer      Output primvar buffer
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param duBuffer       Output buffer derivative wrt u
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param duDesc         vertex buffer descriptor for the duBuffer
+    ///
+    /// @param dvBuffer       Output buffer derivative wrt v
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the dvBuffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable created from a
+    ///                       Far::LimitStencilTable with derivatives
+    ///
+    /// @param instance       not used in the omp kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER>
+    static bool EvalStencils(
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        DST_BUFFER *duBuffer,  BufferDescriptor const &duDesc,
+        DST_BUFFER *dvBuffer,  BufferDescriptor const &dvDesc,
+        CpuCompactStencilTable const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        return EvalStencils(srcBuffer->BindCpuBuffer(), srcDesc,
+                            dstBuffer->BindCpuBuffer(), dstDesc,
+                            duBuffer->BindCpuBuffer(),  duDesc,
+                            dvBuffer->BindCpuBuffer(),  dvDesc,
+                            stencilTable,
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function with derivatives for compact
+    ///        stencil tables, which takes raw CPU pointers for input and
+    ///        output.
+    ///
+    /// @param src            Input primvar pointer. An offset of srcDesc
+    ///                       will be applied internally (i.e. the pointer
+    ///                       should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffer
+    ///
+    /// @param dst            Output primvar pointer. An offset of dstDesc
+    ///                       will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffer
+    ///
+    /// @param du             Output pointer derivative wrt u. An offset of
+    ///                       duDesc will be applied internally.
+    ///
+    /// @param duDesc         vertex buffer descriptor for the duBuffer
+    ///
+    /// @param dv             Output pointer derivative wrt v. An offset of
+    ///                       dvDesc will be applied internally.
+    ///
+    /// @param dvDesc         vertex buffer descriptor for the dvBuffer
+    ///
+    /// @param stencilTable   CpuCompactStencilTable created from a
+    ///                       Far::LimitStencilTable with derivatives
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        const float *src, BufferDescriptor const &srcDesc,
+        float *dst,       BufferDescriptor const &dstDesc,
+        float *du,        BufferDescriptor const &duDesc,
+        float *dv,        BufferDescriptor const &dvDesc,
+        CpuCompactStencilTable const *stencilTable,
+        int start, int end);
+
+    /// ----------------------------------------------------------------------
+    ///
+    ///   Multi-instance stencil evaluations
+    ///
+    /// ----------------------------------------------------------------------
+
+    /// \brief Generic static eval stencils function which applies a stencil
+    ///        table to several instances of the same topology (ex. a crowd).
+    ///        Each block of stencils is applied to all the instances while
+    ///        its weights are in cache, rather than streaming the table
+    ///        once per instance.
+    ///
+    /// @param numInstances   number of instances
+    ///
+    /// @param srcBuffers     Input primvar buffers of the instances.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       const float pointer for read
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffers
+    ///
+    /// @param dstBuffers     Output primvar buffers of the instances.
+    ///                       must have BindCpuBuffer() method returning a
+    ///                       float pointer for write
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffers
+    ///
+    /// @param stencilTable   Far::StencilTable or equivalent
+    ///
+    /// @param instance       not used in the omp kernel
+    ///                       (declared as a typed pointer to prevent
+    ///                        undesirable template resolution)
+    ///
+    /// @param deviceContext  not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        int numInstances,
+        SRC_BUFFER * const *srcBuffers, BufferDescriptor const &srcDesc,
+        DST_BUFFER * const *dstBuffers, BufferDescriptor const &dstDesc,
+        STENCIL_TABLE const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (numInstances <= 0) return true;
+
+        std::vector<const float *> src(numInstances);
+        std::vector<float *> dst(numInstances);
+        for (int i = 0; i < numInstances; ++i) {
+            src[i] = srcBuffers[i]->BindCpuBuffer();
+            dst[i] = dstBuffers[i]->BindCpuBuffer();
+        }
+
+        return EvalStencils(numInstances,
+                            &src[0], srcDesc,
+                            &dst[0], dstDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Generic static eval stencils function which applies a stencil
+    ///        table to several instances stored one after the other in a
+    ///        single buffer.
+    ///
+    /// @param numInstances       number of instances
+    ///
+    /// @param srcBuffer          Input primvar buffer of all the instances.
+    ///                           must have BindCpuBuffer() method returning a
+    ///                           const float pointer for read
+    ///
+    /// @param srcDesc            vertex buffer descriptor of the first
+    ///                           instance in the input buffer
+    ///
+    /// @param srcInstanceStride  number of floats between the primvars of
+    ///                           consecutive instances in the input buffer
+    ///
+    /// @param dstBuffer          Output primvar buffer of all the instances.
+    ///                           must have BindCpuBuffer() method returning a
+    ///                           float pointer for write
+    ///
+    /// @param dstDesc            vertex buffer descriptor of the first
+    ///                           instance in the output buffer
+    ///
+    /// @param dstInstanceStride  number of floats between the primvars of
+    ///                           consecutive instances in the output buffer
+    ///
+    /// @param stencilTable       Far::StencilTable or equivalent
+    ///
+    /// @param instance           not used in the omp kernel
+    ///                           (declared as a typed pointer to prevent
+    ///                            undesirable template resolution)
+    ///
+    /// @param deviceContext      not used in the omp kernel
+    ///
+    template <typename SRC_BUFFER, typename DST_BUFFER, typename STENCIL_TABLE>
+    static bool EvalStencils(
+        int numInstances,
+        SRC_BUFFER *srcBuffer, BufferDescriptor const &srcDesc,
+        int srcInstanceStride,
+        DST_BUFFER *dstBuffer, BufferDescriptor const &dstDesc,
+        int dstInstanceStride,
+        STENCIL_TABLE const *stencilTable,
+        const OmpEvaluator *instance = NULL,
+        void * deviceContext = NULL) {
+
+        (void)instance;       // unused
+        (void)deviceContext;  // unused
+
+        if (numInstances <= 0) return true;
+
+        const float * srcData = srcBuffer->BindCpuBuffer();
+        float * dstData = dstBuffer->BindCpuBuffer();
+
+        std::vector<const float *> src(numInstances);
+        std::vector<float *> dst(numInstances);
+        for (int i = 0; i < numInstances; ++i) {
+            src[i] = srcData + (size_t)i * srcInstanceStride;
+            dst[i] = dstData + (size_t)i * dstInstanceStride;
+        }
+
+        return EvalStencils(numInstances,
+                            &src[0], srcDesc,
+                            &dst[0], dstDesc,
+                            &stencilTable->GetSizes()[0],
+                            &stencilTable->GetOffsets()[0],
+                            &stencilTable->GetControlIndices()[0],
+                            &stencilTable->GetWeights()[0],
+                            /*start = */ 0,
+                            /*end   = */ stencilTable->GetNumStencils());
+    }
+
+    /// \brief Static eval stencils function which applies the stencils
+    ///        [start, end) to several instances, and takes raw CPU pointers
+    ///        for input and output.
+    ///
+    /// @param numInstances   number of instances
+    ///
+    /// @param src            Input primvar pointers of the instances. An
+    ///                       offset of srcDesc will be applied internally
+    ///                       (i.e. the pointers should not include the offset)
+    ///
+    /// @param srcDesc        vertex buffer descriptor for the input buffers
+    ///
+    /// @param dst            Output primvar pointers of the instances. An
+    ///                       offset of dstDesc will be applied internally.
+    ///
+    /// @param dstDesc        vertex buffer descriptor for the output buffers
+    ///
+    /// @param sizes          pointer to the sizes buffer of the stencil table
+    ///
+    /// @param offsets        pointer to the offsets buffer of the stencil table
+    ///
+    /// @param indices        pointer to the indices buffer of the stencil table
+    ///
+    /// @param weights        pointer to the weights buffer of the stencil table
+    ///
+    /// @param start          start index of stencil table
+    ///
+    /// @param end            end index of stencil table
+    ///
+    static bool EvalStencils(
+        int numInstances,
+        const float * const *src, BufferDescriptor const &srcDesc,
+        float * const *dst,       BufferDescriptor const &dstDesc,
+        const int * sizes,
+        const int * offsets,
+        const int * indices,
+        const float * weights,
+        int start, int end);
+
     /// ----------------------------------------------------------------------
     ///
     ///   Limit evaluations with PatchTable
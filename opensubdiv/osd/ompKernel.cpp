@@ -23,8 +23,12 @@
 //
 
 #include "../osd/ompKernel.h"
+#include "../osd/cpuKernel.h"
+#include "../osd/cpuCompactStencilTable.h"
 #include "../osd/bufferDescriptor.h"
+#include "../osd/types.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdlib>
 #include <omp.h>
@@ -35,43 +39,47 @@ namespace OPENSUBDIV_VERSION {
 
 namespace Osd {
 
-template <class T> T *
-elementAtIndex(T * src, int index, BufferDescriptor const &desc) {
+// Number of stencils evaluated by each task
+#define OMP_STENCIL_BLOCK_SIZE 256
 
-    return src + index * desc.stride;
-}
+// Number of patch coordinates evaluated by each task
+#define OMP_PATCH_COORD_BLOCK_SIZE 256
 
-static inline void
-clear(float *dst, BufferDescriptor const &desc) {
+static void
+ompComputeStencils(float const * src, BufferDescriptor const &srcDesc,
+                   int numWeightSets,
+                   float * const * dst, BufferDescriptor const * dstDesc,
+                   int const * sizes,
+                   int const * offsets,
+                   int const * indices,
+                   float const * const * weights,
+                   int start, int end) {
 
-    assert(dst);
-    memset(dst, 0, desc.length*sizeof(float));
-}
+    start = (start > 0 ? start : 0);
 
-static inline void
-addWithWeight(float *dst, const float *src, int srcIndex, float weight,
-              BufferDescriptor const &desc) {
+    int n = end - start;
+    int numBlocks = (n + OMP_STENCIL_BLOCK_SIZE - 1) / OMP_STENCIL_BLOCK_SIZE;
 
-    assert(src && dst);
-    src = elementAtIndex(src, srcIndex, desc);
-    for (int k = 0; k < desc.length; ++k) {
-        dst[k] += src[k] * weight;
-    }
-}
+    // The blocks are evaluated with the SIMD kernels of the Cpu evaluator,
+    // the results are written relative to 'start'.
+#pragma omp parallel for
+    for (int b = 0; b < numBlocks; ++b) {
 
-static inline void
-copy(float *dst, int dstIndex, const float *src,
-     BufferDescriptor const &desc) {
+        int blockStart = start + b * OMP_STENCIL_BLOCK_SIZE,
+            blockEnd = std::min(blockStart + OMP_STENCIL_BLOCK_SIZE, end);
 
-    assert(src && dst);
+        float * blockDst[6];
+        for (int w = 0; w < numWeightSets; ++w) {
+            blockDst[w] = dst[w]
+                ? dst[w] + (blockStart - start) * dstDesc[w].stride : 0;
+        }
 
-    dst = elementAtIndex(dst, dstIndex, desc);
-    memcpy(dst, src, desc.length*sizeof(float));
+        CpuComputeStencils(src, srcDesc, numWeightSets, blockDst, dstDesc,
+                           sizes, offsets, indices, weights,
+                           blockStart, blockEnd);
+    }
 }
 
-
-// XXXX manuelk this should be optimized further by using SIMD - considering
-//              OMP is somewhat obsolete - this is probably not worth it.
 void
 OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float * dst,       BufferDescriptor const &dstDesc,
@@ -80,38 +88,12 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 int const * indices,
                 float const * weights,
                 int start, int end) {
-    start = (start > 0 ? start : 0);
-    
+
     src += srcDesc.offset;
     dst += dstDesc.offset;
 
-    int numThreads = omp_get_max_threads();
-    int n = end - start;
-
-    float * result = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-
-#pragma omp parallel for
-    for (int i = 0; i < n; ++i) {
-
-        int index = i + start; // Stencil index
-
-        // Get thread-local pointers
-        int const           * threadIndices = indices + offsets[index];
-        float const         * threadWeights = weights + offsets[index];
-
-        int threadId = omp_get_thread_num();
-
-        float * threadResult = result + threadId*srcDesc.length;
-
-        clear(threadResult, dstDesc);
-
-        for (int j=0; j<(int)sizes[index]; ++j) {
-            addWithWeight(threadResult, src,
-                threadIndices[j], threadWeights[j], srcDesc);
-        }
-
-        copy(dst, i, threadResult, dstDesc);
-    }
+    ompComputeStencils(src, srcDesc, 1, &dst, &dstDesc,
+                       sizes, offsets, indices, &weights, start, end);
 }
 
 void
@@ -126,55 +108,15 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * duWeights,
                 float const * dvWeights,
                 int start, int end) {
-    start = (start > 0 ? start : 0);
 
-    src += srcDesc.offset;
-    dst += dstDesc.offset;
-    dstDu += dstDuDesc.offset;
-    dstDv += dstDvDesc.offset;
-
-    int numThreads = omp_get_max_threads();
-    int n = end - start;
-
-    float * result = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDu = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDv = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-
-#pragma omp parallel for
-    for (int i = 0; i < n; ++i) {
-
-        int index = i + start; // Stencil index
-
-        // Get thread-local pointers
-        int const           * threadIndices = indices + offsets[index];
-        float const         * threadWeights = weights + offsets[index];
-        float const         * threadWeightsDu = duWeights + offsets[index];
-        float const         * threadWeightsDv = dvWeights + offsets[index];
-
-        int threadId = omp_get_thread_num();
-
-        float * threadResult = result + threadId*srcDesc.length;
-        float * threadResultDu = resultDu + threadId*srcDesc.length;
-        float * threadResultDv = resultDv + threadId*srcDesc.length;
-
-        clear(threadResult, dstDesc);
-        clear(threadResultDu, dstDuDesc);
-        clear(threadResultDv, dstDvDesc);
-
-        for (int j=0; j<(int)sizes[index]; ++j) {
-            addWithWeight(threadResult, src,
-                threadIndices[j], threadWeights[j], srcDesc);
-            addWithWeight(threadResultDu, src,
-                threadIndices[j], threadWeightsDu[j], srcDesc);
-            addWithWeight(threadResultDv, src,
-                threadIndices[j], threadWeightsDv[j], srcDesc);
-        }
-
-        copy(dst, i, threadResult, dstDesc);
-        copy(dstDu, i, threadResultDu, dstDuDesc);
-        copy(dstDv, i, threadResultDv, dstDvDesc);
-    }
+    float * dsts[3] = { dst   ? dst   + dstDesc.offset   : 0,
+                        dstDu ? dstDu + dstDuDesc.offset : 0,
+                        dstDv ? dstDv + dstDvDesc.offset : 0 };
+    BufferDescriptor dstDescs[3] = { dstDesc, dstDuDesc, dstDvDesc };
+    float const * weightSets[3] = { weights, duWeights, dvWeights };
 
+    ompComputeStencils(src + srcDesc.offset, srcDesc, 3, dsts, dstDescs,
+                       sizes, offsets, indices, weightSets, start, end);
 }
 
 void
@@ -195,79 +137,163 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * duvWeights,
                 float const * dvvWeights,
                 int start, int end) {
+
+    float * dsts[6] = { dst    ? dst    + dstDesc.offset    : 0,
+                        dstDu  ? dstDu  + dstDuDesc.offset  : 0,
+                        dstDv  ? dstDv  + dstDvDesc.offset  : 0,
+                        dstDuu ? dstDuu + dstDuuDesc.offset : 0,
+                        dstDuv ? dstDuv + dstDuvDesc.offset : 0,
+                        dstDvv ? dstDvv + dstDvvDesc.offset : 0 };
+    BufferDescriptor dstDescs[6] = { dstDesc, dstDuDesc, dstDvDesc,
+                                     dstDuuDesc, dstDuvDesc, dstDvvDesc };
+    float const * weightSets[6] = { weights, duWeights, dvWeights,
+                                    duuWeights, duvWeights, dvvWeights };
+
+    ompComputeStencils(src + srcDesc.offset, srcDesc, 6, dsts, dstDescs,
+                       sizes, offsets, indices, weightSets, start, end);
+}
+
+void
+OmpComputeStencilList(float const * src, BufferDescriptor const &srcDesc,
+                      int numWeightSets,
+                      float * const * dst, BufferDescriptor const * dstDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * const * weights,
+                      int numStencils, int const * stencilIndices) {
+
+    int numBlocks = (numStencils + OMP_STENCIL_BLOCK_SIZE - 1) /
+                    OMP_STENCIL_BLOCK_SIZE;
+
+    // Small edits are evaluated by the calling thread
+#pragma omp parallel for if (numBlocks > 1)
+    for (int b = 0; b < numBlocks; ++b) {
+
+        int blockStart = b * OMP_STENCIL_BLOCK_SIZE,
+            blockEnd = std::min(blockStart + OMP_STENCIL_BLOCK_SIZE, numStencils);
+
+        CpuComputeStencilList(src, srcDesc, numWeightSets, dst, dstDesc,
+                              sizes, offsets, indices, weights,
+                              blockEnd - blockStart,
+                              stencilIndices + blockStart);
+    }
+}
+
+void
+OmpComputeStencilInstances(int numInstances,
+                           float const * const * src,
+                           BufferDescriptor const &srcDesc,
+                           float * const * dst,
+                           BufferDescriptor const &dstDesc,
+                           int const * sizes,
+                           int const * offsets,
+                           int const * indices,
+                           float const * weights,
+                           int start, int end) {
+
     start = (start > 0 ? start : 0);
+    if (end <= start || numInstances <= 0) return;
+
+    BufferDescriptor wideSrcDesc, wideDstDesc;
+    if (CpuGetInterleavedInstances(numInstances, src, srcDesc, &wideSrcDesc) &&
+        CpuGetInterleavedInstances(numInstances, dst, dstDesc, &wideDstDesc)) {
+        OmpEvalStencils(src[0], wideSrcDesc, dst[0], wideDstDesc,
+                        sizes, offsets, indices, weights, start, end);
+        return;
+    }
 
-    src += srcDesc.offset;
-    dst += dstDesc.offset;
-    dstDu += dstDuDesc.offset;
-    dstDv += dstDvDesc.offset;
-    dstDuu += dstDuuDesc.offset;
-    dstDuv += dstDuvDesc.offset;
-    dstDvv += dstDvvDesc.offset;
+    int numBlocks = (end - start + OMP_STENCIL_BLOCK_SIZE - 1) /
+                    OMP_STENCIL_BLOCK_SIZE;
+    int numTasks = numBlocks * numInstances;
 
-    int numThreads = omp_get_max_threads();
-    int n = end - start;
+    // The tasks of a block are consecutive, so that the static schedule
+    // gives each thread all (or most of) the instances of its blocks.
+#pragma omp parallel for schedule(static)
+    for (int t = 0; t < numTasks; ++t) {
+
+        int b = t / numInstances,
+            i = t - b * numInstances;
+
+        int blockStart = start + b * OMP_STENCIL_BLOCK_SIZE,
+            blockEnd = std::min(blockStart + OMP_STENCIL_BLOCK_SIZE, end);
+
+        float * blockDst = dst[i] + dstDesc.offset +
+                           (blockStart - start) * dstDesc.stride;
 
-    float * result = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDu = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDv = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDuu = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDuv = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
-    float * resultDvv = (float*)alloca(srcDesc.length * numThreads * sizeof(float));
+        CpuComputeStencils(src[i] + srcDesc.offset, srcDesc, 1,
+                           &blockDst, &dstDesc,
+                           sizes, offsets, indices, &weights,
+                           blockStart, blockEnd);
+    }
+}
+
+void
+OmpComputeCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                          int numWeightSets,
+                          float * const * dst, BufferDescriptor const * dstDesc,
+                          CpuCompactStencilTable const & stencilTable,
+                          int start, int end) {
+
+    start = (start > 0 ? start : 0);
+    if (end <= start) return;
+
+    // The tasks are aligned on the blocks of the table, so that each block
+    // is decoded once.
+    int firstTask = start / OMP_STENCIL_BLOCK_SIZE,
+        lastTask = (end - 1) / OMP_STENCIL_BLOCK_SIZE;
 
 #pragma omp parallel for
-    for (int i = 0; i < n; ++i) {
-
-        int index = i + start; // Stencil index
-
-        // Get thread-local pointers
-        int const           * threadIndices = indices + offsets[index];
-        float const         * threadWeights = weights + offsets[index];
-        float const         * threadWeightsDu = duWeights + offsets[index];
-        float const         * threadWeightsDv = dvWeights + offsets[index];
-        float const         * threadWeightsDuu = duuWeights + offsets[index];
-        float const         * threadWeightsDuv = duvWeights + offsets[index];
-        float const         * threadWeightsDvv = dvvWeights + offsets[index];
-
-        int threadId = omp_get_thread_num();
-
-        float * threadResult = result + threadId*srcDesc.length;
-        float * threadResultDu = resultDu + threadId*srcDesc.length;
-        float * threadResultDv = resultDv + threadId*srcDesc.length;
-        float * threadResultDuu = resultDuu + threadId*srcDesc.length;
-        float * threadResultDuv = resultDuv + threadId*srcDesc.length;
-        float * threadResultDvv = resultDvv + threadId*srcDesc.length;
-
-        clear(threadResult, dstDesc);
-        clear(threadResultDu, dstDuDesc);
-        clear(threadResultDv, dstDvDesc);
-        clear(threadResultDuu, dstDuuDesc);
-        clear(threadResultDuv, dstDuvDesc);
-        clear(threadResultDvv, dstDvvDesc);
-
-        for (int j=0; j<(int)sizes[index]; ++j) {
-            addWithWeight(threadResult, src,
-                threadIndices[j], threadWeights[j], srcDesc);
-            addWithWeight(threadResultDu, src,
-                threadIndices[j], threadWeightsDu[j], srcDesc);
-            addWithWeight(threadResultDv, src,
-                threadIndices[j], threadWeightsDv[j], srcDesc);
-            addWithWeight(threadResultDuu, src,
-                threadIndices[j], threadWeightsDuu[j], srcDesc);
-            addWithWeight(threadResultDuv, src,
-                threadIndices[j], threadWeightsDuv[j], srcDesc);
-            addWithWeight(threadResultDvv, src,
-                threadIndices[j], threadWeightsDvv[j], srcDesc);
+    for (int t = firstTask; t <= lastTask; ++t) {
+
+        int taskStart = std::max(start, t * OMP_STENCIL_BLOCK_SIZE),
+            taskEnd = std::min(end, (t + 1) * OMP_STENCIL_BLOCK_SIZE);
+
+        float * taskDst[6];
+        for (int w = 0; w < numWeightSets; ++w) {
+            taskDst[w] = dst[w]
+                ? dst[w] + (taskStart - start) * dstDesc[w].stride : 0;
         }
 
-        copy(dst, i, threadResult, dstDesc);
-        copy(dstDu, i, threadResultDu, dstDuDesc);
-        copy(dstDv, i, threadResultDv, dstDvDesc);
-        copy(dstDuu, i, threadResultDuu, dstDuuDesc);
-        copy(dstDuv, i, threadResultDuv, dstDuvDesc);
-        copy(dstDvv, i, threadResultDvv, dstDvvDesc);
+        CpuComputeCompactStencils(src, srcDesc, numWeightSets, taskDst,
+                                  dstDesc, stencilTable, taskStart, taskEnd);
     }
+}
 
+bool
+OmpEvalPatches(float const * src, BufferDescriptor const &srcDesc,
+               int numWeightSets,
+               float * const * dst, BufferDescriptor const * dstDesc,
+               int numPatchCoords,
+               PatchCoord const * patchCoords,
+               PatchArray const * patchArrays,
+               int const * patchIndexBuffer,
+               PatchParam const * patchParamBuffer) {
+
+    int numBlocks = (numPatchCoords + OMP_PATCH_COORD_BLOCK_SIZE - 1) /
+                    OMP_PATCH_COORD_BLOCK_SIZE;
+
+    int numFailures = 0;
+
+#pragma omp parallel for reduction(+:numFailures)
+    for (int b = 0; b < numBlocks; ++b) {
+
+        int blockStart = b * OMP_PATCH_COORD_BLOCK_SIZE,
+            blockEnd = std::min(numPatchCoords,
+                                blockStart + OMP_PATCH_COORD_BLOCK_SIZE);
+
+        float * blockDst[6];
+        for (int w = 0; w < numWeightSets; ++w) {
+            blockDst[w] = dst[w] ? dst[w] + blockStart * dstDesc[w].stride : 0;
+        }
+
+        if (! CpuEvalPatches(src, srcDesc, numWeightSets, blockDst, dstDesc,
+                             blockEnd - blockStart, patchCoords + blockStart,
+                             patchArrays, patchIndexBuffer, patchParamBuffer)) {
+            ++numFailures;
+        }
+    }
+    return numFailures == 0;
 }
 
 }  // end namespace Osd
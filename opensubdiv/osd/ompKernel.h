@@ -33,6 +33,10 @@ namespace OPENSUBDIV_VERSION {
 namespace Osd {
 
 struct BufferDescriptor;
+struct PatchArray;
+struct PatchCoord;
+struct PatchParam;
+class CpuCompactStencilTable;
 
 void
 OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
@@ -75,6 +79,54 @@ OmpEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * dvvWeights,
                 int start, int end);
 
+/// \brief Evaluates the stencils listed in 'stencilIndices' concurrently
+///        (see CpuComputeStencilList)
+void
+OmpComputeStencilList(float const * src, BufferDescriptor const &srcDesc,
+                      int numWeightSets,
+                      float * const * dst, BufferDescriptor const * dstDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * const * weights,
+                      int numStencils, int const * stencilIndices);
+
+/// \brief Evaluates the stencils [start, end) for several instances
+///        concurrently over stencils and instances
+///        (see CpuComputeStencilInstances)
+void
+OmpComputeStencilInstances(int numInstances,
+                           float const * const * src,
+                           BufferDescriptor const &srcDesc,
+                           float * const * dst,
+                           BufferDescriptor const &dstDesc,
+                           int const * sizes,
+                           int const * offsets,
+                           int const * indices,
+                           float const * weights,
+                           int start, int end);
+
+/// \brief Evaluates the stencils [start, end) of a compact stencil table
+///        concurrently (see CpuComputeCompactStencils)
+void
+OmpComputeCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                          int numWeightSets,
+                          float * const * dst, BufferDescriptor const * dstDesc,
+                          CpuCompactStencilTable const & stencilTable,
+                          int start, int end);
+
+/// \brief Evaluates the limit (and optionally its derivatives) at a list of
+///        patch coordinates concurrently (see CpuEvalPatches)
+bool
+OmpEvalPatches(float const * src, BufferDescriptor const &srcDesc,
+               int numWeightSets,
+               float * const * dst, BufferDescriptor const * dstDesc,
+               int numPatchCoords,
+               PatchCoord const * patchCoords,
+               PatchArray const * patchArrays,
+               int const * patchIndexBuffer,
+               PatchParam const * patchParamBuffer);
+
 } // end namespace Osd
 
 }  // end namespace OPENSUBDIV_VERSION
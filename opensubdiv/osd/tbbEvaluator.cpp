@@ -129,6 +129,130 @@ TbbEvaluator::EvalStencils(
     return true;
 }
 
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    int numStencils, const int * stencilIndices) {
+
+    if (numStencils <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    dst += dstDesc.offset;
+
+    TbbComputeStencilList(src + srcDesc.offset, srcDesc, 1, &dst, &dstDesc,
+                          sizes, offsets, indices, &weights,
+                          numStencils, stencilIndices);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    const int * sizes,
+    const int * offsets,
+    const int * indices,
+    const float * weights,
+    const float * duWeights,
+    const float * dvWeights,
+    int numStencils, const int * stencilIndices) {
+
+    if (numStencils <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+
+    float * dsts[3] = { dst ? dst + dstDesc.offset : 0,
+                        du  ? du  + duDesc.offset  : 0,
+                        dv  ? dv  + dvDesc.offset  : 0 };
+    BufferDescriptor dstDescs[3] = { dstDesc, duDesc, dvDesc };
+    float const * weightSets[3] = { weights, duWeights, dvWeights };
+
+    TbbComputeStencilList(src + srcDesc.offset, srcDesc, 3, dsts, dstDescs,
+                          sizes, offsets, indices, weightSets,
+                          numStencils, stencilIndices);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(int numInstances,
+                           const float * const *src,
+                           BufferDescriptor const &srcDesc,
+                           float * const *dst,
+                           BufferDescriptor const &dstDesc,
+                           const int * sizes,
+                           const int * offsets,
+                           const int * indices,
+                           const float * weights,
+                           int start, int end) {
+
+    if (end <= start || numInstances <= 0) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    TbbComputeStencilInstances(numInstances, src, srcDesc, dst, dstDesc,
+                               sizes, offsets, indices, weights, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+
+    dst += dstDesc.offset;
+
+    TbbComputeCompactStencils(src + srcDesc.offset, srcDesc, 1, &dst, &dstDesc,
+                              *stencilTable, start, end);
+
+    return true;
+}
+
+/* static */
+bool
+TbbEvaluator::EvalStencils(
+    const float *src, BufferDescriptor const &srcDesc,
+    float *dst,       BufferDescriptor const &dstDesc,
+    float *du,        BufferDescriptor const &duDesc,
+    float *dv,        BufferDescriptor const &dvDesc,
+    CpuCompactStencilTable const *stencilTable,
+    int start, int end) {
+
+    if (end <= start) return true;
+    if (srcDesc.length != dstDesc.length) return false;
+    if (srcDesc.length != duDesc.length) return false;
+    if (srcDesc.length != dvDesc.length) return false;
+    if (stencilTable->GetNumWeightSets() < 3) return false;
+
+    float * dsts[3] = { dst ? dst + dstDesc.offset : 0,
+                        du  ? du  + duDesc.offset  : 0,
+                        dv  ? dv  + dvDesc.offset  : 0 };
+    BufferDescriptor dstDescs[3] = { dstDesc, duDesc, dvDesc };
+
+    TbbComputeCompactStencils(src + srcDesc.offset, srcDesc, 3, dsts, dstDescs,
+                              *stencilTable, start, end);
+
+    return true;
+}
+
 /* static */
 bool
 TbbEvaluator::EvalPatches(
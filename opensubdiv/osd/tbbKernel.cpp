@@ -23,13 +23,14 @@
 //
 
 #include "../osd/cpuKernel.h"
+#include "../osd/cpuCompactStencilTable.h"
 #include "../osd/tbbKernel.h"
 #include "../osd/types.h"
 #include "../osd/bufferDescriptor.h"
-#include "../far/patchBasis.h"
 
 #include <cassert>
 #include <cstdlib>
+#include <tbb/blocked_range2d.h>
 #include <tbb/parallel_for.h>
 
 namespace OpenSubdiv {
@@ -39,124 +40,64 @@ namespace Osd {
 
 #define grain_size  200
 
-template <class T> T *
-elementAtIndex(T * src, int index, BufferDescriptor const &desc) {
-
-    return src + index * desc.stride;
-}
-
-static inline void
-clear(float *dst, BufferDescriptor const &desc) {
-
-    assert(dst);
-    memset(dst, 0, desc.length*sizeof(float));
-}
-
-static inline void
-addWithWeight(float *dst, const float *src, int srcIndex, float weight,
-              BufferDescriptor const &desc) {
-
-    assert(src && dst);
-    src = elementAtIndex(src, srcIndex, desc);
-    for (int k = 0; k < desc.length; ++k) {
-        dst[k] += src[k] * weight;
-    }
-}
-
-static inline void
-copy(float *dst, int dstIndex, const float *src,
-     BufferDescriptor const &desc) {
-
-    assert(src && dst);
-
-    dst = elementAtIndex(dst, dstIndex, desc);
-    memcpy(dst, src, desc.length*sizeof(float));
-}
-
-
 class TBBStencilKernel {
 
     BufferDescriptor _srcDesc;
-    BufferDescriptor _dstDesc;
+    BufferDescriptor _dstDesc[6];
     float const * _vertexSrc;
-    float * _vertexDst;
+    float * _vertexDst[6];
 
+    int _numWeightSets;
     int const * _sizes;
     int const * _offsets,
               * _indices;
-    float const * _weights;
-
+    float const * _weights[6];
+    int const * _stencilIndices;
 
 public:
     TBBStencilKernel(float const *src, BufferDescriptor srcDesc,
-                     float *dst,       BufferDescriptor dstDesc,
+                     int numWeightSets,
+                     float * const * dst, BufferDescriptor const * dstDesc,
                      int const * sizes, int const * offsets,
-                     int const * indices, float const * weights) :
+                     int const * indices, float const * const * weights,
+                     int const * stencilIndices = 0) :
          _srcDesc(srcDesc),
-         _dstDesc(dstDesc),
          _vertexSrc(src),
-         _vertexDst(dst),
+         _numWeightSets(numWeightSets),
          _sizes(sizes),
          _offsets(offsets),
          _indices(indices),
-         _weights(weights) { }
-
-    TBBStencilKernel(TBBStencilKernel const & other) {
-        _srcDesc    = other._srcDesc;
-        _dstDesc    = other._dstDesc;
-        _sizes      = other._sizes;
-        _offsets    = other._offsets;
-        _indices    = other._indices;
-        _weights    = other._weights;
-        _vertexSrc  = other._vertexSrc;
-        _vertexDst  = other._vertexDst;
+         _stencilIndices(stencilIndices) {
+
+        for (int w = 0; w < numWeightSets; ++w) {
+            _dstDesc[w] = dstDesc[w];
+            _vertexDst[w] = dst[w];
+            _weights[w] = weights[w];
+        }
     }
 
     void operator() (tbb::blocked_range<int> const &r) const {
-#define USE_SIMD
-#ifdef USE_SIMD
-        if (_srcDesc.length==4 && _srcDesc.stride==4 && _dstDesc.stride==4) {
-
-            // SIMD fast path for aligned primvar data (4 floats)
-            int offset = _offsets[r.begin()];
-            ComputeStencilKernel<4>(_vertexSrc, _vertexDst,
-                _sizes, _indices+offset, _weights+offset, r.begin(), r.end());
-
-        } else if (_srcDesc.length==8 && _srcDesc.stride==4 && _dstDesc.stride==4) {
 
-            // SIMD fast path for aligned primvar data (8 floats)
-            int offset = _offsets[r.begin()];
-            ComputeStencilKernel<8>(_vertexSrc, _vertexDst,
-                _sizes, _indices+offset, _weights+offset, r.begin(), r.end());
-
-        } else {
-#else
-        {
-#endif
-            int const * sizes = _sizes;
-            int const * indices = _indices;
-            float const * weights = _weights;
-
-            if (r.begin()>0) {
-                sizes += r.begin();
-                indices += _offsets[r.begin()];
-                weights += _offsets[r.begin()];
-            }
-
-            // Slow path for non-aligned data
-            float * result = (float*)alloca(_srcDesc.length * sizeof(float));
-
-            for (int i=r.begin(); i<r.end(); ++i, ++sizes) {
-
-                clear(result, _dstDesc);
-
-                for (int j=0; j<*sizes; ++j) {
-                    addWithWeight(result, _vertexSrc, *indices++, *weights++, _srcDesc);
-                }
+        // Lists of stencils are written at the index of each stencil
+        if (_stencilIndices) {
+            CpuComputeStencilList(_vertexSrc, _srcDesc, _numWeightSets,
+                                  _vertexDst, _dstDesc, _sizes, _offsets,
+                                  _indices, _weights, r.end() - r.begin(),
+                                  _stencilIndices + r.begin());
+            return;
+        }
 
-                copy(_vertexDst, i, result, _dstDesc);
-            }
+        // The SIMD kernels of the Cpu evaluator write the results relative
+        // to the beginning of the range.
+        float * dst[6];
+        for (int w = 0; w < _numWeightSets; ++w) {
+            dst[w] = _vertexDst[w]
+                ? _vertexDst[w] + r.begin() * _dstDesc[w].stride : 0;
         }
+
+        CpuComputeStencils(_vertexSrc, _srcDesc, _numWeightSets,
+                           dst, _dstDesc, _sizes, _offsets, _indices,
+                           _weights, r.begin(), r.end());
     }
 };
 
@@ -172,8 +113,8 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     src += srcDesc.offset;
     dst += dstDesc.offset;
 
-    TBBStencilKernel kernel(src, srcDesc, dst, dstDesc,
-                            sizes, offsets, indices, weights);
+    TBBStencilKernel kernel(src, srcDesc, 1, &dst, &dstDesc,
+                            sizes, offsets, indices, &weights);
 
     tbb::blocked_range<int> range(start, end, grain_size);
 
@@ -198,28 +139,15 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     if (du)  du  += duDesc.offset;
     if (dv)  dv  += dvDesc.offset;
 
-    // PERFORMANCE: need to combine 3 launches together
-    if (dst) {
-        TBBStencilKernel kernel(src, srcDesc, dst, dstDesc,
-                                sizes, offsets, indices, weights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
-
-    if (du) {
-        TBBStencilKernel kernel(src, srcDesc, du, duDesc,
-                                sizes, offsets, indices, duWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
-
-    if (dv) {
-        TBBStencilKernel kernel(src, srcDesc, dv, dvDesc,
-                                sizes, offsets, indices, dvWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
+    // all the weight sets are evaluated in a single launch
+    float * dsts[3] = { dst, du, dv };
+    BufferDescriptor dstDescs[3] = { dstDesc, duDesc, dvDesc };
+    float const * weightSets[3] = { weights, duWeights, dvWeights };
 
+    TBBStencilKernel kernel(src, srcDesc, 3, dsts, dstDescs,
+                            sizes, offsets, indices, weightSets);
+    tbb::blocked_range<int> range(start, end, grain_size);
+    tbb::parallel_for(range, kernel);
 }
 
 void
@@ -249,97 +177,29 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
     if (duv) duv += duvDesc.offset;
     if (dvv) dvv += dvvDesc.offset;
 
-    // PERFORMANCE: need to combine 3 launches together
-    if (dst) {
-        TBBStencilKernel kernel(src, srcDesc, dst, dstDesc,
-                                sizes, offsets, indices, weights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
-
-    if (du) {
-        TBBStencilKernel kernel(src, srcDesc, du, duDesc,
-                                sizes, offsets, indices, duWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
-
-    if (dv) {
-        TBBStencilKernel kernel(src, srcDesc, dv, dvDesc,
-                                sizes, offsets, indices, dvWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
-
-    if (duu) {
-        TBBStencilKernel kernel(src, srcDesc, duu, duuDesc,
-                                sizes, offsets, indices, duuWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
-
-    if (duv) {
-        TBBStencilKernel kernel(src, srcDesc, duv, duvDesc,
-                                sizes, offsets, indices, duvWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
+    // all the weight sets are evaluated in a single launch
+    float * dsts[6] = { dst, du, dv, duu, duv, dvv };
+    BufferDescriptor dstDescs[6] = { dstDesc, duDesc, dvDesc,
+                                     duuDesc, duvDesc, dvvDesc };
+    float const * weightSets[6] = { weights, duWeights, dvWeights,
+                                    duuWeights, duvWeights, dvvWeights };
 
-    if (dvv) {
-        TBBStencilKernel kernel(src, srcDesc, dvv, dvvDesc,
-                                sizes, offsets, indices, dvvWeights);
-        tbb::blocked_range<int> range(start, end, grain_size);
-        tbb::parallel_for(range, kernel);
-    }
+    TBBStencilKernel kernel(src, srcDesc, 6, dsts, dstDescs,
+                            sizes, offsets, indices, weightSets);
+    tbb::blocked_range<int> range(start, end, grain_size);
+    tbb::parallel_for(range, kernel);
 }
 
 // ---------------------------------------------------------------------------
 
-template <typename T>
-struct BufferAdapter {
-    BufferAdapter(T *p, int length, int stride) :
-        _p(p), _length(length), _stride(stride) { }
-    void Clear() {
-        for (int i = 0; i < _length; ++i) _p[i] = 0;
-    }
-    void AddWithWeight(T const *src, float w) {
-        if (_p) {
-            for (int i = 0; i < _length; ++i) {
-                _p[i] += src[i] * w;
-            }
-        }
-    }
-    const T *operator[] (int index) const {
-        return _p + _stride * index;
-    }
-    BufferAdapter<T> & operator ++() {
-        if (_p) {
-            _p += _stride;
-        }
-        return *this;
-    }
-
-    T *_p;
-    int _length;
-    int _stride;
-};
-
+// The coordinates of each range are evaluated by the batched kernel of the
+// Cpu evaluator
 class TbbEvalPatchesKernel {
-    BufferDescriptor _srcDesc;
-    BufferDescriptor _dstDesc;
-    BufferDescriptor _dstDuDesc;
-    BufferDescriptor _dstDvDesc;
-    BufferDescriptor _dstDuuDesc;
-    BufferDescriptor _dstDuvDesc;
-    BufferDescriptor _dstDvvDesc;
     float const * _src;
-    float * _dst;
-    float * _dstDu;
-    float * _dstDv;
-    float * _dstDuu;
-    float * _dstDuv;
-    float * _dstDvv;
-    int _numPatchCoords;
+    BufferDescriptor _srcDesc;
+    int _numWeightSets;
+    float * _dst[6];
+    BufferDescriptor _dstDesc[6];
     const PatchCoord *_patchCoords;
     const PatchArray *_patchArrayBuffer;
     const int        *_patchIndexBuffer;
@@ -353,247 +213,203 @@ public:
                          float *dstDuu,    BufferDescriptor dstDuuDesc,
                          float *dstDuv,    BufferDescriptor dstDuvDesc,
                          float *dstDvv,    BufferDescriptor dstDvvDesc,
-                         int numPatchCoords,
+                         int /* numPatchCoords */,
                          const PatchCoord *patchCoords,
                          const PatchArray *patchArrayBuffer,
                          const int *patchIndexBuffer,
                          const PatchParam *patchParamBuffer) :
-        _srcDesc(srcDesc), _dstDesc(dstDesc),
-        _dstDuDesc(dstDuDesc), _dstDvDesc(dstDvDesc),
-        _dstDuuDesc(dstDuuDesc), _dstDuvDesc(dstDuvDesc), _dstDvvDesc(dstDvvDesc),
-        _src(src), _dst(dst),
-        _dstDu(dstDu), _dstDv(dstDv),
-        _dstDuu(dstDuu), _dstDuv(dstDuv), _dstDvv(dstDvv),
-        _numPatchCoords(numPatchCoords),
+        _src(src + srcDesc.offset), _srcDesc(srcDesc),
         _patchCoords(patchCoords),
         _patchArrayBuffer(patchArrayBuffer),
         _patchIndexBuffer(patchIndexBuffer),
         _patchParamBuffer(patchParamBuffer) {
-    }
 
-    void operator() (tbb::blocked_range<int> const &r) const {
-        if (_dstDu == NULL && _dstDv == NULL) {
-            compute(r);
-        } else if (_dstDuu == NULL && _dstDuv == NULL && _dstDvv == NULL) {
-            computeWith1stDerivative(r);
+        if (dstDu == NULL && dstDv == NULL) {
+            _numWeightSets = 1;
+        } else if (dstDuu == NULL && dstDuv == NULL && dstDvv == NULL) {
+            _numWeightSets = 3;
         } else {
-            computeWith2ndDerivative(r);
+            _numWeightSets = 6;
+        }
+
+        float * dsts[6] = { dst, dstDu, dstDv, dstDuu, dstDuv, dstDvv };
+        BufferDescriptor dstDescs[6] = { dstDesc, dstDuDesc, dstDvDesc,
+                                         dstDuuDesc, dstDuvDesc, dstDvvDesc };
+        for (int w = 0; w < 6; ++w) {
+            _dst[w] = dsts[w] ? dsts[w] + dstDescs[w].offset : NULL;
+            _dstDesc[w] = dstDescs[w];
         }
     }
 
-    void compute(tbb::blocked_range<int> const &r) const {
-        float wP[20], wDu[20], wDv[20];
-        BufferAdapter<const float> srcT(_src + _srcDesc.offset,
-                                        _srcDesc.length,
-                                        _srcDesc.stride);
-        BufferAdapter<float> dstT(_dst + _dstDesc.offset
-                                       + r.begin() * _dstDesc.stride,
-                                  _dstDesc.length,
-                                  _dstDesc.stride);
-
-
-        for (int i = r.begin(); i < r.end(); ++i) {
-            PatchCoord const &coord = _patchCoords[i];
-            PatchArray const &array = _patchArrayBuffer[coord.handle.arrayIndex];
-
-            Far::PatchParam const & param =
-                _patchParamBuffer[coord.handle.patchIndex];
-            int patchType = param.IsRegular()
-                ? Far::PatchDescriptor::REGULAR
-                : array.GetPatchType();
-
-            int numControlVertices = 0;
-            if (patchType == Far::PatchDescriptor::REGULAR) {
-                Far::internal::GetBSplineWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv);
-                numControlVertices = 16;
-            } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-                Far::internal::GetGregoryWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv);
-                numControlVertices = 20;
-            } else if (patchType == Far::PatchDescriptor::QUADS) {
-                Far::internal::GetBilinearWeights(param,
-                                                  coord.s, coord.t, wP,
-                                                  wDu, wDv);
-                numControlVertices = 4;
-            } else {
-                assert(0);
-            }
-
-            int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-            int indexBase = array.GetIndexBase() + indexStride *
-                    (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-            const int *cvs = &_patchIndexBuffer[indexBase];
-
-            dstT.Clear();
-            for (int j = 0; j < numControlVertices; ++j) {
-                dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-            }
-            ++dstT;
+    void operator() (tbb::blocked_range<int> const &r) const {
+        float * dst[6];
+        for (int w = 0; w < _numWeightSets; ++w) {
+            dst[w] = _dst[w] ? _dst[w] + r.begin() * _dstDesc[w].stride : NULL;
         }
+
+        bool supported = CpuEvalPatches(_src, _srcDesc, _numWeightSets,
+                                        dst, _dstDesc,
+                                        r.end() - r.begin(),
+                                        _patchCoords + r.begin(),
+                                        _patchArrayBuffer,
+                                        _patchIndexBuffer,
+                                        _patchParamBuffer);
+        assert(supported);
+        (void)supported;
+    }
+};
+
+
+void
+TbbComputeStencilList(float const * src, BufferDescriptor const &srcDesc,
+                      int numWeightSets,
+                      float * const * dst, BufferDescriptor const * dstDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * const * weights,
+                      int numStencils, int const * stencilIndices) {
+
+    TBBStencilKernel kernel(src, srcDesc, numWeightSets, dst, dstDesc,
+                            sizes, offsets, indices, weights, stencilIndices);
+
+    tbb::blocked_range<int> range(0, numStencils, grain_size);
+
+    tbb::parallel_for(range, kernel);
+}
+
+class TBBStencilInstancesKernel {
+
+    BufferDescriptor _srcDesc;
+    BufferDescriptor _dstDesc;
+    float const * const * _vertexSrc;
+    float * const * _vertexDst;
+
+    int const * _sizes;
+    int const * _offsets,
+              * _indices;
+    float const * _weights;
+    int _start;
+
+public:
+    TBBStencilInstancesKernel(float const * const * src,
+                              BufferDescriptor srcDesc,
+                              float * const * dst,
+                              BufferDescriptor dstDesc,
+                              int const * sizes, int const * offsets,
+                              int const * indices, float const * weights,
+                              int start) :
+         _srcDesc(srcDesc),
+         _dstDesc(dstDesc),
+         _vertexSrc(src),
+         _vertexDst(dst),
+         _sizes(sizes),
+         _offsets(offsets),
+         _indices(indices),
+         _weights(weights),
+         _start(start) { }
+
+    // rows are instances and columns are stencils
+    void operator() (tbb::blocked_range2d<int> const &r) const {
+
+        BufferDescriptor dstDesc(_dstDesc);
+        dstDesc.offset += (r.cols().begin() - _start) * dstDesc.stride;
+
+        CpuComputeStencilInstances((int)r.rows().size(),
+                                   _vertexSrc + r.rows().begin(), _srcDesc,
+                                   _vertexDst + r.rows().begin(), dstDesc,
+                                   _sizes, _offsets, _indices, _weights,
+                                   r.cols().begin(), r.cols().end());
+    }
+};
+
+void
+TbbComputeStencilInstances(int numInstances,
+                           float const * const * src,
+                           BufferDescriptor const &srcDesc,
+                           float * const * dst,
+                           BufferDescriptor const &dstDesc,
+                           int const * sizes,
+                           int const * offsets,
+                           int const * indices,
+                           float const * weights,
+                           int start, int end) {
+
+    start = (start > 0 ? start : 0);
+    if (end <= start || numInstances <= 0) return;
+
+    BufferDescriptor wideSrcDesc, wideDstDesc;
+    if (CpuGetInterleavedInstances(numInstances, src, srcDesc, &wideSrcDesc) &&
+        CpuGetInterleavedInstances(numInstances, dst, dstDesc, &wideDstDesc)) {
+        TbbEvalStencils(src[0], wideSrcDesc, dst[0], wideDstDesc,
+                        sizes, offsets, indices, weights, start, end);
+        return;
     }
 
-    void computeWith1stDerivative(tbb::blocked_range<int> const &r) const {
-        float wP[20], wDu[20], wDv[20];
-        BufferAdapter<const float> srcT(_src + _srcDesc.offset,
-                                        _srcDesc.length,
-                                        _srcDesc.stride);
-        BufferAdapter<float> dstT(_dst + _dstDesc.offset
-                                       + r.begin() * _dstDesc.stride,
-                                  _dstDesc.length,
-                                  _dstDesc.stride);
-        BufferAdapter<float> dstDuT(_dstDu + _dstDuDesc.offset
-                                       + r.begin() * _dstDuDesc.stride,
-                                    _dstDuDesc.length,
-                                    _dstDuDesc.stride);
-        BufferAdapter<float> dstDvT(_dstDv + _dstDvDesc.offset
-                                       + r.begin() * _dstDvDesc.stride,
-                                    _dstDvDesc.length,
-                                    _dstDvDesc.stride);
-
-        for (int i = r.begin(); i < r.end(); ++i) {
-            PatchCoord const &coord = _patchCoords[i];
-            PatchArray const &array = _patchArrayBuffer[coord.handle.arrayIndex];
-
-            Far::PatchParam const & param =
-                _patchParamBuffer[coord.handle.patchIndex];
-            int patchType = param.IsRegular()
-                ? Far::PatchDescriptor::REGULAR
-                : array.GetPatchType();
-
-            int numControlVertices = 0;
-            if (patchType == Far::PatchDescriptor::REGULAR) {
-                Far::internal::GetBSplineWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv);
-                numControlVertices = 16;
-            } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-                Far::internal::GetGregoryWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv);
-                numControlVertices = 20;
-            } else if (patchType == Far::PatchDescriptor::QUADS) {
-                Far::internal::GetBilinearWeights(param,
-                                                  coord.s, coord.t,
-                                                  wP, wDu, wDv);
-                numControlVertices = 4;
-            } else {
-                assert(0);
-            }
-
-            int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-            int indexBase = array.GetIndexBase() + indexStride *
-                    (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-            const int *cvs = &_patchIndexBuffer[indexBase];
-
-            dstT.Clear();
-            dstDuT.Clear();
-            dstDvT.Clear();
-            for (int j = 0; j < numControlVertices; ++j) {
-                dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-                dstDuT.AddWithWeight(srcT[cvs[j]], wDu[j]);
-                dstDvT.AddWithWeight(srcT[cvs[j]], wDv[j]);
-            }
-            ++dstT;
-            ++dstDuT;
-            ++dstDvT;
+    TBBStencilInstancesKernel kernel(src, srcDesc, dst, dstDesc,
+                                     sizes, offsets, indices, weights, start);
+
+    tbb::blocked_range2d<int> range(0, numInstances, 1,
+                                    start, end, grain_size);
+
+    tbb::parallel_for(range, kernel);
+}
+
+class TBBCompactStencilKernel {
+
+    BufferDescriptor _srcDesc;
+    BufferDescriptor _dstDesc[6];
+    float const * _vertexSrc;
+    float * _vertexDst[6];
+
+    int _numWeightSets;
+    CpuCompactStencilTable const * _stencilTable;
+
+public:
+    TBBCompactStencilKernel(float const *src, BufferDescriptor srcDesc,
+                            int numWeightSets,
+                            float * const * dst, BufferDescriptor const * dstDesc,
+                            CpuCompactStencilTable const * stencilTable) :
+         _srcDesc(srcDesc),
+         _vertexSrc(src),
+         _numWeightSets(numWeightSets),
+         _stencilTable(stencilTable) {
+
+        for (int w = 0; w < numWeightSets; ++w) {
+            _dstDesc[w] = dstDesc[w];
+            _vertexDst[w] = dst[w];
         }
     }
 
-    void computeWith2ndDerivative(tbb::blocked_range<int> const &r) const {
-        float wP[20], wDu[20], wDv[20], wDuu[20], wDuv[20], wDvv[20];
-        BufferAdapter<const float> srcT(_src + _srcDesc.offset,
-                                        _srcDesc.length,
-                                        _srcDesc.stride);
-        BufferAdapter<float> dstT(_dst + _dstDesc.offset
-                                       + r.begin() * _dstDesc.stride,
-                                  _dstDesc.length,
-                                  _dstDesc.stride);
-        BufferAdapter<float> dstDuT(_dstDu + _dstDuDesc.offset
-                                       + r.begin() * _dstDuDesc.stride,
-                                  _dstDuDesc.length,
-                                  _dstDuDesc.stride);
-        BufferAdapter<float> dstDvT(_dstDv + _dstDvDesc.offset
-                                       + r.begin() * _dstDvDesc.stride,
-                                  _dstDvDesc.length,
-                                  _dstDvDesc.stride);
-        BufferAdapter<float> dstDuuT(_dstDuu + _dstDuuDesc.offset
-                                       + r.begin() * _dstDuuDesc.stride,
-                                  _dstDuuDesc.length,
-                                  _dstDuuDesc.stride);
-        BufferAdapter<float> dstDuvT(_dstDuv + _dstDuvDesc.offset
-                                       + r.begin() * _dstDuvDesc.stride,
-                                  _dstDuvDesc.length,
-                                  _dstDuvDesc.stride);
-        BufferAdapter<float> dstDvvT(_dstDvv + _dstDvvDesc.offset
-                                       + r.begin() * _dstDvvDesc.stride,
-                                  _dstDvvDesc.length,
-                                  _dstDvvDesc.stride);
-
-        for (int i = r.begin(); i < r.end(); ++i) {
-            PatchCoord const &coord = _patchCoords[i];
-            PatchArray const &array = _patchArrayBuffer[coord.handle.arrayIndex];
-
-            Far::PatchParam const & param =
-                _patchParamBuffer[coord.handle.patchIndex];
-            int patchType = param.IsRegular()
-                ? Far::PatchDescriptor::REGULAR
-                : array.GetPatchType();
-
-            int numControlVertices = 0;
-            if (patchType == Far::PatchDescriptor::REGULAR) {
-                Far::internal::GetBSplineWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv, wDuu, wDuv, wDvv);
-                numControlVertices = 16;
-            } else if (patchType == Far::PatchDescriptor::GREGORY_BASIS) {
-                Far::internal::GetGregoryWeights(param,
-                                                 coord.s, coord.t, wP,
-                                                 wDu, wDv, wDuu, wDuv, wDvv);
-                numControlVertices = 20;
-            } else if (patchType == Far::PatchDescriptor::QUADS) {
-                Far::internal::GetBilinearWeights(param,
-                                                  coord.s, coord.t, wP,
-                                                 wDu, wDv, wDuu, wDuv, wDvv);
-                numControlVertices = 4;
-            } else {
-                assert(0);
-            }
-
-            int indexStride = Far::PatchDescriptor(array.GetPatchType()).GetNumControlVertices();
-            int indexBase = array.GetIndexBase() + indexStride *
-                    (coord.handle.patchIndex - array.GetPrimitiveIdBase());
-
-            const int *cvs = &_patchIndexBuffer[indexBase];
-
-            dstT.Clear();
-            dstDuT.Clear();
-            dstDvT.Clear();
-            dstDuuT.Clear();
-            dstDuvT.Clear();
-            dstDvvT.Clear();
-            for (int j = 0; j < numControlVertices; ++j) {
-                dstT.AddWithWeight(srcT[cvs[j]], wP[j]);
-                dstDuT.AddWithWeight(srcT[cvs[j]], wDu[j]);
-                dstDvT.AddWithWeight(srcT[cvs[j]], wDv[j]);
-                dstDuuT.AddWithWeight(srcT[cvs[j]], wDuu[j]);
-                dstDuvT.AddWithWeight(srcT[cvs[j]], wDuv[j]);
-                dstDvvT.AddWithWeight(srcT[cvs[j]], wDvv[j]);
-            }
-            ++dstT;
-            ++dstDuT;
-            ++dstDvT;
-            ++dstDuuT;
-            ++dstDuvT;
-            ++dstDvvT;
+    void operator() (tbb::blocked_range<int> const &r) const {
+
+        float * dst[6];
+        for (int w = 0; w < _numWeightSets; ++w) {
+            dst[w] = _vertexDst[w]
+                ? _vertexDst[w] + r.begin() * _dstDesc[w].stride : 0;
         }
+
+        CpuComputeCompactStencils(_vertexSrc, _srcDesc, _numWeightSets,
+                                  dst, _dstDesc, *_stencilTable,
+                                  r.begin(), r.end());
     }
 };
 
+void
+TbbComputeCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                          int numWeightSets,
+                          float * const * dst, BufferDescriptor const * dstDesc,
+                          CpuCompactStencilTable const & stencilTable,
+                          int start, int end) {
+
+    TBBCompactStencilKernel kernel(src, srcDesc, numWeightSets, dst, dstDesc,
+                                   &stencilTable);
+
+    tbb::blocked_range<int> range(start, end,
+                                  CpuCompactStencilTable::BLOCK_SIZE * 4);
+
+    tbb::parallel_for(range, kernel);
+}
 
 void
 TbbEvalPatches(float const *src, BufferDescriptor const &srcDesc,
@@ -38,6 +38,7 @@ struct PatchArray;
 struct PatchCoord;
 struct PatchParam;
 struct BufferDescriptor;
+class CpuCompactStencilTable;
 
 void
 TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
@@ -80,6 +81,42 @@ TbbEvalStencils(float const * src, BufferDescriptor const &srcDesc,
                 float const * dvvWeights,
                 int start, int end);
 
+/// \brief Evaluates the stencils listed in 'stencilIndices' concurrently
+///        (see CpuComputeStencilList)
+void
+TbbComputeStencilList(float const * src, BufferDescriptor const &srcDesc,
+                      int numWeightSets,
+                      float * const * dst, BufferDescriptor const * dstDesc,
+                      int const * sizes,
+                      int const * offsets,
+                      int const * indices,
+                      float const * const * weights,
+                      int numStencils, int const * stencilIndices);
+
+/// \brief Evaluates the stencils [start, end) for several instances
+///        concurrently over stencils and instances
+///        (see CpuComputeStencilInstances)
+void
+TbbComputeStencilInstances(int numInstances,
+                           float const * const * src,
+                           BufferDescriptor const &srcDesc,
+                           float * const * dst,
+                           BufferDescriptor const &dstDesc,
+                           int const * sizes,
+                           int const * offsets,
+                           int const * indices,
+                           float const * weights,
+                           int start, int end);
+
+/// \brief Evaluates the stencils [start, end) of a compact stencil table
+///        concurrently (see CpuComputeCompactStencils)
+void
+TbbComputeCompactStencils(float const * src, BufferDescriptor const &srcDesc,
+                          int numWeightSets,
+                          float * const * dst, BufferDescriptor const * dstDesc,
+                          CpuCompactStencilTable const & stencilTable,
+                          int start, int end);
+
 void
 TbbEvalPatches(float const *src, BufferDescriptor const &srcDesc,
                float *dst,       BufferDescriptor const &dstDesc,
@@ -1060,6 +1060,19 @@ FVarLevel::getFaceCompositeValueTag(Index faceIndex) const {
     return compTag;
 }
 
+void
+FVarLevel::getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const {
+
+    usage.Add(prefix + "faceVertValues",      _faceVertValues);
+    usage.Add(prefix + "edgeTags",            _edgeTags);
+    usage.Add(prefix + "vertSiblingCounts",   _vertSiblingCounts);
+    usage.Add(prefix + "vertSiblingOffsets",  _vertSiblingOffsets);
+    usage.Add(prefix + "vertFaceSiblings",    _vertFaceSiblings);
+    usage.Add(prefix + "vertValueIndices",    _vertValueIndices);
+    usage.Add(prefix + "vertValueTags",       _vertValueTags);
+    usage.Add(prefix + "vertValueCreaseEnds", _vertValueCreaseEnds);
+}
+
 } // end namespace internal
 } // end namespace Vtr
 
@@ -237,6 +237,8 @@ public:
     //  Debugging methods:
     bool validate() const;
     void print() const;
+
+    void getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const;
     void buildFaceVertexSiblingsFromVertexFaceSiblings(std::vector<Sibling>& fvSiblings) const;
 
 private:
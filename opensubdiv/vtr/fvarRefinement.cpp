@@ -685,6 +685,12 @@ FVarRefinement::getFractionalWeight(Index pVert, LocalIndex pSibling,
             interiorEdgeCount, pEdgeSharpness, cEdgeSharpness);
 }
 
+void
+FVarRefinement::getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const {
+
+    usage.Add(prefix + "childValueParentSource", _childValueParentSource);
+}
+
 } // end namespace internal
 } // end namespace Vtr
 
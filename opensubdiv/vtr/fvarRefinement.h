@@ -61,6 +61,8 @@ public:
     FVarRefinement(Refinement const& refinement, FVarLevel& parent, FVarLevel& child);
     ~FVarRefinement();
 
+    void getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const;
+
     int getChildValueParentSource(Index vIndex, int sibling) const {
         return _childValueParentSource[_childFVar.getVertexValueOffset(vIndex, (LocalIndex)sibling)];
     }
@@ -1652,7 +1652,7 @@ Level::findEdge(Index v0Index, Index v1Index) const {
 }
 
 bool
-Level::completeTopologyFromFaceVertices() {
+Level::completeTopologyFromFaceVertices(bool useThreads) {
 
     //
     //  It's assumed (a pre-condition) that face-vertices have been fully specified and that we
@@ -1685,6 +1685,76 @@ Level::completeTopologyFromFaceVertices() {
 
     this->_edgeFaceCountsAndOffsets.reserve(eCountEstimate * 2);
 
+    //
+    //  Assemble the edges and their incident relations -- concurrently if requested, but
+    //  that succeeds only if all edges are manifold, so assemble serially if it fails:
+    //
+    int maxEdgeFaces = 0;
+    int maxVertFaces = 0;
+    int maxVertEdges = 0;
+
+    IndexVector nonManifoldEdges;
+
+    if (!useThreads || !populateManifoldRelationsConcurrently(maxEdgeFaces, maxVertFaces, maxVertEdges)) {
+        populateRelationsFromFaceVertices(nonManifoldEdges, maxEdgeFaces, maxVertFaces, maxVertEdges);
+    }
+
+    _maxEdgeFaces = maxEdgeFaces;
+
+    assert(_maxValence > 0);
+    _maxValence = std::max(maxVertFaces, _maxValence);
+    _maxValence = std::max(maxVertEdges, _maxValence);
+
+    //  If max-edge-faces too large, max-valence must also be, so just need the one:
+    if (_maxValence > VALENCE_LIMIT) {
+        return false;
+    }
+
+    //
+    //  At this point all incident members are associated with each component.  We still
+    //  need to populate the "local indices" for each and orient manifold components in
+    //  counter-clockwise order.  First tag non-manifold edges and their incident
+    //  vertices so that we can trivially skip orienting these -- though some vertices
+    //  will be determined non-manifold as a result of a failure to orient them (and
+    //  will be marked accordingly when so detected).
+    //
+    //  Finally, the local indices are assigned.  This is trivial for manifold components
+    //  as if component V is in component F, V will only occur once in F.  For non-manifold
+    //  cases V may occur multiple times in F -- we rely on such instances being successive
+    //  based on their original assignment above, which simplifies the task.
+    //
+    //  First resize edges to the new count to ensure anything related to edges is created:
+    eCount = this->getNumEdges();
+    this->resizeEdges(eCount);
+
+    for (int i = 0; i < (int)nonManifoldEdges.size(); ++i) {
+        Index eIndex = nonManifoldEdges[i];
+
+        _edgeTags[eIndex]._nonManifold = true;
+
+        IndexArray eVerts = getEdgeVertices(eIndex);
+        _vertTags[eVerts[0]]._nonManifold = true;
+        _vertTags[eVerts[1]]._nonManifold = true;
+    }
+
+    orientIncidentComponents(useThreads);
+
+    populateLocalIndices(useThreads);
+
+//printf("Vertex topology completed...\n");
+//this->print();
+//printf("  validating vertex topology...\n");
+//this->validateTopology();
+//assert(this->validateTopology());
+    return true;
+}
+
+void
+Level::populateRelationsFromFaceVertices(IndexVector & nonManifoldEdges,
+        int & maxEdgeFaces, int & maxVertFaces, int & maxVertEdges) {
+
+    int fCount = this->getNumFaces();
+
     //
     //  Create the dynamic relations to be populated (edge-faces will remain empty as reserved
     //  above since there are currently no edges) and iterate through the faces to do so:
@@ -1695,9 +1765,6 @@ Level::completeTopologyFromFaceVertices() {
     DynamicRelation dynVertFaces(this->_vertFaceCountsAndOffsets, this->_vertFaceIndices, avgSize);
     DynamicRelation dynVertEdges(this->_vertEdgeCountsAndOffsets, this->_vertEdgeIndices, avgSize);
 
-    //  Inspect each edge created and identify those that are non-manifold as we go:
-    IndexVector nonManifoldEdges;
-
     for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
         IndexArray fVerts = this->getFaceVertices(fIndex);
         IndexArray fEdges = this->getFaceEdges(fIndex);
@@ -1771,62 +1838,246 @@ Level::completeTopologyFromFaceVertices() {
     //  existing value -- and some non-manifold cases can have #faces > #edges, so be
     //  sure to consider both.
     //
-    int maxEdgeFaces = dynEdgeFaces.compressMemberIndices();
-    int maxVertFaces = dynVertFaces.compressMemberIndices();
-    int maxVertEdges = dynVertEdges.compressMemberIndices();
+    maxEdgeFaces = dynEdgeFaces.compressMemberIndices();
+    maxVertFaces = dynVertFaces.compressMemberIndices();
+    maxVertEdges = dynVertEdges.compressMemberIndices();
+}
 
-    _maxEdgeFaces = maxEdgeFaces;
+//
+//  A concurrent alternative to the incremental assembly above.  Each face-vertex (or
+//  "corner") leads an edge to the next vertex of its face, and each edge is identified
+//  by pairing its corner with an opposing corner among those of its end vertex.  Edges
+//  are numbered in order of their first corner, which is the order in which they are
+//  created incrementally, so the results are identical -- but only when all edges are
+//  manifold.  Nothing is assigned and false is returned if a non-manifold edge exists:
+//
+bool
+Level::populateManifoldRelationsConcurrently(int & maxEdgeFaces, int & maxVertFaces,
+                                             int & maxVertEdges) {
 
-    assert(_maxValence > 0);
-    _maxValence = std::max(maxVertFaces, _maxValence);
-    _maxValence = std::max(maxVertEdges, _maxValence);
+    int vCount = this->getNumVertices();
+    int fCount = this->getNumFaces();
+    int cCount = this->getNumFaceVerticesTotal();
 
-    //  If max-edge-faces too large, max-valence must also be, so just need the one:
-    if (_maxValence > VALENCE_LIMIT) {
-        return false;
+    //
+    //  Identify the face of each corner and the end vertex of its leading edge:
+    //
+    IndexVector cornerFaces(cCount);
+    IndexVector cornerEnds(cCount);
+
+    int degenerateCount = 0;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for reduction(+:degenerateCount)
+#endif
+    for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
+        ConstIndexArray fVerts = this->getFaceVertices(fIndex);
+        int             fStart = this->getOffsetOfFaceVertices(fIndex);
+
+        for (int i = 0; i < fVerts.size(); ++i) {
+            Index vEnd = fVerts[(i+1) % fVerts.size()];
+
+            cornerFaces[fStart + i] = fIndex;
+            cornerEnds[fStart + i]  = vEnd;
+            degenerateCount += (vEnd == fVerts[i]);
+        }
     }
+    if (degenerateCount) return false;
 
     //
-    //  At this point all incident members are associated with each component.  We still
-    //  need to populate the "local indices" for each and orient manifold components in
-    //  counter-clockwise order.  First tag non-manifold edges and their incident
-    //  vertices so that we can trivially skip orienting these -- though some vertices
-    //  will be determined non-manifold as a result of a failure to orient them (and
-    //  will be marked accordingly when so detected).
+    //  Gather the corners of each vertex in order -- the counts and offsets of which
+    //  are those of the vertex-faces (reinitialized by the serial assembly if needed):
     //
-    //  Finally, the local indices are assigned.  This is trivial for manifold components
-    //  as if component V is in component F, V will only occur once in F.  For non-manifold
-    //  cases V may occur multiple times in F -- we rely on such instances being successive
-    //  based on their original assignment above, which simplifies the task.
+    IndexVector vertCorners(cCount);
+
+    std::fill(_vertFaceCountsAndOffsets.begin(), _vertFaceCountsAndOffsets.end(), 0);
+    for (int c = 0; c < cCount; ++c) {
+        ++ _vertFaceCountsAndOffsets[2 * _faceVertIndices[c]];
+    }
+    maxVertFaces = 0;
+    for (Index vIndex = 0, vOffset = 0; vIndex < vCount; ++vIndex) {
+        int vFaceCount = _vertFaceCountsAndOffsets[2*vIndex];
+
+        _vertFaceCountsAndOffsets[2*vIndex]     = 0;
+        _vertFaceCountsAndOffsets[2*vIndex + 1] = vOffset;
+
+        vOffset     += vFaceCount;
+        maxVertFaces = std::max(maxVertFaces, vFaceCount);
+    }
+    for (int c = 0; c < cCount; ++c) {
+        int * vCountOffsetPair = &_vertFaceCountsAndOffsets[2 * _faceVertIndices[c]];
+
+        vertCorners[vCountOffsetPair[1] + vCountOffsetPair[0]++] = c;
+    }
+
     //
-    //  First resize edges to the new count to ensure anything related to edges is created:
-    eCount = this->getNumEdges();
-    this->resizeEdges(eCount);
+    //  Identify the opposing corner of each corner, i.e. the one leading from its end
+    //  vertex back to its vertex.  A second opposing corner, or a second corner leading
+    //  to the same end vertex, indicates a non-manifold edge, as does an opposing corner
+    //  in the same face:
+    //
+    IndexVector cornerOpposites(cCount);
 
-    for (int i = 0; i < (int)nonManifoldEdges.size(); ++i) {
-        Index eIndex = nonManifoldEdges[i];
+    int nonManifoldCount = 0;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for reduction(+:nonManifoldCount)
+#endif
+    for (int c = 0; c < cCount; ++c) {
+        Index v0Index = _faceVertIndices[c];
+        Index v1Index = cornerEnds[c];
+
+        Index const * v0Corners = &vertCorners[0] + getOffsetOfVertexFaces(v0Index);
+        Index const * v1Corners = &vertCorners[0] + getOffsetOfVertexFaces(v1Index);
+
+        Index cOpposite = INDEX_INVALID;
+        for (int i = 0; i < getNumVertexFaces(v1Index); ++i) {
+            if (cornerEnds[v1Corners[i]] == v0Index) {
+                nonManifoldCount += IndexIsValid(cOpposite);
+                cOpposite = v1Corners[i];
+            }
+        }
+        for (int i = 0; i < getNumVertexFaces(v0Index); ++i) {
+            nonManifoldCount += (v0Corners[i] != c) && (cornerEnds[v0Corners[i]] == v1Index);
+        }
+        if (IndexIsValid(cOpposite)) {
+            nonManifoldCount += (cornerFaces[cOpposite] == cornerFaces[c]);
+        }
+        cornerOpposites[c] = cOpposite;
+    }
+    if (nonManifoldCount) return false;
 
-        _edgeTags[eIndex]._nonManifold = true;
+    //
+    //  Number the edges in order of their first corner and assign the face-edges -- the
+    //  first corners are identified serially, the remaining face-edges concurrently:
+    //
+    IndexVector edgeCorners;
+    edgeCorners.reserve(vCount * 2);
+
+    for (int c = 0; c < cCount; ++c) {
+        if (!IndexIsValid(cornerOpposites[c]) || (cornerOpposites[c] > c)) {
+            _faceEdgeIndices[c] = (Index) edgeCorners.size();
+            edgeCorners.push_back(c);
+        }
+    }
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int c = 0; c < cCount; ++c) {
+        if (IndexIsValid(cornerOpposites[c]) && (cornerOpposites[c] < c)) {
+            _faceEdgeIndices[c] = _faceEdgeIndices[cornerOpposites[c]];
+        }
+    }
+
+    //
+    //  Assign the vertices and faces of each edge -- the faces of the first and any
+    //  opposing corner:
+    //
+    int eCount = (int) edgeCorners.size();
+
+    _edgeCount = eCount;
+    _edgeVertIndices.resize(2 * eCount);
+    _edgeFaceCountsAndOffsets.resize(2 * eCount);
+
+    maxEdgeFaces = 0;
+    for (Index eIndex = 0, eOffset = 0; eIndex < eCount; ++eIndex) {
+        int eFaceCount = 1 + IndexIsValid(cornerOpposites[edgeCorners[eIndex]]);
+
+        _edgeFaceCountsAndOffsets[2*eIndex]     = eFaceCount;
+        _edgeFaceCountsAndOffsets[2*eIndex + 1] = eOffset;
+
+        eOffset     += eFaceCount;
+        maxEdgeFaces = std::max(maxEdgeFaces, eFaceCount);
+    }
+    _edgeFaceIndices.resize(getNumEdgeFaces(eCount-1) + getOffsetOfEdgeFaces(eCount-1));
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
+        int c = edgeCorners[eIndex];
 
         IndexArray eVerts = getEdgeVertices(eIndex);
-        _vertTags[eVerts[0]]._nonManifold = true;
-        _vertTags[eVerts[1]]._nonManifold = true;
+        eVerts[0] = _faceVertIndices[c];
+        eVerts[1] = cornerEnds[c];
+
+        IndexArray eFaces = getEdgeFaces(eIndex);
+        eFaces[0] = cornerFaces[c];
+        if (eFaces.size() > 1) {
+            eFaces[1] = cornerFaces[cornerOpposites[c]];
+        }
     }
 
-    orientIncidentComponents();
+    //
+    //  Assign the vertex-faces from the corners of each vertex, and the vertex-edges in
+    //  order of creation -- the leading edges of its corners and the trailing edges of
+    //  its corners that are not also leading edges, i.e. those on a boundary:
+    //
+    _vertFaceIndices.resize(cCount);
 
-    populateLocalIndices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (int i = 0; i < cCount; ++i) {
+        _vertFaceIndices[i] = cornerFaces[vertCorners[i]];
+    }
 
-//printf("Vertex topology completed...\n");
-//this->print();
-//printf("  validating vertex topology...\n");
-//this->validateTopology();
-//assert(this->validateTopology());
+    IndexVector cornerTrailing(cCount);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index fIndex = 0; fIndex < fCount; ++fIndex) {
+        int fStart = this->getOffsetOfFaceVertices(fIndex);
+        int fSize  = this->getNumFaceVertices(fIndex);
+
+        for (int i = 0; i < fSize; ++i) {
+            cornerTrailing[fStart + i] = fStart + (i ? (i - 1) : (fSize - 1));
+        }
+    }
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        Index const * vCorners = &vertCorners[0] + getOffsetOfVertexFaces(vIndex);
+
+        int vEdgeCount = getNumVertexFaces(vIndex);
+        for (int i = 0; i < getNumVertexFaces(vIndex); ++i) {
+            vEdgeCount += !IndexIsValid(cornerOpposites[cornerTrailing[vCorners[i]]]);
+        }
+        _vertEdgeCountsAndOffsets[2*vIndex] = vEdgeCount;
+    }
+    maxVertEdges = 0;
+    for (Index vIndex = 0, vOffset = 0; vIndex < vCount; ++vIndex) {
+        _vertEdgeCountsAndOffsets[2*vIndex + 1] = vOffset;
+
+        vOffset     += _vertEdgeCountsAndOffsets[2*vIndex];
+        maxVertEdges = std::max(maxVertEdges, _vertEdgeCountsAndOffsets[2*vIndex]);
+    }
+    _vertEdgeIndices.resize(getNumVertexEdges(vCount-1) + getOffsetOfVertexEdges(vCount-1));
+
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for
+#endif
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        Index const * vCorners = &vertCorners[0] + getOffsetOfVertexFaces(vIndex);
+
+        IndexArray vEdges = getVertexEdges(vIndex);
+
+        int vEdgeCount = 0;
+        for (int i = 0; i < getNumVertexFaces(vIndex); ++i) {
+            int cTrailing = cornerTrailing[vCorners[i]];
+
+            vEdges[vEdgeCount++] = _faceEdgeIndices[vCorners[i]];
+            if (!IndexIsValid(cornerOpposites[cTrailing])) {
+                vEdges[vEdgeCount++] = _faceEdgeIndices[cTrailing];
+            }
+        }
+        std::sort(vEdges.begin(), vEdges.end());
+    }
     return true;
 }
 
 void
-Level::populateLocalIndices() {
+Level::populateLocalIndices(bool useThreads) {
 
     //
     //  We have three sets of local indices -- edge-faces, vert-faces and vert-edges:
@@ -1838,6 +2089,9 @@ Level::populateLocalIndices() {
     this->_vertEdgeLocalIndices.resize(this->_vertEdgeIndices.size());
     this->_edgeFaceLocalIndices.resize(this->_edgeFaceIndices.size());
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useThreads)
+#endif
     for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
         IndexArray      vFaces   = this->getVertexFaces(vIndex);
         LocalIndexArray vInFaces = this->getVertexFaceLocalIndices(vIndex);
@@ -1861,6 +2115,9 @@ Level::populateLocalIndices() {
         }
     }
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useThreads)
+#endif
     for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
         IndexArray      vEdges   = this->getVertexEdges(vIndex);
         LocalIndexArray vInEdges = this->getVertexEdgeLocalIndices(vIndex);
@@ -1878,9 +2135,14 @@ Level::populateLocalIndices() {
                 vInEdges[i] = (i && (vEdges[i] == vEdges[i-1]));
             }
         }
-        _maxValence = std::max(_maxValence, vEdges.size());
+    }
+    for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
+        _maxValence = std::max(_maxValence, this->getNumVertexEdges(vIndex));
     }
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useThreads)
+#endif
     for (Index eIndex = 0; eIndex < eCount; ++eIndex) {
         IndexArray      eFaces   = this->getEdgeFaces(eIndex);
         LocalIndexArray eInFaces = this->getEdgeFaceLocalIndices(eIndex);
@@ -1906,10 +2168,13 @@ Level::populateLocalIndices() {
 }
 
 void
-Level::orientIncidentComponents() {
+Level::orientIncidentComponents(bool useThreads) {
 
     int vCount = getNumVertices();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (useThreads)
+#endif
     for (Index vIndex = 0; vIndex < vCount; ++vIndex) {
         Level::VTag & vTag = _vertTags[vIndex];
         if (!vTag._nonManifold) {
@@ -2092,6 +2357,39 @@ Level::completeFVarChannelTopology(int channel, int regBoundaryValence) {
     return _fvarChannels[channel]->completeTopologyFromFaceValues(regBoundaryValence);
 }
 
+//
+//  Memory usage of the vectors of the level and its face-varying channels:
+//
+void
+Level::getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const {
+
+    usage.Add(prefix + "faceVertCountsAndOffsets", _faceVertCountsAndOffsets);
+    usage.Add(prefix + "faceVertIndices",          _faceVertIndices);
+    usage.Add(prefix + "faceEdgeIndices",          _faceEdgeIndices);
+    usage.Add(prefix + "faceTags",                 _faceTags);
+
+    usage.Add(prefix + "edgeVertIndices",          _edgeVertIndices);
+    usage.Add(prefix + "edgeFaceCountsAndOffsets", _edgeFaceCountsAndOffsets);
+    usage.Add(prefix + "edgeFaceIndices",          _edgeFaceIndices);
+    usage.Add(prefix + "edgeFaceLocalIndices",     _edgeFaceLocalIndices);
+    usage.Add(prefix + "edgeSharpness",            _edgeSharpness);
+    usage.Add(prefix + "edgeTags",                 _edgeTags);
+
+    usage.Add(prefix + "vertFaceCountsAndOffsets", _vertFaceCountsAndOffsets);
+    usage.Add(prefix + "vertFaceIndices",          _vertFaceIndices);
+    usage.Add(prefix + "vertFaceLocalIndices",     _vertFaceLocalIndices);
+    usage.Add(prefix + "vertEdgeCountsAndOffsets", _vertEdgeCountsAndOffsets);
+    usage.Add(prefix + "vertEdgeIndices",          _vertEdgeIndices);
+    usage.Add(prefix + "vertEdgeLocalIndices",     _vertEdgeLocalIndices);
+    usage.Add(prefix + "vertSharpness",            _vertSharpness);
+    usage.Add(prefix + "vertTags",                 _vertTags);
+
+    for (int i = 0; i < (int)_fvarChannels.size(); ++i) {
+        _fvarChannels[i]->getMemoryUsage(usage,
+            prefix + MemoryUsage::GetIndexedName("fvar", i));
+    }
+}
+
 } // end namespace internal
 } // end namespace Vtr
 
@@ -30,6 +30,7 @@
 #include "../sdc/crease.h"
 #include "../sdc/options.h"
 #include "../vtr/types.h"
+#include "../vtr/memoryUsage.h"
 
 #include <algorithm>
 #include <vector>
@@ -291,6 +292,9 @@ public:
 
     void print(const Refinement* parentRefinement = 0) const;
 
+    //  Adds the vectors of the level and its face-varying channels to a breakdown:
+    void getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const;
+
 public:
     //  High-level topology queries -- these may be moved elsewhere:
 
@@ -438,14 +442,18 @@ public:
     //  it necessary to write code to define and orient all relations -- and most
     //  of that seemed best placed here.
     //
-    bool completeTopologyFromFaceVertices();
+    bool completeTopologyFromFaceVertices(bool useThreads = false);
     Index findEdge(Index v0, Index v1, ConstIndexArray v0Edges) const;
 
     //  Methods supporting the above:
-    void orientIncidentComponents();
+    void populateRelationsFromFaceVertices(IndexVector& nonManifoldEdges,
+            int& maxEdgeFaces, int& maxVertFaces, int& maxVertEdges);
+    bool populateManifoldRelationsConcurrently(
+            int& maxEdgeFaces, int& maxVertFaces, int& maxVertEdges);
+    void orientIncidentComponents(bool useThreads = false);
     bool orderVertexFacesAndEdges(Index vIndex, Index* vFaces, Index* vEdges) const;
     bool orderVertexFacesAndEdges(Index vIndex);
-    void populateLocalIndices();
+    void populateLocalIndices(bool useThreads = false);
 
     IndexArray shareFaceVertCountsAndOffsets() const;
 
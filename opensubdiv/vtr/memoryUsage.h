@@ -0,0 +1,114 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#ifndef OPENSUBDIV3_VTR_MEMORY_USAGE_H
+#define OPENSUBDIV3_VTR_MEMORY_USAGE_H
+
+#include "../version.h"
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+namespace OpenSubdiv {
+namespace OPENSUBDIV_VERSION {
+
+namespace Vtr {
+
+///
+/// \brief Breakdown of the memory used by the data of an object
+///
+/// Each component is a block of storage named by a '/' separated path, for
+/// instance "level[1]/faceVertIndices" or "localPointStencils/weights", so
+/// that the usage of a group of components is the total of a common prefix.
+/// The size of a vector is that of its allocated storage (its capacity).
+///
+class MemoryUsage {
+
+public:
+    struct Component {
+        std::string name;
+        size_t      bytes;
+    };
+
+    /// \brief Adds a component (empty components are ignored)
+    void Add(std::string const & name, size_t bytes) {
+        if (bytes) {
+            Component component;
+            component.name = name;
+            component.bytes = bytes;
+            _components.push_back(component);
+        }
+    }
+
+    /// \brief Adds the storage of a vector as a component
+    template <typename T>
+    void Add(std::string const & name, std::vector<T> const & v) {
+        Add(name, v.capacity() * sizeof(T));
+    }
+
+    /// \brief Returns the number of components
+    int GetNumComponents() const { return (int)_components.size(); }
+
+    /// \brief Returns a component
+    Component const & GetComponent(int i) const { return _components[i]; }
+
+    /// \brief Returns the total of all the components (in bytes)
+    size_t GetTotal() const { return GetTotal(std::string()); }
+
+    /// \brief Returns the total of the components whose name starts with
+    ///        'prefix' (in bytes)
+    size_t GetTotal(std::string const & prefix) const {
+        size_t total = 0;
+        for (int i = 0; i < (int)_components.size(); ++i) {
+            if (_components[i].name.compare(0, prefix.size(), prefix) == 0) {
+                total += _components[i].bytes;
+            }
+        }
+        return total;
+    }
+
+    /// \brief Returns the name of an element of an indexed group of
+    ///        components as a prefix, e.g. "level[1]/"
+    static std::string GetIndexedName(char const * name, int index) {
+        char suffix[32];
+        sprintf(suffix, "[%d]/", index);
+        return std::string(name) + suffix;
+    }
+
+    /// \brief Removes all the components
+    void Clear() { _components.clear(); }
+
+private:
+    std::vector<Component> _components;
+};
+
+} // end namespace Vtr
+
+} // end namespace OPENSUBDIV_VERSION
+using namespace OPENSUBDIV_VERSION;
+} // end namespace OpenSubdiv
+
+#endif /* OPENSUBDIV3_VTR_MEMORY_USAGE_H */
@@ -115,6 +115,9 @@ QuadRefinement::populateFaceVertexCountsAndOffsets() {
 
     _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2);
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (int i = 0; i < _child->getNumFaces(); ++i) {
         _child->_faceVertCountsAndOffsets[i*2 + 0] = 4;
         _child->_faceVertCountsAndOffsets[i*2 + 1] = i << 2;
@@ -134,6 +137,9 @@ QuadRefinement::populateFaceVerticesFromParentFaces() {
     //  for its face-verts from the child vertices of the parent face, its edges
     //  and its vertices.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
@@ -205,6 +211,9 @@ QuadRefinement::populateFaceEdgesFromParentFaces() {
     //  The two remaining edges per child faces are perpendicular to these prev/next
     //  edges and share the child vertex of the parent face.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
@@ -293,6 +302,9 @@ QuadRefinement::populateEdgeVerticesFromParentFaces() {
     //  to all.  The second vertex is the child vertex of the parent edge to
     //  which the new child edge is perpendicular.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceEdges      = _parent->getFaceEdges(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
@@ -318,6 +330,9 @@ QuadRefinement::populateEdgeVerticesFromParentEdges() {
     //  to both.  The second vertex is the child vertex of the vertex at the
     //  end of the parent edge.
     //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         ConstIndexArray pEdgeVerts = _parent->getEdgeVertices(pEdge),
                         pEdgeChildren = getEdgeChildEdges(pEdge);
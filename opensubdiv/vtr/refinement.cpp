@@ -52,6 +52,7 @@ Refinement::Refinement(Level const & parentArg, Level & childArg, Sdc::Options c
     _regFaceSize(-1),
     _uniform(false),
     _faceVertsFirst(false),
+    _useThreads(false),
     _childFaceFromFaceCount(0),
     _childEdgeFromFaceCount(0),
     _childEdgeFromEdgeCount(0),
@@ -121,6 +122,7 @@ Refinement::refine(Options refineOptions) {
 
     _uniform        = !refineOptions._sparse;
     _faceVertsFirst =  refineOptions._faceVertsFirst;
+    _useThreads     =  refineOptions._useThreads;
 
     //  We may soon have an option here to suppress refinement of FVar channels...
     bool refineOptions_ignoreFVarChannels = false;
@@ -374,9 +376,13 @@ void
 Refinement::populateFaceParentFromParentFaces(ChildTag const initialChildTags[2][4]) {
 
     if (_uniform) {
-        Index cFace = getFirstChildFaceFromFaces();
+        //  Child faces of each face are consecutive, so parent faces are independent:
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
             ConstIndexArray cFaces = getFaceChildFaces(pFace);
+            Index cFace = cFaces[0];
             if (cFaces.size() == 4) {
                 _childFaceTag[cFace + 0] = initialChildTags[0][0];
                 _childFaceTag[cFace + 1] = initialChildTags[0][1];
@@ -387,8 +393,6 @@ Refinement::populateFaceParentFromParentFaces(ChildTag const initialChildTags[2]
                 _childFaceParentIndex[cFace + 1] = pFace;
                 _childFaceParentIndex[cFace + 2] = pFace;
                 _childFaceParentIndex[cFace + 3] = pFace;
-
-                cFace += 4;
             } else {
                 bool childTooLarge = (cFaces.size() > 4);
                 for (int i = 0; i < cFaces.size(); ++i, ++cFace) {
@@ -399,6 +403,9 @@ Refinement::populateFaceParentFromParentFaces(ChildTag const initialChildTags[2]
         }
     } else {
         //  Child faces of faces:
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
             bool incomplete = !_parentFaceTag[pFace]._selected;
 
@@ -439,9 +446,12 @@ void
 Refinement::populateEdgeParentFromParentFaces(ChildTag const initialChildTags[2][4]) {
 
     if (_uniform) {
-        Index cEdge = getFirstChildEdgeFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
             ConstIndexArray cEdges = getFaceChildEdges(pFace);
+            Index cEdge = cEdges[0];
             if (cEdges.size() == 4) {
                 _childEdgeTag[cEdge + 0] = initialChildTags[0][0];
                 _childEdgeTag[cEdge + 1] = initialChildTags[0][1];
@@ -452,8 +462,6 @@ Refinement::populateEdgeParentFromParentFaces(ChildTag const initialChildTags[2]
                 _childEdgeParentIndex[cEdge + 1] = pFace;
                 _childEdgeParentIndex[cEdge + 2] = pFace;
                 _childEdgeParentIndex[cEdge + 3] = pFace;
-
-                cEdge += 4;
             } else {
                 bool childTooLarge = (cEdges.size() > 4);
                 for (int i = 0; i < cEdges.size(); ++i, ++cEdge) {
@@ -463,6 +471,9 @@ Refinement::populateEdgeParentFromParentFaces(ChildTag const initialChildTags[2]
             }
         }
     } else {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
             bool incomplete = !_parentFaceTag[pFace]._selected;
 
@@ -493,8 +504,13 @@ void
 Refinement::populateEdgeParentFromParentEdges(ChildTag const initialChildTags[2][4]) {
 
     if (_uniform) {
-        Index cEdge = getFirstChildEdgeFromEdges();
-        for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge, cEdge += 2) {
+        Index cEdgeBegin = getFirstChildEdgeFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
+        for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
+            Index cEdge = cEdgeBegin + 2 * pEdge;
+
             _childEdgeTag[cEdge + 0] = initialChildTags[0][0];
             _childEdgeTag[cEdge + 1] = initialChildTags[0][1];
 
@@ -502,6 +518,9 @@ Refinement::populateEdgeParentFromParentEdges(ChildTag const initialChildTags[2]
             _childEdgeParentIndex[cEdge + 1] = pEdge;
         }
     } else {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
             bool incomplete = !_parentEdgeTag[pEdge]._selected;
 
@@ -544,15 +563,21 @@ Refinement::populateVertexParentFromParentFaces(ChildTag const initialChildTags[
     if (getNumChildVerticesFromFaces() == 0) return;
 
     if (_uniform) {
-        Index cVert = getFirstChildVertexFromFaces();
-        for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace, ++cVert) {
+        Index cVertBegin = getFirstChildVertexFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
+        for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
             //  Child tag was initialized as the complete and only child when allocated
 
-            _childVertexParentIndex[cVert] = pFace;
+            _childVertexParentIndex[cVertBegin + pFace] = pFace;
         }
     } else {
         ChildTag const & completeChildTag = initialChildTags[0][0];
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
             Index cVert = _faceChildVertIndex[pFace];
             if (IndexIsValid(cVert)) {
@@ -569,15 +594,21 @@ void
 Refinement::populateVertexParentFromParentEdges(ChildTag const initialChildTags[2][4]) {
 
     if (_uniform) {
-        Index cVert = getFirstChildVertexFromEdges();
-        for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge, ++cVert) {
+        Index cVertBegin = getFirstChildVertexFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
+        for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
             //  Child tag was initialized as the complete and only child when allocated
 
-            _childVertexParentIndex[cVert] = pEdge;
+            _childVertexParentIndex[cVertBegin + pEdge] = pEdge;
         }
     } else {
         ChildTag const & completeChildTag = initialChildTags[0][0];
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
             Index cVert = _edgeChildVertIndex[pEdge];
             if (IndexIsValid(cVert)) {
@@ -594,15 +625,21 @@ void
 Refinement::populateVertexParentFromParentVertices(ChildTag const initialChildTags[2][4]) {
 
     if (_uniform) {
-        Index cVert = getFirstChildVertexFromVertices();
-        for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert, ++cVert) {
+        Index cVertBegin = getFirstChildVertexFromVertices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
+        for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
             //  Child tag was initialized as the complete and only child when allocated
 
-            _childVertexParentIndex[cVert] = pVert;
+            _childVertexParentIndex[cVertBegin + pVert] = pVert;
         }
     } else {
         ChildTag const & completeChildTag = initialChildTags[0][0];
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index pVert = 0; pVert < _parent->getNumVertices(); ++pVert) {
             Index cVert = _vertChildVertIndex[pVert];
             if (IndexIsValid(cVert)) {
@@ -641,9 +678,12 @@ Refinement::populateFaceTagsFromParentFaces() {
     //
     //  Tags for faces originating from faces are inherited from the parent face:
     //
-    Index cFace    = getFirstChildFaceFromFaces();
-    Index cFaceEnd = cFace + getNumChildFacesFromFaces();
-    for ( ; cFace < cFaceEnd; ++cFace) {
+    Index cFaceBegin = getFirstChildFaceFromFaces();
+    Index cFaceEnd   = cFaceBegin + getNumChildFacesFromFaces();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
+    for (Index cFace = cFaceBegin; cFace < cFaceEnd; ++cFace) {
         _child->_faceTags[cFace] = _parent->_faceTags[_childFaceParentIndex[cFace]];
     }
 }
@@ -677,9 +717,12 @@ Refinement::populateEdgeTagsFromParentEdges() {
     //
     //  Tags for edges originating from edges are inherited from the parent edge:
     //
-    Index cEdge    = getFirstChildEdgeFromEdges();
-    Index cEdgeEnd = cEdge + getNumChildEdgesFromEdges();
-    for ( ; cEdge < cEdgeEnd; ++cEdge) {
+    Index cEdgeBegin = getFirstChildEdgeFromEdges();
+    Index cEdgeEnd   = cEdgeBegin + getNumChildEdgesFromEdges();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
+    for (Index cEdge = cEdgeBegin; cEdge < cEdgeEnd; ++cEdge) {
         _child->_edgeTags[cEdge] = _parent->_edgeTags[_childEdgeParentIndex[cEdge]];
     }
 }
@@ -694,6 +737,9 @@ Refinement::populateVertexTagVectors() {
     populateVertexTagsFromParentVertices();
 
     if (!_uniform) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
         for (Index cVert = 0; cVert < _child->getNumVertices(); ++cVert) {
             if (_childVertexTag[cVert]._incomplete) {
                 _child->_vertTags[cVert]._incomplete = true;
@@ -715,15 +761,18 @@ Refinement::populateVertexTagsFromParentFaces() {
     vTag.clear();
     vTag._rule = Sdc::Crease::RULE_SMOOTH;
 
-    Index cVert    = getFirstChildVertexFromFaces();
-    Index cVertEnd = cVert + getNumChildVerticesFromFaces();
+    Index cVertBegin = getFirstChildVertexFromFaces();
+    Index cVertEnd   = cVertBegin + getNumChildVerticesFromFaces();
 
     if (_parent->_depth > 0) {
-        for ( ; cVert < cVertEnd; ++cVert) {
+        for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
             _child->_vertTags[cVert] = vTag;
         }
     } else {
-        for ( ; cVert < cVertEnd; ++cVert) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp parallel for if (_useThreads)
+#endif
+        for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
             _child->_vertTags[cVert] = vTag;
 
             if (_parent->getNumFaceVertices(_childVertexParentIndex[cVert]) != _regFaceSize) {
@@ -739,13 +788,18 @@ Refinement::populateVertexTagsFromParentEdges() {
     //  Tags for vertices originating from edges are initialized according to the tags
     //  of the parent edge:
     //
-    Level::VTag vTag;
-    vTag.clear();
+    Level::VTag vTagClear;
+    vTagClear.clear();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         Index cVert = _edgeChildVertIndex[pEdge];
         if (!IndexIsValid(cVert)) continue;
 
+        Level::VTag vTag = vTagClear;
+
         //  From the cleared local VTag, we just need to assign properties dependent
         //  on the parent edge:
         Level::ETag const& pEdgeTag = _parent->_edgeTags[pEdge];
@@ -769,9 +823,12 @@ Refinement::populateVertexTagsFromParentVertices() {
     //
     //  Tags for vertices originating from vertices are inherited from the parent vertex:
     //
-    Index cVert    = getFirstChildVertexFromVertices();
-    Index cVertEnd = cVert + getNumChildVerticesFromVertices();
-    for ( ; cVert < cVertEnd; ++cVert) {
+    Index cVertBegin = getFirstChildVertexFromVertices();
+    Index cVertEnd   = cVertBegin + getNumChildVerticesFromVertices();
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
+    for (Index cVert = cVertBegin; cVert < cVertEnd; ++cVert) {
         _child->_vertTags[cVert] = _parent->_vertTags[_childVertexParentIndex[cVert]];
     }
 }
@@ -798,14 +855,34 @@ Refinement::subdivideTopology(Relations const& applyTo) {
     if (applyTo._edgeVertices) {
         populateEdgeVertexRelation();
     }
-    if (applyTo._edgeFaces) {
-        populateEdgeFaceRelation();
-    }
-    if (applyTo._vertexFaces) {
-        populateVertexFaceRelation();
-    }
-    if (applyTo._vertexEdges) {
-        populateVertexEdgeRelation();
+
+    //
+    //  The remaining relations accumulate their counts and offsets incrementally
+    //  and so must each be populated serially, but they share no data with each
+    //  other and so can be populated concurrently:
+    //
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel sections if (_useThreads)
+#endif
+    {
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp section
+#endif
+        if (applyTo._edgeFaces) {
+            populateEdgeFaceRelation();
+        }
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp section
+#endif
+        if (applyTo._vertexFaces) {
+            populateVertexFaceRelation();
+        }
+#ifdef OPENSUBDIV_HAS_OPENMP
+        #pragma omp section
+#endif
+        if (applyTo._vertexEdges) {
+            populateVertexEdgeRelation();
+        }
     }
 
     //
@@ -1239,6 +1316,39 @@ Refinement::markSparseEdgeChildren() {
     }
 }
 
+//
+//  Memory usage of the vectors of the refinement and its face-varying channels
+//  (the face-child counts and offsets are shared with the parent Level or are
+//  local to the subclass):
+//
+void
+Refinement::getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const {
+
+    usage.Add(prefix + "faceChildFaceIndices",   _faceChildFaceIndices);
+    usage.Add(prefix + "faceChildEdgeIndices",   _faceChildEdgeIndices);
+    usage.Add(prefix + "faceChildVertIndex",     _faceChildVertIndex);
+    usage.Add(prefix + "edgeChildEdgeIndices",   _edgeChildEdgeIndices);
+    usage.Add(prefix + "edgeChildVertIndex",     _edgeChildVertIndex);
+    usage.Add(prefix + "vertChildVertIndex",     _vertChildVertIndex);
+
+    usage.Add(prefix + "childFaceParentIndex",   _childFaceParentIndex);
+    usage.Add(prefix + "childEdgeParentIndex",   _childEdgeParentIndex);
+    usage.Add(prefix + "childVertexParentIndex", _childVertexParentIndex);
+
+    usage.Add(prefix + "childFaceTag",           _childFaceTag);
+    usage.Add(prefix + "childEdgeTag",           _childEdgeTag);
+    usage.Add(prefix + "childVertexTag",         _childVertexTag);
+
+    usage.Add(prefix + "parentFaceTag",          _parentFaceTag);
+    usage.Add(prefix + "parentEdgeTag",          _parentEdgeTag);
+    usage.Add(prefix + "parentVertexTag",        _parentVertexTag);
+
+    for (int i = 0; i < (int)_fvarChannels.size(); ++i) {
+        _fvarChannels[i]->getMemoryUsage(usage,
+            prefix + MemoryUsage::GetIndexedName("fvar", i));
+    }
+}
+
 } // end namespace internal
 } // end namespace Vtr
 
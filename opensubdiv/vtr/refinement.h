@@ -100,6 +100,14 @@ public:
     //          vertex-faces for any face-varying channels present.  So it will
     //          generate one or two of the six possible topological relations.
     //
+    //      "use threads": the passes that write each child component from a single
+    //          parent component (parent/child mappings, tags and the face-vertex,
+    //          face-edge and edge-vertex relations) iterate over the parent
+    //          components concurrently, while the three relations whose counts and
+    //          offsets are accumulated incrementally are populated concurrently with
+    //          each other.  The resulting child Level is identical to that of the
+    //          serial refinement.  This has no effect unless OpenMP is available.
+    //
     //  These are strictly controlled right now, e.g. for sparse refinement, we
     //  currently enforce full topology at the finest level to allow for subsequent
     //  patch construction.
@@ -107,12 +115,14 @@ public:
     struct Options {
         Options() : _sparse(false),
                     _faceVertsFirst(false),
-                    _minimalTopology(false)
+                    _minimalTopology(false),
+                    _useThreads(false)
                     { }
 
         unsigned int _sparse          : 1;
         unsigned int _faceVertsFirst  : 1;
         unsigned int _minimalTopology : 1;
+        unsigned int _useThreads      : 1;
 
         //  Still under consideration:
         //unsigned int _childToParentMap : 1;
@@ -159,6 +169,9 @@ public:
 
     Index getChildVertexParentIndex(Index v) const  { return _childVertexParentIndex[v]; }
 
+    //  Adds the vectors of the refinement and its face-varying channels to a breakdown:
+    virtual void getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const;
+
 //
 //  Modifiers intended for internal/protected use:
 //
@@ -340,6 +353,7 @@ protected:
     //  Determined by the refinement options:
     bool _uniform;
     bool _faceVertsFirst;
+    bool _useThreads;
 
     //
     //  Inventory and ordering of the types of child components:
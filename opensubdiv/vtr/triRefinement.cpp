@@ -132,6 +132,9 @@ TriRefinement::populateFaceVertexCountsAndOffsets() {
 
     _child->_faceVertCountsAndOffsets.resize(_child->getNumFaces() * 2, 3);
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (int i = 0; i < _child->getNumFaces(); ++i) {
         _child->_faceVertCountsAndOffsets[i*2 + 1] = i * 3;
     }
@@ -140,7 +143,10 @@ TriRefinement::populateFaceVertexCountsAndOffsets() {
 void
 TriRefinement::populateFaceVerticesFromParentFaces() {
 
-   for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
+    for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
                         pFaceChildren = getFaceChildFaces(pFace);
@@ -216,6 +222,9 @@ TriRefinement::populateFaceEdgeRelation() {
 void
 TriRefinement::populateFaceEdgesFromParentFaces() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceVerts = _parent->getFaceVertices(pFace),
                         pFaceEdges = _parent->getFaceEdges(pFace),
@@ -288,6 +297,9 @@ TriRefinement::populateEdgeVertexRelation() {
 void
 TriRefinement::populateEdgeVerticesFromParentFaces() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (Index pFace = 0; pFace < _parent->getNumFaces(); ++pFace) {
         ConstIndexArray pFaceEdges      = _parent->getFaceEdges(pFace),
                         pFaceChildEdges = getFaceChildEdges(pFace);
@@ -324,6 +336,9 @@ TriRefinement::populateEdgeVerticesFromParentFaces() {
 void
 TriRefinement::populateEdgeVerticesFromParentEdges() {
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #pragma omp parallel for if (_useThreads)
+#endif
     for (Index pEdge = 0; pEdge < _parent->getNumEdges(); ++pEdge) {
         ConstIndexArray pEdgeVerts      = _parent->getEdgeVertices(pEdge),
                         pEdgeChildEdges = getEdgeChildEdges(pEdge);
@@ -923,6 +938,15 @@ TriRefinement::markSparseFaceChildren() {
     }
 }
 
+void
+TriRefinement::getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const {
+
+    Refinement::getMemoryUsage(usage, prefix);
+
+    usage.Add(prefix + "faceChildFaceCountsAndOffsets",
+              _localFaceChildFaceCountsAndOffsets);
+}
+
 } // end namespace internal
 } // end namespace Vtr
 
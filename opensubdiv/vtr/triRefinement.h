@@ -47,6 +47,8 @@ public:
     TriRefinement(Level const & parent, Level & child, Sdc::Options const & options);
     ~TriRefinement();
 
+    virtual void getMemoryUsage(MemoryUsage & usage, std::string const & prefix) const;
+
 protected:
     //
     //  Virtual methods to complete the configuration of the parent-to-child mapping:
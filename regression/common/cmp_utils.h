@@ -157,7 +157,12 @@ GetReorderedHbrVertexData(
                     assert(v->GetParentVertex());
                 }
 
-                // populate child edges
+                // populate child edges (only used to refine the next level:
+                // Hbr does not refine holes, and the edges of the last level
+                // may be missing in the faces that were made holes by edits)
+                if (level == refiner.GetMaxLevel()) {
+                    continue;
+                }
                 for (int edge=0; edge < refLevel.GetNumEdges(); ++edge) {
 
                     ConstIndexArray farVerts = refLevel.GetEdgeVertices(edge);
@@ -135,6 +135,120 @@ InterpolateFVarData(OpenSubdiv::Far::TopologyRefiner & refiner,
 
 //------------------------------------------------------------------------------
 
+inline void
+GetHierarchicalEdits(Shape const & shape,
+    OpenSubdiv::Far::HierarchicalEdits & edits) {
+
+    typedef OpenSubdiv::Far::HierarchicalEdits HierarchicalEdits;
+
+    edits.Clear();
+
+    for (int i=0; i<(int)shape.tags.size(); ++i) {
+
+        Shape::tag * t = shape.tags[i];
+
+        if (t->name=="vertexedit" || t->name=="edgeedit") {
+
+            // Each operation is a triplet of strings: modifier, variable
+            // and operation (only "P" values and sharpness are supported)
+            int floatstride = 0;
+            std::vector<HierarchicalEdits::Operation> ops;
+            std::vector<bool> isSharpness;
+            std::vector<int> floatwidths;
+
+            for (int j=0; j+2<(int)t->stringargs.size(); j+=3) {
+                std::string const & opmodifiername = t->stringargs[j],
+                                  & varname = t->stringargs[j+1],
+                                  & opname = t->stringargs[j+2];
+
+                HierarchicalEdits::Operation op = HierarchicalEdits::SET;
+                if (opmodifiername=="set") {
+                    op = HierarchicalEdits::SET;
+                } else if (opmodifiername=="add") {
+                    op = HierarchicalEdits::ADD;
+                } else if (opmodifiername=="subtract") {
+                    op = HierarchicalEdits::SUBTRACT;
+                } else {
+                    printf("invalid modifier %s\n", opmodifiername.c_str());
+                    continue;
+                }
+
+                if ((t->name=="vertexedit" && opname=="value") || opname=="sharpness") {
+                    if (varname != "P") continue;
+
+                    // assuming width of P == 3
+                    int width = opname=="sharpness" ? 1 : 3;
+                    floatstride += width;
+
+                    ops.push_back(op);
+                    isSharpness.push_back(opname=="sharpness");
+                    floatwidths.push_back(width);
+                } else {
+                    printf("%s tag specifies invalid operation '%s %s'\n",
+                        t->name.c_str(), opmodifiername.c_str(), opname.c_str());
+                }
+            }
+
+            int floatoffset = 0;
+            for (int j=0; j<(int)ops.size(); ++j) {
+                int floatidx = floatoffset;
+                for (int k=0; k+1<(int)t->intargs.size(); ) {
+                    int pathlength = t->intargs[k],
+                        faceid = t->intargs[k+1],
+                        vertexid = t->intargs[k+pathlength],
+                        nsubfaces = pathlength - 2;
+                    int const * subfaces = &t->intargs[k+2];
+
+                    if (! isSharpness[j]) {
+                        edits.AddVertexEdit(faceid, nsubfaces, subfaces,
+                            (OpenSubdiv::Far::LocalIndex)vertexid, ops[j],
+                                &t->floatargs[floatidx], floatwidths[j]);
+                    } else if (t->name=="vertexedit") {
+                        edits.AddVertexSharpnessEdit(faceid, nsubfaces, subfaces,
+                            (OpenSubdiv::Far::LocalIndex)vertexid, ops[j],
+                                t->floatargs[floatidx]);
+                    } else {
+                        edits.AddEdgeSharpnessEdit(faceid, nsubfaces, subfaces,
+                            (OpenSubdiv::Far::LocalIndex)vertexid, ops[j],
+                                t->floatargs[floatidx]);
+                    }
+
+                    // Advance to the next path and its float data
+                    k += pathlength + 1;
+                    floatidx += floatstride;
+                }
+                floatoffset += floatwidths[j];
+            }
+        } else if (t->name=="faceedit") {
+
+            int nint = (int)t->intargs.size();
+            for (int k=0; k<nint; ) {
+                int pathlength = t->intargs[k];
+                if (k+pathlength>=nint) {
+                    printf("Invalid path length for %s tag\n", t->name.c_str());
+                    break;
+                }
+
+                int faceid = t->intargs[k+1],
+                    nsubfaces = pathlength - 1;
+                int const * subfaces = &t->intargs[k+2];
+
+                for (int l=0; l<(int)t->stringargs.size(); ++l) {
+                    if (t->stringargs[l]=="hole") {
+                        edits.AddHoleEdit(faceid, nsubfaces, subfaces);
+                    } else {
+                        printf("Faceedit tag specifies unsupported operation '%s'\n",
+                            t->stringargs[l].c_str());
+                    }
+                }
+                k += pathlength + 1;
+            }
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+
 template <class T>
 OpenSubdiv::Far::TopologyRefiner *
 InterpolateFarVertexData(Shape const & shape, int maxlevel, std::vector<T> &data) {
@@ -149,6 +263,12 @@ InterpolateFarVertexData(Shape const & shape, int maxlevel, std::vector<T> &data
                 GetSdcType(shape), GetSdcOptions(shape)));
     assert(refiner);
 
+    OpenSubdiv::Far::HierarchicalEdits edits;
+    GetHierarchicalEdits(shape, edits);
+    if (! edits.IsEmpty()) {
+        refiner->SetHierarchicalEdits(edits);
+    }
+
     FarTopologyRefiner::UniformOptions options(maxlevel);
     options.fullTopologyInLastLevel=true;
     refiner->RefineUniform(options);
@@ -161,12 +281,21 @@ InterpolateFarVertexData(Shape const & shape, int maxlevel, std::vector<T> &data
                             shape.verts[i*3+2]);
     }
 
+    // vertex edits (positions only)
+    std::vector<T> editValues(edits.GetNumVertexEdits());
+    for (int i=0; i<edits.GetNumVertexEdits(); ++i) {
+        float const * value = edits.GetVertexEditValues(i);
+        editValues[i].SetPosition(value[0], value[1], value[2]);
+    }
+
     T * srcVerts = &data[0];
     T * dstVerts = srcVerts + refiner->GetLevel(0).GetNumVertices();
     OpenSubdiv::Far::PrimvarRefiner primvarRefiner(*refiner);
 
+    primvarRefiner.ApplyVertexEdits(0, editValues, srcVerts);
     for (int i = 1; i <= refiner->GetMaxLevel(); ++i) {
         primvarRefiner.Interpolate(i, srcVerts, dstVerts);
+        primvarRefiner.ApplyVertexEdits(i, editValues, dstVerts);
         srcVerts = dstVerts;
         dstVerts += refiner->GetLevel(i).GetNumVertices();
     }
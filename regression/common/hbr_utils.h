@@ -650,17 +650,22 @@ interpolateHbrVertexData(Shape const * sh, int maxlevel) {
 
     for (int level=0, firstface=0; level<maxlevel; ++level ) {
         int nfaces = hmesh->GetNumFaces();
-        for (int i=firstface; i<nfaces; ++i) {
+        for (int i=firstface; i<hmesh->GetNumFaces(); ++i) {
 
             OpenSubdiv::HbrFace<T> * f = hmesh->GetFace(i);
-            assert(f->GetDepth()==level);
-            if (! f->IsHole()) {
+            // Hierarchical edits make Hbr refine faces out of order (the
+            // ancestors of the edited faces and their neighbors), so only the
+            // faces of the current level are refined, including those added
+            // during this pass.
+            if (f->GetDepth()==level && ! f->IsHole()) {
                 f->Refine();
             }
         }
         // Hbr allocates faces sequentially, skip faces that have already been
-        // refined.
-        firstface = nfaces;
+        // refined (all of them when there are no edits).
+        while (firstface<nfaces && hmesh->GetFace(firstface)->GetDepth()<=level) {
+            ++firstface;
+        }
     }
     return hmesh;
 }
@@ -22,14 +22,20 @@
 //   language governing permissions and limitations under the Apache License.
 //
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cstdlib>
 #include <fstream>
+#include <map>
 #include <sstream>
 
+#include <opensubdiv/far/limitEvaluator.h>
+#include <opensubdiv/far/patchBVH.h>
 #include <opensubdiv/far/primvarRefiner.h>
 #include <opensubdiv/far/stencilTableFactory.h>
 #include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/serializer.h>
 #include "../../regression/common/far_utils.h"
 // XXX: revisit the directory structure for examples/tests
 #include "../../examples/common/stopwatch.h"
@@ -37,8 +43,95 @@
 #include "init_shapes.h"
 
 //------------------------------------------------------------------------------
+// Vertex container implementation.
+//
+struct Vertex {
+
+    void Clear( void * =0 ) {
+        _position[0]=_position[1]=_position[2]=0.0f;
+    }
+
+    void AddWithWeight(Vertex const & src, float weight) {
+        _position[0]+=weight*src._position[0];
+        _position[1]+=weight*src._position[1];
+        _position[2]+=weight*src._position[2];
+    }
+
+    float _position[3];
+};
+
+//------------------------------------------------------------------------------
+static double
+timeUpdateValues(OpenSubdiv::Far::StencilTable const * stencils,
+                 std::vector<Vertex> const & controlValues, int numRepeats)
+{
+    std::vector<Vertex> values(stencils->GetNumStencils());
+
+    Stopwatch s;
+    s.Start();
+    for (int i = 0; i < numRepeats; ++i) {
+        stencils->UpdateValues(&controlValues[0], &values[0]);
+    }
+    s.Stop();
+    return s.GetElapsed() / numRepeats;
+}
+
+//------------------------------------------------------------------------------
+static double
+toMB(size_t bytes) {
+    return (double)bytes / (1024.0 * 1024.0);
+}
+
+// Prints the memory used by each level and refinement of a refiner and the
+// relations that use the most memory over all the levels
 static void
-doPerf(const Shape *shape, int maxlevel, int endCapType)
+printRefinerMemoryUsage(OpenSubdiv::Far::TopologyRefiner const & refiner)
+{
+    using namespace OpenSubdiv;
+
+    Far::MemoryUsage usage;
+    size_t total = refiner.GetMemoryUsage(&usage);
+
+    printf("TopologyRefiner memory      %.2f MB\n", toMB(total));
+    for (int level = 0; level < refiner.GetNumLevels(); ++level) {
+        std::string levelName =
+            Far::MemoryUsage::GetIndexedName("level", level);
+        std::string refinementName =
+            Far::MemoryUsage::GetIndexedName("refinement", level);
+        printf("  level %-2d %6.2f MB (fvar %.2f MB)",
+               level, toMB(usage.GetTotal(levelName)),
+               toMB(usage.GetTotal(levelName + "fvar")));
+        if (level < refiner.GetMaxLevel()) {
+            printf("  refinement %6.2f MB",
+                   toMB(usage.GetTotal(refinementName)));
+        }
+        printf("\n");
+    }
+
+    // total of each relation over all the levels
+    std::map<std::string, size_t> relations;
+    for (int i = 0; i < usage.GetNumComponents(); ++i) {
+        std::string const & name = usage.GetComponent(i).name;
+        std::string group = name.substr(0, name.find('['));
+        relations[group + "/" + name.substr(name.rfind('/') + 1)] +=
+            usage.GetComponent(i).bytes;
+    }
+    std::vector<std::pair<size_t, std::string> > largest;
+    for (std::map<std::string, size_t>::const_iterator it = relations.begin();
+         it != relations.end(); ++it) {
+        largest.push_back(std::make_pair(it->second, it->first));
+    }
+    std::sort(largest.rbegin(), largest.rend());
+    for (int i = 0; i < std::min(5, (int)largest.size()); ++i) {
+        printf("  %-32s %6.2f MB\n", largest[i].second.c_str(),
+               toMB(largest[i].first));
+    }
+}
+
+//------------------------------------------------------------------------------
+static void
+doPerf(const Shape *shape, int maxlevel, int endCapType, bool useThreads,
+       bool reorder)
 {
     using namespace OpenSubdiv;
 
@@ -52,10 +145,15 @@ doPerf(const Shape *shape, int maxlevel, int endCapType)
     // ----------------------------------------------------------------------
     // Instantiate a FarTopologyRefiner from the descriptor and refine
     s.Start();
-    Far::TopologyRefiner * refiner = Far::TopologyRefinerFactory<Shape>::Create(
-        *shape, Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
+    Far::TopologyRefiner * refiner = 0;
+    {
+        Far::TopologyRefinerFactory<Shape>::Options options(type, sdcOptions);
+        options.useThreads = useThreads;
+        refiner = Far::TopologyRefinerFactory<Shape>::Create(*shape, options);
+    }
     {
         Far::TopologyRefiner::AdaptiveOptions options(maxlevel);
+        options.useThreads = useThreads;
         refiner->RefineAdaptive(options);
     }
 
@@ -68,6 +166,7 @@ doPerf(const Shape *shape, int maxlevel, int endCapType)
     Far::StencilTable const * vertexStencils = NULL;
     {
         Far::StencilTableFactory::Options options;
+        options.useThreads = useThreads;
         vertexStencils = Far::StencilTableFactory::Create(*refiner, options);
     }
     s.Stop();
@@ -80,6 +179,7 @@ doPerf(const Shape *shape, int maxlevel, int endCapType)
     {
         Far::PatchTableFactory::Options poptions(maxlevel);
         poptions.SetEndCapType((Far::PatchTableFactory::Options::EndCapType)endCapType);
+        poptions.useThreads = useThreads;
         patchTable = Far::PatchTableFactory::Create(*refiner, poptions);
     }
 
@@ -113,6 +213,280 @@ doPerf(const Shape *shape, int maxlevel, int endCapType)
     printf("StencilTableFactory::Append %f %5.2f%%\n",
            timeAppendStencil, timeAppendStencil/timeTotal*100);
     printf("Total                       %f\n", timeTotal);
+
+    // ---------------------------------------------------------------------
+    // Memory used by the refiner and the tables
+    printRefinerMemoryUsage(*refiner);
+    printf("StencilTable memory         %.2f MB\n",
+           toMB(vertexStencils->GetMemoryUsage()));
+    {
+        Far::MemoryUsage usage;
+        size_t total = patchTable->GetMemoryUsage(&usage);
+        printf("PatchTable memory           %.2f MB (local point stencils "
+               "%.2f MB)\n", toMB(total),
+               toMB(usage.GetTotal("localPoint")));
+    }
+
+    // ---------------------------------------------------------------------
+    // Read the tables back from their serialization
+    {
+        std::vector<unsigned char> stencilRecord, patchRecord;
+        Far::Serializer::WriteStencilTable(*vertexStencils, stencilRecord);
+        Far::Serializer::WritePatchTable(*patchTable, patchRecord);
+
+        s.Start();
+        Far::StencilTable const * readStencils =
+            Far::Serializer::ReadStencilTable(
+                &stencilRecord[0], stencilRecord.size());
+        Far::PatchTable const * readPatchTable =
+            Far::Serializer::ReadPatchTable(
+                &patchRecord[0], patchRecord.size());
+        s.Stop();
+        double timeRead = s.GetElapsed();
+
+        printf("Serializer::Read            %f (%.2f MB, x %.1f)\n", timeRead,
+               (double)(stencilRecord.size() + patchRecord.size()) /
+                   (1024.0 * 1024.0),
+               timeTotal / timeRead);
+
+        delete readStencils;
+        delete readPatchTable;
+    }
+
+    // ---------------------------------------------------------------------
+    // Evaluate the stencils, optionally reordered for cache locality
+    int const numRepeats = 10;
+
+    std::vector<Vertex> controlValues(vertexStencils->GetNumControlVertices());
+    for (int i = 0; i < (int)controlValues.size(); ++i) {
+        controlValues[i]._position[0] = shape->verts[i*3+0];
+        controlValues[i]._position[1] = shape->verts[i*3+1];
+        controlValues[i]._position[2] = shape->verts[i*3+2];
+    }
+
+    double timeUpdate =
+        timeUpdateValues(vertexStencils, controlValues, numRepeats);
+    printf("StencilTable::UpdateValues  %f\n", timeUpdate);
+
+    // ---------------------------------------------------------------------
+    // Interpolate the same values level by level
+    {
+        Far::PrimvarRefiner::Options options;
+        options.useThreads = useThreads;
+        Far::PrimvarRefiner primvarRefiner(*refiner, options);
+
+        std::vector<Vertex> values(refiner->GetNumVerticesTotal());
+        std::copy(controlValues.begin(), controlValues.end(), values.begin());
+
+        s.Start();
+        for (int i = 0; i < numRepeats; ++i) {
+            Vertex * src = &values[0];
+            for (int level = 1; level <= refiner->GetMaxLevel(); ++level) {
+                Vertex * dst = src + refiner->GetLevel(level-1).GetNumVertices();
+                primvarRefiner.Interpolate(level, src, dst);
+                src = dst;
+            }
+        }
+        s.Stop();
+        printf("PrimvarRefiner::Interpolate %f\n", s.GetElapsed() / numRepeats);
+    }
+
+    // ---------------------------------------------------------------------
+    // Evaluate random limit locations, in their order and sorted by patch
+    {
+        int numControlVerts = vertexStencils->GetNumControlVertices(),
+            numLocations = 64 * patchTable->GetNumPtexFaces();
+
+        std::vector<Vertex> points(numControlVerts +
+                                   vertexStencils->GetNumStencils());
+        std::copy(controlValues.begin(), controlValues.end(), points.begin());
+        vertexStencils->UpdateValues(&controlValues[0],
+                                     &points[numControlVerts]);
+
+        srand(0);
+        std::vector<int> faces(numLocations);
+        std::vector<float> u(numLocations), v(numLocations);
+        for (int i = 0; i < numLocations; ++i) {
+            faces[i] = rand() % patchTable->GetNumPtexFaces();
+            u[i] = (float)rand() / (float)RAND_MAX;
+            v[i] = (float)rand() / (float)RAND_MAX;
+        }
+
+        Far::PatchMap patchMap(*patchTable);
+        std::vector<float> P(numLocations * 3), dPdu(numLocations * 3),
+                           dPdv(numLocations * 3);
+
+        // (best of a few evaluations)
+        double timeEvaluate[2] = { 0.0, 0.0 };
+        for (int pass = 0; pass < 10; ++pass) {
+            Far::LimitEvaluator::Options options;
+            options.sortLocations = (pass & 1);
+            options.useThreads = useThreads;
+
+            s.Start();
+            Far::LimitEvaluator::Evaluate(*patchTable, patchMap, numLocations,
+                &faces[0], &u[0], &v[0], points[0]._position, 3,
+                (int)(sizeof(Vertex) / sizeof(float)),
+                &P[0], &dPdu[0], &dPdv[0], 0, 0, 0, options);
+            s.Stop();
+            double & time = timeEvaluate[pass & 1];
+            time = (pass < 2) ? s.GetElapsed() : std::min(time, s.GetElapsed());
+        }
+        printf("LimitEvaluator::Evaluate    %f (%d locations)\n",
+               timeEvaluate[0], numLocations);
+        printf("LimitEvaluator::Evaluate    %f (sorted by patch, x %.2f)\n",
+               timeEvaluate[1], timeEvaluate[0] / timeEvaluate[1]);
+    }
+
+    // ---------------------------------------------------------------------
+    // Locate random limit locations with a patch map, one at a time and as
+    // batches of locations sorted by face
+    {
+        int numLocations = 64 * patchTable->GetNumPtexFaces();
+
+        s.Start();
+        Far::PatchMap patchMap(*patchTable);
+        s.Stop();
+        double timeCreateMap = s.GetElapsed();
+
+        srand(0);
+        std::vector<int> faces(numLocations);
+        std::vector<float> u(numLocations), v(numLocations);
+        for (int i = 0; i < numLocations; ++i) {
+            faces[i] = rand() % patchTable->GetNumPtexFaces();
+            u[i] = (float)rand() / (float)RAND_MAX;
+            v[i] = (float)rand() / (float)RAND_MAX;
+        }
+
+        std::vector<Far::PatchMap::Handle const *> handles(numLocations);
+
+        s.Start();
+        for (int i = 0; i < numLocations; ++i) {
+            handles[i] = patchMap.FindPatch(faces[i], u[i], v[i]);
+        }
+        s.Stop();
+        double timeFind = s.GetElapsed();
+
+        // the same locations sorted by face
+        std::vector<int> sortedFaces(faces);
+        std::sort(sortedFaces.begin(), sortedFaces.end());
+
+        s.Start();
+        patchMap.FindPatches(numLocations, &sortedFaces[0], &u[0], &v[0],
+                             &handles[0]);
+        s.Stop();
+        double timeFindSorted = s.GetElapsed();
+
+        printf("PatchMap::PatchMap          %f (%.2f MB)\n", timeCreateMap,
+               toMB(patchMap.GetMemoryUsage()));
+        printf("PatchMap::FindPatch         %f (%d locations)\n",
+               timeFind, numLocations);
+        printf("PatchMap::FindPatches       %f (sorted by face, x %.2f)\n",
+               timeFindSorted, timeFind / timeFindSorted);
+    }
+
+    // ---------------------------------------------------------------------
+    // Build and refit a patch BVH, then find the closest limit points of
+    // random points and the first hits of random rays through the mesh
+    {
+        int numControlVerts = vertexStencils->GetNumControlVertices(),
+            numQueries = 16 * patchTable->GetNumPtexFaces(),
+            stride = (int)(sizeof(Vertex) / sizeof(float));
+
+        std::vector<Vertex> points(numControlVerts +
+                                   vertexStencils->GetNumStencils());
+        std::copy(controlValues.begin(), controlValues.end(), points.begin());
+        vertexStencils->UpdateValues(&controlValues[0],
+                                     &points[numControlVerts]);
+
+        float const * controlPoints = points[0]._position;
+
+        s.Start();
+        Far::PatchBVH bvh(*patchTable, controlPoints, stride);
+        s.Stop();
+        double timeBuild = s.GetElapsed();
+
+        s.Start();
+        bvh.Refit(controlPoints, stride);
+        s.Stop();
+        double timeRefit = s.GetElapsed();
+
+        float lo[3], hi[3];
+        for (int k = 0; k < 3; ++k) {
+            lo[k] = hi[k] = controlValues[0]._position[k];
+            for (int i = 1; i < (int)controlValues.size(); ++i) {
+                lo[k] = std::min(lo[k], controlValues[i]._position[k]);
+                hi[k] = std::max(hi[k], controlValues[i]._position[k]);
+            }
+        }
+
+        srand(0);
+        std::vector<float> queries(numQueries * 3);
+        for (int i = 0; i < numQueries * 3; ++i) {
+            float r = (float)rand() / (float)RAND_MAX;
+            queries[i] = lo[i % 3] + r * (hi[i % 3] - lo[i % 3]);
+        }
+
+        Far::PatchBVH::Hit hit;
+
+        s.Start();
+        for (int i = 0; i < numQueries; ++i) {
+            bvh.FindClosestPoint(&queries[i * 3], controlPoints, stride, hit);
+        }
+        s.Stop();
+        double timeClosest = s.GetElapsed();
+
+        // rays from the random points through the center of the mesh
+        int numHits = 0;
+        s.Start();
+        for (int i = 0; i < numQueries; ++i) {
+            float const * origin = &queries[i * 3];
+            float direction[3] = { 0.5f * (lo[0] + hi[0]) - origin[0],
+                                   0.5f * (lo[1] + hi[1]) - origin[1],
+                                   0.5f * (lo[2] + hi[2]) - origin[2] };
+            numHits += bvh.Intersect(origin, direction, controlPoints, stride,
+                                     hit);
+        }
+        s.Stop();
+        double timeIntersect = s.GetElapsed();
+
+        printf("PatchBVH::PatchBVH          %f (%d nodes, %.2f MB)\n",
+               timeBuild, bvh.GetNumNodes(), toMB(bvh.GetMemoryUsage()));
+        printf("PatchBVH::Refit             %f\n", timeRefit);
+        printf("PatchBVH::FindClosestPoint  %f (%d points)\n",
+               timeClosest, numQueries);
+        printf("PatchBVH::Intersect         %f (%d rays, %d hits)\n",
+               timeIntersect, numQueries, numHits);
+    }
+
+    if (reorder) {
+        std::vector<Far::Index> controlVertPermutation;
+
+        s.Start();
+        Far::StencilTable const * reorderedStencils =
+            Far::StencilTableFactory::Reorder(*vertexStencils,
+                NULL, &controlVertPermutation);
+        s.Stop();
+        double timeReorder = s.GetElapsed();
+
+        std::vector<Vertex> reorderedValues(controlValues.size());
+        for (int i = 0; i < (int)reorderedValues.size(); ++i) {
+            reorderedValues[i] = controlValues[controlVertPermutation[i]];
+        }
+
+        double timeUpdateReordered =
+            timeUpdateValues(reorderedStencils, reorderedValues, numRepeats);
+
+        printf("StencilTableFactory::Reorder %f\n", timeReorder);
+        printf("StencilTable::UpdateValues  %f (reordered, x %.2f)\n",
+               timeUpdateReordered, timeUpdate/timeUpdateReordered);
+
+        delete reorderedStencils;
+    }
+
+    delete vertexStencils;
+    delete patchTable;
+    delete refiner;
 }
 
 //------------------------------------------------------------------------------
@@ -123,6 +497,8 @@ int main(int argc, char **argv)
     int maxlevel = 8;
     std::string str;
     int endCapType = Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
+    bool useThreads = false;
+    bool reorder = false;
 
     for (int i = 1; i < argc; ++i) {
         if (strstr(argv[i], ".obj")) {
@@ -138,6 +514,12 @@ int main(int argc, char **argv)
         else if (!strcmp(argv[i], "-l")) {
             maxlevel = atoi(argv[++i]);
         }
+        else if (!strcmp(argv[i], "-t")) {
+            useThreads = true;
+        }
+        else if (!strcmp(argv[i], "-r")) {
+            reorder = true;
+        }
         else if (!strcmp(argv[i], "-e")) {
             const char *type = argv[++i];
             if (!strcmp(type, "bspline")) {
@@ -163,7 +545,7 @@ int main(int argc, char **argv)
 
         for (int lv = 1; lv <= maxlevel; ++lv) {
             printf("---- %s, level %d ----\n", g_shapes[i].name.c_str(), lv);
-            doPerf(shape, lv, endCapType);
+            doPerf(shape, lv, endCapType, useThreads, reorder);
         }
     }
 }
@@ -22,9 +22,22 @@
 //   language governing permissions and limitations under the Apache License.
 //
 
+#include <algorithm>
 #include <cassert>
 #include <cstdio>
+#include <cmath>
+#include <cstring>
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+#endif
+
+#include <far/faceRegion.h>
+#include <far/limitEvaluator.h>
+#include <far/patchBVH.h>
+#include <far/patchTableFactory.h>
+#include <far/serializer.h>
+#include <far/stencilTableFactory.h>
 
 #include "../../regression/common/hbr_utils.h"
 #include "../../regression/common/far_utils.h"
@@ -255,20 +268,7 @@ isBaseMeshNonManifold(FarTopologyRefiner const & refiner) {
 }
 
 static bool
-shapeHasHierarchicalEditTags(Shape const & shape) {
-
-    for (int i = 0; i < (int)shape.tags.size(); ++i) {
-        Shape::tag const & tag = *shape.tags[i];
-
-        if ((tag.name == "vertexedit") || (tag.name == "edgeedit") || (tag.name == "faceedit")) {
-            return true;
-        }
-    }
-    return false;
-}
-
-static bool
-areVerticesCompatibleWithHbr(Shape const & shape, FarTopologyRefiner const & refiner,
+areVerticesCompatibleWithHbr(FarTopologyRefiner const & refiner,
                              std::string * incompatibleString = 0)
 {
     //
@@ -276,8 +276,6 @@ areVerticesCompatibleWithHbr(Shape const & shape, FarTopologyRefiner const & ref
     //   - non-manifold features -- Hbr does not support them
     //   - very high-valence vertex -- accumulation of Hbr inaccuracies becomes considerable
     //   - Chaikin creasing -- Hbr known to be incorrect
-    //   - hierarchical edits -- not supported by FarTopologyRefiner
-    //       - Shape will include tags "vertexedit", "edgeedit" and "faceedit"
     //
     if (isBaseMeshNonManifold(refiner)) {
         if (incompatibleString) {
@@ -297,15 +295,1549 @@ areVerticesCompatibleWithHbr(Shape const & shape, FarTopologyRefiner const & ref
         }
         return false;
     }
-    if (shapeHasHierarchicalEditTags(shape)) {
-        if (incompatibleString) {
-            *incompatibleString = std::string("hierarchical edits no longer supported");
+    return true;
+}
+
+//------------------------------------------------------------------------------
+template <class T>
+static bool
+isBitwiseEqual(std::vector<T> const & a, std::vector<T> const & b) {
+    return (a.size()==b.size()) &&
+        (a.empty() || memcmp(&a[0], &b[0], a.size()*sizeof(T))==0);
+}
+
+static int
+compareThreadedStencils(FarTopologyRefiner const & refiner) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+
+    // Stencils factorized concurrently must match the serial ones exactly
+    // (skip high valence poles, which are very expensive to factorize)
+    int failures = 0;
+    if (refiner.GetMaxValence() > 64) {
+        return failures;
+    }
+
+    for (int mode=0; mode<3; ++mode) {
+        if (mode==FarStencilTableFactory::INTERPOLATE_FACE_VARYING &&
+            refiner.GetNumFVarChannels()==0) {
+            continue;
+        }
+
+        FarStencilTableFactory::Options options;
+        options.interpolationMode = mode;
+        options.generateOffsets = true;
+        options.maxLevel = 3;
+
+        FarStencilTable const * serial =
+            FarStencilTableFactory::Create(refiner, options);
+
+        options.useThreads = true;
+        FarStencilTable const * threaded =
+            FarStencilTableFactory::Create(refiner, options);
+
+        if (! (isBitwiseEqual(serial->GetSizes(), threaded->GetSizes()) &&
+               isBitwiseEqual(serial->GetOffsets(), threaded->GetOffsets()) &&
+               isBitwiseEqual(serial->GetControlIndices(), threaded->GetControlIndices()) &&
+               isBitwiseEqual(serial->GetWeights(), threaded->GetWeights()))) {
+            printf("  threaded stencils (mode %d) differ from serial ones\n", mode);
+            ++failures;
+        }
+        delete serial;
+        delete threaded;
+    }
+    return failures;
+}
+
+template <class ARRAY>
+static void
+appendArray(ARRAY const & array, std::vector<int> & data) {
+    data.push_back(array.size());
+    for (int i=0; i<array.size(); ++i) {
+        data.push_back(array[i]);
+    }
+}
+
+static void
+getRefinedTopology(FarTopologyRefiner const & refiner,
+    std::vector<int> & topology, std::vector<float> & sharpness) {
+
+    typedef OpenSubdiv::Far::TopologyLevel FarTopologyLevel;
+
+    for (int level=0; level<refiner.GetNumLevels(); ++level) {
+        FarTopologyLevel const & refLevel = refiner.GetLevel(level);
+
+        for (int f=0; f<refLevel.GetNumFaces(); ++f) {
+            appendArray(refLevel.GetFaceVertices(f), topology);
+            appendArray(refLevel.GetFaceEdges(f), topology);
+            topology.push_back(refLevel.IsFaceHole(f));
+            if (level > 0) {
+                topology.push_back(refLevel.GetFaceParentFace(f));
+            }
         }
+        for (int e=0; e<refLevel.GetNumEdges(); ++e) {
+            appendArray(refLevel.GetEdgeVertices(e), topology);
+            appendArray(refLevel.GetEdgeFaces(e), topology);
+            appendArray(refLevel.GetEdgeFaceLocalIndices(e), topology);
+            topology.push_back(refLevel.IsEdgeBoundary(e));
+            topology.push_back(refLevel.IsEdgeNonManifold(e));
+            sharpness.push_back(refLevel.GetEdgeSharpness(e));
+        }
+        for (int v=0; v<refLevel.GetNumVertices(); ++v) {
+            appendArray(refLevel.GetVertexFaces(v), topology);
+            appendArray(refLevel.GetVertexFaceLocalIndices(v), topology);
+            appendArray(refLevel.GetVertexEdges(v), topology);
+            appendArray(refLevel.GetVertexEdgeLocalIndices(v), topology);
+            topology.push_back(refLevel.IsVertexBoundary(v));
+            topology.push_back(refLevel.IsVertexNonManifold(v));
+            topology.push_back(refLevel.GetVertexRule(v));
+            sharpness.push_back(refLevel.GetVertexSharpness(v));
+        }
+        for (int c=0; c<refLevel.GetNumFVarChannels(); ++c) {
+            for (int f=0; f<refLevel.GetNumFaces(); ++f) {
+                appendArray(refLevel.GetFaceFVarValues(f, c), topology);
+            }
+        }
+    }
+}
+
+static int
+compareThreadedRefinement(Shape const & shape) {
+
+    // Base levels constructed and levels refined concurrently must match the
+    // serial ones exactly, for both uniform and adaptive refinement
+    int failures = 0;
+    for (int adaptive=0; adaptive<2; ++adaptive) {
+        if (adaptive && shape.scheme == kBilinear) {
+            continue;
+        }
+
+        std::vector<int>   topology[2];
+        std::vector<float> sharpness[2];
+        for (int threaded=0; threaded<2; ++threaded) {
+            FarTopologyRefinerFactory::Options factoryOptions(
+                GetSdcType(shape), GetSdcOptions(shape));
+            factoryOptions.useThreads = threaded;
+
+            FarTopologyRefiner * refiner =
+                FarTopologyRefinerFactory::Create(shape, factoryOptions);
+
+            if (adaptive) {
+                FarTopologyRefiner::AdaptiveOptions options(3);
+                options.useThreads = threaded;
+                refiner->RefineAdaptive(options);
+            } else {
+                FarTopologyRefiner::UniformOptions options(3);
+                options.fullTopologyInLastLevel = true;
+                options.useThreads = threaded;
+                refiner->RefineUniform(options);
+            }
+            getRefinedTopology(*refiner, topology[threaded], sharpness[threaded]);
+            delete refiner;
+        }
+
+        if (! (isBitwiseEqual(topology[0], topology[1]) &&
+               isBitwiseEqual(sharpness[0], sharpness[1]))) {
+            printf("  threaded construction and %s refinement differ from serial ones\n",
+                adaptive ? "adaptive" : "uniform");
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+template <class T>
+static void
+interpolatePrimvars(FarTopologyRefiner const & refiner, bool threaded,
+    std::vector<T> const & coarse, std::vector<T> & data, int channel) {
+
+    // Interpolates all the levels followed by the limit (with tangents), for
+    // vertex data or for the values of a face-varying channel
+    typedef OpenSubdiv::Far::PrimvarRefiner FarPrimvarRefiner;
+
+    FarPrimvarRefiner::Options options;
+    options.useThreads = threaded;
+    FarPrimvarRefiner primvarRefiner(refiner, options);
+
+    int maxlevel = refiner.GetMaxLevel();
+
+    std::vector<T> src(coarse), dst;
+    data.clear();
+    for (int level=1; level<=maxlevel; ++level) {
+        FarTopologyLevel const & refLevel = refiner.GetLevel(level);
+        if (channel < 0) {
+            dst.resize(refLevel.GetNumVertices());
+            primvarRefiner.Interpolate(level, src, dst);
+        } else {
+            dst.resize(refLevel.GetNumFVarValues(channel));
+            primvarRefiner.InterpolateFaceVarying(level, src, dst, channel);
+        }
+        data.insert(data.end(), dst.begin(), dst.end());
+        src.swap(dst);
+    }
+
+    if (channel < 0) {
+        std::vector<T> pos(src.size()), tan1(src.size()), tan2(src.size());
+        primvarRefiner.Limit(src, pos, tan1, tan2);
+        data.insert(data.end(), pos.begin(), pos.end());
+        data.insert(data.end(), tan1.begin(), tan1.end());
+        data.insert(data.end(), tan2.begin(), tan2.end());
+
+        src.assign(coarse.begin(), coarse.end());
+        dst.resize(refiner.GetLevel(1).GetNumVertices());
+        primvarRefiner.InterpolateVarying(1, src, dst);
+        data.insert(data.end(), dst.begin(), dst.end());
+    } else {
+        std::vector<T> limit(src.size());
+        primvarRefiner.LimitFaceVarying(src, limit, channel);
+        data.insert(data.end(), limit.begin(), limit.end());
+    }
+}
+
+static int
+compareThreadedPrimvars(FarTopologyRefiner const & refiner,
+    std::vector<xyzVV> const & farVertexData) {
+
+    // Primvars interpolated concurrently must match the serial ones exactly
+    int failures = 0;
+    for (int channel=-1; channel<refiner.GetNumFVarChannels(); ++channel) {
+
+        FarTopologyLevel const & coarseLevel = refiner.GetLevel(0);
+
+        std::vector<xyzVV> coarse;
+        if (channel < 0) {
+            coarse.assign(farVertexData.begin(),
+                farVertexData.begin() + coarseLevel.GetNumVertices());
+        } else {
+            for (int i=0; i<coarseLevel.GetNumFVarValues(channel); ++i) {
+                coarse.push_back(xyzVV((float)i, 0.5f*(float)i, 1.0f));
+            }
+        }
+
+        std::vector<xyzVV> data[2];
+        for (int threaded=0; threaded<2; ++threaded) {
+            interpolatePrimvars(refiner, threaded!=0, coarse, data[threaded], channel);
+        }
+
+        if (! isBitwiseEqual(data[0], data[1])) {
+            if (channel < 0) {
+                printf("  threaded vertex primvars differ from serial ones\n");
+            } else {
+                printf("  threaded face-varying primvars (channel %d) differ "
+                    "from serial ones\n", channel);
+            }
+            ++failures;
+        }
+    }
+    return failures;
+}
+
+static int
+compareDoubleStencils(FarTopologyRefiner const & refiner) {
+
+    typedef OpenSubdiv::Far::StencilTable                    FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory             FarStencilTableFactory;
+    typedef OpenSubdiv::Far::StencilTableReal<double>        FarStencilTableD;
+    typedef OpenSubdiv::Far::StencilTableFactoryReal<double> FarStencilTableFactoryD;
+
+    // Stencils factorized in double precision and converted to single
+    // precision must match the single precision ones
+    int failures = 0;
+    if (refiner.GetMaxValence() > 64) {
+        return failures;
+    }
+
+    FarStencilTableFactory::Options options;
+    options.generateOffsets = true;
+    options.maxLevel = 3;
+
+    FarStencilTableFactoryD::Options optionsD;
+    optionsD.generateOffsets = true;
+    optionsD.maxLevel = 3;
+
+    FarStencilTable const * single =
+        FarStencilTableFactory::Create(refiner, options);
+    FarStencilTableD const * dbl =
+        FarStencilTableFactoryD::Create(refiner, optionsD);
+    FarStencilTable const * converted =
+        FarStencilTableFactory::Create(*dbl);
+
+    bool equal =
+        isBitwiseEqual(single->GetSizes(), converted->GetSizes()) &&
+        isBitwiseEqual(single->GetControlIndices(), converted->GetControlIndices());
+
+    std::vector<float> const & weights = single->GetWeights();
+    for (int i=0; equal && i<(int)weights.size(); ++i) {
+        equal = std::abs(weights[i] - converted->GetWeights()[i]) <= PRECISION;
+    }
+    if (! equal) {
+        printf("  double precision stencils differ from single precision ones\n");
+        ++failures;
+    }
+    delete single;
+    delete dbl;
+    delete converted;
+    return failures;
+}
+
+static int
+compareEditStencils(Shape const & shape, FarTopologyRefiner const & refiner,
+                    std::vector<xyzVV> const & farVertexData) {
+
+    typedef OpenSubdiv::Far::HierarchicalEdits   FarHierarchicalEdits;
+    typedef OpenSubdiv::Far::Stencil             FarStencil;
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+
+    // Stencils applied to the control vertices followed by the values of the
+    // vertex edits must match the vertices interpolated and edited level by
+    // level
+    int failures = 0;
+    FarHierarchicalEdits const * edits = refiner.GetHierarchicalEdits();
+    if (! edits) {
+        return failures;
+    }
+
+    std::vector<float> controlValues(shape.verts);
+    for (int i=0; i<edits->GetNumVertexEdits(); ++i) {
+        float const * value = edits->GetVertexEditValues(i);
+        controlValues.insert(controlValues.end(), value, value + 3);
+    }
+
+    for (int pass=0; pass<2; ++pass) {
+        FarStencilTableFactory::Options options;
+        options.generateOffsets = true;
+        options.generateIntermediateLevels = true;
+        options.generateControlVerts = true;
+        options.useThreads = (pass == 1);
+
+        FarStencilTable const * table =
+            FarStencilTableFactory::Create(refiner, options);
+
+        bool equal = (table->GetNumControlVertices() ==
+                        (int)controlValues.size() / 3) &&
+                     (table->GetNumStencils() == (int)farVertexData.size());
+
+        for (int i=0; equal && i<table->GetNumStencils(); ++i) {
+            FarStencil stencil = table->GetStencil(i);
+
+            float pos[3] = { 0.0f, 0.0f, 0.0f };
+            for (int j=0; j<stencil.GetSize(); ++j) {
+                float const * src = &controlValues[stencil.GetVertexIndices()[j] * 3];
+                for (int k=0; k<3; ++k) {
+                    pos[k] += stencil.GetWeights()[j] * src[k];
+                }
+            }
+            float const * farPos = farVertexData[i].GetPos();
+            float delta[3] = { pos[0] - farPos[0],
+                               pos[1] - farPos[1],
+                               pos[2] - farPos[2] };
+            equal = sqrtf(delta[0]*delta[0] + delta[1]*delta[1] +
+                          delta[2]*delta[2]) <= PRECISION;
+        }
+        if (! equal) {
+            printf("  %s stencils with vertex edits differ from the interpolated vertices\n",
+                options.useThreads ? "threaded" : "serial");
+            ++failures;
+        }
+        delete table;
+    }
+    return failures;
+}
+
+static bool
+isPermutation(std::vector<OpenSubdiv::Far::Index> const & permutation, int size) {
+
+    std::vector<char> found(size, 0);
+    if ((int)permutation.size()!=size) {
         return false;
     }
+    for (int i=0; i<size; ++i) {
+        if (permutation[i]<0 || permutation[i]>=size || found[permutation[i]]) {
+            return false;
+        }
+        found[permutation[i]] = 1;
+    }
     return true;
 }
 
+static int
+compareReorderedStencils(FarTopologyRefiner const & refiner) {
+
+    typedef OpenSubdiv::Far::Index               FarIndex;
+    typedef OpenSubdiv::Far::Stencil             FarStencil;
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+
+    // Reordered stencils must be permutations of the original ones, with
+    // identical coefficients once the control vertices are remapped
+    int failures = 0;
+    if (refiner.GetMaxValence() > 64) {
+        return failures;
+    }
+
+    FarStencilTableFactory::Options options;
+    options.generateOffsets = true;
+    options.maxLevel = 3;
+
+    FarStencilTable const * table =
+        FarStencilTableFactory::Create(refiner, options);
+
+    for (int mode=1; mode<4; ++mode) {
+
+        FarStencilTableFactory::ReorderOptions reorderOptions;
+        reorderOptions.reorderStencils = (mode & 1) != 0;
+        reorderOptions.reorderControlVerts = (mode & 2) != 0;
+
+        std::vector<FarIndex> stencilPermutation, controlVertPermutation;
+        FarStencilTable const * reordered = FarStencilTableFactory::Reorder(
+            *table, &stencilPermutation, &controlVertPermutation, reorderOptions);
+
+        bool equal =
+            isPermutation(stencilPermutation, table->GetNumStencils()) &&
+            isPermutation(controlVertPermutation, table->GetNumControlVertices()) &&
+            reordered->GetNumStencils()==table->GetNumStencils() &&
+            reordered->GetOffsets().size()==table->GetOffsets().size();
+
+        for (int i=0; equal && i<reordered->GetNumStencils(); ++i) {
+            FarStencil src = table->GetStencil(stencilPermutation[i]),
+                       dst = reordered->GetStencil(i);
+            equal = (src.GetSize()==dst.GetSize()) &&
+                (memcmp(src.GetWeights(), dst.GetWeights(),
+                        src.GetSize()*sizeof(float))==0);
+            for (int j=0; equal && j<src.GetSize(); ++j) {
+                equal = controlVertPermutation[dst.GetVertexIndices()[j]] ==
+                        src.GetVertexIndices()[j];
+            }
+            if (! reorderOptions.reorderStencils) {
+                equal = equal && (stencilPermutation[i]==i);
+            }
+        }
+        for (int i=0; equal && i<table->GetNumControlVertices(); ++i) {
+            if (! reorderOptions.reorderControlVerts) {
+                equal = (controlVertPermutation[i]==i);
+            }
+        }
+        if (! equal) {
+            printf("  reordered stencils (mode %d) differ from original ones\n", mode);
+            ++failures;
+        }
+        delete reordered;
+    }
+    delete table;
+    return failures;
+}
+
+// Swaps the 32 bit words of a serialized record (emulates a record written
+// on a host with the opposite byte order)
+static void
+swapRecord(std::vector<unsigned char> & data) {
+    for (size_t i=0; i+3<data.size(); i+=4) {
+        std::swap(data[i], data[i+3]);
+        std::swap(data[i+1], data[i+2]);
+    }
+}
+
+template <class TABLE>
+static bool
+checkSerializedTable(TABLE const & table,
+    void (*writeTable)(TABLE const &, std::vector<unsigned char> &),
+    TABLE const * (*readTable)(void const *, size_t)) {
+
+    // tables read back must serialize to identical records, whether the
+    // records were read from a mapped file or swapped
+    std::vector<unsigned char> record, copy;
+    writeTable(table, record);
+
+    char const * filename = "far_regression_serializer.bin";
+    if (! OpenSubdiv::Far::Serializer::WriteFile(filename, record)) {
+        return false;
+    }
+    OpenSubdiv::Far::Serializer::MappedFile * file =
+        OpenSubdiv::Far::Serializer::MappedFile::Open(filename);
+    TABLE const * mapped = file ? readTable(file->GetData(), file->GetSize()) : 0;
+    delete file;
+    remove(filename);
+
+    bool equal = (mapped != 0);
+    if (equal) {
+        writeTable(*mapped, copy);
+        equal = (copy == record);
+    }
+    delete mapped;
+
+    copy = record;
+    swapRecord(copy);
+    TABLE const * swapped = readTable(&copy[0], copy.size());
+    if (swapped) {
+        copy.clear();
+        writeTable(*swapped, copy);
+        equal = equal && (copy == record);
+    } else {
+        equal = false;
+    }
+    delete swapped;
+    return equal;
+}
+
+static int
+compareSerializedTables(Shape const & shape, FarTopologyRefiner const & refiner) {
+
+    typedef OpenSubdiv::Far::Serializer              FarSerializer;
+    typedef OpenSubdiv::Far::StencilTable            FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory     FarStencilTableFactory;
+    typedef OpenSubdiv::Far::LimitStencilTable       FarLimitStencilTable;
+    typedef OpenSubdiv::Far::LimitStencilTableFactory FarLimitStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable              FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory       FarPatchTableFactory;
+
+    int failures = 0;
+    if (refiner.GetMaxValence() > 64) {
+        return failures;
+    }
+
+    // stencils
+    FarStencilTableFactory::Options options;
+    options.generateOffsets = true;
+    options.maxLevel = 3;
+
+    FarStencilTable const * stencils =
+        FarStencilTableFactory::Create(refiner, options);
+    if (! checkSerializedTable(*stencils,
+            &FarSerializer::WriteStencilTable, &FarSerializer::ReadStencilTable)) {
+        printf("  serialized stencil table differs from the original one\n");
+        ++failures;
+    }
+    delete stencils;
+
+    if (shape.scheme != kCatmark) {
+        return failures;
+    }
+
+    // limit stencils (at the center of every ptex face)
+    FarTopologyRefiner * adaptiveRefiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+
+    FarTopologyRefiner::AdaptiveOptions adaptiveOptions(2);
+    adaptiveOptions.useSingleCreasePatch = true;
+    adaptiveRefiner->RefineAdaptive(adaptiveOptions);
+
+    FarPatchTableFactory::Options patchOptions(2);
+    patchOptions.useSingleCreasePatch = true;
+    patchOptions.generateFVarTables = true;
+    patchOptions.endCapType =
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
+
+    FarPatchTable const * patchTable =
+        FarPatchTableFactory::Create(*adaptiveRefiner, patchOptions);
+    if (! checkSerializedTable(*patchTable,
+            &FarSerializer::WritePatchTable, &FarSerializer::ReadPatchTable)) {
+        printf("  serialized patch table differs from the original one\n");
+        ++failures;
+    }
+
+    float center = 0.5f;
+    int numPtexFaces = patchTable->GetNumPtexFaces();
+    FarLimitStencilTableFactory::LocationArrayVec locations(numPtexFaces);
+    for (int i=0; i<numPtexFaces; ++i) {
+        locations[i].ptexIdx = i;
+        locations[i].numLocations = 1;
+        locations[i].s = locations[i].t = &center;
+    }
+    FarLimitStencilTable const * limitStencils =
+        FarLimitStencilTableFactory::Create(*adaptiveRefiner, locations);
+    if (! checkSerializedTable(*limitStencils,
+            &FarSerializer::WriteLimitStencilTable,
+            &FarSerializer::ReadLimitStencilTable)) {
+        printf("  serialized limit stencil table differs from the original one\n");
+        ++failures;
+    }
+    delete limitStencils;
+    delete patchTable;
+    delete adaptiveRefiner;
+    return failures;
+}
+
+static int
+compareThreadedPatchTables(Shape const & shape) {
+
+    typedef OpenSubdiv::Far::Serializer              FarSerializer;
+    typedef OpenSubdiv::Far::PatchTable              FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory       FarPatchTableFactory;
+
+    // Adaptive patch tables populated concurrently must serialize to records
+    // identical to those of the serial ones, for each type of end-cap
+    int failures = 0;
+    if (shape.scheme == kBilinear) {
+        return failures;
+    }
+
+    FarTopologyRefiner * refiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+
+    FarTopologyRefiner::AdaptiveOptions adaptiveOptions(3);
+    adaptiveOptions.useSingleCreasePatch = true;
+    refiner->RefineAdaptive(adaptiveOptions);
+
+    FarPatchTableFactory::Options::EndCapType endCapTypes[] = {
+        FarPatchTableFactory::Options::ENDCAP_BSPLINE_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS,
+        FarPatchTableFactory::Options::ENDCAP_LEGACY_GREGORY };
+
+    for (int i=0; i<3; ++i) {
+        FarPatchTableFactory::Options patchOptions(3);
+        patchOptions.useSingleCreasePatch = true;
+        patchOptions.generateFVarTables =
+            (endCapTypes[i] != FarPatchTableFactory::Options::ENDCAP_LEGACY_GREGORY);
+        patchOptions.generateFVarLegacyLinearPatches = false;
+        patchOptions.SetEndCapType(endCapTypes[i]);
+
+        std::vector<unsigned char> records[2];
+        for (int threaded=0; threaded<2; ++threaded) {
+            patchOptions.useThreads = threaded;
+
+            FarPatchTable const * patchTable =
+                FarPatchTableFactory::Create(*refiner, patchOptions);
+            FarSerializer::WritePatchTable(*patchTable, records[threaded]);
+            delete patchTable;
+        }
+
+        if (records[0] != records[1]) {
+            printf("  threaded patch table (end-cap type %d) differs from serial one\n",
+                (int)endCapTypes[i]);
+            ++failures;
+        }
+    }
+    delete refiner;
+    return failures;
+}
+
+// Applies a factorized stencil table to xyz coordinates (the values of the
+// control vertices are copied first)
+static void
+applyStencils(OpenSubdiv::Far::StencilTable const & table,
+              std::vector<float> const & controlValues,
+              std::vector<float> & values, int numComponents) {
+
+    int numControlVerts = (int)controlValues.size() / numComponents;
+
+    values = controlValues;
+    values.resize((numControlVerts + table.GetNumStencils()) * numComponents, 0.0f);
+
+    for (int i=0; i<table.GetNumStencils(); ++i) {
+        OpenSubdiv::Far::Stencil stencil = table.GetStencil(i);
+        float * dst = &values[(numControlVerts + i) * numComponents];
+        for (int j=0; j<stencil.GetSize(); ++j) {
+            float const * src = &controlValues[stencil.GetVertexIndices()[j] * numComponents];
+            for (int k=0; k<numComponents; ++k) {
+                dst[k] += stencil.GetWeights()[j] * src[k];
+            }
+        }
+    }
+}
+
+// Applies a table of level-to-level stencils to xyz coordinates, one pass
+// after the other (the values of the control vertices are copied first)
+static void
+applyLevelStencils(OpenSubdiv::Far::StencilTable const & table,
+                   std::vector<float> const & controlValues,
+                   std::vector<float> & values, int numComponents) {
+
+    std::vector<OpenSubdiv::Far::Index> const & offsets = table.GetLevelOffsets(),
+                                              & sources = table.GetLevelSourceOffsets();
+
+    int numControlVerts = (int)controlValues.size() / numComponents;
+
+    values = controlValues;
+    values.resize((numControlVerts + table.GetNumStencils()) * numComponents, 0.0f);
+
+    for (int pass=0; pass+1<(int)offsets.size(); ++pass) {
+        for (int i=offsets[pass]; i<offsets[pass+1]; ++i) {
+            OpenSubdiv::Far::Stencil stencil = table.GetStencil(i);
+            float * dst = &values[(numControlVerts + i) * numComponents];
+            for (int j=0; j<stencil.GetSize(); ++j) {
+                float const * src = &values[(numControlVerts + sources[pass] +
+                    stencil.GetVertexIndices()[j]) * numComponents];
+                for (int k=0; k<numComponents; ++k) {
+                    dst[k] += stencil.GetWeights()[j] * src[k];
+                }
+            }
+        }
+    }
+}
+
+static bool
+areValuesEqual(std::vector<float> const & a, std::vector<float> const & b) {
+
+    // values accumulated in a different order around high valence vertices
+    // differ by a few ulps
+    float const tolerance = 1e-5f;
+
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (int i=0; i<(int)a.size(); ++i) {
+        if (std::abs(a[i] - b[i]) > tolerance * std::max(1.0f, std::abs(a[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static int
+compareLevelStencils(Shape const & shape, FarTopologyRefiner const & refiner,
+                     std::vector<xyzVV> const & farVertexData) {
+
+    typedef OpenSubdiv::Far::Serializer          FarSerializer;
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+
+    // Level-to-level stencils evaluated level by level must match the
+    // interpolated vertices, and the factorized stencils once the local
+    // points of adaptive patches are appended
+    int failures = 0;
+    if (refiner.GetHierarchicalEdits() || refiner.GetMaxValence() > 64) {
+        return failures;
+    }
+
+    std::vector<float> interpolated;
+    for (int i=0; i<(int)farVertexData.size(); ++i) {
+        float const * pos = farVertexData[i].GetPos();
+        interpolated.insert(interpolated.end(), pos, pos + 3);
+    }
+
+    for (int pass=0; pass<2; ++pass) {
+        FarStencilTableFactory::Options options;
+        options.factorizeIntermediateLevels = false;
+        options.useThreads = (pass == 1);
+
+        FarStencilTable const * table =
+            FarStencilTableFactory::Create(refiner, options);
+
+        std::vector<float> values;
+        applyLevelStencils(*table, shape.verts, values, 3);
+        if (! areValuesEqual(values, interpolated)) {
+            printf("  %s level-to-level stencils differ from the interpolated vertices\n",
+                options.useThreads ? "threaded" : "serial");
+            ++failures;
+        }
+        if (pass == 0 && ! checkSerializedTable(*table,
+                &FarSerializer::WriteStencilTable, &FarSerializer::ReadStencilTable)) {
+            printf("  serialized level-to-level stencil table differs from the original one\n");
+            ++failures;
+        }
+        delete table;
+    }
+
+    if (shape.scheme == kBilinear) {
+        return failures;
+    }
+
+    FarTopologyRefiner * adaptiveRefiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+    adaptiveRefiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+
+    FarPatchTableFactory::Options patchOptions(3);
+    patchOptions.endCapType =
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
+    FarPatchTable const * patchTable =
+        FarPatchTableFactory::Create(*adaptiveRefiner, patchOptions);
+
+    std::vector<float> values[2];
+    for (int pass=0; pass<2; ++pass) {
+        FarStencilTableFactory::Options options;
+        options.factorizeIntermediateLevels = (pass == 0);
+
+        FarStencilTable const * table =
+            FarStencilTableFactory::Create(*adaptiveRefiner, options);
+        if (FarStencilTable const * tableWithLocalPoints =
+            FarStencilTableFactory::AppendLocalPointStencilTable(
+                *adaptiveRefiner, table, patchTable->GetLocalPointStencilTable())) {
+            delete table;
+            table = tableWithLocalPoints;
+        }
+        if (options.factorizeIntermediateLevels) {
+            applyStencils(*table, shape.verts, values[pass], 3);
+        } else {
+            applyLevelStencils(*table, shape.verts, values[pass], 3);
+        }
+        delete table;
+    }
+    if (! areValuesEqual(values[1], values[0])) {
+        printf("  adaptive level-to-level stencils differ from the factorized ones\n");
+        ++failures;
+    }
+    delete patchTable;
+    delete adaptiveRefiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// Applies the listed stencils of a table to xyz coordinates, leaving the other
+// values untouched (the stencils of level-to-level tables are listed one pass
+// after the other)
+static void
+applyRegionStencils(OpenSubdiv::Far::StencilTable const & table,
+                    std::vector<OpenSubdiv::Far::Index> const & stencils,
+                    int numControlVerts, std::vector<float> & values,
+                    int numComponents) {
+
+    std::vector<OpenSubdiv::Far::Index> const & offsets = table.GetLevelOffsets(),
+                                              & sources = table.GetLevelSourceOffsets();
+
+    for (int i=0, pass=0; i<(int)stencils.size(); ++i) {
+        int source = 0;
+        if (! offsets.empty()) {
+            while (stencils[i] >= offsets[pass+1]) {
+                ++pass;
+            }
+            source = numControlVerts + sources[pass];
+        }
+        OpenSubdiv::Far::Stencil stencil = table.GetStencil(stencils[i]);
+        float * dst = &values[(numControlVerts + stencils[i]) * numComponents];
+        std::fill(dst, dst + numComponents, 0.0f);
+        for (int j=0; j<stencil.GetSize(); ++j) {
+            float const * src = &values[(source + stencil.GetVertexIndices()[j]) * numComponents];
+            for (int k=0; k<numComponents; ++k) {
+                dst[k] += stencil.GetWeights()[j] * src[k];
+            }
+        }
+    }
+}
+
+static int
+checkFaceRegion(Shape const & shape) {
+
+    typedef OpenSubdiv::Far::Index               FarIndex;
+    typedef OpenSubdiv::Far::ConstIndexArray     FarConstIndexArray;
+    typedef OpenSubdiv::Far::FaceRegion          FarFaceRegion;
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchParam          FarPatchParam;
+
+    // The stencils of a region of the base faces must evaluate the vertices
+    // and the patches of the region as the whole table does (the values left
+    // unevaluated are poisoned)
+    int failures = 0;
+
+    FarTopologyRefiner * refiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+    if (refiner->GetHierarchicalEdits() || refiner->GetMaxValence() > 64) {
+        delete refiner;
+        return failures;
+    }
+
+    std::vector<FarIndex> faces;
+    for (int face=0; face<refiner->GetLevel(0).GetNumFaces(); face+=3) {
+        faces.push_back(face);
+    }
+
+    float const poison = 1e30f;
+
+    int numControlVerts = (int)shape.verts.size() / 3;
+
+    bool adaptive = (shape.scheme != kBilinear);
+    if (adaptive) {
+        refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+    } else {
+        refiner->RefineUniform(FarTopologyRefiner::UniformOptions(2));
+    }
+
+    FarPatchTable const * patchTable = 0;
+    if (adaptive) {
+        FarPatchTableFactory::Options patchOptions(3);
+        patchOptions.endCapType =
+            FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
+        patchTable = FarPatchTableFactory::Create(*refiner, patchOptions);
+    }
+
+    FarFaceRegion region(*refiner, patchTable, (int)faces.size(), &faces[0]);
+
+    for (int pass=0; pass<3; ++pass) {
+        FarStencilTableFactory::Options options;
+        options.generateIntermediateLevels = adaptive || (pass != 0);
+        options.factorizeIntermediateLevels = (pass != 2);
+
+        FarStencilTable const * table =
+            FarStencilTableFactory::Create(*refiner, options);
+        if (patchTable) {
+            if (FarStencilTable const * tableWithLocalPoints =
+                FarStencilTableFactory::AppendLocalPointStencilTable(
+                    *refiner, table, patchTable->GetLocalPointStencilTable())) {
+                delete table;
+                table = tableWithLocalPoints;
+            }
+        }
+
+        std::vector<float> values, regionValues;
+        if (options.factorizeIntermediateLevels) {
+            applyStencils(*table, shape.verts, values, 3);
+        } else {
+            applyLevelStencils(*table, shape.verts, values, 3);
+        }
+
+        std::vector<FarIndex> stencils;
+        if (! region.GetStencils(*table, stencils)) {
+            printf("  face region : stencil table layout not recognized\n");
+            ++failures;
+            delete table;
+            continue;
+        }
+        regionValues = shape.verts;
+        regionValues.resize(values.size(), poison);
+        applyRegionStencils(*table, stencils, numControlVerts, regionValues, 3);
+
+        // the vertices of the last level and the patches of the region
+        int maxLevel = refiner->GetMaxLevel(),
+            lastLevelVertex = refiner->GetNumVerticesTotal() -
+                refiner->GetLevel(maxLevel).GetNumVertices(),
+            firstVertex = options.generateIntermediateLevels ?
+                numControlVerts : lastLevelVertex;
+
+        int regionFailures = 0;
+
+        FarConstIndexArray vertices = region.GetVertices(maxLevel);
+        for (int i=0; i<vertices.size(); ++i) {
+            int vert = numControlVerts + lastLevelVertex + vertices[i] - firstVertex;
+            for (int k=0; k<3; ++k) {
+                if (regionValues[vert*3+k] != values[vert*3+k]) {
+                    ++regionFailures;
+                    break;
+                }
+            }
+        }
+
+        for (int i=0; i<(int)region.GetPatches().size(); ++i) {
+            FarPatchTable::PatchHandle const & handle = region.GetPatches()[i];
+            FarPatchParam param = patchTable->GetPatchParam(handle);
+
+            float u = 0.5f, v = 0.5f;
+            if (shape.scheme == kLoop) {
+                u = v = 1.0f / 3.0f;
+                param.UnnormalizeTriangle(u, v);
+            } else {
+                param.Unnormalize(u, v);
+            }
+
+            float w[20];
+            patchTable->EvaluateBasis(handle, u, v, w);
+
+            FarConstIndexArray cvs = patchTable->GetPatchVertices(handle);
+            for (int k=0; k<3; ++k) {
+                float p = 0.0f, regionP = 0.0f;
+                for (int j=0; j<cvs.size(); ++j) {
+                    p += w[j] * values[cvs[j]*3+k];
+                    regionP += w[j] * regionValues[cvs[j]*3+k];
+                }
+                if (p != regionP) {
+                    ++regionFailures;
+                    break;
+                }
+            }
+        }
+
+        if (regionFailures) {
+            printf("  face region : %d vertices or patches of %s stencils differ\n",
+                regionFailures, options.factorizeIntermediateLevels ?
+                    "factorized" : "level-to-level");
+            failures += regionFailures;
+        }
+
+        delete table;
+    }
+
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+static int
+compareLimitEvaluation(Shape const & shape) {
+
+    typedef OpenSubdiv::Far::StencilTable             FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory      FarStencilTableFactory;
+    typedef OpenSubdiv::Far::LimitStencilTable        FarLimitStencilTable;
+    typedef OpenSubdiv::Far::LimitStencilTableFactory FarLimitStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable               FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory        FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchMap                 FarPatchMap;
+    typedef OpenSubdiv::Far::LimitEvaluator           FarLimitEvaluator;
+
+    // Batched limit evaluation must match the limit stencils, and must not
+    // depend on the order or the threading of the evaluation
+    int failures = 0;
+    if (shape.scheme != kCatmark) {
+        return failures;
+    }
+
+    FarTopologyRefiner * refiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+    if (refiner->GetMaxValence() > 64) {
+        delete refiner;
+        return failures;
+    }
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(2));
+
+    FarPatchTableFactory::Options patchOptions(2);
+    patchOptions.endCapType =
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
+    FarPatchTable const * patchTable =
+        FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    FarStencilTable const * stencils =
+        FarStencilTableFactory::Create(*refiner);
+    if (FarStencilTable const * stencilsWithLocalPoints =
+        FarStencilTableFactory::AppendLocalPointStencilTable(
+            *refiner, stencils, patchTable->GetLocalPointStencilTable())) {
+        delete stencils;
+        stencils = stencilsWithLocalPoints;
+    }
+
+    std::vector<float> controlPoints;
+    applyStencils(*stencils, shape.verts, controlPoints, 3);
+
+    // a few locations on each ptex face
+    static float const st[][2] = {
+        { 0.25f, 0.25f }, { 0.5f, 0.5f }, { 0.8f, 0.3f }, { 0.1f, 0.95f } };
+    int const numLocationsPerFace = (int)(sizeof(st) / sizeof(st[0]));
+
+    int numPtexFaces = patchTable->GetNumPtexFaces(),
+        numLocations = numPtexFaces * numLocationsPerFace;
+
+    std::vector<int> faces(numLocations);
+    std::vector<float> s(numLocations), t(numLocations);
+    FarLimitStencilTableFactory::LocationArrayVec locationArrays(numPtexFaces);
+    for (int face=0; face<numPtexFaces; ++face) {
+        for (int j=0; j<numLocationsPerFace; ++j) {
+            int i = face * numLocationsPerFace + j;
+            faces[i] = face;
+            s[i] = st[j][0];
+            t[i] = st[j][1];
+        }
+        locationArrays[face].ptexIdx = face;
+        locationArrays[face].numLocations = numLocationsPerFace;
+        locationArrays[face].s = &s[face * numLocationsPerFace];
+        locationArrays[face].t = &t[face * numLocationsPerFace];
+    }
+
+    FarPatchMap patchMap(*patchTable);
+
+    std::vector<float> P[2], dPdu[2], dPdv[2];
+    for (int pass=0; pass<2; ++pass) {
+        FarLimitEvaluator::Options options;
+        options.sortLocations = (pass == 1);
+        options.useThreads = (pass == 1);
+
+        P[pass].resize(numLocations * 3);
+        dPdu[pass].resize(numLocations * 3);
+        dPdv[pass].resize(numLocations * 3);
+        int numEvaluated = FarLimitEvaluator::Evaluate(*patchTable, patchMap,
+            numLocations, &faces[0], &s[0], &t[0], &controlPoints[0], 3, 3,
+            &P[pass][0], &dPdu[pass][0], &dPdv[pass][0], 0, 0, 0, options);
+        if (numEvaluated != numLocations) {
+            printf("  limit evaluation : %d locations evaluated out of %d\n",
+                numEvaluated, numLocations);
+            ++failures;
+        }
+    }
+    if (! (isBitwiseEqual(P[0], P[1]) && isBitwiseEqual(dPdu[0], dPdu[1]) &&
+           isBitwiseEqual(dPdv[0], dPdv[1]))) {
+        printf("  sorted and threaded limit evaluation differs from the serial one\n");
+        ++failures;
+    }
+
+    FarLimitStencilTable const * limitStencils =
+        FarLimitStencilTableFactory::Create(*refiner, locationArrays);
+
+    std::vector<float> limitP, limitDu, limitDv;
+    {
+        std::vector<float> const & coarse = shape.verts;
+        limitP.resize(numLocations * 3);
+        limitDu.resize(numLocations * 3);
+        limitDv.resize(numLocations * 3);
+        for (int i=0; i<numLocations; ++i) {
+            OpenSubdiv::Far::LimitStencil stencil = limitStencils->GetLimitStencil(i);
+            for (int j=0; j<stencil.GetSize(); ++j) {
+                float const * src = &coarse[stencil.GetVertexIndices()[j] * 3];
+                for (int k=0; k<3; ++k) {
+                    limitP[i*3+k] += stencil.GetWeights()[j] * src[k];
+                    limitDu[i*3+k] += stencil.GetDuWeights()[j] * src[k];
+                    limitDv[i*3+k] += stencil.GetDvWeights()[j] * src[k];
+                }
+            }
+        }
+    }
+
+    bool equal = true;
+    for (int i=0; equal && i<numLocations*3; ++i) {
+        equal = std::abs(P[0][i] - limitP[i]) <= 1e-4f * std::max(1.0f, std::abs(limitP[i])) &&
+                std::abs(dPdu[0][i] - limitDu[i]) <= 1e-4f * std::max(1.0f, std::abs(limitDu[i])) &&
+                std::abs(dPdv[0][i] - limitDv[i]) <= 1e-4f * std::max(1.0f, std::abs(limitDv[i]));
+    }
+    if (! equal) {
+        printf("  batched limit evaluation differs from the limit stencils\n");
+        ++failures;
+    }
+
+    delete limitStencils;
+    delete stencils;
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkPatchMap(Shape const & shape) {
+
+    typedef OpenSubdiv::Far::PatchTable        FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchParam        FarPatchParam;
+    typedef OpenSubdiv::Far::PatchMap          FarPatchMap;
+
+    // The center of every patch must be located in the patch, one location
+    // at a time and as batches sorted by face
+    int failures = 0;
+    if (shape.scheme == kBilinear) {
+        return failures;
+    }
+
+    FarTopologyRefiner * refiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(3));
+
+    FarPatchTable const * patchTable =
+        FarPatchTableFactory::Create(*refiner, FarPatchTableFactory::Options(3));
+
+    FarPatchMap patchMap(*patchTable);
+
+    int numPatches = patchTable->GetNumPatchesTotal();
+
+    std::vector<std::pair<int, int> > faces(numPatches);
+    std::vector<float> u(numPatches), v(numPatches);
+    for (int patch=0; patch<numPatches; ++patch) {
+        FarPatchParam param = patchTable->GetPatchParamTable()[patch];
+        if (shape.scheme == kLoop) {
+            u[patch] = v[patch] = 1.0f / 3.0f;
+            param.UnnormalizeTriangle(u[patch], v[patch]);
+        } else {
+            u[patch] = v[patch] = 0.5f;
+            param.Unnormalize(u[patch], v[patch]);
+        }
+        faces[patch] = std::make_pair((int)param.GetFaceId(), patch);
+    }
+    std::sort(faces.begin(), faces.end());
+
+    std::vector<int> sortedFaces(numPatches);
+    std::vector<float> sortedU(numPatches), sortedV(numPatches);
+    for (int i=0; i<numPatches; ++i) {
+        sortedFaces[i] = faces[i].first;
+        sortedU[i] = u[faces[i].second];
+        sortedV[i] = v[faces[i].second];
+    }
+
+    std::vector<FarPatchMap::Handle const *> handles(numPatches);
+    patchMap.FindPatches(numPatches, &sortedFaces[0], &sortedU[0],
+                         &sortedV[0], &handles[0]);
+
+    for (int i=0; i<numPatches; ++i) {
+        int patch = faces[i].second;
+        FarPatchMap::Handle const * handle =
+            patchMap.FindPatch(sortedFaces[i], sortedU[i], sortedV[i]);
+        if (! handle || handle->patchIndex != patch || handles[i] != handle) {
+            ++failures;
+        }
+    }
+    if (failures) {
+        printf("  patch map : %d patches not located\n", failures);
+    }
+
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkPatchBVH(Shape const & shape) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchParam          FarPatchParam;
+    typedef OpenSubdiv::Far::PatchBVH            FarPatchBVH;
+    typedef OpenSubdiv::Far::ConstIndexArray     FarConstIndexArray;
+
+    // The center of every patch must be found back by a closest point query
+    // and by a ray cast towards it along its normal, before and after the
+    // hierarchy is refit to deformed control points
+    int failures = 0;
+    if (shape.scheme == kBilinear) {
+        return failures;
+    }
+
+    FarTopologyRefiner * refiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+    if (refiner->GetMaxValence() > 64) {
+        delete refiner;
+        return failures;
+    }
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(2));
+
+    FarPatchTableFactory::Options patchOptions(2);
+    patchOptions.endCapType =
+        FarPatchTableFactory::Options::ENDCAP_GREGORY_BASIS;
+    FarPatchTable const * patchTable =
+        FarPatchTableFactory::Create(*refiner, patchOptions);
+
+    FarStencilTable const * table =
+        FarStencilTableFactory::Create(*refiner, FarStencilTableFactory::Options());
+    if (FarStencilTable const * tableWithLocalPoints =
+        FarStencilTableFactory::AppendLocalPointStencilTable(
+            *refiner, table, patchTable->GetLocalPointStencilTable())) {
+        delete table;
+        table = tableWithLocalPoints;
+    }
+
+    std::vector<float> controlValues = shape.verts, values;
+    applyStencils(*table, controlValues, values, 3);
+
+    FarPatchBVH bvh(*patchTable, &values[0]);
+
+    int closestFailures = 0,
+        rayFailures = 0;
+
+    for (int pass=0; pass<2; ++pass) {
+        if (pass == 1) {
+            // a non rigid deformation of the control points
+            for (int i=0; i<(int)controlValues.size(); i+=3) {
+                controlValues[i] = 2.0f * controlValues[i] + controlValues[i+1];
+                controlValues[i+2] += 1.0f;
+            }
+            applyStencils(*table, controlValues, values, 3);
+            bvh.Refit(&values[0]);
+        }
+
+        float extent = 0.0f;
+        for (int k=0; k<3; ++k) {
+            float lo = values[k], hi = values[k];
+            for (int i=k; i<(int)values.size(); i+=3) {
+                lo = std::min(lo, values[i]);
+                hi = std::max(hi, values[i]);
+            }
+            extent = std::max(extent, hi - lo);
+        }
+        float tolerance = 1e-3f * extent;
+
+        for (int array=0, patch=0; array<patchTable->GetNumPatchArrays(); ++array) {
+            for (int j=0; j<patchTable->GetNumPatches(array); ++j, ++patch) {
+
+                FarPatchTable::PatchHandle handle;
+                handle.arrayIndex = array;
+                handle.patchIndex = patch;
+                handle.vertIndex = j * patchTable->GetPatchArrayDescriptor(
+                    array).GetNumControlVertices();
+
+                FarPatchParam param = patchTable->GetPatchParam(handle);
+                float s = 0.5f, t = 0.5f;
+                if (shape.scheme == kLoop) {
+                    s = t = 1.0f / 3.0f;
+                    param.UnnormalizeTriangle(s, t);
+                } else {
+                    param.Unnormalize(s, t);
+                }
+
+                float w[20], wDs[20], wDt[20];
+                patchTable->EvaluateBasis(handle, s, t, w, wDs, wDt);
+
+                FarConstIndexArray cvs = patchTable->GetPatchVertices(handle);
+                float P[3] = { 0.0f, 0.0f, 0.0f },
+                      Ps[3] = { 0.0f, 0.0f, 0.0f },
+                      Pt[3] = { 0.0f, 0.0f, 0.0f };
+                for (int i=0; i<cvs.size(); ++i) {
+                    for (int k=0; k<3; ++k) {
+                        P[k] += w[i] * values[cvs[i]*3+k];
+                        Ps[k] += wDs[i] * values[cvs[i]*3+k];
+                        Pt[k] += wDt[i] * values[cvs[i]*3+k];
+                    }
+                }
+                float N[3] = { Ps[1]*Pt[2] - Ps[2]*Pt[1],
+                               Ps[2]*Pt[0] - Ps[0]*Pt[2],
+                               Ps[0]*Pt[1] - Ps[1]*Pt[0] };
+                float length = std::sqrt(N[0]*N[0] + N[1]*N[1] + N[2]*N[2]);
+
+                FarPatchBVH::Hit hit;
+                if (! bvh.FindClosestPoint(P, &values[0], 3, hit) ||
+                    hit.distance > tolerance) {
+                    ++closestFailures;
+                }
+
+                if (length <= 1e-6f * extent * extent) {
+                    continue;
+                }
+
+                // the hit may be closer to the origin than the center of the
+                // patch (folds), but must lie on the ray and on the surface
+                float height = 0.01f * extent,
+                      origin[3], direction[3];
+                for (int k=0; k<3; ++k) {
+                    direction[k] = -N[k] / length;
+                    origin[k] = P[k] - height * direction[k];
+                }
+                if (! bvh.Intersect(origin, direction, &values[0], 3, hit) ||
+                    hit.distance > height + tolerance) {
+                    ++rayFailures;
+                    continue;
+                }
+
+                float hitP[3] = { 0.0f, 0.0f, 0.0f };
+                patchTable->EvaluateBasis(hit.handle, hit.s, hit.t, w);
+                FarConstIndexArray hitCVs = patchTable->GetPatchVertices(hit.handle);
+                for (int i=0; i<hitCVs.size(); ++i) {
+                    for (int k=0; k<3; ++k) {
+                        hitP[k] += w[i] * values[hitCVs[i]*3+k];
+                    }
+                }
+                float onSurface = 0.0f, onRay = 0.0f;
+                for (int k=0; k<3; ++k) {
+                    float d = hitP[k] - hit.P[k],
+                          r = origin[k] + hit.distance * direction[k] - hit.P[k];
+                    onSurface += d * d;
+                    onRay += r * r;
+                }
+                if (std::sqrt(onSurface) > tolerance || std::sqrt(onRay) > tolerance) {
+                    ++rayFailures;
+                }
+            }
+        }
+    }
+
+    if (closestFailures || rayFailures) {
+        printf("  patch BVH : %d closest point and %d ray queries failed\n",
+            closestFailures, rayFailures);
+        failures += closestFailures + rayFailures;
+    }
+
+    delete table;
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+static bool
+isVertexSemiSharp(FarTopologyLevel const & level, int vert) {
+
+    typedef OpenSubdiv::Sdc::Crease SdcCrease;
+
+    if (SdcCrease::IsSemiSharp(level.GetVertexSharpness(vert))) {
+        return true;
+    }
+    OpenSubdiv::Far::ConstIndexArray vEdges = level.GetVertexEdges(vert);
+    for (int i=0; i<vEdges.size(); ++i) {
+        if (SdcCrease::IsSemiSharp(level.GetEdgeSharpness(vEdges[i]))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static int
+compareLoopPatches(Shape const & shape) {
+
+    typedef OpenSubdiv::Far::StencilTable        FarStencilTable;
+    typedef OpenSubdiv::Far::StencilTableFactory FarStencilTableFactory;
+    typedef OpenSubdiv::Far::PrimvarRefiner      FarPrimvarRefiner;
+    typedef OpenSubdiv::Far::PatchTable          FarPatchTable;
+    typedef OpenSubdiv::Far::PatchTableFactory   FarPatchTableFactory;
+    typedef OpenSubdiv::Far::PatchDescriptor     FarPatchDescriptor;
+    typedef OpenSubdiv::Far::PatchMap            FarPatchMap;
+    typedef OpenSubdiv::Far::ConstIndexArray     FarConstIndexArray;
+
+    // The box-spline patches of an adaptively refined Loop mesh must match
+    // the limit positions of the vertices of the first uniform level, at the
+    // corners and at the edge mid-points of every base face
+    int failures = 0;
+    if (shape.scheme != kLoop) {
+        return failures;
+    }
+
+    int const maxLevel = 3;
+
+    FarTopologyRefiner * refiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+    refiner->RefineAdaptive(FarTopologyRefiner::AdaptiveOptions(maxLevel));
+
+    FarPatchTable const * patchTable =
+        FarPatchTableFactory::Create(*refiner, FarPatchTableFactory::Options(maxLevel));
+
+    FarStencilTable const * stencils = FarStencilTableFactory::Create(*refiner);
+    std::vector<float> controlPoints;
+    applyStencils(*stencils, shape.verts, controlPoints, 3);
+    delete stencils;
+
+    FarPatchMap patchMap(*patchTable);
+
+    // limit positions of the first uniform level
+    FarTopologyRefiner * uniformRefiner =
+        FarTopologyRefinerFactory::Create(shape,
+            FarTopologyRefinerFactory::Options(
+                GetSdcType(shape), GetSdcOptions(shape)));
+    FarTopologyRefiner::UniformOptions uniformOptions(1);
+    uniformOptions.fullTopologyInLastLevel = true;
+    uniformRefiner->RefineUniform(uniformOptions);
+
+    FarTopologyLevel const & baseLevel = uniformRefiner->GetLevel(0);
+
+    std::vector<xyzVV> coarse(baseLevel.GetNumVertices()),
+        refined(uniformRefiner->GetLevel(1).GetNumVertices()),
+        limit(uniformRefiner->GetLevel(1).GetNumVertices());
+    for (int i=0; i<(int)coarse.size(); ++i) {
+        coarse[i].SetPosition(shape.verts[i*3], shape.verts[i*3+1], shape.verts[i*3+2]);
+    }
+    FarPrimvarRefiner primvarRefiner(*uniformRefiner);
+    primvarRefiner.Interpolate(1, coarse, refined);
+    primvarRefiner.Limit(refined, limit);
+
+    static float const st[][2] = {
+        { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 0.0f, 1.0f },
+        { 0.5f, 0.0f }, { 0.5f, 0.5f }, { 0.0f, 0.5f } };
+
+    int numCompared = 0, numDiffering = 0;
+    for (int face=0; face<baseLevel.GetNumFaces(); ++face) {
+        if (baseLevel.IsFaceHole(face)) {
+            continue;
+        }
+        FarConstIndexArray fVerts = baseLevel.GetFaceVertices(face),
+                           fEdges = baseLevel.GetFaceEdges(face);
+        for (int i=0; i<6; ++i) {
+            FarPatchMap::Handle const * handle =
+                patchMap.FindPatch(face, st[i][0], st[i][1]);
+            if (! handle) {
+                ++numDiffering;
+                continue;
+            }
+            // semi-sharp features are only approximated by the patches of
+            // the last level
+            FarPatchDescriptor desc = patchTable->GetPatchDescriptor(*handle);
+            if ((desc.GetType() != FarPatchDescriptor::LOOP) ||
+                (patchTable->GetPatchParam(*handle).GetDepth() >= maxLevel)) {
+                continue;
+            }
+
+            float w[12];
+            patchTable->EvaluateBasis(*handle, st[i][0], st[i][1], w);
+
+            FarConstIndexArray cvs = patchTable->GetPatchVertices(*handle);
+            float p[3] = { 0.0f, 0.0f, 0.0f };
+            for (int j=0; j<cvs.size(); ++j) {
+                for (int k=0; k<3; ++k) {
+                    p[k] += w[j] * controlPoints[cvs[j]*3 + k];
+                }
+            }
+
+            // the limit of a vertex with semi-sharp features is approximated
+            int vert = (i < 3) ? baseLevel.GetVertexChildVertex(fVerts[i])
+                               : baseLevel.GetEdgeChildVertex(fEdges[i-3]);
+            if (isVertexSemiSharp(uniformRefiner->GetLevel(1), vert)) {
+                continue;
+            }
+            float const * q = limit[vert].GetPos();
+            for (int k=0; k<3; ++k) {
+                if (std::abs(p[k] - q[k]) > 1e-4f * std::max(1.0f, std::abs(q[k]))) {
+                    ++numDiffering;
+                    break;
+                }
+            }
+            ++numCompared;
+        }
+    }
+    if (numDiffering) {
+        printf("  Loop patches : %d locations out of %d differ from the limit surface\n",
+            numDiffering, numCompared);
+        ++failures;
+    }
+
+    delete uniformRefiner;
+    delete patchTable;
+    delete refiner;
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+static int
+checkMemoryUsage(FarTopologyRefiner const & refiner) {
+
+    typedef OpenSubdiv::Far::MemoryUsage  FarMemoryUsage;
+    typedef OpenSubdiv::Far::StencilTable FarStencilTable;
+
+    // The totals must match the breakdowns, which must cover every level
+    // (and face-varying channel) and hold at least the content of the tables
+    int failures = 0;
+
+    FarMemoryUsage usage;
+    size_t total = refiner.GetMemoryUsage(&usage);
+    if (total == 0 || total != usage.GetTotal() ||
+        total != refiner.GetMemoryUsage()) {
+        ++failures;
+    }
+    for (int level=0; level<refiner.GetNumLevels(); ++level) {
+        std::string name = FarMemoryUsage::GetIndexedName("level", level);
+        if (usage.GetTotal(name + "faceVertIndices") <
+            refiner.GetLevel(level).GetNumFaceVertices() * sizeof(int)) {
+            ++failures;
+        }
+        if (refiner.GetNumFVarChannels() &&
+            usage.GetTotal(name + FarMemoryUsage::GetIndexedName("fvar", 0)) == 0) {
+            ++failures;
+        }
+    }
+
+    FarStencilTable const * stencils =
+        OpenSubdiv::Far::StencilTableFactory::Create(refiner);
+    if (stencils) {
+        FarMemoryUsage stencilUsage;
+        size_t stencilTotal =
+            stencils->GetMemoryUsage(&stencilUsage, "stencils/");
+        size_t content = stencils->GetSizes().size() * sizeof(int) +
+                         stencils->GetOffsets().size() * sizeof(int) +
+                         stencils->GetControlIndices().size() * sizeof(int) +
+                         stencils->GetWeights().size() * sizeof(float);
+        if (stencilTotal < content ||
+            stencilTotal != stencilUsage.GetTotal("stencils/")) {
+            ++failures;
+        }
+        delete stencils;
+    }
+
+    if (failures) {
+        printf("  memory usage : %d inconsistent totals\n", failures);
+    }
+    return failures;
+}
+
 //------------------------------------------------------------------------------
 static int
 checkMesh(Shape const & shape, std::string const& name, int maxlevel) {
@@ -323,12 +1855,28 @@ checkMesh(Shape const & shape, std::string const& name, int maxlevel) {
     // Perform relevant tests and accumulate failures:
     int failureCount = 0;
 
-    if (areVerticesCompatibleWithHbr(shape, *refiner, &warningDetail)) {
+    if (areVerticesCompatibleWithHbr(*refiner, &warningDetail)) {
         failureCount = compareVerticesWithHbr(shape, *refiner, farVertexData);
     } else {
         printf("  warning : vertex data not compared with Hbr (%s)\n", warningDetail.c_str());
     }
 
+    failureCount += compareThreadedRefinement(shape);
+    failureCount += compareThreadedPrimvars(*refiner, farVertexData);
+    failureCount += compareThreadedStencils(*refiner);
+    failureCount += compareDoubleStencils(*refiner);
+    failureCount += compareEditStencils(shape, *refiner, farVertexData);
+    failureCount += compareLevelStencils(shape, *refiner, farVertexData);
+    failureCount += checkFaceRegion(shape);
+    failureCount += compareReorderedStencils(*refiner);
+    failureCount += compareSerializedTables(shape, *refiner);
+    failureCount += compareThreadedPatchTables(shape);
+    failureCount += compareLimitEvaluation(shape);
+    failureCount += checkPatchMap(shape);
+    failureCount += checkPatchBVH(shape);
+    failureCount += compareLoopPatches(shape);
+    failureCount += checkMemoryUsage(*refiner);
+
     return failureCount;
 }
 
@@ -339,6 +1887,13 @@ int main(int /* argc */, char ** /* argv */) {
 
     initShapes();
 
+#ifdef OPENSUBDIV_HAS_OPENMP
+    // exercise the threaded code paths even on machines with few cores
+    if (omp_get_max_threads() < 4) {
+        omp_set_num_threads(4);
+    }
+#endif
+
     if (g_debugmode)
         printf("[ ");
     else
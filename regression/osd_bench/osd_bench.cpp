@@ -0,0 +1,871 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+//
+// Benchmark suite of the per-frame evaluation paths of the CPU evaluators:
+// EvalStencils (vertex, level-to-level and limit stencils) and EvalPatches,
+// swept over shapes, evaluators, thread counts, primvar layouts and
+// derivative counts.
+// The results are printed as a table and can be written to JSON and/or CSV
+// files to track performance between releases.
+//
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <opensubdiv/far/patchMap.h>
+#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/ptexIndices.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/osd/cpuEvaluator.h>
+#include <opensubdiv/osd/cpuKernel.h>
+#include <opensubdiv/osd/cpuPatchTable.h>
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <omp.h>
+    #include <opensubdiv/osd/ompEvaluator.h>
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+    #include <opensubdiv/osd/tbbEvaluator.h>
+#endif
+#include "../../regression/common/far_utils.h"
+// XXX: revisit the directory structure for examples/tests
+#include "../../examples/common/stopwatch.h"
+
+#include "init_shapes.h"
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+// Primvar layouts: the primvar is read from (and written to) the beginning of
+// each element of 'stride' floats.
+struct Layout {
+    char const * name;
+    int length,
+        stride;
+};
+
+static Layout g_layouts[] = {
+    { "xyz",          3,  3 },
+    { "xyz+normal",   3,  6 },
+    { "xyzw",         4,  4 },
+    { "xyz+rgb",      6,  6 },
+    { "8 floats",     8,  8 },
+    { "12 floats",   12, 12 },
+};
+
+static int const g_numLayouts = (int)(sizeof(g_layouts)/sizeof(Layout));
+
+static char const * g_isaNames[] = { "scalar", "avx2", "avx512" };
+
+// Minimum duration of a sample: fast evaluations are repeated within a
+// sample so that the timer resolution does not dominate the measurement
+static double const g_minSampleTime = 0.005;
+
+//------------------------------------------------------------------------------
+// A measurement of one configuration
+struct Result {
+    std::string shape;
+    int         level;
+    std::string evaluator;
+    int         numThreads;
+    std::string isa;
+    std::string kernel;
+    int         numSets;
+    Layout      layout;
+    int         numElements,   // stencils or patch coordinates
+                numIterations, // evaluations per sample
+                numSamples;
+    double      mean,          // seconds per evaluation
+                stddev,
+                min,
+                median;
+    double      bytes;         // bytes touched by an evaluation
+};
+
+static std::vector<Result> g_results;
+
+static void
+computeStatistics(std::vector<double> samples, Result & result) {
+
+    int n = (int)samples.size();
+
+    double sum = 0.0;
+    for (int i = 0; i < n; ++i) sum += samples[i];
+    result.mean = sum / n;
+
+    double var = 0.0;
+    for (int i = 0; i < n; ++i) {
+        var += (samples[i] - result.mean) * (samples[i] - result.mean);
+    }
+    result.stddev = n > 1 ? std::sqrt(var / (n - 1)) : 0.0;
+
+    std::sort(samples.begin(), samples.end());
+    result.min = samples[0];
+    result.median = (n % 2) ? samples[n/2] :
+                              0.5 * (samples[n/2-1] + samples[n/2]);
+}
+
+//------------------------------------------------------------------------------
+// An evaluation to be timed
+struct Task {
+    virtual ~Task() { }
+    virtual void Run() = 0;
+};
+
+// Times 'numSamples' samples of a task (after a warm up evaluation, which
+// is also used to choose the number of evaluations per sample)
+static void
+measure(Task & task, int numSamples, Result & result) {
+
+    Stopwatch s;
+    s.Start();
+    task.Run();
+    s.Stop();
+
+    int numIterations = 1;
+    if (s.GetElapsed() < g_minSampleTime) {
+        numIterations = std::min(1000,
+            (int)std::ceil(g_minSampleTime / std::max(s.GetElapsed(), 1e-6)));
+    }
+
+    std::vector<double> samples(numSamples);
+    for (int i = 0; i < numSamples; ++i) {
+        s.Start();
+        for (int j = 0; j < numIterations; ++j) {
+            task.Run();
+        }
+        s.Stop();
+        samples[i] = s.GetElapsed() / numIterations;
+    }
+
+    result.numIterations = numIterations;
+    result.numSamples = numSamples;
+    computeStatistics(samples, result);
+}
+
+static void
+printResult(Result const & r) {
+
+    double throughput = r.numElements / std::max(r.mean, 1e-12);
+    printf("%-4s %2d thr  %-10s %d set(s)  %-10s  %8.3f ms +- %6.3f  "
+           "%8.2f M/s  %7.2f GB/s\n",
+           r.evaluator.c_str(), r.numThreads, r.kernel.c_str(), r.numSets,
+           r.layout.name, r.mean*1000.0, r.stddev*1000.0,
+           throughput * 1e-6, r.bytes / std::max(r.mean, 1e-12) * 1e-9);
+}
+
+//------------------------------------------------------------------------------
+// Stencil evaluation
+typedef Far::StencilTableReal<float>      StencilTable;
+typedef Far::LimitStencilTableReal<float> LimitStencilTable;
+
+template <class EVALUATOR>
+struct StencilTask : public Task {
+
+    StencilTask(StencilTable const & table, int numSets,
+                std::vector<float> const & src, Layout const & layout) :
+        _table(table), _numSets(numSets), _src(src),
+        _desc(0, layout.length, layout.stride) {
+
+        for (int w = 0; w < numSets; ++w) {
+            _dst[w].resize(table.GetNumStencils() * layout.stride);
+        }
+    }
+
+    virtual void Run() {
+
+        int const * sizes = &_table.GetSizes()[0],
+                  * offsets = &_table.GetOffsets()[0],
+                  * indices = &_table.GetControlIndices()[0];
+        int numStencils = _table.GetNumStencils();
+
+        if (_numSets == 1) {
+            EVALUATOR::EvalStencils(&_src[0], _desc, &_dst[0][0], _desc,
+                sizes, offsets, indices, &_table.GetWeights()[0],
+                0, numStencils);
+            return;
+        }
+
+        LimitStencilTable const & table =
+            static_cast<LimitStencilTable const &>(_table);
+
+        if (_numSets == 3) {
+            EVALUATOR::EvalStencils(&_src[0], _desc,
+                &_dst[0][0], _desc, &_dst[1][0], _desc, &_dst[2][0], _desc,
+                sizes, offsets, indices, &table.GetWeights()[0],
+                &table.GetDuWeights()[0], &table.GetDvWeights()[0],
+                0, numStencils);
+        } else {
+            EVALUATOR::EvalStencils(&_src[0], _desc,
+                &_dst[0][0], _desc, &_dst[1][0], _desc, &_dst[2][0], _desc,
+                &_dst[3][0], _desc, &_dst[4][0], _desc, &_dst[5][0], _desc,
+                sizes, offsets, indices, &table.GetWeights()[0],
+                &table.GetDuWeights()[0], &table.GetDvWeights()[0],
+                &table.GetDuuWeights()[0], &table.GetDuvWeights()[0],
+                &table.GetDvvWeights()[0],
+                0, numStencils);
+        }
+    }
+
+    StencilTable const & _table;
+    int _numSets;
+    std::vector<float> const & _src;
+    Osd::BufferDescriptor _desc;
+    std::vector<float> _dst[6];
+};
+
+// Evaluation of all the refinement levels through the buffer interface of the
+// evaluators, with the control vertices followed by the refined vertices in a
+// single buffer (as in Osd::Mesh): factorized tables are evaluated in a
+// single pass, level-to-level tables one level at a time.
+struct LevelBuffer {
+
+    LevelBuffer(std::vector<float> & data) : _data(data) { }
+
+    float * BindCpuBuffer() { return &_data[0]; }
+
+    std::vector<float> & _data;
+};
+
+template <class EVALUATOR>
+struct LevelStencilTask : public Task {
+
+    LevelStencilTask(StencilTable const & table, int numControlVerts,
+                     std::vector<float> const & src, Layout const & layout) :
+        _table(table),
+        _srcDesc(0, layout.length, layout.stride),
+        _dstDesc(numControlVerts * layout.stride, layout.length,
+                 layout.stride) {
+
+        _buffer.assign(src.begin(),
+                       src.begin() + numControlVerts * layout.stride);
+        _buffer.resize(
+            (numControlVerts + table.GetNumStencils()) * layout.stride);
+    }
+
+    virtual void Run() {
+
+        LevelBuffer buffer(_buffer);
+        EVALUATOR::EvalStencils(&buffer, _srcDesc, &buffer, _dstDesc, &_table);
+    }
+
+    StencilTable const & _table;
+    Osd::BufferDescriptor _srcDesc,
+                          _dstDesc;
+    std::vector<float> _buffer;
+};
+
+// Bytes read and written by a stencil evaluation: the table (sizes, offsets,
+// indices and weights), the gathered source primvars and the destination
+// primvars. Cache reuse of the source primvars is not accounted for.
+static double
+getStencilBytes(StencilTable const & table, int numSets,
+                Layout const & layout) {
+
+    double numStencils = table.GetNumStencils(),
+           numIndices = (double)table.GetControlIndices().size();
+    return numStencils * 2 * sizeof(int) +
+           numIndices * (sizeof(int) + numSets * sizeof(float)) +
+           numIndices * layout.length * sizeof(float) +
+           numStencils * numSets * layout.length * sizeof(float);
+}
+
+//------------------------------------------------------------------------------
+// Patch evaluation
+template <class EVALUATOR>
+struct PatchTask : public Task {
+
+    PatchTask(Osd::CpuPatchTable const & patchTable,
+              std::vector<Osd::PatchCoord> const & coords, int numSets,
+              std::vector<float> const & src, Layout const & layout) :
+        _patchTable(patchTable), _coords(coords), _numSets(numSets),
+        _src(src), _desc(0, layout.length, layout.stride) {
+
+        for (int w = 0; w < numSets; ++w) {
+            _dst[w].resize(coords.size() * layout.stride);
+        }
+    }
+
+    virtual void Run() {
+
+        int numCoords = (int)_coords.size();
+        Osd::PatchArray const * arrays = _patchTable.GetPatchArrayBuffer();
+        int const * indices = _patchTable.GetPatchIndexBuffer();
+        Osd::PatchParam const * params = _patchTable.GetPatchParamBuffer();
+
+        if (_numSets == 1) {
+            EVALUATOR::EvalPatches(&_src[0], _desc, &_dst[0][0], _desc,
+                numCoords, &_coords[0], arrays, indices, params);
+        } else if (_numSets == 3) {
+            EVALUATOR::EvalPatches(&_src[0], _desc,
+                &_dst[0][0], _desc, &_dst[1][0], _desc, &_dst[2][0], _desc,
+                numCoords, &_coords[0], arrays, indices, params);
+        } else {
+            EVALUATOR::EvalPatches(&_src[0], _desc,
+                &_dst[0][0], _desc, &_dst[1][0], _desc, &_dst[2][0], _desc,
+                &_dst[3][0], _desc, &_dst[4][0], _desc, &_dst[5][0], _desc,
+                numCoords, &_coords[0], arrays, indices, params);
+        }
+    }
+
+    Osd::CpuPatchTable const & _patchTable;
+    std::vector<Osd::PatchCoord> const & _coords;
+    int _numSets;
+    std::vector<float> const & _src;
+    Osd::BufferDescriptor _desc;
+    std::vector<float> _dst[6];
+};
+
+// Bytes read and written by a patch evaluation: the patch coordinates and
+// parameters, the control vertex indices and primvars and the destination
+// primvars.
+static double
+getPatchBytes(Far::PatchTable const & patchTable,
+              std::vector<Osd::PatchCoord> const & coords, int numSets,
+              Layout const & layout) {
+
+    double bytes = 0.0;
+    for (int i = 0; i < (int)coords.size(); ++i) {
+        int numCVs = patchTable.GetPatchVertices(coords[i].handle).size();
+        bytes += sizeof(Osd::PatchCoord) + sizeof(Osd::PatchParam) +
+                 numCVs * (sizeof(int) + layout.length * sizeof(float)) +
+                 numSets * layout.length * sizeof(float);
+    }
+    return bytes;
+}
+
+//------------------------------------------------------------------------------
+// The tables of a shape shared by all the evaluators
+struct ShapeTables {
+
+    ShapeTables() : vertexStencils(0), factorizedStencils(0),
+        levelStencils(0), limitStencils(0), farPatchTable(0),
+        patchTable(0) { }
+
+    ~ShapeTables() {
+        delete vertexStencils;
+        delete factorizedStencils;
+        delete levelStencils;
+        delete limitStencils;
+        delete patchTable;
+        delete farPatchTable;
+    }
+
+    std::string name;
+    int level;
+
+    StencilTable const * vertexStencils;
+    StencilTable const * factorizedStencils, // all the levels, factorized
+                       * levelStencils;      // all the levels, level-to-level
+    LimitStencilTable const * limitStencils;
+    Far::PatchTable const * farPatchTable;
+    Osd::CpuPatchTable const * patchTable;
+    std::vector<Osd::PatchCoord> patchCoords;
+
+    std::vector<float> coarsePrimvars,  // sources of the stencils
+                       patchPrimvars;   // sources of the patches
+};
+
+static void
+randomize(std::vector<float> & v, int size) {
+    v.resize(size);
+    for (int i = 0; i < size; ++i) {
+        v[i] = (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+    }
+}
+
+static void
+createTables(Shape const * shape, int level, int numLocationsPerFace,
+             ShapeTables & tables) {
+
+    Sdc::SchemeType type = GetSdcType(*shape);
+    Sdc::Options sdcOptions = GetSdcOptions(*shape);
+
+    tables.level = level;
+
+    // Vertex stencils of uniform refinement
+    {
+        Far::TopologyRefiner * refiner =
+            Far::TopologyRefinerFactory<Shape>::Create(*shape,
+                Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
+        refiner->RefineUniform(Far::TopologyRefiner::UniformOptions(level));
+
+        Far::StencilTableFactory::Options options;
+        options.generateOffsets = true;
+        options.generateIntermediateLevels = false;
+        tables.vertexStencils =
+            Far::StencilTableFactory::Create(*refiner, options);
+
+        // All the levels, factorized or level-to-level: the cheaper of the
+        // two depends on the shape and the level.
+        options.generateIntermediateLevels = true;
+        tables.factorizedStencils =
+            Far::StencilTableFactory::Create(*refiner, options);
+
+        options.factorizeIntermediateLevels = false;
+        tables.levelStencils =
+            Far::StencilTableFactory::Create(*refiner, options);
+
+        delete refiner;
+    }
+
+    // Limit stencils and patches of adaptive refinement at random locations
+    Far::TopologyRefiner * refiner =
+        Far::TopologyRefinerFactory<Shape>::Create(*shape,
+            Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
+    refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(level));
+
+    Far::PatchTableFactory::Options patchOptions(level);
+    patchOptions.SetEndCapType(
+        Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    tables.farPatchTable = Far::PatchTableFactory::Create(*refiner,
+                                                          patchOptions);
+    tables.patchTable = Osd::CpuPatchTable::Create(tables.farPatchTable);
+
+    Far::PatchMap patchMap(*tables.farPatchTable);
+
+    int numFaces = Far::PtexIndices(*refiner).GetNumFaces();
+
+    std::vector<float> s(numFaces * numLocationsPerFace),
+                       t(numFaces * numLocationsPerFace);
+    Far::LimitStencilTableFactory::LocationArrayVec locations(numFaces);
+    for (int face = 0; face < numFaces; ++face) {
+        for (int i = 0; i < numLocationsPerFace; ++i) {
+            int index = face * numLocationsPerFace + i;
+            s[index] = (float)rand() / (float)RAND_MAX;
+            t[index] = (float)rand() / (float)RAND_MAX;
+
+            Far::PatchMap::Handle const * handle =
+                patchMap.FindPatch(face, s[index], t[index]);
+            if (handle) {
+                tables.patchCoords.push_back(
+                    Osd::PatchCoord(*handle, s[index], t[index]));
+            }
+        }
+        locations[face].ptexIdx = face;
+        locations[face].numLocations = numLocationsPerFace;
+        locations[face].s = &s[face * numLocationsPerFace];
+        locations[face].t = &t[face * numLocationsPerFace];
+    }
+
+    Far::LimitStencilTableFactory::Options limitOptions;
+    limitOptions.generate1stDerivatives = true;
+    limitOptions.generate2ndDerivatives = true;
+    tables.limitStencils = Far::LimitStencilTableFactory::Create(
+        *refiner, locations, 0, 0, limitOptions);
+
+    // Primvar buffers large enough for the widest layout
+    int maxStride = 0;
+    for (int l = 0; l < g_numLayouts; ++l) {
+        maxStride = std::max(maxStride, g_layouts[l].stride);
+    }
+    randomize(tables.coarsePrimvars,
+              refiner->GetLevel(0).GetNumVertices() * maxStride);
+    randomize(tables.patchPrimvars,
+              (refiner->GetNumVerticesTotal() +
+               tables.farPatchTable->GetNumLocalPoints()) * maxStride);
+
+    delete refiner;
+}
+
+//------------------------------------------------------------------------------
+static void
+addResult(ShapeTables const & tables, char const * evaluatorName,
+          int numThreads, char const * kernel, int numSets,
+          Layout const & layout, int numElements, double bytes,
+          Task & task, int numSamples) {
+
+    Result result;
+    result.shape = tables.name;
+    result.level = tables.level;
+    result.evaluator = evaluatorName;
+    result.numThreads = numThreads;
+    result.isa = g_isaNames[Osd::CpuGetKernelISA()];
+    result.kernel = kernel;
+    result.numSets = numSets;
+    result.layout = layout;
+    result.numElements = numElements;
+    result.bytes = bytes;
+
+    measure(task, numSamples, result);
+
+    printResult(result);
+    g_results.push_back(result);
+}
+
+template <class EVALUATOR>
+static void
+benchEvaluator(ShapeTables const & tables, char const * evaluatorName,
+               int numThreads, int numSamples) {
+
+    for (int l = 0; l < g_numLayouts; ++l) {
+        Layout const & layout = g_layouts[l];
+
+        {
+            StencilTask<EVALUATOR> task(*tables.vertexStencils, 1,
+                                        tables.coarsePrimvars, layout);
+            addResult(tables, evaluatorName, numThreads, "vertex", 1, layout,
+                tables.vertexStencils->GetNumStencils(),
+                getStencilBytes(*tables.vertexStencils, 1, layout),
+                task, numSamples);
+        }
+
+        int numControlVerts = tables.levelStencils->GetNumControlVertices();
+        {
+            LevelStencilTask<EVALUATOR> task(*tables.factorizedStencils,
+                numControlVerts, tables.coarsePrimvars, layout);
+            addResult(tables, evaluatorName, numThreads, "factorized", 1,
+                layout, tables.factorizedStencils->GetNumStencils(),
+                getStencilBytes(*tables.factorizedStencils, 1, layout),
+                task, numSamples);
+        }
+        {
+            LevelStencilTask<EVALUATOR> task(*tables.levelStencils,
+                numControlVerts, tables.coarsePrimvars, layout);
+            addResult(tables, evaluatorName, numThreads, "levels", 1,
+                layout, tables.levelStencils->GetNumStencils(),
+                getStencilBytes(*tables.levelStencils, 1, layout),
+                task, numSamples);
+        }
+
+        for (int numSets = 1; numSets <= 6; numSets += (numSets == 1 ? 2 : 3)) {
+            StencilTask<EVALUATOR> task(*tables.limitStencils, numSets,
+                                        tables.coarsePrimvars, layout);
+            addResult(tables, evaluatorName, numThreads, "limit", numSets,
+                layout, tables.limitStencils->GetNumStencils(),
+                getStencilBytes(*tables.limitStencils, numSets, layout),
+                task, numSamples);
+        }
+
+        for (int numSets = 1; numSets <= 6; numSets += (numSets == 1 ? 2 : 3)) {
+            PatchTask<EVALUATOR> task(*tables.patchTable, tables.patchCoords,
+                                      numSets, tables.patchPrimvars, layout);
+            addResult(tables, evaluatorName, numThreads, "patches", numSets,
+                layout, (int)tables.patchCoords.size(),
+                getPatchBytes(*tables.farPatchTable, tables.patchCoords,
+                              numSets, layout),
+                task, numSamples);
+        }
+    }
+}
+
+//------------------------------------------------------------------------------
+// Generates a flat grid of size x size quads
+static std::string
+generateGrid(int size) {
+
+    std::stringstream ss;
+    for (int y = 0; y <= size; ++y) {
+        for (int x = 0; x <= size; ++x) {
+            ss << "v " << (float)x / size << " 0 " << (float)y / size << "\n";
+        }
+    }
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            int v = y * (size + 1) + x + 1;
+            ss << "f " << v << " " << v + 1 << " " << v + size + 2 << " "
+               << v + size + 1 << "\n";
+        }
+    }
+    return ss.str();
+}
+
+//------------------------------------------------------------------------------
+// JSON and CSV output
+// Escapes the quotes of a string (and the backslashes in JSON)
+static std::string
+escapeString(std::string const & str, bool csv) {
+
+    std::string result;
+    for (int i = 0; i < (int)str.size(); ++i) {
+        if (str[i] == '"') {
+            result += csv ? '"' : '\\';
+        } else if (str[i] == '\\' && ! csv) {
+            result += '\\';
+        }
+        result += str[i];
+    }
+    return result;
+}
+
+static bool
+writeJSON(char const * filename) {
+
+    FILE * f = fopen(filename, "w");
+    if (! f) return false;
+
+    fprintf(f, "{\n  \"benchmark\": \"osd_bench\",\n");
+    fprintf(f, "  \"minSampleTime\": %g,\n", g_minSampleTime);
+    fprintf(f, "  \"results\": [\n");
+    for (int i = 0; i < (int)g_results.size(); ++i) {
+        Result const & r = g_results[i];
+        fprintf(f, "    { \"shape\": \"%s\", \"level\": %d, "
+                   "\"evaluator\": \"%s\", \"threads\": %d, \"isa\": \"%s\", "
+                   "\"kernel\": \"%s\", \"weightSets\": %d, "
+                   "\"layout\": \"%s\", \"length\": %d, \"stride\": %d, "
+                   "\"elements\": %d, \"iterations\": %d, \"samples\": %d, "
+                   "\"meanMs\": %.6f, \"stddevMs\": %.6f, \"minMs\": %.6f, "
+                   "\"medianMs\": %.6f, \"elementsPerSecond\": %.6g, "
+                   "\"gbPerSecond\": %.6g }%s\n",
+                escapeString(r.shape, false).c_str(), r.level,
+                r.evaluator.c_str(), r.numThreads, r.isa.c_str(),
+                r.kernel.c_str(), r.numSets, r.layout.name,
+                r.layout.length, r.layout.stride, r.numElements,
+                r.numIterations, r.numSamples, r.mean*1000.0, r.stddev*1000.0,
+                r.min*1000.0, r.median*1000.0,
+                r.numElements / std::max(r.mean, 1e-12),
+                r.bytes / std::max(r.mean, 1e-12) * 1e-9,
+                (i + 1 < (int)g_results.size()) ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    fclose(f);
+    return true;
+}
+
+static bool
+writeCSV(char const * filename) {
+
+    FILE * f = fopen(filename, "w");
+    if (! f) return false;
+
+    fprintf(f, "shape,level,evaluator,threads,isa,kernel,weightSets,layout,"
+               "length,stride,elements,iterations,samples,meanMs,stddevMs,"
+               "minMs,medianMs,elementsPerSecond,gbPerSecond\n");
+    for (int i = 0; i < (int)g_results.size(); ++i) {
+        Result const & r = g_results[i];
+        fprintf(f, "\"%s\",%d,%s,%d,%s,%s,%d,\"%s\",%d,%d,%d,%d,%d,"
+                   "%.6f,%.6f,%.6f,%.6f,%.6g,%.6g\n",
+                escapeString(r.shape, true).c_str(),
+                r.level, r.evaluator.c_str(), r.numThreads, r.isa.c_str(),
+                r.kernel.c_str(), r.numSets, r.layout.name, r.layout.length,
+                r.layout.stride, r.numElements, r.numIterations,
+                r.numSamples, r.mean*1000.0, r.stddev*1000.0, r.min*1000.0,
+                r.median*1000.0, r.numElements / std::max(r.mean, 1e-12),
+                r.bytes / std::max(r.mean, 1e-12) * 1e-9);
+    }
+    fclose(f);
+    return true;
+}
+
+//------------------------------------------------------------------------------
+static void
+parseList(char const * str, std::vector<int> & values) {
+    values.clear();
+    std::stringstream ss(str);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        int value = atoi(item.c_str());
+        if (value > 0) values.push_back(value);
+    }
+}
+
+static void
+usage(char const * program) {
+    printf("Usage: %s [options] [file.obj ...]\n"
+           "  -l <level>          refinement level (default 2)\n"
+           "  -n <samples>        number of samples (default 10)\n"
+           "  -p <locations>      limit locations per face (default 4)\n"
+           "  -e <evaluators>     comma separated cpu,omp,tbb (default all)\n"
+           "  -t <threads>        comma separated thread counts of the\n"
+           "                      omp and tbb evaluators (default 1,max)\n"
+           "  -a <isa>            scalar, avx2 or avx512 (default best)\n"
+           "  -s <shape>          shape of the regression library (or 'all')\n"
+           "  -g <size>           generated grid of size x size quads\n"
+           "  -json <file>        write the results as JSON\n"
+           "  -csv <file>         write the results as CSV\n",
+           program);
+}
+
+int main(int argc, char **argv)
+{
+    int level = 2,
+        numSamples = 10,
+        numLocationsPerFace = 4;
+    std::string evaluators = "cpu,omp,tbb";
+    std::vector<int> threadCounts;
+    char const * jsonFile = 0,
+               * csvFile = 0;
+
+    initShapes();
+
+    std::vector<ShapeDesc> shapes;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strstr(argv[i], ".obj")) {
+            std::ifstream ifs(argv[i]);
+            if (ifs) {
+                std::stringstream ss;
+                ss << ifs.rdbuf();
+                ifs.close();
+                shapes.push_back(ShapeDesc(argv[i], ss.str(), kCatmark));
+            } else {
+                printf("Cannot read %s\n", argv[i]);
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "-l") && i+1 < argc) {
+            level = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-n") && i+1 < argc) {
+            numSamples = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-p") && i+1 < argc) {
+            numLocationsPerFace = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-e") && i+1 < argc) {
+            evaluators = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-t") && i+1 < argc) {
+            parseList(argv[++i], threadCounts);
+        }
+        else if (!strcmp(argv[i], "-a") && i+1 < argc) {
+            const char *isa = argv[++i];
+            Osd::CpuKernelISA kernelISA;
+            if (!strcmp(isa, "scalar")) {
+                kernelISA = Osd::CPU_KERNEL_ISA_SCALAR;
+            } else if (!strcmp(isa, "avx2")) {
+                kernelISA = Osd::CPU_KERNEL_ISA_AVX2;
+            } else if (!strcmp(isa, "avx512")) {
+                kernelISA = Osd::CPU_KERNEL_ISA_AVX512;
+            } else {
+                printf("Unknown instruction set %s\n", isa);
+                return 1;
+            }
+            Osd::CpuSetKernelISA(kernelISA);
+        }
+        else if (!strcmp(argv[i], "-s") && i+1 < argc) {
+            std::string name = argv[++i];
+            bool found = false;
+            for (int j = 0; j < (int)g_defaultShapes.size(); ++j) {
+                if (name == "all" || name == g_defaultShapes[j].name) {
+                    shapes.push_back(g_defaultShapes[j]);
+                    found = true;
+                }
+            }
+            if (! found) {
+                printf("Unknown shape %s\n", name.c_str());
+                return 1;
+            }
+        }
+        else if (!strcmp(argv[i], "-g") && i+1 < argc) {
+            int size = std::max(1, atoi(argv[++i]));
+            std::stringstream name;
+            name << "grid" << size << "x" << size;
+            shapes.push_back(ShapeDesc(name.str().c_str(), generateGrid(size),
+                                       kCatmark));
+        }
+        else if (!strcmp(argv[i], "-json") && i+1 < argc) {
+            jsonFile = argv[++i];
+        }
+        else if (!strcmp(argv[i], "-csv") && i+1 < argc) {
+            csvFile = argv[++i];
+        }
+        else {
+            usage(argv[0]);
+            return 1;
+        }
+    }
+
+    if (shapes.empty()) {
+        shapes = g_defaultShapes;
+        shapes.push_back(ShapeDesc("grid128x128", generateGrid(128), kCatmark));
+    }
+
+    bool useCpu = evaluators.find("cpu") != std::string::npos,
+         useOmp = evaluators.find("omp") != std::string::npos,
+         useTbb = evaluators.find("tbb") != std::string::npos;
+    (void)useOmp;
+    (void)useTbb;
+
+    int maxThreads = 1;
+#ifdef OPENSUBDIV_HAS_OPENMP
+    maxThreads = omp_get_max_threads();
+#endif
+    if (threadCounts.empty()) {
+        threadCounts.push_back(1);
+        if (maxThreads > 1) threadCounts.push_back(maxThreads);
+    }
+
+    for (int i = 0; i < (int)shapes.size(); ++i) {
+        Shape const * shape = Shape::parseObj(
+            shapes[i].data.c_str(),
+            shapes[i].scheme,
+            shapes[i].isLeftHanded);
+
+        ShapeTables tables;
+        tables.name = shapes[i].name;
+        createTables(shape, level, numLocationsPerFace, tables);
+
+        printf("---- %s, level %d : %d vertex stencils, %d limit stencils, "
+               "%d patch coordinates, %s ----\n", tables.name.c_str(), level,
+               tables.vertexStencils->GetNumStencils(),
+               tables.limitStencils->GetNumStencils(),
+               (int)tables.patchCoords.size(),
+               g_isaNames[Osd::CpuGetKernelISA()]);
+
+        if (useCpu) {
+            benchEvaluator<Osd::CpuEvaluator>(tables, "cpu", 1, numSamples);
+        }
+#ifdef OPENSUBDIV_HAS_OPENMP
+        if (useOmp) {
+            for (int t = 0; t < (int)threadCounts.size(); ++t) {
+                Osd::OmpEvaluator::SetNumThreads(threadCounts[t]);
+                benchEvaluator<Osd::OmpEvaluator>(tables, "omp",
+                    threadCounts[t], numSamples);
+            }
+            Osd::OmpEvaluator::SetNumThreads(maxThreads);
+        }
+#endif
+#ifdef OPENSUBDIV_HAS_TBB
+        if (useTbb) {
+            for (int t = 0; t < (int)threadCounts.size(); ++t) {
+                Osd::TbbEvaluator::SetNumThreads(threadCounts[t]);
+                benchEvaluator<Osd::TbbEvaluator>(tables, "tbb",
+                    threadCounts[t], numSamples);
+            }
+            Osd::TbbEvaluator::SetNumThreads(-1);
+        }
+#endif
+        delete shape;
+    }
+
+    if (jsonFile && ! writeJSON(jsonFile)) {
+        printf("Cannot write %s\n", jsonFile);
+        return 1;
+    }
+    if (csvFile && ! writeCSV(csvFile)) {
+        printf("Cannot write %s\n", csvFile);
+        return 1;
+    }
+    return 0;
+}
+
+//------------------------------------------------------------------------------
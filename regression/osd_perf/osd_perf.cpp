@@ -0,0 +1,1127 @@
+//
+//   Copyright 2026 Pixar
+//
+//   Licensed under the Apache License, Version 2.0 (the "Apache License")
+//   with the following modification; you may not use this file except in
+//   compliance with the Apache License and the following modification to it:
+//   Section 6. Trademarks. is deleted and replaced with:
+//
+//   6. Trademarks. This License does not grant permission to use the trade
+//      names, trademarks, service marks, or product names of the Licensor
+//      and its affiliates, except as required to comply with Section 4(c) of
+//      the License and to reproduce the content of the NOTICE file.
+//
+//   You may obtain a copy of the Apache License at
+//
+//       http://www.apache.org/licenses/LICENSE-2.0
+//
+//   Unless required by applicable law or agreed to in writing, software
+//   distributed under the Apache License with the above modification is
+//   distributed on an "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+//   KIND, either express or implied. See the Apache License for the specific
+//   language governing permissions and limitations under the Apache License.
+//
+
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+#include <opensubdiv/far/patchMap.h>
+#include <opensubdiv/far/patchTableFactory.h>
+#include <opensubdiv/far/primvarRefiner.h>
+#include <opensubdiv/far/ptexIndices.h>
+#include <opensubdiv/far/stencilInverseTable.h>
+#include <opensubdiv/far/stencilTableFactory.h>
+#include <opensubdiv/osd/cpuCompactStencilTable.h>
+#include <opensubdiv/osd/cpuEvaluator.h>
+#include <opensubdiv/osd/cpuKernel.h>
+#include <opensubdiv/osd/cpuPatchTable.h>
+#include <opensubdiv/osd/cpuVertexBuffer.h>
+#include <opensubdiv/osd/mesh.h>
+#ifdef OPENSUBDIV_HAS_OPENMP
+    #include <opensubdiv/osd/ompEvaluator.h>
+#endif
+#include "../../regression/common/far_utils.h"
+// XXX: revisit the directory structure for examples/tests
+#include "../../examples/common/stopwatch.h"
+
+#include "init_shapes.h"
+
+using namespace OpenSubdiv;
+
+//------------------------------------------------------------------------------
+// Primvar layouts: the primvar is read from (and written to) the beginning of
+// each element of 'stride' floats.
+struct Layout {
+    char const * name;
+    int length,
+        stride;
+};
+
+static Layout g_layouts[] = {
+    { "xyz",          3,  3 },
+    { "xyz+normal",   3,  6 },
+    { "xyzw",         4,  4 },
+    { "xyz+rgb",      6,  6 },
+    { "8 floats",     8,  8 },
+    { "12 floats",   12, 12 },
+};
+
+static char const * g_isaNames[] = { "scalar", "avx2", "avx512" };
+
+// The widest instruction set compared to the scalar kernels
+static Osd::CpuKernelISA g_isa = Osd::CPU_KERNEL_ISA_AVX512;
+
+// Value of the floats of the destination buffers that are not part of the
+// primvar (these must not be overwritten by the kernels).
+static float const g_sentinel = 1234.5f;
+
+//------------------------------------------------------------------------------
+typedef Far::StencilTableReal<float>      StencilTable;
+typedef Far::LimitStencilTableReal<float> LimitStencilTable;
+
+// Returns the number of weight sets of a table: 1 (point), 3 (1st
+// derivatives) or 6 (2nd derivatives)
+static int
+getNumWeightSets(StencilTable const & table) {
+
+    LimitStencilTable const * limitTable =
+        dynamic_cast<LimitStencilTable const *>(&table);
+    if (! limitTable || limitTable->GetDuWeights().empty()) return 1;
+    return limitTable->GetDuuWeights().empty() ? 3 : 6;
+}
+
+template <class EVALUATOR>
+static void
+evalStencils(StencilTable const & stencils, int numSets,
+             float const * src, Osd::BufferDescriptor const & srcDesc,
+             std::vector<float> * dst, Osd::BufferDescriptor const & dstDesc) {
+
+    int const * sizes = &stencils.GetSizes()[0],
+              * offsets = &stencils.GetOffsets()[0],
+              * indices = &stencils.GetControlIndices()[0];
+    int numStencils = stencils.GetNumStencils();
+
+    if (numSets == 1) {
+        EVALUATOR::EvalStencils(src, srcDesc, &dst[0][0], dstDesc,
+            sizes, offsets, indices, &stencils.GetWeights()[0],
+            0, numStencils);
+        return;
+    }
+
+    LimitStencilTable const & table =
+        static_cast<LimitStencilTable const &>(stencils);
+
+    if (numSets == 3) {
+        EVALUATOR::EvalStencils(src, srcDesc,
+            &dst[0][0], dstDesc, &dst[1][0], dstDesc, &dst[2][0], dstDesc,
+            sizes, offsets, indices, &table.GetWeights()[0],
+            &table.GetDuWeights()[0], &table.GetDvWeights()[0],
+            0, numStencils);
+    } else {
+        EVALUATOR::EvalStencils(src, srcDesc,
+            &dst[0][0], dstDesc, &dst[1][0], dstDesc, &dst[2][0], dstDesc,
+            &dst[3][0], dstDesc, &dst[4][0], dstDesc, &dst[5][0], dstDesc,
+            sizes, offsets, indices, &table.GetWeights()[0],
+            &table.GetDuWeights()[0], &table.GetDvWeights()[0],
+            &table.GetDuuWeights()[0], &table.GetDuvWeights()[0],
+            &table.GetDvvWeights()[0],
+            0, numStencils);
+    }
+}
+
+// Returns the average time of an evaluation
+template <class EVALUATOR>
+static double
+timeStencils(StencilTable const & table, int numSets,
+             std::vector<float> const & src, Layout const & layout,
+             std::vector<float> * dst, int numRepeats) {
+
+    Osd::BufferDescriptor desc(0, layout.length, layout.stride);
+
+    for (int w = 0; w < numSets; ++w) {
+        dst[w].assign(table.GetNumStencils() * layout.stride, g_sentinel);
+    }
+
+    // warm up the caches and the destination buffers
+    evalStencils<EVALUATOR>(table, numSets, &src[0], desc, dst, desc);
+
+    Stopwatch s;
+    s.Start();
+    for (int i = 0; i < numRepeats; ++i) {
+        evalStencils<EVALUATOR>(table, numSets, &src[0], desc, dst, desc);
+    }
+    s.Stop();
+    return s.GetElapsed() / numRepeats;
+}
+
+// Returns the number of primvars that differ between the scalar and the
+// SIMD kernels (or that overwrote the interleaved data)
+static int
+compareResults(std::vector<float> const * expected,
+               std::vector<float> const * result,
+               int numSets, Layout const & layout, float tolerance = 1e-4f) {
+
+    int failures = 0;
+    for (int w = 0; w < numSets; ++w) {
+        for (int i = 0; i < (int)expected[w].size(); ++i) {
+            float a = expected[w][i],
+                  b = result[w][i];
+            if ((i % layout.stride) >= layout.length) {
+                if (b != g_sentinel) ++failures;
+            } else if (std::abs(a - b) > tolerance * std::max(1.0f, std::abs(a))) {
+                ++failures;
+            }
+        }
+    }
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+template <class EVALUATOR>
+static int
+doPerf(char const * evaluatorName, StencilTable const & table,
+       char const * tableName, std::vector<float> const & src,
+       int numRepeats) {
+
+    Osd::CpuKernelISA bestISA = Osd::CpuSetKernelISA(g_isa);
+
+    int failures = 0;
+    int maxNumSets = getNumWeightSets(table);
+    for (int numSets = 1; numSets <= maxNumSets; numSets += (numSets == 1 ? 2 : 3)) {
+
+        for (int l = 0; l < (int)(sizeof(g_layouts)/sizeof(Layout)); ++l) {
+            Layout const & layout = g_layouts[l];
+
+            std::vector<float> expected[6], result[6];
+
+            Osd::CpuSetKernelISA(Osd::CPU_KERNEL_ISA_SCALAR);
+            double timeScalar = timeStencils<EVALUATOR>(
+                table, numSets, src, layout, expected, numRepeats);
+
+            Osd::CpuSetKernelISA(bestISA);
+            double timeSimd = timeStencils<EVALUATOR>(
+                table, numSets, src, layout, result, numRepeats);
+
+            int layoutFailures =
+                compareResults(expected, result, numSets, layout);
+
+            printf("%-4s %-8s %d set(s)  %-10s  %-6s %8.3f ms  %-6s %8.3f ms"
+                   "  x%5.2f%s\n",
+                   evaluatorName, tableName, numSets, layout.name,
+                   g_isaNames[Osd::CPU_KERNEL_ISA_SCALAR], timeScalar*1000.0,
+                   g_isaNames[bestISA], timeSimd*1000.0,
+                   timeScalar / std::max(timeSimd, 1e-9),
+                   layoutFailures ? "  (results differ)" : "");
+
+            failures += layoutFailures;
+        }
+    }
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// Raw pointer wrapper for the buffer interface of the evaluators
+struct RawBuffer {
+    RawBuffer(float * data) : _data(data) { }
+    float * BindCpuBuffer() { return _data; }
+    float * _data;
+};
+
+template <class EVALUATOR>
+static void
+evalDirtyStencils(StencilTable const & stencils, int numSets,
+                  Far::StencilInverseTable const & inverseTable,
+                  std::vector<Far::Index> const & dirtyVerts,
+                  std::vector<float> & src, Osd::BufferDescriptor const & desc,
+                  std::vector<float> * dst) {
+
+    RawBuffer srcBuffer(&src[0]), dstBuffer(&dst[0][0]);
+
+    if (numSets == 1) {
+        EVALUATOR::EvalStencils(&srcBuffer, desc, &dstBuffer, desc,
+            &stencils, &inverseTable,
+            (int)dirtyVerts.size(), &dirtyVerts[0]);
+    } else {
+        RawBuffer duBuffer(&dst[1][0]), dvBuffer(&dst[2][0]);
+        EVALUATOR::EvalStencils(&srcBuffer, desc, &dstBuffer, desc,
+            &duBuffer, desc, &dvBuffer, desc,
+            &static_cast<LimitStencilTable const &>(stencils), &inverseTable,
+            (int)dirtyVerts.size(), &dirtyVerts[0]);
+    }
+}
+
+// Edits a few control vertices and compares the sparse update of the
+// affected stencils to a complete evaluation
+template <class EVALUATOR>
+static int
+doSparsePerf(char const * evaluatorName, StencilTable const & table,
+             char const * tableName, std::vector<float> const & src,
+             int numRepeats) {
+
+    int numSets = std::min(getNumWeightSets(table), 3);
+    Layout const & layout = g_layouts[0];
+    Osd::BufferDescriptor desc(0, layout.length, layout.stride);
+
+    Far::StencilInverseTable inverseTable(table);
+
+    int const numDirtyVerts = 8;
+    std::vector<Far::Index> dirtyVerts;
+    for (int i = 0; i < numDirtyVerts; ++i) {
+        dirtyVerts.push_back(i * table.GetNumControlVertices() / numDirtyVerts);
+    }
+
+    std::vector<float> editedSrc(src);
+    for (int i = 0; i < numDirtyVerts; ++i) {
+        for (int j = 0; j < layout.length; ++j) {
+            editedSrc[dirtyVerts[i] * layout.stride + j] += 0.5f;
+        }
+    }
+
+    std::vector<float> initial[6], expected[6], result[6];
+    timeStencils<EVALUATOR>(table, numSets, src, layout, initial, 1);
+    double timeFull = timeStencils<EVALUATOR>(
+        table, numSets, editedSrc, layout, expected, numRepeats);
+
+    for (int w = 0; w < numSets; ++w) {
+        result[w] = initial[w];
+    }
+    evalDirtyStencils<EVALUATOR>(table, numSets, inverseTable, dirtyVerts,
+                                 editedSrc, desc, result);
+    int failures = compareResults(expected, result, numSets, layout);
+
+    Stopwatch s;
+    s.Start();
+    for (int i = 0; i < numRepeats; ++i) {
+        evalDirtyStencils<EVALUATOR>(table, numSets, inverseTable, dirtyVerts,
+                                     editedSrc, desc, result);
+    }
+    s.Stop();
+    double timeSparse = s.GetElapsed() / numRepeats;
+
+    printf("%-4s %-8s %d set(s)  %d dirty vertices  full %8.3f ms  "
+           "sparse %8.3f ms  x%5.2f%s\n",
+           evaluatorName, tableName, numSets, numDirtyVerts,
+           timeFull*1000.0, timeSparse*1000.0,
+           timeFull / std::max(timeSparse, 1e-9),
+           failures ? "  (results differ)" : "");
+
+    return failures;
+}
+
+// Compares the evaluation of a compact table to the one of its source table
+template <class EVALUATOR>
+static int
+doCompactPerf(char const * evaluatorName, StencilTable const & table,
+              Osd::CpuCompactStencilTable const & compactTable,
+              char const * tableName, std::vector<float> const & src,
+              int numRepeats) {
+
+    static char const * formatNames[] = { "float", "half", "fixed16" };
+
+    int numSets = std::min(getNumWeightSets(table), 3);
+    Layout const & layout = g_layouts[0];
+    Osd::BufferDescriptor desc(0, layout.length, layout.stride);
+
+    std::vector<float> expected[6], result[6];
+    double timeFloat = timeStencils<EVALUATOR>(
+        table, numSets, src, layout, expected, numRepeats);
+
+    RawBuffer srcBuffer(const_cast<float *>(&src[0]));
+    std::vector<RawBuffer> dstBuffers;
+    for (int w = 0; w < numSets; ++w) {
+        result[w].assign(table.GetNumStencils() * layout.stride, g_sentinel);
+        dstBuffers.push_back(RawBuffer(&result[w][0]));
+    }
+
+    Stopwatch s;
+    for (int i = 0; i <= numRepeats; ++i) {
+        // the first evaluation warms up the caches
+        if (i == 1) s.Start();
+        if (numSets == 1) {
+            EVALUATOR::EvalStencils(&srcBuffer, desc, &dstBuffers[0], desc,
+                                    &compactTable);
+        } else {
+            EVALUATOR::EvalStencils(&srcBuffer, desc, &dstBuffers[0], desc,
+                                    &dstBuffers[1], desc, &dstBuffers[2], desc,
+                                    &compactTable);
+        }
+    }
+    s.Stop();
+    double timeCompact = s.GetElapsed() / numRepeats;
+
+    // the quantization error accumulates over the coefficients of a stencil
+    // (the control values are within [-1, 1])
+    int maxSize = 0;
+    for (int i = 0; i < table.GetNumStencils(); ++i) {
+        maxSize = std::max(maxSize, table.GetSizes()[i]);
+    }
+    float tolerance = 1e-4f + compactTable.GetWeightError() * (float)maxSize;
+    int failures = compareResults(expected, result, numSets, layout, tolerance);
+
+    size_t tableSize = (table.GetSizes().size() + table.GetOffsets().size() +
+                        table.GetControlIndices().size()) * sizeof(int) +
+                       table.GetWeights().size() * getNumWeightSets(table) *
+                       sizeof(float);
+
+    printf("%-4s %-8s %d set(s)  %-7s  %7.2f MB -> %7.2f MB  float %8.3f ms  "
+           "compact %8.3f ms  x%5.2f%s\n",
+           evaluatorName, tableName, numSets,
+           formatNames[compactTable.GetWeightFormat()],
+           (double)tableSize / (1024.0 * 1024.0),
+           (double)compactTable.GetMemoryUsage() / (1024.0 * 1024.0),
+           timeFloat*1000.0, timeCompact*1000.0,
+           timeFloat / std::max(timeCompact, 1e-9),
+           failures ? "  (results differ)" : "");
+
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// Compares the evaluation of several instances at once to the evaluation of
+// each instance on its own
+template <class EVALUATOR>
+static int
+doInstancesPerf(char const * evaluatorName, StencilTable const & table,
+                char const * tableName, int numRepeats) {
+
+    int const numInstances = 16;
+
+    Layout const & layout = g_layouts[0];
+    Osd::BufferDescriptor desc(0, layout.length, layout.stride);
+
+    int const * sizes = &table.GetSizes()[0],
+              * offsets = &table.GetOffsets()[0],
+              * indices = &table.GetControlIndices()[0];
+    float const * weights = &table.GetWeights()[0];
+    int numStencils = table.GetNumStencils();
+
+    // the instances are stored one after the other in single buffers
+    int srcInstanceStride = table.GetNumControlVertices() * layout.stride,
+        dstInstanceStride = numStencils * layout.stride;
+
+    std::vector<float> src(numInstances * srcInstanceStride);
+    for (int i = 0; i < (int)src.size(); ++i) {
+        src[i] = (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+    }
+
+    std::vector<float> expected(numInstances * dstInstanceStride, g_sentinel),
+                       result(numInstances * dstInstanceStride, g_sentinel);
+
+    std::vector<float const *> srcs(numInstances);
+    std::vector<float *> dsts(numInstances);
+    for (int i = 0; i < numInstances; ++i) {
+        srcs[i] = &src[i * srcInstanceStride];
+        dsts[i] = &result[i * dstInstanceStride];
+    }
+
+    Stopwatch s;
+    for (int r = 0; r <= numRepeats; ++r) {
+        // the first evaluation warms up the caches
+        if (r == 1) s.Start();
+        for (int i = 0; i < numInstances; ++i) {
+            EVALUATOR::EvalStencils(&src[i * srcInstanceStride], desc,
+                                    &expected[i * dstInstanceStride], desc,
+                                    sizes, offsets, indices, weights,
+                                    0, numStencils);
+        }
+    }
+    s.Stop();
+    double timeSingle = s.GetElapsed() / numRepeats;
+
+    for (int r = 0; r <= numRepeats; ++r) {
+        if (r == 1) s.Start();
+        EVALUATOR::EvalStencils(numInstances, &srcs[0], desc, &dsts[0], desc,
+                                sizes, offsets, indices, weights,
+                                0, numStencils);
+    }
+    s.Stop();
+    double timeBatched = s.GetElapsed() / numRepeats;
+
+    int failures = compareResults(&expected, &result, 1, layout);
+
+    // same evaluation from a strided multi-instance buffer
+    std::vector<float> strided(numInstances * dstInstanceStride, g_sentinel);
+    RawBuffer srcBuffer(&src[0]), dstBuffer(&strided[0]);
+    EVALUATOR::EvalStencils(numInstances,
+                            &srcBuffer, desc, srcInstanceStride,
+                            &dstBuffer, desc, dstInstanceStride, &table);
+    failures += compareResults(&expected, &strided, 1, layout);
+
+    // instances interleaved in the elements of the buffers, which are
+    // evaluated as a single wider primvar
+    int length = layout.length;
+    Osd::BufferDescriptor interleavedDesc(0, length, numInstances * length);
+
+    std::vector<float> interleavedSrc(src.size()),
+                       interleaved(numInstances * numStencils * length);
+    for (int i = 0; i < numInstances; ++i) {
+        for (int v = 0; v < table.GetNumControlVertices(); ++v) {
+            for (int k = 0; k < length; ++k) {
+                interleavedSrc[(v * numInstances + i) * length + k] =
+                    src[i * srcInstanceStride + v * layout.stride + k];
+            }
+        }
+    }
+    RawBuffer interleavedSrcBuffer(&interleavedSrc[0]),
+              interleavedBuffer(&interleaved[0]);
+
+    for (int r = 0; r <= numRepeats; ++r) {
+        if (r == 1) s.Start();
+        EVALUATOR::EvalStencils(numInstances,
+                                &interleavedSrcBuffer, interleavedDesc, length,
+                                &interleavedBuffer, interleavedDesc, length,
+                                &table);
+    }
+    s.Stop();
+    double timeInterleaved = s.GetElapsed() / numRepeats;
+
+    for (int i = 0; i < numInstances; ++i) {
+        for (int v = 0; v < numStencils; ++v) {
+            for (int k = 0; k < length; ++k) {
+                float a = expected[i * dstInstanceStride + v * layout.stride + k],
+                      b = interleaved[(v * numInstances + i) * length + k];
+                if (std::abs(a - b) > 1e-4f * std::max(1.0f, std::abs(a))) {
+                    ++failures;
+                }
+            }
+        }
+    }
+
+    printf("%-4s %-8s %d instances  single %8.3f ms  batched %8.3f ms  "
+           "x%5.2f  interleaved %8.3f ms  x%5.2f%s\n",
+           evaluatorName, tableName, numInstances,
+           timeSingle*1000.0, timeBatched*1000.0,
+           timeSingle / std::max(timeBatched, 1e-9),
+           timeInterleaved*1000.0,
+           timeSingle / std::max(timeInterleaved, 1e-9),
+           failures ? "  (results differ)" : "");
+
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+static int
+doPerf(const Shape *shape, int maxlevel, int numRepeats) {
+
+    Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
+
+    Sdc::Options sdcOptions;
+    sdcOptions.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+
+    Far::TopologyRefiner * refiner = Far::TopologyRefinerFactory<Shape>::Create(
+        *shape, Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
+    {
+        Far::TopologyRefiner::AdaptiveOptions options(maxlevel);
+        refiner->RefineAdaptive(options);
+    }
+
+    // Vertex stencils of the refined vertices
+    Far::StencilTable const * vertexStencils = NULL;
+    {
+        Far::StencilTableFactory::Options options;
+        options.generateOffsets = true;
+        vertexStencils = Far::StencilTableFactory::Create(*refiner, options);
+    }
+
+    // Limit stencils with derivatives at a grid of locations on every face
+    Far::LimitStencilTable const * limitStencils = NULL;
+    std::vector<float> coords;
+    {
+        int const gridSize = 5;
+        for (int i = 0; i < gridSize; ++i) {
+            for (int j = 0; j < gridSize; ++j) {
+                coords.push_back((float)i / (float)(gridSize-1));
+                coords.push_back((float)j / (float)(gridSize-1));
+            }
+        }
+        std::vector<float> s(coords.size()/2), t(coords.size()/2);
+        for (int i = 0; i < (int)s.size(); ++i) {
+            s[i] = coords[2*i];
+            t[i] = coords[2*i+1];
+        }
+
+        int numFaces = Far::PtexIndices(*refiner).GetNumFaces();
+        Far::LimitStencilTableFactory::LocationArrayVec locations(numFaces);
+        for (int face = 0; face < numFaces; ++face) {
+            locations[face].ptexIdx = face;
+            locations[face].numLocations = (int)s.size();
+            locations[face].s = &s[0];
+            locations[face].t = &t[0];
+        }
+
+        Far::LimitStencilTableFactory::Options options;
+        options.generate1stDerivatives = true;
+        options.generate2ndDerivatives = true;
+        limitStencils = Far::LimitStencilTableFactory::Create(
+            *refiner, locations, 0, 0, options);
+    }
+
+    // A primvar buffer large enough for the widest layout
+    int numControlVerts = refiner->GetLevel(0).GetNumVertices();
+    std::vector<float> src(numControlVerts * 12);
+    for (int i = 0; i < (int)src.size(); ++i) {
+        src[i] = (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+    }
+
+    printf("%d vertex stencils, %d limit stencils\n",
+           vertexStencils->GetNumStencils(), limitStencils->GetNumStencils());
+
+    int failures = 0;
+    failures += doPerf<Osd::CpuEvaluator>("cpu", *vertexStencils, "vertex",
+                                          src, numRepeats);
+    failures += doPerf<Osd::CpuEvaluator>("cpu", *limitStencils, "limit",
+                                          src, numRepeats);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    failures += doPerf<Osd::OmpEvaluator>("omp", *vertexStencils, "vertex",
+                                          src, numRepeats);
+    failures += doPerf<Osd::OmpEvaluator>("omp", *limitStencils, "limit",
+                                          src, numRepeats);
+#endif
+
+    failures += doSparsePerf<Osd::CpuEvaluator>("cpu", *vertexStencils,
+                                                "vertex", src, numRepeats);
+    failures += doSparsePerf<Osd::CpuEvaluator>("cpu", *limitStencils,
+                                                "limit", src, numRepeats);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    failures += doSparsePerf<Osd::OmpEvaluator>("omp", *vertexStencils,
+                                                "vertex", src, numRepeats);
+    failures += doSparsePerf<Osd::OmpEvaluator>("omp", *limitStencils,
+                                                "limit", src, numRepeats);
+#endif
+
+    Osd::CpuCompactStencilTable const * compactVertexStencils =
+        Osd::CpuCompactStencilTable::Create(vertexStencils);
+    Osd::CpuCompactStencilTable const * compactLimitStencils =
+        Osd::CpuCompactStencilTable::Create(limitStencils);
+
+    failures += doCompactPerf<Osd::CpuEvaluator>("cpu", *vertexStencils,
+        *compactVertexStencils, "vertex", src, numRepeats);
+    failures += doCompactPerf<Osd::CpuEvaluator>("cpu", *limitStencils,
+        *compactLimitStencils, "limit", src, numRepeats);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    failures += doCompactPerf<Osd::OmpEvaluator>("omp", *vertexStencils,
+        *compactVertexStencils, "vertex", src, numRepeats);
+    failures += doCompactPerf<Osd::OmpEvaluator>("omp", *limitStencils,
+        *compactLimitStencils, "limit", src, numRepeats);
+#endif
+
+    failures += doInstancesPerf<Osd::CpuEvaluator>("cpu", *vertexStencils,
+                                                   "vertex", numRepeats);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    failures += doInstancesPerf<Osd::OmpEvaluator>("omp", *vertexStencils,
+                                                   "vertex", numRepeats);
+#endif
+
+    delete compactVertexStencils;
+    delete compactLimitStencils;
+
+    delete vertexStencils;
+    delete limitStencils;
+    delete refiner;
+
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// Evaluates the limit at patch coordinates one at a time with the basis
+// weights of the Far patch table (reference for the batched kernels)
+static void
+evalPatchesReference(Far::PatchTable const & patchTable,
+                     std::vector<Osd::PatchCoord> const & coords, int numSets,
+                     std::vector<float> const & src, Layout const & layout,
+                     std::vector<float> * dst) {
+
+    float w[6][20];
+    for (int i = 0; i < (int)coords.size(); ++i) {
+        Osd::PatchCoord const & coord = coords[i];
+
+        Far::ConstIndexArray cvs = patchTable.GetPatchVertices(coord.handle);
+        patchTable.EvaluateBasis(coord.handle, coord.s, coord.t, w[0],
+            numSets > 1 ? w[1] : 0, numSets > 1 ? w[2] : 0,
+            numSets > 3 ? w[3] : 0, numSets > 3 ? w[4] : 0,
+            numSets > 3 ? w[5] : 0);
+
+        for (int set = 0; set < numSets; ++set) {
+            float * d = &dst[set][i * layout.stride];
+            for (int k = 0; k < layout.length; ++k) {
+                d[k] = 0.0f;
+            }
+            for (int j = 0; j < cvs.size(); ++j) {
+                float const * v = &src[cvs[j] * layout.stride];
+                for (int k = 0; k < layout.length; ++k) {
+                    d[k] += v[k] * w[set][j];
+                }
+            }
+        }
+    }
+}
+
+template <class EVALUATOR>
+static void
+evalPatches(Osd::CpuPatchTable const & patchTable,
+            std::vector<Osd::PatchCoord> const & coords, int numSets,
+            std::vector<float> const & src, Layout const & layout,
+            std::vector<float> * dst) {
+
+    Osd::BufferDescriptor desc(0, layout.length, layout.stride);
+
+    int numCoords = (int)coords.size();
+    Osd::PatchArray const * arrays = patchTable.GetPatchArrayBuffer();
+    int const * indices = patchTable.GetPatchIndexBuffer();
+    Osd::PatchParam const * params = patchTable.GetPatchParamBuffer();
+
+    if (numSets == 1) {
+        EVALUATOR::EvalPatches(&src[0], desc, &dst[0][0], desc,
+            numCoords, &coords[0], arrays, indices, params);
+    } else if (numSets == 3) {
+        EVALUATOR::EvalPatches(&src[0], desc,
+            &dst[0][0], desc, &dst[1][0], desc, &dst[2][0], desc,
+            numCoords, &coords[0], arrays, indices, params);
+    } else {
+        EVALUATOR::EvalPatches(&src[0], desc,
+            &dst[0][0], desc, &dst[1][0], desc, &dst[2][0], desc,
+            &dst[3][0], desc, &dst[4][0], desc, &dst[5][0], desc,
+            numCoords, &coords[0], arrays, indices, params);
+    }
+}
+
+// Returns the average time of an evaluation with the evaluator (or with the
+// reference when no patch table is given)
+template <class EVALUATOR>
+static double
+timePatches(Far::PatchTable const & farPatchTable,
+            Osd::CpuPatchTable const * patchTable,
+            std::vector<Osd::PatchCoord> const & coords, int numSets,
+            std::vector<float> const & src, Layout const & layout,
+            std::vector<float> * dst, int numRepeats) {
+
+    for (int w = 0; w < numSets; ++w) {
+        dst[w].assign(coords.size() * layout.stride, g_sentinel);
+    }
+
+    Stopwatch s;
+    for (int i = 0; i <= numRepeats; ++i) {
+        // the first evaluation warms up the caches
+        if (i == 1) s.Start();
+        if (patchTable) {
+            evalPatches<EVALUATOR>(*patchTable, coords, numSets, src,
+                                   layout, dst);
+        } else {
+            evalPatchesReference(farPatchTable, coords, numSets, src,
+                                 layout, dst);
+        }
+    }
+    s.Stop();
+    return s.GetElapsed() / numRepeats;
+}
+
+template <class EVALUATOR>
+static int
+doPatchPerf(char const * evaluatorName, Far::PatchTable const & farPatchTable,
+            Osd::CpuPatchTable const & patchTable,
+            std::vector<Osd::PatchCoord> const & coords,
+            std::vector<float> const & src, int numRepeats) {
+
+    Osd::CpuKernelISA bestISA = Osd::CpuSetKernelISA(g_isa);
+
+    int failures = 0;
+    for (int numSets = 1; numSets <= 6; numSets += (numSets == 1 ? 2 : 3)) {
+
+        for (int l = 0; l < (int)(sizeof(g_layouts)/sizeof(Layout)); ++l) {
+            Layout const & layout = g_layouts[l];
+
+            std::vector<float> expected[6], result[6];
+
+            double timeReference = timePatches<EVALUATOR>(farPatchTable, 0,
+                coords, numSets, src, layout, expected, numRepeats);
+
+            Osd::CpuSetKernelISA(bestISA);
+            double timeBatched = timePatches<EVALUATOR>(farPatchTable,
+                &patchTable, coords, numSets, src, layout, result, numRepeats);
+
+            int layoutFailures =
+                compareResults(expected, result, numSets, layout, 1e-3f);
+
+            printf("%-4s patches  %d set(s)  %-10s  single %8.3f ms  "
+                   "batched %-6s %8.3f ms  x%5.2f%s\n",
+                   evaluatorName, numSets, layout.name, timeReference*1000.0,
+                   g_isaNames[bestISA], timeBatched*1000.0,
+                   timeReference / std::max(timeBatched, 1e-9),
+                   layoutFailures ? "  (results differ)" : "");
+
+            failures += layoutFailures;
+        }
+    }
+    return failures;
+}
+
+static int
+doPatchPerf(const Shape *shape, int maxlevel, int numRepeats) {
+
+    Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
+
+    Sdc::Options sdcOptions;
+    sdcOptions.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+
+    Far::TopologyRefiner * refiner = Far::TopologyRefinerFactory<Shape>::Create(
+        *shape, Far::TopologyRefinerFactory<Shape>::Options(type, sdcOptions));
+    refiner->RefineAdaptive(Far::TopologyRefiner::AdaptiveOptions(maxlevel));
+
+    Far::PatchTableFactory::Options options(maxlevel);
+    options.SetEndCapType(
+        Far::PatchTableFactory::Options::ENDCAP_GREGORY_BASIS);
+    Far::PatchTable const * farPatchTable =
+        Far::PatchTableFactory::Create(*refiner, options);
+
+    Osd::CpuPatchTable const * patchTable =
+        Osd::CpuPatchTable::Create(farPatchTable);
+
+    // Random locations on every face
+    Far::PatchMap patchMap(*farPatchTable);
+
+    int const numLocationsPerFace = 32;
+    int numFaces = Far::PtexIndices(*refiner).GetNumFaces();
+
+    std::vector<Osd::PatchCoord> coords;
+    for (int face = 0; face < numFaces; ++face) {
+        for (int i = 0; i < numLocationsPerFace; ++i) {
+            float s = (float)rand() / (float)RAND_MAX,
+                  t = (float)rand() / (float)RAND_MAX;
+            Far::PatchMap::Handle const * handle =
+                patchMap.FindPatch(face, s, t);
+            if (handle) {
+                coords.push_back(Osd::PatchCoord(*handle, s, t));
+            }
+        }
+    }
+
+    // Random primvars for the refined vertices and the local points
+    int numVertices = refiner->GetNumVerticesTotal() +
+                      farPatchTable->GetNumLocalPoints();
+    std::vector<float> src(numVertices * 12);
+    for (int i = 0; i < (int)src.size(); ++i) {
+        src[i] = (float)rand() / (float)RAND_MAX * 2.0f - 1.0f;
+    }
+
+    printf("%d patch coordinates\n", (int)coords.size());
+
+    int failures = 0;
+    failures += doPatchPerf<Osd::CpuEvaluator>("cpu", *farPatchTable,
+                                               *patchTable, coords, src,
+                                               numRepeats);
+#ifdef OPENSUBDIV_HAS_OPENMP
+    failures += doPatchPerf<Osd::OmpEvaluator>("omp", *farPatchTable,
+                                               *patchTable, coords, src,
+                                               numRepeats);
+#endif
+
+    delete patchTable;
+    delete farPatchTable;
+    delete refiner;
+
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// Creates the tables of several instances of a shape with and without a
+// topology cache and checks that the cached instances share a single entry
+typedef Osd::MeshTopologyCacheT<Far::StencilTable, Osd::CpuPatchTable>
+    TopologyCache;
+
+static int
+doTopologyCachePerf(const Shape *shape, int maxlevel) {
+
+    int const numInstances = 8;
+
+    Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
+
+    Sdc::Options sdcOptions;
+    sdcOptions.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+
+    Far::TopologyRefinerFactory<Shape>::Options options(type, sdcOptions);
+
+    Osd::MeshBitset bits;
+    bits.set(Osd::MeshAdaptive, true);
+    bits.set(Osd::MeshEndCapGregoryBasis, true);
+
+    int failures = 0;
+
+    std::vector<TopologyCache::Entry *> entries(numInstances);
+    Stopwatch s;
+    s.Start();
+    for (int i = 0; i < numInstances; ++i) {
+        entries[i] = TopologyCache::CreateEntry(
+            Far::TopologyRefinerFactory<Shape>::Create(*shape, options),
+            3, 0, maxlevel, bits);
+    }
+    s.Stop();
+    double timeUncached = s.GetElapsed();
+
+    TopologyCache cache;
+    std::vector<TopologyCache::Entry *> cachedEntries(numInstances);
+    s.Start();
+    for (int i = 0; i < numInstances; ++i) {
+        cachedEntries[i] = cache.Acquire(
+            Far::TopologyRefinerFactory<Shape>::Create(*shape, options),
+            3, 0, maxlevel, bits);
+    }
+    s.Stop();
+    double timeCached = s.GetElapsed();
+
+    // all instances share the entry of the first one
+    if (cache.GetNumEntries() != 1) ++failures;
+    for (int i = 0; i < numInstances; ++i) {
+        if (cachedEntries[i] != cachedEntries[0]) ++failures;
+    }
+    if (cachedEntries[0]->refCount != numInstances) ++failures;
+    if (cachedEntries[0]->numVertices != entries[0]->numVertices ||
+        cachedEntries[0]->farPatchTable->GetNumPatchesTotal() !=
+            entries[0]->farPatchTable->GetNumPatchesTotal()) {
+        ++failures;
+    }
+
+    // a different refinement of the same topology has its own entry
+    Osd::MeshBitset uniformBits;
+    TopologyCache::Entry * uniformEntry = cache.Acquire(
+        Far::TopologyRefinerFactory<Shape>::Create(*shape, options),
+        3, 0, std::min(maxlevel, 2), uniformBits);
+    if (cache.GetNumEntries() != 2 || uniformEntry == cachedEntries[0]) {
+        ++failures;
+    }
+    cache.Release(uniformEntry);
+
+    for (int i = 0; i < numInstances; ++i) {
+        cache.Release(cachedEntries[i]);
+        TopologyCache::DestroyEntry(entries[i]);
+    }
+    if (cache.GetNumEntries() != 0) ++failures;
+
+    printf("topology cache  %d instances  uncached %8.3f ms  "
+           "cached %8.3f ms  x%5.2f%s\n",
+           numInstances, timeUncached*1000.0, timeCached*1000.0,
+           timeUncached / std::max(timeCached, 1e-9),
+           failures ? "  (entries differ)" : "");
+
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+// Cpu buffers and patch tables with the bindings required by Osd::Mesh
+class MeshVertexBuffer : public Osd::CpuVertexBuffer {
+public:
+    static MeshVertexBuffer * Create(int numElements, int numVertices,
+                                     void * deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new MeshVertexBuffer(numElements, numVertices);
+    }
+
+    float * BindVBO(void * deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return BindCpuBuffer();
+    }
+
+protected:
+    MeshVertexBuffer(int numElements, int numVertices) :
+        Osd::CpuVertexBuffer(numElements, numVertices) { }
+};
+
+class MeshPatchTable : public Osd::CpuPatchTable {
+public:
+    typedef float * VertexBufferBinding;
+
+    static MeshPatchTable * Create(Far::PatchTable const * patchTable,
+                                   void * deviceContext = NULL) {
+        (void)deviceContext;  // unused
+        return new MeshPatchTable(patchTable);
+    }
+
+protected:
+    explicit MeshPatchTable(Far::PatchTable const * patchTable) :
+        Osd::CpuPatchTable(patchTable) { }
+};
+
+typedef Osd::Mesh<MeshVertexBuffer, Far::StencilTable, Osd::CpuEvaluator,
+                  MeshPatchTable> CpuMesh;
+
+struct UV {
+    void Clear() { u = v = 0.0f; }
+    void AddWithWeight(UV const & src, float weight) {
+        u += weight * src.u;
+        v += weight * src.v;
+    }
+    float u, v;
+};
+
+// Refines the uvs of a shape with the face-varying stencils of a mesh and
+// compares them to the ones interpolated level by level
+static int
+doFaceVaryingPerf(const Shape *shape, int maxlevel, int numRepeats) {
+
+    if (shape->uvs.empty()) return 0;
+
+    Sdc::SchemeType type = OpenSubdiv::Sdc::SCHEME_CATMARK;
+
+    Sdc::Options sdcOptions;
+    sdcOptions.SetVtxBoundaryInterpolation(Sdc::Options::VTX_BOUNDARY_EDGE_ONLY);
+    sdcOptions.SetFVarLinearInterpolation(Sdc::Options::FVAR_LINEAR_NONE);
+
+    Far::TopologyRefinerFactory<Shape>::Options options(type, sdcOptions);
+
+    int failures = 0;
+    int numCoarseUVs = (int)shape->uvs.size() / 2;
+
+    // uniform : the last level matches the level by level interpolation
+    Osd::MeshBitset bits;
+    bits.set(Osd::MeshFVarData, true);
+
+    CpuMesh mesh(Far::TopologyRefinerFactory<Shape>::Create(*shape, options),
+                 3, 0, maxlevel, bits, NULL, NULL, NULL, 2);
+
+    mesh.UpdateFaceVaryingBuffer(&shape->uvs[0], 0, numCoarseUVs);
+
+    Stopwatch s;
+    for (int i = 0; i <= numRepeats; ++i) {
+        // the first refinement warms up the caches
+        if (i == 1) s.Start();
+        mesh.RefineFaceVarying();
+    }
+    s.Stop();
+    double timeStencils = s.GetElapsed() / numRepeats;
+
+    Far::TopologyRefiner const & refiner = *mesh.GetTopologyRefiner();
+    Far::PrimvarRefiner primvarRefiner(refiner);
+
+    std::vector<UV> uvs(refiner.GetNumFVarValuesTotal());
+    memcpy(&uvs[0], &shape->uvs[0], numCoarseUVs * sizeof(UV));
+
+    for (int i = 0; i <= numRepeats; ++i) {
+        if (i == 1) s.Start();
+        UV * src = &uvs[0];
+        for (int level = 1; level <= maxlevel; ++level) {
+            UV * dst = src + refiner.GetLevel(level-1).GetNumFVarValues();
+            primvarRefiner.InterpolateFaceVarying(level, src, dst);
+            src = dst;
+        }
+    }
+    s.Stop();
+    double timeLevels = s.GetElapsed() / numRepeats;
+
+    int numLastValues = refiner.GetLevel(maxlevel).GetNumFVarValues();
+    if (mesh.GetNumFaceVaryingValues() != numCoarseUVs + numLastValues) {
+        ++failures;
+    } else {
+        UV const * expected = &uvs[uvs.size() - numLastValues];
+        float const * result =
+            mesh.GetFaceVaryingBuffer()->BindCpuBuffer() + numCoarseUVs * 2;
+        for (int i = 0; i < numLastValues; ++i) {
+            if (std::abs(expected[i].u - result[2*i+0]) > 1e-5f ||
+                std::abs(expected[i].v - result[2*i+1]) > 1e-5f) {
+                ++failures;
+            }
+        }
+    }
+
+    // adaptive : the face-varying patches index the refined and end cap
+    // values of the mesh
+    bits.set(Osd::MeshAdaptive, true);
+    bits.set(Osd::MeshFVarAdaptive, true);
+    bits.set(Osd::MeshEndCapGregoryBasis, true);
+
+    CpuMesh adaptiveMesh(
+        Far::TopologyRefinerFactory<Shape>::Create(*shape, options),
+        3, 0, maxlevel, bits, NULL, NULL, NULL, 2);
+
+    adaptiveMesh.UpdateFaceVaryingBuffer(&shape->uvs[0], 0, numCoarseUVs);
+    adaptiveMesh.RefineFaceVarying();
+
+    Far::ConstIndexArray fvarValues =
+        adaptiveMesh.GetFarPatchTable()->GetFVarValues();
+    for (int i = 0; i < fvarValues.size(); ++i) {
+        if (fvarValues[i] < 0 ||
+            fvarValues[i] >= adaptiveMesh.GetNumFaceVaryingValues()) {
+            ++failures;
+            break;
+        }
+    }
+
+    printf("fvar uniform  %d values  levels %8.3f ms  stencils %8.3f ms  "
+           "x%5.2f%s\n",
+           numLastValues, timeLevels*1000.0, timeStencils*1000.0,
+           timeLevels / std::max(timeStencils, 1e-9),
+           failures ? "  (results differ)" : "");
+
+    return failures;
+}
+
+//------------------------------------------------------------------------------
+int main(int argc, char **argv)
+{
+    int maxlevel = 3,
+        numRepeats = 10;
+    std::string str;
+
+    for (int i = 1; i < argc; ++i) {
+        if (strstr(argv[i], ".obj")) {
+            std::ifstream ifs(argv[i]);
+            if (ifs) {
+                std::stringstream ss;
+                ss << ifs.rdbuf();
+                ifs.close();
+                str = ss.str();
+                g_shapes.push_back(ShapeDesc(argv[i], str.c_str(), kCatmark));
+            }
+        }
+        else if (!strcmp(argv[i], "-l")) {
+            maxlevel = atoi(argv[++i]);
+        }
+        else if (!strcmp(argv[i], "-n")) {
+            numRepeats = std::max(1, atoi(argv[++i]));
+        }
+        else if (!strcmp(argv[i], "-a")) {
+            const char *isa = argv[++i];
+            if (!strcmp(isa, "scalar")) {
+                g_isa = Osd::CPU_KERNEL_ISA_SCALAR;
+            } else if (!strcmp(isa, "avx2")) {
+                g_isa = Osd::CPU_KERNEL_ISA_AVX2;
+            } else if (!strcmp(isa, "avx512")) {
+                g_isa = Osd::CPU_KERNEL_ISA_AVX512;
+            } else {
+                printf("Unknown instruction set %s\n", isa);
+                return 1;
+            }
+        }
+    }
+
+    if (g_shapes.empty()) {
+        initShapes();
+    }
+
+    int failures = 0;
+    for (int i = 0; i < (int)g_shapes.size(); ++i) {
+        Shape const * shape = Shape::parseObj(
+            g_shapes[i].data.c_str(),
+            g_shapes[i].scheme,
+            g_shapes[i].isLeftHanded);
+
+        printf("---- %s, level %d ----\n", g_shapes[i].name.c_str(), maxlevel);
+        failures += doPerf(shape, maxlevel, numRepeats);
+        failures += doPatchPerf(shape, maxlevel, numRepeats);
+        failures += doTopologyCachePerf(shape, maxlevel);
+        failures += doFaceVaryingPerf(shape, maxlevel, numRepeats);
+
+        delete shape;
+    }
+
+    if (failures) {
+        printf("Total failures : %d\n", failures);
+    }
+    return failures ? 1 : 0;
+}
+
+//------------------------------------------------------------------------------